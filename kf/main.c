@@ -1,63 +1,65 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "ukfCfg.h"
+#include "ukfMem.h"
+#include "ukfBatch.h"
+#include "ukfFix.h"
+#include "ukfQueue.h"
+#include "ukfPool.h"
+#include "ukfReplay.h"
+#include "ukfSmooth.h"
+#include "ukfImm.h"
+#include "ukfRef.h"
+#include "rngCfg.h"
 
 #define UKF_TEST_EPS (1e-3)
 
+//! Fixed-point engine against the matlab reference, Q15 keeps only 8 fractional state bits
+#if defined(MTX_FIX_Q15)
+#define UKF_TEST_FIX_EPS (5e-1)
+#else
+#define UKF_TEST_FIX_EPS UKF_TEST_EPS
+#endif
+
 extern tUkfMatrix UkfMatrixCfg;
+extern tUkfBatchModel UkfBatchModelCfg;
+extern tUkfFixScale UkfFixScaleCfg;
+extern tUkfFixModel UkfFixModelCfg;
 
-void ukf_test(void) {
+/**
+ * @brief Run UKF configuration of the example model against the matlab reference
+ * 
+ * @param pUkfMatrix UKF configuration
+ * @param pName Test name
+ */
+void ukf_test(tUkfMatrix *pUkfMatrix, const char *pName) {
     uint8_t tfInitCfg = 0;
     tUKF ukfIo;
     uint32_t simLoop;
-
-    //UKF filter measurement input(data log is generated in matlab and used for UKF simulation for 15 iteration)
-    static const float yt[2][15] = {
-        {
-            0, 16.085992708563385, 12.714829185978214, 14.528500994457660, 19.105561355310275,
-            23.252820029388918, 29.282949862903255, 36.270058819651275, 44.244884173240955, 47.394243121124411,
-            55.988905459180458, 61.667450941562109, 68.624980301613647, 76.337963872393104, 82.611325690835159
-        }, // y1 test
-        {
-            0, 16.750821420874981, 14.277640835870006, 16.320754051600520, 20.560460303503849,
-            24.827446289454556, 31.290961393448615, 36.853553457560210, 42.157283183453522, 49.382835230961490,
-            57.516319669684677, 65.664496283509095, 71.428712755732704, 79.241720894223079, 84.902760328915676
-        }
-    };
-
-    //UKF filter expected system states calculated with matlab script for 15 iterations
-    static const float x_exp[15][4] = {
-        /*       x1                  x2                  x3                   x4       */
-        {4.901482729572258,  4.576939885855807,  49.990342921246459, 49.958134463327802},
-        {10.103304943868373, 9.409135720815829,  50.226544716205318, 49.750795004242228},
-        {15.132069573131298, 14.138974122835807, 50.429540890147599, 49.191128327737864},
-        {20.322823824348411, 19.096919763991380, 50.836860772439010, 49.189580207886742},
-        {24.940146120267713, 23.399758647105461, 49.577386595072561, 47.383813382660449},
-        {30.021901202161214, 27.882145089050120, 49.977568320123794, 46.551744562547626},
-        {34.844137036519108, 32.753891693435087, 49.474006205027358, 47.190693993547214},
-        {39.048783329419251, 38.499098203031146, 47.606199725375902, 50.001113730363919},
-        {43.883085498256158, 42.383331307689538, 47.209657232695072, 46.747611757031784},
-        {49.479941190207498, 47.255980559687778, 49.911944505272395, 47.887236233284476},
-        {55.928745858553086, 51.180270357916882, 53.472542964944132, 46.510558543249353},
-        {61.636426955126616, 55.275415649334157, 54.052126522632797, 45.262815392265203},
-        {67.755622369652016, 59.602096868661732, 55.881393486598796, 45.326766104509289},
-        {73.045763444967164, 63.838187852739992, 54.782159791340007, 44.291415099856643},
-        {80.489525793047093, 66.908477563332085, 58.973616985147245, 42.638148924845950}
-    };
+#if defined(UKF_PROFILE)
+    static const char *const phaseName[UKF_PHASE_NUM] = {"sigmapoint", "pred_state", "pred_output", "covariances", "meas_update", "step"};
+    tUkfProfile prof;
+    uint8_t phaseIdx;
+#endif
 
     //UKF initialization: CFG
-    tfInitCfg = ukf_init(&ukfIo, &UkfMatrixCfg);
+    tfInitCfg = ukf_init(&ukfIo, pUkfMatrix);
+#if defined(UKF_PROFILE)
+    ukf_prof_init(&prof, NULL);
+    ukfIo.pProf = &prof;
+#endif
 
     if (tfInitCfg == 0) {
-        float err[4] = {0, 0, 0, 0};
-        float absErrAccum[4] = {0, 0, 0, 0};
+        mtxScalar err[4] = {0, 0, 0, 0};
+        mtxScalar absErrAccum[4] = {0, 0, 0, 0};
 
         //UKF simulation CFG0: BEGIN
         //printf("ukf.m | ukf.c | diff \n");
         for (simLoop = 1; simLoop < 15; simLoop++) {
-            float* const py_cfg = ukfIo.input.y.val;
+            mtxScalar* const py_cfg = ukfIo.input.y.val;
 
             //UKF:CFG0 apply/load system measurements in working array for current iteration.
             py_cfg[0] = yt[0][simLoop];
@@ -78,7 +80,14 @@ void ukf_test(void) {
             absErrAccum[3] += err[3];
         }
 
-        printf("Accumulated error between ukf.m and ukf.c \n");
+#if defined(UKF_PROFILE)
+        printf("Phase timing [ticks] (%s)\n", pName);
+        for (phaseIdx = 0; phaseIdx < UKF_PHASE_NUM; phaseIdx++) {
+            printf("%-12s min %8u mean %8u max %8u\n", phaseName[phaseIdx], (unsigned)prof.phase[phaseIdx].min,
+                   (unsigned)ukf_prof_mean(&prof.phase[phaseIdx]), (unsigned)prof.phase[phaseIdx].max);
+        }
+#endif
+        printf("Accumulated error between ukf.m and ukf.c (%s)\n", pName);
         if (fabs(absErrAccum[0]) > UKF_TEST_EPS) { 
             printf("ERROR: Accumulated error absErrAccum[0] is too big: %.6e > %.6e\n", absErrAccum[0], UKF_TEST_EPS); 
         } else {
@@ -105,8 +114,1858 @@ void ukf_test(void) {
     }
 }
 
+/**
+ * @brief Rank-1 Cholesky update of a factor with zero pivot, downdate against the factor
+ * of the explicit matrix and a downdate which must fail without touching the factor
+ */
+void mtx_test_chol_update(void) {
+    //A = [4 2 0; 2 5 1; 0 1 3]
+    static const mtxScalar A[9] = {MTX_C(4.0), MTX_C(2.0), MTX_C(0.0), MTX_C(2.0), MTX_C(5.0), MTX_C(1.0), MTX_C(0.0), MTX_C(1.0), MTX_C(3.0)};
+    static const mtxScalar v0[3] = {MTX_C(1.0), MTX_C(0.5), MTX_C(-0.5)};
+    mtxScalar L[9], L0[9], B[9], v[3];
+    tMatrix Lm = {3, 3, L};
+    tMatrix vm = {3, 1, v};
+    mtxScalar err = 0;
+    uint8_t idx;
+
+    printf("\nRank-1 Cholesky update and downdate\n");
+
+    //L = diag(1, 0, 1) is the factor of a singular matrix, adding e2*e2' gives I
+    memset(L, 0, sizeof(L));
+    L[0] = MTX_C(1.0);
+    L[8] = MTX_C(1.0);
+    v[0] = 0;
+    v[1] = MTX_C(1.0);
+    v[2] = 0;
+    if (MTX_OPERATION_OK != mtx_chol_update(&Lm, &vm, MTX_C(1.0)) || MTX_C(1.0) != L[4]) {
+        printf("ERROR: update of a zero pivot failed\n");
+    } else {
+        printf("1. SUCCESS! update of a zero pivot\n");
+    }
+
+    //chol(A - 0.5*v*v') against the downdated chol(A)
+    mtx_kernel_cpy(L, A, 9);
+    (void)mtx_kernel_chol_lower(L, 3);
+    for (idx = 0; idx < 9; idx++) {
+        B[idx] = A[idx] - MTX_C(0.5) * v0[idx / 3] * v0[idx % 3];
+    }
+    (void)mtx_kernel_chol_lower(B, 3);
+    mtx_kernel_cpy(v, v0, 3);
+    if (MTX_OPERATION_OK != mtx_chol_update(&Lm, &vm, -MTX_C(0.5))) {
+        printf("ERROR: valid downdate failed\n");
+    } else {
+        for (idx = 0; idx < 9; idx++) {
+            err += fabs(L[idx] - B[idx]);
+        }
+        if (!(err < UKF_TEST_EPS)) {
+            printf("ERROR: downdated factor differs: %.6e > %.6e\n", err, UKF_TEST_EPS);
+        } else {
+            printf("2. SUCCESS! downdate %.6e < %.6e\n", err, UKF_TEST_EPS);
+        }
+    }
+
+    //A - 10*v*v' is indefinite
+    mtx_kernel_cpy(L0, L, 9);
+    mtx_kernel_cpy(v, v0, 3);
+    if (MTX_NOT_POS_DEFINED != mtx_chol_update(&Lm, &vm, -MTX_C(10.0)) || 0 != memcmp(L, L0, sizeof(L))) {
+        printf("ERROR: failed downdate not reported or factor changed\n");
+    } else {
+        printf("3. SUCCESS! failed downdate leaves the factor unchanged\n");
+    }
+}
+
+/**
+ * @brief Prediction of the example model is linear: closed form prediction with its
+ * transition matrix must give the same x(k|k-1), P(k|k-1) as the unscented prediction
+ * in both filter modes
+ */
+void ukf_test_linear(void) {
+    static mtxScalar Fxx[4][4] = {
+        {1, 0, MTX_C(0.1), 0},
+        {0, 1, 0, MTX_C(0.1)},
+        {0, 0, 1, 0},
+        {0, 0, 0, 1},
+    };
+    static const uint8_t filterMode[2] = {UKF_MODE_STANDARD, UKF_MODE_SQRT};
+    mtxScalar pred[2][4 + 16];
+    uint8_t mIdx, vIdx, eIdx;
+
+    for (mIdx = 0; mIdx < 2; mIdx++) {
+        mtxScalar errAccum = 0;
+
+        UkfMatrixCfg.filter_mode = filterMode[mIdx];
+
+        for (vIdx = 0; vIdx < 2; vIdx++) {
+            tUKF ukfIo;
+            uint8_t simLoop;
+
+            UkfMatrixCfg.F_state_transition = (tMatrix){4, 4, &Fxx[0][0]};
+            if (0 != ukf_init(&ukfIo, &UkfMatrixCfg)) {
+                printf("\nlinear prediction initialization fail\n");
+            }
+
+            //one unscented step moves the state away from the initial condition: in both
+            //variants the update must see propagated (not redrawn) sigma points
+            ukfIo.par.Fxx = (tMatrix){0, 0, NULL};
+            ukfIo.input.y.val[0] = yt[0][1];
+            ukfIo.input.y.val[1] = yt[1][1];
+            ukf_step(&ukfIo);
+            ukfIo.par.Fxx = (0 == vIdx) ? (tMatrix){0, 0, NULL} : UkfMatrixCfg.F_state_transition;
+
+            for (simLoop = 0; simLoop < 5; simLoop++) {
+                ukf_predict(&ukfIo, UkfMatrixCfg.dT);
+            }
+
+            for (eIdx = 0; eIdx < 4; eIdx++) {
+                pred[vIdx][eIdx] = ukfIo.update.x.val[eIdx];
+            }
+            for (eIdx = 0; eIdx < 16; eIdx++) {
+                //square-root filter: compare lower Cholesky factors, QR may flip the sign of a column
+                pred[vIdx][4 + eIdx] = (UKF_MODE_SQRT == filterMode[mIdx]) ? fabs(ukfIo.update.Pxx.val[eIdx]) : ukfIo.update.Pxx.val[eIdx];
+            }
+        }
+
+        for (eIdx = 0; eIdx < 4 + 16; eIdx++) {
+            errAccum += fabs(pred[1][eIdx] - pred[0][eIdx]);
+        }
+
+        printf("\nLinear vs unscented prediction, %s (state and covariance)\n", (UKF_MODE_SQRT == filterMode[mIdx]) ? "square-root" : "standard");
+        if (!(errAccum < UKF_TEST_EPS)) {
+            printf("ERROR: Accumulated error is too big: %.6e > %.6e\n", errAccum, UKF_TEST_EPS);
+        } else {
+            printf("1. SUCCESS! %.6e < %.6e\n", errAccum, UKF_TEST_EPS);
+        }
+    }
+
+    {
+        //the update after a linear prediction redraws the sigma points from x(k|k-1), P(k|k-1):
+        //standard (Pxx restored after the draw) and square-root filter must agree
+        mtxScalar post[2][4 + 16];
+        mtxScalar errAccum = 0;
+
+        for (mIdx = 0; mIdx < 2; mIdx++) {
+            tUKF ukfIo;
+            uint8_t simLoop, row, col, k;
+
+            UkfMatrixCfg.filter_mode = filterMode[mIdx];
+            UkfMatrixCfg.F_state_transition = (tMatrix){4, 4, &Fxx[0][0]};
+            (void)ukf_init(&ukfIo, &UkfMatrixCfg);
+
+            for (simLoop = 1; simLoop < 6; simLoop++) {
+                (void)ukf_predict(&ukfIo, UkfMatrixCfg.dT);
+                ukfIo.input.y.val[0] = yt[0][simLoop];
+                ukfIo.input.y.val[1] = yt[1][simLoop];
+                (void)ukf_update(&ukfIo);
+            }
+
+            for (eIdx = 0; eIdx < 4; eIdx++) {
+                post[mIdx][eIdx] = ukfIo.update.x.val[eIdx];
+            }
+            for (row = 0; row < 4; row++) {
+                for (col = 0; col < 4; col++) {
+                    mtxScalar sum = 0;
+
+                    for (k = 0; k < 4 && UKF_MODE_SQRT == filterMode[mIdx]; k++) {
+                        sum += ukfIo.update.Pxx.val[4 * row + k] * ukfIo.update.Pxx.val[4 * col + k];
+                    }
+                    post[mIdx][4 + 4 * row + col] = (UKF_MODE_SQRT == filterMode[mIdx]) ? sum : ukfIo.update.Pxx.val[4 * row + col];
+                }
+            }
+        }
+
+        for (eIdx = 0; eIdx < 4 + 16; eIdx++) {
+            errAccum += fabs(post[1][eIdx] - post[0][eIdx]);
+        }
+
+        printf("\nLinear prediction and update, standard vs square-root (state and covariance)\n");
+        if (!(errAccum < UKF_TEST_EPS)) {
+            printf("ERROR: Accumulated error is too big: %.6e > %.6e\n", errAccum, UKF_TEST_EPS);
+        } else {
+            printf("1. SUCCESS! %.6e < %.6e\n", errAccum, UKF_TEST_EPS);
+        }
+    }
+
+    {
+        //velocity limiter below the initial velocity: x(k|k-1) of the linear prediction is clamped
+        static mtxScalar xLim[4][3] = {{0, 0, 0}, {0, 0, 0}, {-1, MTX_C(0.5), MTX_C(0.1)}, {0, 0, 0}};
+        static uint8_t xLimEnbl[4] = {0, 0, 1, 0};
+        tUKF ukfIo;
+
+        UkfMatrixCfg.filter_mode = UKF_MODE_STANDARD;
+        UkfMatrixCfg.F_state_transition = (tMatrix){4, 4, &Fxx[0][0]};
+        (void)ukf_init(&ukfIo, &UkfMatrixCfg);
+        ukfIo.par.xLim = (tMatrix){4, 3, &xLim[0][0]};
+        ukfIo.par.xLimEnbl = (tMatrixBool){4, 1, &xLimEnbl[0]};
+        ukfIo.update.x.val[2] = 2;
+        (void)ukf_predict(&ukfIo, UkfMatrixCfg.dT);
+        ukfIo.par.xLim = (tMatrix){0, 0, NULL};
+        ukfIo.par.xLimEnbl = (tMatrixBool){0, 0, NULL};
+
+        if (MTX_C(0.5) != ukfIo.predict.x_m.val[2]) {
+            printf("ERROR: state limiter ignored by linear prediction, x(3) = %.6e\n", ukfIo.predict.x_m.val[2]);
+        } else {
+            printf("2. SUCCESS! state limiter clamps x(k|k-1) of linear prediction, x(3) = %.6e\n", ukfIo.predict.x_m.val[2]);
+        }
+    }
+
+    UkfMatrixCfg.F_state_transition = (tMatrix){0, 0, NULL};
+    UkfMatrixCfg.filter_mode = UKF_MODE_STANDARD;
+}
+
+/**
+ * @brief Lay out a filter of the example model in memory and copy the example configuration
+ * 
+ * @param pCfg UKF configuration to lay out
+ * @param pMem Memory of the filter
+ * @param memSize Bytes available at pMem
+ * @param filterMode UKF_MODE_STANDARD or UKF_MODE_SQRT
+ * @return uint8_t 0 := OK, 1 := memory too small
+ */
+static uint8_t ukf_test_arena_cfg(tUkfMatrix *pCfg, void *pMem, uint32_t memSize, uint8_t filterMode) {
+    if (0 != ukf_mem_layout(pCfg, pMem, memSize, Lx, Ly, filterMode, UKF_SIGMA_SYMMETRIC)) {
+        return 1;
+    }
+    (void)mtx_cpy(&pCfg->Sc_vector, &UkfMatrixCfg.Sc_vector);
+    (void)mtx_cpy(&pCfg->x_system_states_ic, &UkfMatrixCfg.x_system_states_ic);
+    (void)mtx_cpy(&pCfg->Pxx0_init_error_covariance, &UkfMatrixCfg.Pxx0_init_error_covariance);
+    (void)mtx_cpy(&pCfg->Qxx_process_noise_cov, &UkfMatrixCfg.Qxx_process_noise_cov);
+    (void)mtx_cpy(&pCfg->Ryy0_init_out_covariance, &UkfMatrixCfg.Ryy0_init_out_covariance);
+    pCfg->fcnPredictBatch = UkfMatrixCfg.fcnPredictBatch;
+    pCfg->fcnObserveBatch = UkfMatrixCfg.fcnObserveBatch;
+    pCfg->fcnPredictVec = UkfMatrixCfg.fcnPredictVec;
+    pCfg->fcnObserveVec = UkfMatrixCfg.fcnObserveVec;
+    pCfg->dT = UkfMatrixCfg.dT;
+
+    return 0;
+}
+
+/**
+ * @brief Run the example model from filters laid out back to back in one arena
+ */
+void ukf_test_arena(void) {
+    static const uint8_t filterMode[2] = {UKF_MODE_STANDARD, UKF_MODE_SQRT};
+    static uint64_t arena[512];
+    uint8_t *pMem = (uint8_t *)&arena[0];
+    tUkfMatrix ukfMatrix[2];
+    uint8_t fIdx;
+
+    for (fIdx = 0; fIdx < 2; fIdx++) {
+        const uint32_t memSize = ukf_mem_size(Lx, Ly, filterMode[fIdx], UKF_SIGMA_SYMMETRIC);
+        tUkfMatrix *const pCfg = &ukfMatrix[fIdx];
+
+        if (0 == ukf_test_arena_cfg(pCfg, pMem, (uint32_t)((uint8_t *)&arena[512] - pMem), filterMode[fIdx])) {
+            pMem += memSize;
+
+            printf("\n");
+            ukf_test(pCfg, (UKF_MODE_SQRT == filterMode[fIdx]) ? "arena, square-root" : "arena, standard");
+        } else {
+            printf("\narena layout fail\n");
+        }
+    }
+}
+
+/**
+ * @brief Scratch planner: byte count report must match ukf_mem_size() and sharing must save memory
+ */
+void ukf_test_mem_plan(void) {
+    static const uint8_t filterMode[2] = {UKF_MODE_STANDARD, UKF_MODE_SQRT};
+    uint8_t fIdx;
+
+    printf("\nMemory plan of the example (total, persistent, scratch, scratch without sharing)\n");
+    for (fIdx = 0; fIdx < 2; fIdx++) {
+        tUkfMemPlan plan;
+        const uint32_t total = ukf_mem_plan(&plan, Lx, Ly, filterMode[fIdx], UKF_SIGMA_SYMMETRIC);
+
+        if (total != ukf_mem_size(Lx, Ly, filterMode[fIdx], UKF_SIGMA_SYMMETRIC) || total != plan.persist + plan.scratch ||
+            !(plan.scratch < plan.scratchUnshared)) {
+            printf("ERROR: Inconsistent memory plan: %u, %u, %u, %u\n", (unsigned)plan.total, (unsigned)plan.persist,
+                   (unsigned)plan.scratch, (unsigned)plan.scratchUnshared);
+        } else {
+            printf("%u. SUCCESS! %u = %u + %u bytes, %u < %u\n", (unsigned)(fIdx + 1), (unsigned)plan.total, (unsigned)plan.persist,
+                   (unsigned)plan.scratch, (unsigned)plan.scratch, (unsigned)plan.scratchUnshared);
+        }
+    }
+}
+
+#define UKF_TEST_BATCH_LANES    (8u)
+#define UKF_TEST_BATCH_STEPS    (14u)
+#define UKF_TEST_BATCH_BAD      (5u)    //lane with indefinite Pxx
+#define UKF_TEST_BATCH_GAIN     (6u)    //lane with failing gain in the first step
+
+/**
+ * @brief One run of the example model in the lockstep batch engine, every lane sees its own
+ * measurements. With faults lane UKF_TEST_BATCH_BAD starts with an indefinite Pxx and the gain
+ * of lane UKF_TEST_BATCH_GAIN fails in the first step (Ryy0 slightly negative, Pxx tiny).
+ * Every lane but the indefinite one is compared with scalar ukf_step() on the same input.
+ *
+ * @param pBatch Batch working structure
+ * @param pMem Memory block
+ * @param memSize Size of memory block
+ * @param faulty Insert faults
+ * @param pAbsErr Accumulated state error of lane 0 vs matlab reference [4]
+ * @param pFault Lane faults of the first step [UKF_TEST_BATCH_LANES]
+ * @param pFinite Set to 0 if any lane got a non finite state
+ * @return mtxScalar Largest accumulated state error of a lane vs scalar ukf_step()
+ */
+static mtxScalar ukf_test_batch_run(tUkfBatch *pBatch, void *pMem, uint32_t memSize, uint8_t faulty, mtxScalar *pAbsErr,
+                                    uint8_t *pFault, uint8_t *pFinite) {
+    static mtxScalar xLane[UKF_TEST_BATCH_STEPS][4][UKF_TEST_BATCH_LANES];
+    const uint32_t nFilt = UKF_TEST_BATCH_LANES;
+    mtxScalar *const pR = UkfMatrixCfg.Ryy0_init_out_covariance.val;
+    const mtxScalar R[2] = {pR[0], pR[3]};
+    const mtxScalar rBad = faulty ? MTX_C(-1e-6) : R[0];
+    mtxScalar laneErrMax = 0;
+    uint32_t simLoop, fIdx, eIdx;
+    mtxDim xIdx;
+
+    *pFinite = 0;
+    if (0 != ukf_batch_init(pBatch, pMem, memSize, nFilt, &UkfMatrixCfg, &UkfBatchModelCfg)) {
+        return 1;
+    }
+    *pFinite = 1;
+
+    if (faulty) {
+        pBatch->Pxx[0 * nFilt + UKF_TEST_BATCH_BAD] = -1;
+        for (eIdx = 0; eIdx < 16; eIdx++) {
+            pBatch->Pxx[eIdx * nFilt + UKF_TEST_BATCH_GAIN] *= MTX_C(1e-12);
+        }
+    }
+
+    for (simLoop = 1; simLoop <= UKF_TEST_BATCH_STEPS; simLoop++) {
+        pBatch->Ryy0[0] = (1 == simLoop) ? rBad : R[0];
+        pBatch->Ryy0[3] = (1 == simLoop && faulty) ? rBad : R[1];
+        for (fIdx = 0; fIdx < nFilt; fIdx++) {
+            pBatch->y[0 * nFilt + fIdx] = yt[0][simLoop] + MTX_C(0.02) * fIdx;
+            pBatch->y[1 * nFilt + fIdx] = yt[1][simLoop] - MTX_C(0.01) * fIdx;
+        }
+
+        (void)ukf_batch_step(pBatch);
+        if (1 == simLoop) {
+            (void)memcpy(pFault, pBatch->fault, nFilt);
+        }
+
+        for (xIdx = 0; xIdx < 4; xIdx++) {
+            for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                xLane[simLoop - 1][xIdx][fIdx] = pBatch->x[xIdx * nFilt + fIdx];
+                *pFinite &= (0 != isfinite(pBatch->x[xIdx * nFilt + fIdx]));
+            }
+            pAbsErr[xIdx] += fabs(pBatch->x[xIdx * nFilt + 0] - x_exp[simLoop - 1][xIdx]);
+        }
+    }
+
+    for (fIdx = 0; fIdx < nFilt; fIdx++) {
+        mtxScalar laneErr = 0;
+        tUKF ukfIo;
+
+        if (faulty && UKF_TEST_BATCH_BAD == fIdx) {
+            continue;
+        }
+        (void)ukf_init(&ukfIo, &UkfMatrixCfg);
+        if (faulty && UKF_TEST_BATCH_GAIN == fIdx) {
+            for (eIdx = 0; eIdx < 16; eIdx++) {
+                ukfIo.update.Pxx.val[eIdx] *= MTX_C(1e-12);
+            }
+        }
+        for (simLoop = 1; simLoop <= UKF_TEST_BATCH_STEPS; simLoop++) {
+            pR[0] = (1 == simLoop) ? rBad : R[0];
+            pR[3] = (1 == simLoop && faulty) ? rBad : R[1];
+            ukfIo.input.y.val[0] = yt[0][simLoop] + MTX_C(0.02) * fIdx;
+            ukfIo.input.y.val[1] = yt[1][simLoop] - MTX_C(0.01) * fIdx;
+
+            (void)ukf_step(&ukfIo);
+
+            for (xIdx = 0; xIdx < 4; xIdx++) {
+                laneErr += fabs(xLane[simLoop - 1][xIdx][fIdx] - ukfIo.update.x.val[xIdx]);
+            }
+        }
+        laneErrMax = (laneErr > laneErrMax) ? laneErr : laneErrMax;
+    }
+    pR[0] = R[0];
+    pR[3] = R[1];
+
+    return laneErrMax;
+}
+
+/**
+ * @brief Run the example model in the lockstep batch engine: lane 0 against the matlab
+ * reference, all lanes against scalar ukf_step(), then faults confined to their lanes
+ */
+void ukf_test_batch(void) {
+    static uint64_t arena[2048];
+    mtxScalar absErrAccum[4] = {0, 0, 0, 0};
+    mtxScalar unused[4] = {0, 0, 0, 0};
+    uint8_t fault[UKF_TEST_BATCH_LANES];
+    uint8_t finite[2];
+    mtxScalar laneErr[2];
+    tUkfBatch batch;
+    uint32_t fIdx;
+    mtxDim xIdx;
+    uint8_t ok = 1;
+
+    UkfMatrixCfg.filter_mode = UKF_MODE_STANDARD;
+    UkfMatrixCfg.update_mode = UKF_UPDATE_BATCH;
+    laneErr[0] = ukf_test_batch_run(&batch, &arena[0], sizeof(arena), 0, absErrAccum, fault, &finite[0]);
+    laneErr[1] = ukf_test_batch_run(&batch, &arena[0], sizeof(arena), 1, unused, fault, &finite[1]);
+    UkfMatrixCfg.update_mode = UKF_UPDATE_AUTO;
+
+    printf("\nAccumulated error between ukf.m and ukf.c (batch, %u filters)\n", (unsigned)UKF_TEST_BATCH_LANES);
+    for (xIdx = 0; xIdx < 4; xIdx++) {
+        if (fabs(absErrAccum[xIdx]) > UKF_TEST_EPS) {
+            printf("ERROR: Accumulated error absErrAccum[%u] is too big: %.6e > %.6e\n", xIdx, absErrAccum[xIdx], UKF_TEST_EPS);
+        } else {
+            printf("%u. SUCCESS! %.6e < %.6e\n", xIdx + 1, absErrAccum[xIdx], UKF_TEST_EPS);
+        }
+    }
+
+    if (!(laneErr[0] < UKF_TEST_EPS) || 0 == finite[0]) {
+        printf("ERROR: batch lanes differ from scalar ukf_step(): %.6e > %.6e\n", laneErr[0], UKF_TEST_EPS);
+    } else {
+        printf("5. SUCCESS! every lane follows scalar ukf_step(), error %.6e < %.6e\n", laneErr[0], UKF_TEST_EPS);
+    }
+
+    for (fIdx = 0; fIdx < UKF_TEST_BATCH_LANES; fIdx++) {
+        const uint8_t expected = (UKF_TEST_BATCH_BAD == fIdx) ? UKF_FAULT_SIGMAPOINT :
+                                 ((UKF_TEST_BATCH_GAIN == fIdx) ? UKF_FAULT_GAIN : 0);
+
+        ok &= (expected == fault[fIdx]);
+    }
+    if (0 == ok || 0 == finite[1] || !(laneErr[1] < UKF_TEST_EPS)) {
+        printf("ERROR: lane faults not confined, lane %u 0x%02x, lane %u 0x%02x, error %.6e\n", (unsigned)UKF_TEST_BATCH_BAD,
+               fault[UKF_TEST_BATCH_BAD], (unsigned)UKF_TEST_BATCH_GAIN, fault[UKF_TEST_BATCH_GAIN], laneErr[1]);
+    } else {
+        printf("6. SUCCESS! faults kept in lanes %u and %u, other lanes follow ukf_step(), error %.6e < %.6e\n",
+               (unsigned)UKF_TEST_BATCH_BAD, (unsigned)UKF_TEST_BATCH_GAIN, laneErr[1], UKF_TEST_EPS);
+    }
+}
+
+/**
+ * @brief Sums of full-scale products must saturate instead of overflowing the
+ * accumulator, and every clamp must be reported
+ */
+static void ukf_test_fix_sat(void) {
+    const int8_t frac = (int8_t)(sizeof(mtxFix) * 8u - 2u);
+    mtxFix a[4] = {MTX_FIX_MAX, MTX_FIX_MAX, MTX_FIX_MAX, MTX_FIX_MAX};
+    mtxFix b[4] = {MTX_FIX_MIN, MTX_FIX_MIN, MTX_FIX_MIN, MTX_FIX_MIN};
+    mtxFix q[2] = {(mtxFix)1 << (frac - 2), (mtxFix)1 << (frac - 2)};
+    mtxFix d[3] = {0, 0, 0};
+    tMatrixFix A = {1, 4, 0, &a[0]};
+    tMatrixFix At = {4, 1, 0, &a[0]};
+    tMatrixFix B = {1, 4, 0, &b[0]};
+    tMatrixFix Q = {1, 2, 0, &q[0]};
+    tMatrixFix D0 = {1, 1, 0, &d[0]};
+    tMatrixFix D1 = {1, 1, 0, &d[1]};
+    tMatrixFix D2 = {1, 1, 0, &d[2]};
+    mtxResultInfo res[4];
+
+    A.frac = At.frac = B.frac = Q.frac = D0.frac = D1.frac = D2.frac = frac;
+
+    //4 products of nearly 1.0*2^frac each exceed the accumulator of both formats
+    res[0] = mtx_fix_mul(&A, &At, &D0);
+    res[1] = mtx_fix_mul_src2tr(&B, &A, &D1);
+    //1/4*1/4 + 1/4*1/4 = 1/8 fits the format
+    res[2] = mtx_fix_mul_src2tr(&Q, &Q, &D2);
+    //MAX + MAX is clamped
+    res[3] = mtx_fix_add(&D0, &D0);
+
+    if (MTX_SATURATED != res[0] || MTX_SATURATED != res[1] || MTX_OPERATION_OK != res[2] || MTX_SATURATED != res[3] ||
+        MTX_FIX_MAX != d[0] || MTX_FIX_MIN != d[1] || ((mtxFix)1 << (frac - 3)) != d[2]) {
+        printf("ERROR: fixed-point saturation, results %u %u %u %u, values %ld %ld %ld\n", (unsigned)res[0], (unsigned)res[1],
+               (unsigned)res[2], (unsigned)res[3], (long)d[0], (long)d[1], (long)d[2]);
+    } else {
+        printf("6. SUCCESS! sums of full-scale products saturate and report MTX_SATURATED\n");
+    }
+}
+
+/**
+ * @brief Run the example model in the fixed-point engine against the matlab reference
+ */
+void ukf_test_fix(void) {
+    static uint64_t arena[256];
+    tUkfFix fix;
+
+    UkfMatrixCfg.filter_mode = UKF_MODE_STANDARD;
+    if (0 == ukf_fix_init(&fix, &arena[0], sizeof(arena), &UkfMatrixCfg, &UkfFixScaleCfg, &UkfFixModelCfg)) {
+        mtxScalar absErrAccum[4] = {0, 0, 0, 0};
+        uint32_t simLoop;
+        mtxDim xIdx;
+
+        for (simLoop = 1; simLoop < 15; simLoop++) {
+            fix.y.val[0] = mtx_fix_from_f(yt[0][simLoop], fix.y.frac);
+            fix.y.val[1] = mtx_fix_from_f(yt[1][simLoop], fix.y.frac);
+
+            ukf_fix_step(&fix);
+
+            for (xIdx = 0; xIdx < 4; xIdx++) {
+                absErrAccum[xIdx] += fabs(mtx_fix_to_f(fix.x.val[xIdx], fix.x.frac) - x_exp[simLoop - 1][xIdx]);
+            }
+        }
+
+        printf("\nAccumulated error between ukf.m and ukf.c (fixed-point, %s)\n", (2 == sizeof(mtxFix)) ? "Q15" : "Q31");
+        for (xIdx = 0; xIdx < 4; xIdx++) {
+            if (fabs(absErrAccum[xIdx]) > UKF_TEST_FIX_EPS) {
+                printf("ERROR: Accumulated error absErrAccum[%u] is too big: %.6e > %.6e\n", xIdx, absErrAccum[xIdx], UKF_TEST_FIX_EPS);
+            } else {
+                printf("%u. SUCCESS! %.6e < %.6e\n", xIdx + 1, absErrAccum[xIdx], UKF_TEST_FIX_EPS);
+            }
+        }
+
+        if (0u != fix.saturated) {
+            printf("ERROR: example model saturates the fixed-point formats\n");
+        } else {
+            printf("5. SUCCESS! no value clamped in the example model\n");
+        }
+        ukf_test_fix_sat();
+    } else {
+        printf("\nfixed-point initialization fail\n");
+    }
+}
+
+/**
+ * @brief Constant velocity model x = [px vx py vy], position is measured
+ */
+static void ukf_test_linear_fx(tMatrix *pu_p, tMatrix *pX_p, tMatrix *pX_m, mtxDim sigmaIdx, mtxDim sigmaCnt, mtxScalar dT) {
+    mtxDim col;
+
+    (void)pu_p;
+    (void)pX_p;
+    for (col = sigmaIdx; col < sigmaIdx + sigmaCnt; col++) {
+        UKF_SIGMA_AT(pX_m, 0, col) += dT * UKF_SIGMA_AT(pX_m, 1, col);
+        UKF_SIGMA_AT(pX_m, 2, col) += dT * UKF_SIGMA_AT(pX_m, 3, col);
+    }
+}
+
+static void ukf_test_linear_hy(tMatrix *pu, tMatrix *pX_m, tMatrix *pY_m, mtxDim sigmaIdx, mtxDim sigmaCnt) {
+    mtxDim col;
+
+    (void)pu;
+    for (col = sigmaIdx; col < sigmaIdx + sigmaCnt; col++) {
+        UKF_SIGMA_AT(pY_m, 0, col) = UKF_SIGMA_AT(pX_m, 0, col);
+        UKF_SIGMA_AT(pY_m, 1, col) = UKF_SIGMA_AT(pX_m, 2, col);
+    }
+}
+
+/**
+ * @brief Every sigma set is exact for a linear model: the spherical simplex filter
+ * (standard and square-root) must reproduce state and covariance of the symmetric set
+ */
+void ukf_test_simplex(void) {
+    static const uint8_t filterMode[3] = {UKF_MODE_STANDARD, UKF_MODE_STANDARD, UKF_MODE_SQRT};
+    static const uint8_t sigmaScheme[3] = {UKF_SIGMA_SYMMETRIC, UKF_SIGMA_SIMPLEX, UKF_SIGMA_SIMPLEX};
+    static const char *const pName[3] = {"symmetric", "simplex", "simplex, square-root"};
+    static uint64_t arena[512];
+    mtxScalar xEnd[3][4];
+    mtxScalar pEnd[3][4];
+    uint8_t vIdx, xIdx;
+    uint32_t simLoop;
+
+    for (vIdx = 0; vIdx < 3; vIdx++) {
+        tUkfMatrix cfg;
+        tUKF ukfIo;
+
+        if (0 != ukf_mem_layout(&cfg, arena, sizeof(arena), Lx, Ly, filterMode[vIdx], sigmaScheme[vIdx])) {
+            printf("\nsimplex layout fail (%s)\n", pName[vIdx]);
+        }
+        (void)mtx_cpy(&cfg.Qxx_process_noise_cov, &UkfMatrixCfg.Qxx_process_noise_cov);
+        (void)mtx_cpy(&cfg.Ryy0_init_out_covariance, &UkfMatrixCfg.Ryy0_init_out_covariance);
+        cfg.fcnPredictBatch = &ukf_test_linear_fx;
+        cfg.fcnObserveBatch = &ukf_test_linear_hy;
+        cfg.dT = UkfMatrixCfg.dT;
+
+        if (0 != ukf_init(&ukfIo, &cfg)) {
+            printf("\nsimplex initialization fail (%s)\n", pName[vIdx]);
+        }
+
+        for (simLoop = 1; simLoop < 15; simLoop++) {
+            ukfIo.input.y.val[0] = MTX_C(0.1) * simLoop;
+            ukfIo.input.y.val[1] = MTX_C(0.05) * simLoop * simLoop;
+            ukf_step(&ukfIo);
+        }
+
+        for (xIdx = 0; xIdx < 4; xIdx++) {
+            mtxScalar const *const pRow = &ukfIo.update.Pxx.val[4 * xIdx];
+            mtxDim col;
+
+            xEnd[vIdx][xIdx] = ukfIo.update.x.val[xIdx];
+            pEnd[vIdx][xIdx] = pRow[xIdx];
+            if (UKF_MODE_SQRT == filterMode[vIdx]) {
+                //square-root filter holds the lower Cholesky factor: Pxx(i,i) = sum(S(i,:)^2)
+                pEnd[vIdx][xIdx] = 0;
+                for (col = 0; col <= xIdx; col++) {
+                    pEnd[vIdx][xIdx] += pRow[col] * pRow[col];
+                }
+            }
+        }
+    }
+
+    for (vIdx = 1; vIdx < 3; vIdx++) {
+        mtxScalar errAccum = 0;
+
+        for (xIdx = 0; xIdx < 4; xIdx++) {
+            errAccum += fabs(xEnd[vIdx][xIdx] - xEnd[0][xIdx]) + fabs(pEnd[vIdx][xIdx] - pEnd[0][xIdx]);
+        }
+
+        printf("\nLinear model, %s vs symmetric sigma set (state and covariance)\n", pName[vIdx]);
+        if (!(errAccum < UKF_TEST_EPS)) {
+            printf("ERROR: Accumulated error is too big: %.6e > %.6e\n", errAccum, UKF_TEST_EPS);
+        } else {
+            printf("1. SUCCESS! %.6e < %.6e\n", errAccum, UKF_TEST_EPS);
+        }
+    }
+}
+
+/**
+ * @brief Separate ukf_predict() and ukf_update() calls must reproduce ukf_step()
+ * against the matlab reference, a repeated update must not inflate the covariance
+ */
+void ukf_test_split(void) {
+    mtxScalar absErrAccum = 0;
+    mtxScalar pGrowth = 0;
+    uint32_t simLoop;
+    mtxDim xIdx;
+    tUKF ukfIo;
+
+    if (0 != ukf_init(&ukfIo, &UkfMatrixCfg)) {
+        printf("\nsplit initialization fail\n");
+    }
+
+    for (simLoop = 1; simLoop < 15; simLoop++) {
+        ukfIo.input.y.val[0] = yt[0][simLoop];
+        ukfIo.input.y.val[1] = yt[1][simLoop];
+
+        ukf_predict(&ukfIo, UkfMatrixCfg.dT);
+        ukf_update(&ukfIo);
+
+        for (xIdx = 0; xIdx < 4; xIdx++) {
+            absErrAccum += fabs(ukfIo.update.x.val[xIdx] - x_exp[simLoop - 1][xIdx]);
+        }
+    }
+
+    //second update redraws the sigma points from the posterior, one more measurement can only shrink P
+    pGrowth = ukfIo.update.Pxx.val[0];
+    ukf_update(&ukfIo);
+    pGrowth = ukfIo.update.Pxx.val[0] - pGrowth;
+    if (isnan(ukfIo.update.x.val[0])) {
+        pGrowth = 1;
+    }
+
+    printf("\nSplit predict/update (accumulated error of all states, repeated update)\n");
+    if (!(absErrAccum < 4 * UKF_TEST_EPS) || !(pGrowth <= 0)) {
+        printf("ERROR: Accumulated error is too big: %.6e, %.6e\n", absErrAccum, pGrowth);
+    } else {
+        printf("1. SUCCESS! %.6e < %.6e\n", absErrAccum, 4 * UKF_TEST_EPS);
+    }
+}
+
+/**
+ * @brief Measurements published through the ISR queue ahead of the filter must reproduce
+ * the matlab reference in order, a full queue must reject the newest sample
+ */
+void ukf_test_queue(void) {
+    static uint64_t arena[32];
+    mtxScalar absErrAccum = 0;
+    uint32_t pushIdx = 1;
+    uint32_t stamp = 0;
+    uint8_t orderErr = 0;
+    uint8_t fullRejected = 0;
+    uint32_t simLoop;
+    mtxDim xIdx;
+    tUkfQueue queue;
+    tUKF ukfIo;
+
+    if (0 != ukf_init(&ukfIo, &UkfMatrixCfg) || 0 != ukf_queue_init(&queue, arena, sizeof(arena), Ly, 4)) {
+        printf("\nqueue initialization fail\n");
+    }
+
+    for (simLoop = 1; simLoop < 15; simLoop++) {
+        //producer runs ahead until the queue is full
+        while (pushIdx < 15) {
+            const mtxScalar y[Ly] = {yt[0][pushIdx], yt[1][pushIdx]};
+
+            if (0 != ukf_queue_push(&queue, 10u * pushIdx, y, NULL)) {
+                fullRejected = 1;
+                break;
+            }
+            pushIdx++;
+        }
+
+        if (0 == ukf_queue_acquire(&queue, &ukfIo, &stamp)) {
+            ukf_step(&ukfIo);
+            ukf_queue_release(&queue);
+        }
+        if (stamp != 10u * simLoop) {
+            orderErr = 1;
+        }
+
+        for (xIdx = 0; xIdx < 4; xIdx++) {
+            absErrAccum += fabs(ukfIo.update.x.val[xIdx] - x_exp[simLoop - 1][xIdx]);
+        }
+    }
+
+    printf("\nMeasurement queue (accumulated error of all states, order and overflow)\n");
+    if (!(absErrAccum < 4 * UKF_TEST_EPS) || 0 != orderErr || 0 == fullRejected || 0 == queue.dropped || 0 != ukf_queue_count(&queue)) {
+        printf("ERROR: Queue test failed: %.6e, order %u, dropped %u\n", absErrAccum, (unsigned)orderErr, (unsigned)queue.dropped);
+    } else {
+        printf("1. SUCCESS! %.6e < %.6e\n", absErrAccum, 4 * UKF_TEST_EPS);
+    }
+}
+
+/**
+ * @brief Sigma point propagation on the thread pool must be bit-for-bit equal to the sequential
+ * path, with batch and with per-state callbacks and in both filter modes
+ */
+void ukf_test_parallel(void) {
+    static const uint8_t filterMode[3] = {UKF_MODE_STANDARD, UKF_MODE_STANDARD, UKF_MODE_SQRT};
+    static const char *const pName[3] = {"standard, batch callbacks", "standard, per-state callbacks", "square-root, batch callbacks"};
+    static mtxScalar ref[14][4 + 16];
+    tUkfPool pool;
+    uint8_t vIdx;
+
+    if (0 != ukf_pool_init(&pool, 3)) {
+        printf("\nthread pool initialization fail\n");
+    } else {
+        printf("\nParallel sigma point propagation (accumulated error of all states, bit-for-bit against sequential)\n");
+        for (vIdx = 0; vIdx < 3; vIdx++) {
+            tUkfMatrix cfg = UkfMatrixCfg;
+            mtxScalar absErrAccum = 0;
+            uint8_t mismatch = 0;
+            uint8_t eIdx;
+
+            cfg.filter_mode = filterMode[vIdx];
+            if (1 == vIdx) {
+                cfg.fcnPredictBatch = NULL;
+                cfg.fcnObserveBatch = NULL;
+                cfg.fcnPredictVec = NULL;
+                cfg.fcnObserveVec = NULL;
+            }
+
+            for (eIdx = 0; eIdx < 2; eIdx++) {
+                tUKF ukfIo;
+                uint32_t simLoop;
+                mtxDim xIdx;
+
+                if (0 != ukf_init(&ukfIo, &cfg)) {
+                    printf("\nparallel initialization fail (%s)\n", pName[vIdx]);
+                }
+                ukfIo.pExec = (0 == eIdx) ? NULL : &pool.exec;
+
+                for (simLoop = 1; simLoop < 15; simLoop++) {
+                    ukfIo.input.y.val[0] = yt[0][simLoop];
+                    ukfIo.input.y.val[1] = yt[1][simLoop];
+                    ukf_step(&ukfIo);
+
+                    if (0 == eIdx) {
+                        (void)memcpy(&ref[simLoop - 1][0], ukfIo.update.x.val, 4 * sizeof(mtxScalar));
+                        (void)memcpy(&ref[simLoop - 1][4], ukfIo.update.Pxx.val, 16 * sizeof(mtxScalar));
+                    } else {
+                        if (0 != memcmp(&ref[simLoop - 1][0], ukfIo.update.x.val, 4 * sizeof(mtxScalar)) ||
+                            0 != memcmp(&ref[simLoop - 1][4], ukfIo.update.Pxx.val, 16 * sizeof(mtxScalar))) {
+                            mismatch = 1;
+                        }
+                        for (xIdx = 0; xIdx < 4; xIdx++) {
+                            absErrAccum += fabs(ukfIo.update.x.val[xIdx] - x_exp[simLoop - 1][xIdx]);
+                        }
+                    }
+                }
+            }
+
+            if (!(absErrAccum < 4 * UKF_TEST_EPS) || 0 != mismatch) {
+                printf("ERROR: Parallel result differs (%s): %.6e, mismatch %u\n", pName[vIdx], absErrAccum, (unsigned)mismatch);
+            } else {
+                printf("%u. SUCCESS! %.6e < %.6e (%s)\n", (unsigned)(vIdx + 1), absErrAccum, 4 * UKF_TEST_EPS, pName[vIdx]);
+            }
+        }
+
+        ukf_pool_destroy(&pool);
+    }
+}
+
+/**
+ * @brief Warm restart: a filter restored from a checkpoint must continue bit-for-bit like the
+ * uninterrupted one, corrupted checkpoints and checkpoints of another mode must be rejected
+ */
+void ukf_test_checkpoint(void) {
+    static const uint8_t filterMode[2] = {UKF_MODE_STANDARD, UKF_MODE_SQRT};
+    static uint64_t ckpt[2][64];
+    static mtxScalar ref[14][4 + 16];
+    uint8_t mIdx;
+
+    printf("\nCheckpoint and warm restore (accumulated error of all states, bit-for-bit against uninterrupted run)\n");
+    for (mIdx = 0; mIdx < 2; mIdx++) {
+        mtxScalar absErrAccum = 0;
+        uint8_t mismatch = 0;
+        uint8_t rejectErr = 0;
+        uint32_t ckptSize = 0;
+        uint8_t rIdx;
+
+        UkfMatrixCfg.filter_mode = filterMode[mIdx];
+
+        for (rIdx = 0; rIdx < 2; rIdx++) {
+            tUKF ukfIo;
+            uint32_t simLoop;
+            mtxDim xIdx;
+
+            if (0 != ukf_init(&ukfIo, &UkfMatrixCfg)) {
+                printf("\ncheckpoint initialization fail\n");
+            }
+
+            for (simLoop = 1; simLoop < 15; simLoop++) {
+                if (1 == rIdx && 8 == simLoop) {
+                    //restart: state of the running filter is lost, resume from the checkpoint of step 7
+                    if (0 != ukf_init(&ukfIo, &UkfMatrixCfg) || 0 != ukf_restore(&ukfIo, &UkfMatrixCfg, ckpt[mIdx], sizeof(ckpt[mIdx]))) {
+                        rejectErr = 1;
+                    }
+                }
+
+                ukfIo.input.y.val[0] = yt[0][simLoop];
+                ukfIo.input.y.val[1] = yt[1][simLoop];
+                ukf_step(&ukfIo);
+
+                if (0 == rIdx) {
+                    if (7 == simLoop) {
+                        ckptSize = ukf_checkpoint_size(&ukfIo);
+                        if (0 != ukf_checkpoint_save(&ukfIo, ckpt[mIdx], ckptSize)) {
+                            rejectErr = 1;
+                        }
+                    }
+                    (void)memcpy(&ref[simLoop - 1][0], ukfIo.update.x.val, 4 * sizeof(mtxScalar));
+                    (void)memcpy(&ref[simLoop - 1][4], ukfIo.update.Pxx.val, 16 * sizeof(mtxScalar));
+                } else {
+                    if (0 != memcmp(&ref[simLoop - 1][0], ukfIo.update.x.val, 4 * sizeof(mtxScalar)) ||
+                        0 != memcmp(&ref[simLoop - 1][4], ukfIo.update.Pxx.val, 16 * sizeof(mtxScalar))) {
+                        mismatch = 1;
+                    }
+                    for (xIdx = 0; xIdx < 4; xIdx++) {
+                        absErrAccum += fabs(ukfIo.update.x.val[xIdx] - x_exp[simLoop - 1][xIdx]);
+                    }
+                }
+            }
+
+            if (1 == rIdx) {
+                uint8_t *const pByte = (uint8_t *)ckpt[mIdx] + sizeof(tUkfCkptHeader) + 1;
+
+                //flipped payload bit, truncated memory
+                *pByte ^= 0x10u;
+                if (0 == ukf_restore(&ukfIo, &UkfMatrixCfg, ckpt[mIdx], sizeof(ckpt[mIdx])) ||
+                    0 == ukf_restore(&ukfIo, &UkfMatrixCfg, ckpt[mIdx], ckptSize - 1u)) {
+                    rejectErr = 1;
+                }
+                *pByte ^= 0x10u;
+            }
+        }
+
+        if (!(absErrAccum < 4 * UKF_TEST_EPS) || 0 != mismatch || 0 != rejectErr) {
+            printf("ERROR: Restored filter differs (%s): %.6e, mismatch %u, reject %u\n",
+                   (UKF_MODE_SQRT == filterMode[mIdx]) ? "square-root" : "standard", absErrAccum, (unsigned)mismatch, (unsigned)rejectErr);
+        } else {
+            printf("%u. SUCCESS! %.6e < %.6e (%s, %u bytes)\n", (unsigned)(mIdx + 1), absErrAccum, 4 * UKF_TEST_EPS,
+                   (UKF_MODE_SQRT == filterMode[mIdx]) ? "square-root" : "standard", (unsigned)ckptSize);
+        }
+    }
+
+    //checkpoint of the standard filter does not fit the square-root configuration
+    {
+        tUKF ukfIo;
+
+        printf("Checkpoint of another filter mode\n");
+        if (0 == ukf_restore(&ukfIo, &UkfMatrixCfg, ckpt[0], sizeof(ckpt[0]))) {
+            printf("ERROR: Checkpoint of the standard filter accepted by the square-root configuration\n");
+        } else {
+            printf("1. SUCCESS! rejected\n");
+        }
+    }
+
+    UkfMatrixCfg.filter_mode = UKF_MODE_STANDARD;
+}
+
+/**
+ * @brief Replay of binary logs: two logs on the thread pool must reproduce the matlab reference
+ * in their estimate files, a truncated log must be reported
+ */
+void ukf_test_replay(void) {
+    enum { nJob = 2 };
+    static tUkfReplay replay[nJob];
+    static uint64_t arena[nJob][256];
+    tUkfReplayJob job[nJob];
+    tUkfMatrix ukfMatrix[nJob];
+    tUKF ukfIo[nJob];
+    tUkfPool pool;
+    mtxScalar absErrAccum = 0;
+    uint8_t Result = 0;
+    uint8_t jIdx;
+
+    if (0 != ukf_pool_init(&pool, 2)) {
+        Result = 1;
+    }
+
+    for (jIdx = 0; jIdx < nJob; jIdx++) {
+        tUkfMatrix *const pCfg = &ukfMatrix[jIdx];
+        tUkfLogHeader hdr = {UKF_LOG_MAGIC, UKF_LOG_VERSION, (uint8_t)sizeof(mtxScalar), 0, Ly, 0, 0};
+        uint32_t simLoop;
+
+        if (0 != ukf_mem_layout(pCfg, arena[jIdx], sizeof(arena[jIdx]), Lx, Ly, UKF_MODE_STANDARD, UKF_SIGMA_SYMMETRIC)) {
+            Result = 1;
+        } else {
+            (void)mtx_cpy(&pCfg->Sc_vector, &UkfMatrixCfg.Sc_vector);
+            (void)mtx_cpy(&pCfg->x_system_states_ic, &UkfMatrixCfg.x_system_states_ic);
+            (void)mtx_cpy(&pCfg->Pxx0_init_error_covariance, &UkfMatrixCfg.Pxx0_init_error_covariance);
+            (void)mtx_cpy(&pCfg->Qxx_process_noise_cov, &UkfMatrixCfg.Qxx_process_noise_cov);
+            (void)mtx_cpy(&pCfg->Ryy0_init_out_covariance, &UkfMatrixCfg.Ryy0_init_out_covariance);
+            pCfg->fcnPredictBatch = UkfMatrixCfg.fcnPredictBatch;
+            pCfg->fcnObserveBatch = UkfMatrixCfg.fcnObserveBatch;
+            pCfg->fcnPredictVec = UkfMatrixCfg.fcnPredictVec;
+            pCfg->fcnObserveVec = UkfMatrixCfg.fcnObserveVec;
+            pCfg->dT = UkfMatrixCfg.dT;
+        }
+        if (0 != ukf_init(&ukfIo[jIdx], pCfg)) {
+            Result = 1;
+        }
+
+        job[jIdx].pLog = tmpfile();
+        job[jIdx].pEst = tmpfile();
+        job[jIdx].pUkf = &ukfIo[jIdx];
+        job[jIdx].nFilt = 1;
+        job[jIdx].pReplay = &replay[jIdx];
+        if (NULL == job[jIdx].pLog || NULL == job[jIdx].pEst) {
+            Result = 1;
+        } else {
+            (void)fwrite(&hdr, sizeof(hdr), 1, job[jIdx].pLog);
+            for (simLoop = 1; simLoop < 15; simLoop++) {
+                const tUkfLogRecord rec = {10u * simLoop, 3u};
+                const mtxScalar y[Ly] = {yt[0][simLoop], yt[1][simLoop]};
+
+                (void)fwrite(&rec, sizeof(rec), 1, job[jIdx].pLog);
+                (void)fwrite(y, sizeof(y), 1, job[jIdx].pLog);
+            }
+            if (1 == jIdx) {
+                //second log ends with a truncated record
+                (void)fwrite(&hdr, sizeof(uint32_t), 1, job[jIdx].pLog);
+            }
+            rewind(job[jIdx].pLog);
+        }
+    }
+
+    if (0 == Result) {
+        ukf_replay_jobs(job, nJob, &pool.exec);
+
+        for (jIdx = 0; jIdx < nJob; jIdx++) {
+            tUkfEstHeader est;
+            uint32_t simLoop;
+
+            rewind(job[jIdx].pEst);
+            if (1 != fread(&est, sizeof(est), 1, job[jIdx].pEst) || UKF_EST_MAGIC != est.magic || 1 != est.nFilt || Lx != est.xLen ||
+                14 != job[jIdx].samples || jIdx != job[jIdx].result) {
+                Result = 1;
+            }
+            for (simLoop = 1; simLoop < 15 && 0 == Result; simLoop++) {
+                tUkfLogRecord rec;
+                mtxScalar x[Lx];
+                mtxDim xIdx;
+
+                if (1 != fread(&rec, sizeof(rec), 1, job[jIdx].pEst) || 1 != fread(x, sizeof(x), 1, job[jIdx].pEst) || 10u * simLoop != rec.stamp) {
+                    Result = 1;
+                }
+                for (xIdx = 0; xIdx < Lx; xIdx++) {
+                    absErrAccum += fabs(x[xIdx] - x_exp[simLoop - 1][xIdx]);
+                }
+            }
+        }
+        ukf_pool_destroy(&pool);
+    }
+
+    for (jIdx = 0; jIdx < nJob; jIdx++) {
+        if (NULL != job[jIdx].pLog) {
+            (void)fclose(job[jIdx].pLog);
+        }
+        if (NULL != job[jIdx].pEst) {
+            (void)fclose(job[jIdx].pEst);
+        }
+    }
+
+    printf("\nLog replay, %u logs on the thread pool (accumulated error of all states, truncated log)\n", (unsigned)nJob);
+    if (!(absErrAccum < 2 * 4 * UKF_TEST_EPS) || 0 != Result) {
+        printf("ERROR: Replay failed: %.6e, result %u\n", absErrAccum, (unsigned)Result);
+    } else {
+        printf("1. SUCCESS! %.6e < %.6e\n", absErrAccum, 2 * 4 * UKF_TEST_EPS);
+    }
+}
+
+/**
+ * @brief RTS smoother on the reference sequence: captured cross-covariance of the unscented
+ * prediction must equal P*F' of the linear example model, fixed-lag and fixed-interval
+ * results must agree (also with a wrapped ring), smoothing must not increase the variance
+ * and both filter modes must give the same smoothed trajectory
+ */
+void ukf_test_smooth(void) {
+    enum { nStep = 14, nLag = 4, nWrap = 4 };
+    static const mtxScalar Fxx[4][4] = {
+        {1, 0, MTX_C(0.1), 0},
+        {0, 1, 0, MTX_C(0.1)},
+        {0, 0, 1, 0},
+        {0, 0, 0, 1},
+    };
+    static const uint8_t filterMode[2] = {UKF_MODE_STANDARD, UKF_MODE_SQRT};
+    static uint64_t memFull[1024];
+    static uint64_t memWrap[512];
+    static mtxScalar xs[2][nStep][Lx];
+    mtxScalar errCross = 0;
+    mtxScalar errLag = 0;
+    mtxScalar errMode = 0;
+    uint8_t varGrowth = 0;
+    uint8_t Result = 0;
+    uint8_t mIdx;
+
+    for (mIdx = 0; mIdx < 2; mIdx++) {
+        tUkfSmooth smooth, wrap;
+        tUKF ukfIo;
+        mtxScalar xLag[2][Lx], PLag[Lx * Lx];
+        mtxScalar trFilt[nStep];
+        tMatrix xm = {Lx, 1, &xLag[0][0]};
+        tMatrix xw = {Lx, 1, &xLag[1][0]};
+        tMatrix Pm = {Lx, Lx, &PLag[0]};
+        uint32_t simLoop;
+        uint16_t eIdx;
+        mtxDim row, col, k;
+
+        UkfMatrixCfg.filter_mode = filterMode[mIdx];
+        if (0 != ukf_init(&ukfIo, &UkfMatrixCfg) ||
+            0 != ukf_smooth_init(&smooth, memFull, sizeof(memFull), Lx, ukfIo.par.sLen, nStep) ||
+            0 != ukf_smooth_init(&wrap, memWrap, sizeof(memWrap), Lx, ukfIo.par.sLen, nWrap)) {
+            Result = 1;
+        }
+
+        ukf_smooth_attach(&smooth, &ukfIo);
+        for (simLoop = 1; simLoop <= nStep && 0 == Result; simLoop++) {
+            ukfIo.input.y.val[0] = yt[0][simLoop];
+            ukfIo.input.y.val[1] = yt[1][simLoop];
+            ukf_step(&ukfIo);
+        }
+
+        //second pass of the same sequence ends in the same state and records into the short ring
+        if (0 != ukf_init(&ukfIo, &UkfMatrixCfg)) {
+            Result = 1;
+        }
+        ukf_smooth_attach(&wrap, &ukfIo);
+        for (simLoop = 1; simLoop <= nStep && 0 == Result; simLoop++) {
+            ukfIo.input.y.val[0] = yt[0][simLoop];
+            ukfIo.input.y.val[1] = yt[1][simLoop];
+            ukf_step(&ukfIo);
+        }
+
+        if (0 != Result || nStep != smooth.count || nWrap != wrap.count ||
+            0 != ukf_smooth_lag(&smooth, &ukfIo, nLag, &xm, &Pm) || 0 != ukf_smooth_lag(&wrap, &ukfIo, nLag, &xw, NULL) ||
+            0 == ukf_smooth_lag(&wrap, &ukfIo, nWrap + 1, &xw, NULL)) {
+            Result = 1;
+        } else {
+            for (eIdx = 0; eIdx < nStep; eIdx++) {
+                mtxScalar const *const pP = &smooth.pP[Lx * Lx * eIdx];
+                mtxScalar const *const pC = &smooth.pC[Lx * Lx * eIdx];
+
+                //C(k) = P(k|k)*F' for the linear prediction of the example
+                for (row = 0; row < Lx; row++) {
+                    for (col = 0; col < Lx; col++) {
+                        mtxScalar sum = 0;
+
+                        for (k = 0; k < Lx; k++) {
+                            sum += pP[Lx * row + k] * Fxx[col][k];
+                        }
+                        errCross += fabs(pC[Lx * row + col] - sum);
+                    }
+                }
+                trFilt[eIdx] = pP[0] + pP[5] + pP[10] + pP[15];
+            }
+
+            if (0 != ukf_smooth_interval(&smooth, &ukfIo)) {
+                Result = 1;
+            }
+
+            for (eIdx = 0; eIdx < nStep && 0 == Result; eIdx++) {
+                mtxScalar PIdx[Lx * Lx];
+                tMatrix xe = {Lx, 1, &xs[mIdx][eIdx][0]};
+                tMatrix Pe = {Lx, Lx, &PIdx[0]};
+
+                (void)ukf_smooth_get(&smooth, eIdx, &xe, &Pe);
+                if (PIdx[0] + PIdx[5] + PIdx[10] + PIdx[15] > trFilt[eIdx] * MTX_C(1.000001)) {
+                    varGrowth = 1;
+                }
+                for (k = 0; k < Lx && nStep - nLag == eIdx; k++) {
+                    //fixed-lag estimate of the final step is x(N-lag|N)
+                    errLag += fabs(xs[mIdx][eIdx][k] - xLag[0][k]) + fabs(xLag[1][k] - xLag[0][k]);
+                }
+            }
+        }
+    }
+
+    for (mIdx = 0; mIdx < nStep; mIdx++) {
+        mtxDim xIdx;
+
+        for (xIdx = 0; xIdx < Lx; xIdx++) {
+            errMode += fabs(xs[1][mIdx][xIdx] - xs[0][mIdx][xIdx]);
+        }
+    }
+    UkfMatrixCfg.filter_mode = UKF_MODE_STANDARD;
+
+    printf("\nRTS smoother (cross-covariance vs P*F', fixed-lag vs fixed-interval, square-root vs standard)\n");
+    if (0 != Result || 0 != varGrowth || !(errCross < UKF_TEST_EPS) || !(errLag < UKF_TEST_EPS) || !(errMode < UKF_TEST_EPS)) {
+        printf("ERROR: Smoother failed: %.6e, %.6e, %.6e, result %u, variance %u\n", errCross, errLag, errMode, (unsigned)Result,
+               (unsigned)varGrowth);
+    } else {
+        printf("1. SUCCESS! %.6e, %.6e, %.6e < %.6e\n", errCross, errLag, errMode, UKF_TEST_EPS);
+    }
+}
+
+/**
+ * @brief Constant position model x = [px vx py vy], velocity is not kept
+ */
+static void ukf_test_imm_fx(tMatrix *pu_p, tMatrix *pX_p, tMatrix *pX_m, mtxDim sigmaIdx, mtxDim sigmaCnt, mtxScalar dT) {
+    mtxDim col;
+
+    (void)pu_p;
+    (void)pX_p;
+    (void)dT;
+    for (col = sigmaIdx; col < sigmaIdx + sigmaCnt; col++) {
+        UKF_SIGMA_AT(pX_m, 1, col) = 0;
+        UKF_SIGMA_AT(pX_m, 3, col) = 0;
+    }
+}
+
+/**
+ * @brief Bank of two constant velocity models (low and high process noise) and a
+ * constant position model
+ */
+static uint8_t ukf_test_imm_bank(tUkfImm *pImm, tUKF *pModel, uint64_t (*pArena)[512], uint64_t *pMem, uint32_t memSize,
+                                 uint8_t filterMode, uint8_t updateMode, mtxScalar const *pTrans) {
+    static const mtxScalar qDiag[3] = {MTX_C(1e-4), MTX_C(1e-1), MTX_C(1e-4)};
+    uint8_t Result = 0;
+    uint8_t j;
+    mtxDim k;
+
+    for (j = 0; j < 3; j++) {
+        tUkfMatrix cfg;
+
+        if (0 != ukf_mem_layout(&cfg, pArena[j], sizeof(pArena[j]), Lx, Ly, filterMode, UKF_SIGMA_SYMMETRIC)) {
+            Result = 1;
+        } else {
+            for (k = 0; k < Lx; k++) {
+                cfg.Qxx_process_noise_cov.val[Lx * k + k] = qDiag[j];
+            }
+            for (k = 0; k < Ly; k++) {
+                cfg.Ryy0_init_out_covariance.val[Ly * k + k] = MTX_C(0.01);
+            }
+            cfg.fcnPredictBatch = (2 == j) ? &ukf_test_imm_fx : &ukf_test_linear_fx;
+            cfg.fcnObserveBatch = &ukf_test_linear_hy;
+            cfg.dT = MTX_C(0.1);
+            cfg.update_mode = updateMode;
+            if (0 != ukf_init(&pModel[j], &cfg)) {
+                Result = 1;
+            }
+        }
+    }
+
+    if (0 == Result && 0 != ukf_imm_init(pImm, pMem, memSize, pModel, 3, pTrans, NULL)) {
+        Result = 1;
+    }
+
+    return Result;
+}
+
+/**
+ * @brief IMM bank on a target moving with constant velocity: work shared between models
+ * with coincident mixing must not change the result, the constant position model must
+ * lose, sequential, batch and square-root update must agree on the mode probabilities and
+ * a bank of one model must reproduce ukf_step()
+ */
+void ukf_test_imm(void) {
+    enum { nModel = 3, nStep = 40 };
+    static const mtxScalar transUni[nModel * nModel] = {
+        MTX_C(1.0) / 3, MTX_C(1.0) / 3, MTX_C(1.0) / 3,
+        MTX_C(1.0) / 3, MTX_C(1.0) / 3, MTX_C(1.0) / 3,
+        MTX_C(1.0) / 3, MTX_C(1.0) / 3, MTX_C(1.0) / 3,
+    };
+    static const mtxScalar transDiag[nModel * nModel] = {
+        MTX_C(0.9), MTX_C(0.05), MTX_C(0.05),
+        MTX_C(0.05), MTX_C(0.9), MTX_C(0.05),
+        MTX_C(0.05), MTX_C(0.05), MTX_C(0.9),
+    };
+    static const uint8_t filterMode[3] = {UKF_MODE_STANDARD, UKF_MODE_STANDARD, UKF_MODE_SQRT};
+    static const uint8_t updateMode[3] = {UKF_UPDATE_AUTO, UKF_UPDATE_BATCH, UKF_UPDATE_AUTO};
+    static uint64_t arena[3][nModel][512];
+    static uint64_t bankMem[3][256];
+    static mtxScalar xRef[15][Lx];
+    mtxScalar muEnd[3][nModel];
+    mtxScalar errTrack = 0;
+    mtxScalar errMode = 0;
+    mtxScalar errSingle = 0;
+    uint32_t shareCnt = 0;
+    uint8_t shareMiss = 0;
+    uint8_t Result = 0;
+    uint8_t vIdx, bIdx, j;
+    uint32_t simLoop;
+
+    for (vIdx = 0; vIdx < 3; vIdx++) {
+        tUkfImm imm[3];
+        tUKF model[3][nModel];
+        const uint8_t chol = (UKF_MODE_STANDARD == filterMode[vIdx]) ? UKF_SHARE_CHOL : 0;
+
+        //uniform transitions: all mixing weights coincide, bank 1 evaluates every model on its own
+        for (bIdx = 0; bIdx < 3; bIdx++) {
+            if (0 != ukf_test_imm_bank(&imm[bIdx], model[bIdx], arena[bIdx], bankMem[bIdx], sizeof(bankMem[bIdx]), filterMode[vIdx],
+                                       updateMode[vIdx], (2 == bIdx) ? transDiag : transUni)) {
+                Result = 1;
+            }
+        }
+        imm[1].share = 0;
+
+        for (simLoop = 1; simLoop <= nStep && 0 == Result; simLoop++) {
+            const mtxScalar t = MTX_C(0.1) * simLoop;
+            mtxScalar y[Ly];
+
+            y[0] = MTX_C(2.0) * t + MTX_C(0.02) * MTX_SIN(MTX_C(1.7) * simLoop);
+            y[1] = MTX_C(-1.5) * t + MTX_C(0.02) * MTX_SIN(MTX_C(2.3) * simLoop + 1);
+            for (bIdx = 0; bIdx < 3; bIdx++) {
+                ukf_imm_step(&imm[bIdx], y, NULL);
+            }
+
+            if (0 != memcmp(imm[0].mu, imm[1].mu, sizeof(imm[0].mu[0]) * nModel) || 0 != memcmp(imm[0].px, imm[1].px, sizeof(mtxScalar) * Lx) ||
+                0 != memcmp(imm[0].pP, imm[1].pP, sizeof(mtxScalar) * Lx * Lx) || imm[0].used[0] != chol ||
+                imm[0].used[1] != (chol | UKF_SHARE_PROP | UKF_SHARE_OBS) || imm[0].used[2] != chol || imm[1].used[1] != chol) {
+                shareMiss = 1;
+            }
+            shareCnt += (0 != (imm[0].used[1] & UKF_SHARE_PROP)) ? 1u : 0u;
+        }
+
+        for (j = 0; j < nModel; j++) {
+            muEnd[vIdx][j] = imm[2].mu[j];
+        }
+        errTrack += fabs(imm[2].px[0] - MTX_C(2.0) * nStep * MTX_C(0.1)) + fabs(imm[2].px[2] + MTX_C(1.5) * nStep * MTX_C(0.1)) +
+                    fabs(imm[2].mu[0] + imm[2].mu[1] + imm[2].mu[2] - 1);
+        if (!(muEnd[vIdx][2] < MTX_C(0.05))) {
+            Result = 1;
+        }
+    }
+
+    for (j = 0; j < nModel; j++) {
+        errMode += fabs(muEnd[1][j] - muEnd[0][j]) + fabs(muEnd[2][j] - muEnd[0][j]);
+    }
+
+    //one model: c = mu = 1, the mixing returns the estimate unchanged
+    {
+        static const mtxScalar trans1 = 1;
+        tUkfImm single;
+        tUKF ukfIo;
+        mtxDim xIdx;
+
+        if (0 != ukf_init(&ukfIo, &UkfMatrixCfg)) {
+            Result = 1;
+        }
+        for (simLoop = 1; simLoop < 15 && 0 == Result; simLoop++) {
+            ukfIo.input.y.val[0] = yt[0][simLoop];
+            ukfIo.input.y.val[1] = yt[1][simLoop];
+            ukf_step(&ukfIo);
+            (void)memcpy(xRef[simLoop], ukfIo.update.x.val, sizeof(xRef[simLoop]));
+        }
+
+        if (0 != ukf_init(&ukfIo, &UkfMatrixCfg) || 0 != ukf_imm_init(&single, bankMem[0], sizeof(bankMem[0]), &ukfIo, 1, &trans1, NULL)) {
+            Result = 1;
+        }
+        for (simLoop = 1; simLoop < 15 && 0 == Result; simLoop++) {
+            const mtxScalar y[Ly] = {yt[0][simLoop], yt[1][simLoop]};
+
+            ukf_imm_step(&single, y, NULL);
+            if (0 != memcmp(xRef[simLoop], single.px, sizeof(xRef[simLoop])) || 0 != memcmp(xRef[simLoop], ukfIo.update.x.val, sizeof(xRef[simLoop]))) {
+                shareMiss = 1;
+            }
+            for (xIdx = 0; xIdx < Lx; xIdx++) {
+                errSingle += fabs(single.px[xIdx] - x_exp[simLoop - 1][xIdx]);
+            }
+        }
+    }
+
+    printf("\nIMM bank (shared vs separate model work, tracking and mode probability, update formulations, single model)\n");
+    if (0 != Result || 0 != shareMiss || nStep * 3 != shareCnt || !(errTrack < 0.1) || !(errMode < UKF_TEST_EPS) ||
+        !(errSingle < 4 * UKF_TEST_EPS)) {
+        printf("ERROR: IMM bank failed: %.6e, %.6e, %.6e, result %u, share %u/%u\n", errTrack, errMode, errSingle, (unsigned)Result,
+               (unsigned)shareMiss, (unsigned)shareCnt);
+    } else {
+        printf("1. SUCCESS! %.6e, %.6e, %.6e, mu(CP) %.3e\n", errTrack, errMode, errSingle, muEnd[0][2]);
+    }
+
+    //model 1 without likelihood (Pyy not positive definite) must lose its mode probability in both
+    //update formulations, zero mixed covariances must be reported by the mixing or repaired
+    Result = 0;
+    shareMiss = 0;
+    for (vIdx = 0; vIdx < 4; vIdx++) {
+        const uint8_t sqrt = (vIdx >= 2) ? 1u : 0u;
+        tUkfImm bank;
+        tUKF model[nModel];
+        uint8_t status = 0;
+        mtxDim k;
+
+        if (0 != ukf_test_imm_bank(&bank, model, arena[0], bankMem[0], sizeof(bankMem[0]), (0 != sqrt) ? UKF_MODE_SQRT : UKF_MODE_STANDARD,
+                                   (1 == vIdx) ? UKF_UPDATE_BATCH : UKF_UPDATE_AUTO, transUni)) {
+            Result = 1;
+        }
+        for (j = 0; j < nModel && 0 != sqrt; j++) {
+            (void)memset(model[j].update.Pxx.val, 0, sizeof(mtxScalar) * Lx * Lx);
+        }
+        for (k = 0; k < Ly && 0 == sqrt; k++) {
+            model[1].par.Ryy0.val[Ly * k + k] = MTX_C(-10.0);
+        }
+        model[0].health.recover = (3 == vIdx) ? 1u : 0u;
+
+        for (simLoop = 1; simLoop <= 5 && 0 == Result; simLoop++) {
+            const mtxScalar y[Ly] = {MTX_C(0.2) * simLoop, MTX_C(-0.15) * simLoop};
+
+            status |= ukf_imm_step(&bank, y, NULL);
+        }
+
+        if (0 == sqrt && (UKF_FAULT_GAIN != status || 0 != bank.port[1].share.lik || UKF_FAULT_GAIN != bank.port[1].status ||
+                          MTX_C(0.0) != bank.mu[1] || !(fabs(bank.mu[0] + bank.mu[2] - 1) < UKF_TEST_EPS))) {
+            shareMiss = 1;
+        }
+        if (2 == vIdx && (0 == (bank.port[1].status & UKF_FAULT_SIGMAPOINT) && 0 == (status & UKF_FAULT_SIGMAPOINT))) {
+            shareMiss = 1;
+        }
+        if (2 == vIdx && (1u != model[0].health.fault[0] || 0 != model[0].health.repair[0])) {
+            shareMiss = 1;
+        }
+        if (3 == vIdx && (0 != (status & UKF_FAULT_SIGMAPOINT) || 1u != model[0].health.repair[0])) {
+            shareMiss = 1;
+        }
+        for (k = 0; k < Lx; k++) {
+            if (!(fabs(bank.px[k]) < MTX_C(10.0))) {
+                shareMiss = 1;
+            }
+        }
+    }
+
+    if (0 != Result || 0 != shareMiss) {
+        printf("ERROR: IMM faults not handled, result %u, check %u\n", (unsigned)Result, (unsigned)shareMiss);
+    } else {
+        printf("2. SUCCESS! model without likelihood gets no mode probability, mixing faults reported and repaired\n");
+    }
+}
+
+/**
+ * @brief Partial measurements: batch, sequential and square-root update must agree when
+ * measurement channels are missing (masked) and on predict only ticks
+ */
+void ukf_test_partial(void) {
+    static const uint8_t filterMode[3] = {UKF_MODE_STANDARD, UKF_MODE_STANDARD, UKF_MODE_SQRT};
+    static const uint8_t updateMode[3] = {UKF_UPDATE_BATCH, UKF_UPDATE_SEQUENTIAL, UKF_UPDATE_BATCH};
+    static const char *const pName[3] = {"batch", "sequential", "square-root"};
+    mtxScalar xEnd[3][4];
+    uint8_t vIdx, xIdx;
+    uint32_t simLoop;
+
+    for (vIdx = 0; vIdx < 3; vIdx++) {
+        tUKF ukfIo;
+
+        UkfMatrixCfg.filter_mode = filterMode[vIdx];
+        UkfMatrixCfg.update_mode = updateMode[vIdx];
+
+        if (0 != ukf_init(&ukfIo, &UkfMatrixCfg)) {
+            printf("\npartial measurement initialization fail (%s)\n", pName[vIdx]);
+        }
+
+        for (simLoop = 1; simLoop < 15; simLoop++) {
+            if (0 == simLoop % 5) {
+                ukf_predict(&ukfIo, UkfMatrixCfg.dT);
+            } else {
+                ukfIo.input.y.val[0] = yt[0][simLoop];
+                ukfIo.input.y.val[1] = (0 == simLoop % 3) ? NAN : yt[1][simLoop];
+                ukfIo.input.yValid.val[0] = 1;
+                ukfIo.input.yValid.val[1] = (0 == simLoop % 3) ? 0 : 1;
+                ukf_step(&ukfIo);
+            }
+        }
+
+        for (xIdx = 0; xIdx < 4; xIdx++) {
+            xEnd[vIdx][xIdx] = ukfIo.update.x.val[xIdx];
+        }
+        ukfIo.input.yValid.val[1] = 1;
+    }
+
+    UkfMatrixCfg.filter_mode = UKF_MODE_STANDARD;
+    UkfMatrixCfg.update_mode = UKF_UPDATE_AUTO;
+
+    for (vIdx = 1; vIdx < 3; vIdx++) {
+        mtxScalar errAccum = 0;
+
+        for (xIdx = 0; xIdx < 4; xIdx++) {
+            errAccum += fabs(xEnd[vIdx][xIdx] - xEnd[0][xIdx]);
+        }
+
+        printf("\nPartial measurements, %s vs batch update\n", pName[vIdx]);
+        if (!(errAccum < UKF_TEST_EPS)) {
+            printf("ERROR: Accumulated error is too big: %.6e > %.6e\n", errAccum, UKF_TEST_EPS);
+        } else {
+            printf("1. SUCCESS! %.6e < %.6e\n", errAccum, UKF_TEST_EPS);
+        }
+    }
+}
+
+//! Center weight forced in one step of ukf_test_health(), makes the output covariance indefinite
+#define UKF_TEST_HEALTH_WC (-1e6)
+//! Factor of S(k|k-1) in one step of ukf_test_health(), makes the downdate of the update fail
+#define UKF_TEST_HEALTH_SCALE (0.6)
+//! First jitter of the repair of the scaled S(k|k-1)
+#define UKF_TEST_HEALTH_JITTER (1.0)
+//! Deviation from the reference allowed after a repaired step, the repair changes the covariance
+#define UKF_TEST_HEALTH_EPS (1e-1)
+
+//! Fault injected by ukf_test_health_run()
+#define UKF_TEST_INJECT_PXX     (0u)  //collapsed Pxx
+#define UKF_TEST_INJECT_WC      (1u)  //negative center weight (indefinite Pyy or Sy downdate)
+#define UKF_TEST_INJECT_PRED    (2u)  //shifted center point with negative weight in the prediction only (S(k|k-1) downdate)
+#define UKF_TEST_INJECT_UPDATE  (3u)  //scaled S(k|k-1) (S(k|k) downdate)
+#define UKF_TEST_INJECT_UPD_REF (4u)  //scaled S(k|k-1) repaired by the hook like by the filter, no fault
+
+//! Prediction hooks of ukf_test_health_run(), modify the filter inside of the faulty step
+typedef struct {
+    tUKF *pUkf;         //filter to modify
+    uint8_t inject;     //UKF_TEST_INJECT_PRED, UKF_TEST_INJECT_UPDATE or UKF_TEST_INJECT_UPD_REF
+    uint8_t active;     //1 := faulty step
+    mtxScalar wc0;      //center weight of the regular steps
+    mtxScalar x0[4];    //center sigma point of the regular steps
+} tUkfTestHealthHook;
+
+static void ukf_test_health_cross(void *pCtx, const tUKF *pUkf) {
+    tUkfTestHealthHook *const pHook = (tUkfTestHealthHook *)pCtx;
+    mtxScalar *const pX = pHook->pUkf->predict.X_m.val;
+    const mtxDim sLen = pUkf->par.sLen;
+    uint8_t xIdx;
+
+    //sLen is not used by the sigma point major layout
+    (void)sLen;
+    if (0 != pHook->active && UKF_TEST_INJECT_PRED == pHook->inject) {
+        //center point half way to sigma point 1 with negative weight: its downdate fails
+        for (xIdx = 0; xIdx < 4; xIdx++) {
+            const mtxScalar xm = pUkf->predict.x_m.val[xIdx];
+
+            pHook->x0[xIdx] = pX[UKF_SIGMA_IDX(4, sLen, xIdx, 0)];
+            pX[UKF_SIGMA_IDX(4, sLen, xIdx, 0)] = xm + MTX_C(0.5) * (pX[UKF_SIGMA_IDX(4, sLen, xIdx, 1)] - xm);
+        }
+        pHook->wc0 = pUkf->par.Wc.val[0];
+        pHook->pUkf->par.Wc.val[0] = -pHook->wc0;
+    }
+}
+
+static void ukf_test_health_pred(void *pCtx, const tUKF *pUkf) {
+    tUkfTestHealthHook *const pHook = (tUkfTestHealthHook *)pCtx;
+    mtxScalar *const pX = pHook->pUkf->predict.X_m.val;
+    const mtxDim sLen = pUkf->par.sLen;
+    uint8_t xIdx;
+
+    //sLen is not used by the sigma point major layout
+    (void)sLen;
+    if (0 != pHook->active && UKF_TEST_INJECT_PRED == pHook->inject) {
+        for (xIdx = 0; xIdx < 4; xIdx++) {
+            pX[UKF_SIGMA_IDX(4, sLen, xIdx, 0)] = pHook->x0[xIdx];
+        }
+        pHook->pUkf->par.Wc.val[0] = pHook->wc0;
+    } else if (0 != pHook->active && (UKF_TEST_INJECT_UPDATE == pHook->inject || UKF_TEST_INJECT_UPD_REF == pHook->inject)) {
+        mtxScalar *const pS = pHook->pUkf->predict.P_m.val;
+
+        for (xIdx = 0; xIdx < 4u * 4u; xIdx++) {
+            pS[xIdx] *= (mtxScalar)UKF_TEST_HEALTH_SCALE;
+        }
+        if (UKF_TEST_INJECT_UPD_REF == pHook->inject) {
+            //first try of the repair with UKF_TEST_HEALTH_JITTER: diagonal of S*S' doubled
+            mtx_kernel_chol_product(pS, 4);
+            for (xIdx = 0; xIdx < 4; xIdx++) {
+                pS[4 * xIdx + xIdx] += pS[4 * xIdx + xIdx];
+            }
+            (void)mtx_kernel_chol_lower(pS, 4);
+        }
+    }
+}
+
+/**
+ * @brief Run the example model with one faulty step (fault at simLoop == 4) against the reference
+ * 
+ * @param pUkfMatrix UKF configuration
+ * @param recover tUKF.health.recover
+ * @param pHealth Health of the filter after the last step
+ * @param pErr Accumulated error of the last step
+ * @param pX State of the last step (4)
+ * @param inject UKF_TEST_INJECT_*
+ * @return uint8_t Accumulated step results
+ */
+static uint8_t ukf_test_health_run(tUkfMatrix *pUkfMatrix, uint8_t recover, tUkfHealth *pHealth, mtxScalar *pErr, mtxScalar *pX,
+                                   uint8_t inject) {
+    tUkfTestHealthHook hookCtx;
+    tUkfPredHook hook;
+    uint8_t status = 0;
+    tUKF ukfIo;
+    uint32_t simLoop;
+    uint8_t xIdx;
+
+    if (0 != ukf_init(&ukfIo, pUkfMatrix)) {
+        printf("\nhealth initialization fail\n");
+    }
+    ukfIo.health.recover = recover;
+    if (UKF_TEST_INJECT_UPDATE == inject) {
+        //the scaled factor is far from the downdate, the repair must restore the scale
+        ukfIo.health.jitter = (mtxScalar)UKF_TEST_HEALTH_JITTER;
+    }
+    hookCtx = (tUkfTestHealthHook){&ukfIo, inject, 0, 0, {0, 0, 0, 0}};
+    hook = (tUkfPredHook){NULL, &ukf_test_health_cross, &ukf_test_health_pred, &hookCtx};
+    ukfIo.pHook = &hook;
+
+    for (simLoop = 1; simLoop < 15; simLoop++) {
+        const mtxScalar wc0 = ukfIo.par.Wc.val[0];
+
+        ukfIo.input.y.val[0] = yt[0][simLoop];
+        ukfIo.input.y.val[1] = yt[1][simLoop];
+        hookCtx.active = (4 == simLoop);
+
+        if (4 == simLoop && UKF_TEST_INJECT_WC == inject) {
+            ukfIo.par.Wc.val[0] = UKF_TEST_HEALTH_WC;
+        } else if (4 == simLoop && UKF_TEST_INJECT_PXX == inject) {
+            //state 1 collapses on state 0, cancellation leaves a slightly negative determinant
+            mtxScalar *const pP = ukfIo.update.Pxx.val;
+
+            for (xIdx = 0; xIdx < 4; xIdx++) {
+                pP[4 * 1 + xIdx] = pP[4 * 0 + xIdx];
+                pP[4 * xIdx + 1] = pP[4 * xIdx + 0];
+            }
+            pP[4 * 1 + 1] = pP[0] * MTX_C(0.9999);
+        }
+        status |= ukf_step(&ukfIo);
+        ukfIo.par.Wc.val[0] = wc0;
+    }
+
+    *pErr = 0;
+    for (xIdx = 0; xIdx < 4; xIdx++) {
+        *pErr += fabs(ukfIo.update.x.val[xIdx] - x_exp[13][xIdx]);
+        pX[xIdx] = ukfIo.update.x.val[xIdx];
+    }
+    *pHealth = ukfIo.health;
+
+    return status;
+}
+
+/**
+ * @brief Numerical health: a step with an indefinite covariance must be reported without
+ * recovery and be repaired in the same step with it, so the filter follows the reference
+ * again. The sequential update skips a measurement without positive variance instead, an
+ * unrepaired Pxx skips the whole step. The scaled S(k|k-1) moves the filter away from the reference by itself, the repaired
+ * S(k|k) downdate must equal the one of a filter repaired before the update (every column
+ * downdated). The standard filter laid out by ukf_mem_layout() must repair the gain as well.
+ */
+void ukf_test_health(void) {
+#define UKF_TEST_HEALTH_N (7u)
+    static const uint8_t filterMode[UKF_TEST_HEALTH_N] = {UKF_MODE_STANDARD, UKF_MODE_STANDARD, UKF_MODE_STANDARD, UKF_MODE_SQRT,
+                                                          UKF_MODE_SQRT, UKF_MODE_SQRT, UKF_MODE_STANDARD};
+    static const uint8_t updateMode[UKF_TEST_HEALTH_N] = {UKF_UPDATE_AUTO, UKF_UPDATE_BATCH, UKF_UPDATE_SEQUENTIAL, UKF_UPDATE_AUTO,
+                                                          UKF_UPDATE_AUTO, UKF_UPDATE_AUTO, UKF_UPDATE_BATCH};
+    static const uint8_t inject[UKF_TEST_HEALTH_N] = {UKF_TEST_INJECT_PXX, UKF_TEST_INJECT_WC, UKF_TEST_INJECT_WC, UKF_TEST_INJECT_WC,
+                                                      UKF_TEST_INJECT_PRED, UKF_TEST_INJECT_UPDATE, UKF_TEST_INJECT_WC};
+    static const uint8_t fault[UKF_TEST_HEALTH_N] = {UKF_FAULT_SIGMAPOINT, UKF_FAULT_GAIN, UKF_FAULT_GAIN, UKF_FAULT_OUTPUT_COV,
+                                                     UKF_FAULT_PRED_COV, UKF_FAULT_COV_UPDATE, UKF_FAULT_GAIN};
+    //counter index of the fault: bit position
+    static const uint8_t faultIdx[UKF_TEST_HEALTH_N] = {0, 3, 3, 2, 1, 4, 3};
+    static const uint8_t repairable[UKF_TEST_HEALTH_N] = {1, 1, 0, 1, 1, 1, 1};
+    //a skipped step keeps the faulty Pxx, it fails again in every following step (3 steps before the fault)
+    static const uint8_t persistent[UKF_TEST_HEALTH_N] = {1, 0, 0, 0, 0, 0, 0};
+    static const uint8_t arena[UKF_TEST_HEALTH_N] = {0, 0, 0, 0, 0, 0, 1};
+    //injection of the run the repaired one is compared to, UKF_TEST_INJECT_PXX := matlab reference
+    static const uint8_t refInject[UKF_TEST_HEALTH_N] = {UKF_TEST_INJECT_PXX, UKF_TEST_INJECT_PXX, UKF_TEST_INJECT_PXX, UKF_TEST_INJECT_PXX,
+                                                         UKF_TEST_INJECT_PXX, UKF_TEST_INJECT_UPD_REF, UKF_TEST_INJECT_PXX};
+    static const char *const pName[UKF_TEST_HEALTH_N] = {"standard, Pxx", "batch update, Pyy", "sequential update, Pyy", "square-root, Sy",
+                                                         "square-root, S(k|k-1)", "square-root, S(k|k)", "arena, batch update, Pyy"};
+    static uint64_t arenaMem[512];
+    uint8_t vIdx;
+
+    for (vIdx = 0; vIdx < UKF_TEST_HEALTH_N; vIdx++) {
+        tUkfMatrix arenaCfg;
+        tUkfMatrix *pCfg = &UkfMatrixCfg;
+        tUkfHealth health[3];
+        mtxScalar err[3];
+        mtxScalar x[3][4];
+        mtxScalar eps = UKF_TEST_HEALTH_EPS;
+        uint32_t faultSteps;
+        uint8_t status[3];
+        uint8_t recover;
+        uint8_t xIdx;
+
+        if (0 != arena[vIdx]) {
+            pCfg = &arenaCfg;
+            if (0 != ukf_test_arena_cfg(pCfg, arenaMem, sizeof(arenaMem), filterMode[vIdx])) {
+                printf("\nhealth arena layout fail\n");
+                continue;
+            }
+        }
+        pCfg->filter_mode = filterMode[vIdx];
+        pCfg->update_mode = updateMode[vIdx];
+        for (recover = 0; recover < 2; recover++) {
+            status[recover] = ukf_test_health_run(pCfg, recover, &health[recover], &err[recover], x[recover], inject[vIdx]);
+        }
+        if (UKF_TEST_INJECT_PXX != refInject[vIdx]) {
+            status[2] = ukf_test_health_run(pCfg, 0, &health[2], &err[2], x[2], refInject[vIdx]);
+            err[1] = (0 == status[2]) ? 0 : MTX_C(1.0);
+            for (xIdx = 0; xIdx < 4; xIdx++) {
+                err[1] += fabs(x[1][xIdx] - x[2][xIdx]);
+            }
+            eps = UKF_TEST_EPS;
+        }
+
+        faultSteps = (0 != persistent[vIdx]) ? (health[0].steps - 3u) : 1u;
+        printf("\nNumerical health, %s\n", pName[vIdx]);
+        if (fault[vIdx] != status[0] || faultSteps != health[0].faultSteps || 0 == health[0].fault[faultIdx[vIdx]] ||
+            0 != health[0].repair[faultIdx[vIdx]]) {
+            printf("ERROR: fault 0x%02x not reported without recovery, status 0x%02x\n", fault[vIdx], status[0]);
+        } else {
+            printf("1. SUCCESS! fault 0x%02x reported in %u of %u steps\n", status[0], (unsigned)health[0].faultSteps,
+                   (unsigned)health[0].steps);
+        }
+
+        if (0 == repairable[vIdx]) {
+            if (fault[vIdx] != status[1] || 0 != health[1].repair[faultIdx[vIdx]]) {
+                printf("ERROR: skipped measurement not reported with recovery, status 0x%02x\n", status[1]);
+            } else {
+                printf("2. SUCCESS! skipped measurement reported with recovery, status 0x%02x\n", status[1]);
+            }
+        } else if (0 != status[1] || 0 == health[1].repair[faultIdx[vIdx]] || !(err[1] < eps)) {
+            printf("ERROR: fault not repaired, status 0x%02x, error %.6e\n", status[1], err[1]);
+        } else {
+            printf("2. SUCCESS! repaired in the same step (jitter %.1e), error %.6e < %.6e\n", health[1].jitterMax, err[1], eps);
+        }
+    }
+    UkfMatrixCfg.filter_mode = UKF_MODE_STANDARD;
+    UkfMatrixCfg.update_mode = UKF_UPDATE_AUTO;
+#undef UKF_TEST_HEALTH_N
+}
+
+/**
+ * @brief Numerical health: a Pxx that is not repaired draws no sigma points, the step and the
+ * update without prediction must be skipped with x and Pxx unchanged, with and without recovery
+ */
+void ukf_test_health_skip(void) {
+    static const char *const pName[2] = {"step", "update without prediction"};
+    uint8_t vIdx, recover;
+
+    for (vIdx = 0; vIdx < 2; vIdx++) {
+        printf("\nNumerical health, Pxx not repairable, %s\n", pName[vIdx]);
+
+        for (recover = 0; recover < 2; recover++) {
+            mtxScalar x[4];
+            mtxScalar P[16];
+            uint8_t status;
+            tUKF ukfIo;
+
+            if (0 != ukf_init(&ukfIo, &UkfMatrixCfg)) {
+                printf("\nhealth initialization fail\n");
+            }
+            ukfIo.health.recover = recover;
+            ukfIo.input.y.val[0] = yt[0][1];
+            ukfIo.input.y.val[1] = yt[1][1];
+            //correlation far beyond 1, the largest jitter of a repair does not cover it
+            ukfIo.update.Pxx.val[4 * 0 + 1] = ukfIo.update.Pxx.val[4 * 0 + 0] * MTX_C(1e3);
+            ukfIo.update.Pxx.val[4 * 1 + 0] = ukfIo.update.Pxx.val[4 * 0 + 1];
+            memcpy(x, ukfIo.update.x.val, sizeof(x));
+            memcpy(P, ukfIo.update.Pxx.val, sizeof(P));
+
+            status = (0 == vIdx) ? ukf_step(&ukfIo) : ukf_update(&ukfIo);
+
+            if (UKF_FAULT_SIGMAPOINT != status || 0 != ukfIo.health.repair[0] || 0 != memcmp(x, ukfIo.update.x.val, sizeof(x)) ||
+                0 != memcmp(P, ukfIo.update.Pxx.val, sizeof(P))) {
+                printf("ERROR: recover %u, status 0x%02x, x or Pxx changed by the skipped step\n", recover, status);
+            } else {
+                printf("%u. SUCCESS! recover %u, fault 0x%02x reported, x and Pxx unchanged\n", recover + 1, recover, status);
+            }
+        }
+    }
+}
+#if defined(MTX_WIDE_INDEX)
+#define UKF_TEST_WIDE_N (150u)
+
+static mtxScalar WideA[UKF_TEST_WIDE_N * UKF_TEST_WIDE_N];
+static mtxScalar WideB[UKF_TEST_WIDE_N * UKF_TEST_WIDE_N];
+static mtxScalar WideC[UKF_TEST_WIDE_N * UKF_TEST_WIDE_N];
+static mtxScalar WideS[UKF_TEST_WIDE_N * UKF_TEST_WIDE_N];
+
+/**
+ * @brief Constant states, the first yLen states are measured directly
+ */
+static void ukf_test_wide_fx(tMatrix *pu_p, tMatrix *pX_p, tMatrix *pX_m, mtxDim sigmaIdx, mtxDim sigmaCnt, mtxScalar dT) {
+    (void)pu_p;
+    (void)pX_p;
+    (void)pX_m;
+    (void)sigmaIdx;
+    (void)sigmaCnt;
+    (void)dT;
+}
+
+static void ukf_test_wide_hy(tMatrix *pu, tMatrix *pX_m, tMatrix *pY_m, mtxDim sigmaIdx, mtxDim sigmaCnt) {
+    const mtxDim yLen = UKF_SIGMA_NELEM(pY_m);
+    mtxDim col, yIdx;
+
+    (void)pu;
+    for (col = sigmaIdx; col < sigmaIdx + sigmaCnt; col++) {
+        for (yIdx = 0; yIdx < yLen; yIdx++) {
+            UKF_SIGMA_AT(pY_m, yIdx, col) = UKF_SIGMA_AT(pX_m, yIdx, col);
+        }
+    }
+}
+
+/**
+ * @brief Wide-index build: blocked kernels against plain loops and a filter with more than
+ * 127 states (sLen > 255) against the closed form of independent scalar Kalman filters
+ */
+void ukf_test_wide(void) {
+    static const uint8_t filterMode[2] = {UKF_MODE_STANDARD, UKF_MODE_SQRT};
+    static uint64_t arena[524288];
+    const mtxDim n = UKF_TEST_WIDE_N;
+    tMatrix a = {n, n, WideA}, b = {n, n, WideB}, c = {n, n, WideC}, s = {n, n, WideS};
+    mtxScalar errMax = 0;
+    uint32_t lcg = 12345u;
+    mtxDim row, col, k;
+    uint8_t fIdx;
+
+    for (row = 0; row < n; row++) {
+        for (col = 0; col < n; col++) {
+            lcg = lcg * 1664525u + 1013904223u;
+            WideA[n * row + col] = (mtxScalar)(lcg >> 8) / (mtxScalar)(1u << 23) - MTX_C(1.0);
+            lcg = lcg * 1664525u + 1013904223u;
+            WideB[n * row + col] = (mtxScalar)(lcg >> 8) / (mtxScalar)(1u << 23) - MTX_C(1.0);
+        }
+    }
+
+    //C = A*B and C = A*B' element by element, S = A*A' + n*I
+    (void)mtx_mul(&a, &b, &c);
+    for (row = 0; row < n; row++) {
+        for (col = 0; col < n; col++) {
+            double sum = 0;
+
+            for (k = 0; k < n; k++) {
+                sum += (double)WideA[n * row + k] * WideB[n * k + col];
+            }
+            errMax = fmax(errMax, fabs(WideC[n * row + col] - sum));
+        }
+    }
+    (void)mtx_mul_src2tr(&a, &b, &c);
+    for (row = 0; row < n; row++) {
+        for (col = 0; col < n; col++) {
+            double sum = 0;
+
+            for (k = 0; k < n; k++) {
+                sum += (double)WideA[n * row + k] * WideB[n * col + k];
+            }
+            errMax = fmax(errMax, fabs(WideC[n * row + col] - sum));
+        }
+    }
+    (void)mtx_mul_src2tr(&a, &a, &s);
+    for (row = 0; row < n; row++) {
+        WideS[n * row + row] += n;
+    }
+    (void)mtx_cpy(&c, &s);
+    if (MTX_OPERATION_OK != mtx_chol_lower(&c)) {
+        errMax = 1;
+    }
+    for (row = 0; row < n; row++) {
+        for (col = 0; col < n; col++) {
+            double sum = 0;
+
+            for (k = 0; k <= row; k++) {
+                sum += (double)WideC[n * row + k] * WideC[n * col + k];
+            }
+            //factor must be lower triangular and L*L' must reproduce S
+            errMax = fmax(errMax, fabs(WideS[n * row + col] - sum) / n + ((col > row) ? fabs(WideC[n * row + col]) : 0));
+        }
+    }
+
+    printf("\nWide index, blocked mtx_mul, mtx_mul_src2tr and mtx_chol_lower (%ux%u)\n", n, n);
+    if (!(errMax < UKF_TEST_EPS)) {
+        printf("ERROR: Max error is too big: %.6e > %.6e\n", errMax, UKF_TEST_EPS);
+    } else {
+        printf("1. SUCCESS! %.6e < %.6e\n", errMax, UKF_TEST_EPS);
+    }
+
+    for (fIdx = 0; fIdx < 2; fIdx++) {
+        const mtxScalar r = MTX_C(1e-1);
+        mtxScalar p = 1;
+        mtxScalar keep = 1;
+        tUkfMatrix cfg;
+        tUKF ukfIo;
+        uint32_t simLoop;
+
+        errMax = 0;
+        if (0 != ukf_mem_layout(&cfg, arena, sizeof(arena), n, n, filterMode[fIdx], UKF_SIGMA_SYMMETRIC)) {
+            printf("\nwide layout fail\n");
+        }
+        //Qxx stays zero, Pxx0 is the identity
+        for (row = 0; row < n; row++) {
+            cfg.Ryy0_init_out_covariance.val[n * row + row] = r;
+        }
+        cfg.update_mode = UKF_UPDATE_BATCH;
+        cfg.fcnPredictBatch = &ukf_test_wide_fx;
+        cfg.fcnObserveBatch = &ukf_test_wide_hy;
+        cfg.dT = MTX_C(0.1);
+
+        if (0 != ukf_init(&ukfIo, &cfg)) {
+            printf("\nwide initialization fail\n");
+        }
+
+        //x(0) = 0 and a constant measurement y per state: y - x(k) = (1 - gain(k))*(y - x(k-1))
+        for (simLoop = 1; simLoop < 10; simLoop++) {
+            const mtxScalar gain = p / (p + r);
+
+            p = (1 - gain) * p;
+            keep *= 1 - gain;
+            for (row = 0; row < n; row++) {
+                ukfIo.input.y.val[row] = MTX_SIN(MTX_C(0.1) * row);
+            }
+            ukf_step(&ukfIo);
+
+            for (row = 0; row < n; row++) {
+                errMax = fmax(errMax, fabs(ukfIo.update.x.val[row] - (1 - keep) * MTX_SIN(MTX_C(0.1) * row)));
+            }
+        }
+
+        printf("\nWide index, %u states %s filter (sLen %u) vs scalar Kalman filters\n", n,
+               (UKF_MODE_SQRT == filterMode[fIdx]) ? "square-root" : "standard", ukfIo.par.sLen);
+        if (!(errMax < UKF_TEST_EPS)) {
+            printf("ERROR: Max error is too big: %.6e > %.6e\n", errMax, UKF_TEST_EPS);
+        } else {
+            printf("1. SUCCESS! %.6e < %.6e\n", errMax, UKF_TEST_EPS);
+        }
+    }
+}
+#endif
+
 int main(void) {
     printf("App STARTED\n\n");
-    ukf_test();
+    UkfMatrixCfg.filter_mode = UKF_MODE_STANDARD;
+    ukf_test(&UkfMatrixCfg, "standard, sequential update");
+    printf("\n");
+    UkfMatrixCfg.update_mode = UKF_UPDATE_BATCH;
+    ukf_test(&UkfMatrixCfg, "standard, batch update");
+    UkfMatrixCfg.update_mode = UKF_UPDATE_AUTO;
+    printf("\n");
+    UkfMatrixCfg.filter_mode = UKF_MODE_SQRT;
+    ukf_test(&UkfMatrixCfg, "square-root");
+    printf("\n");
+    ukf_test_rng();
+    mtx_test_chol_update();
+    ukf_test_linear();
+    ukf_test_arena();
+    ukf_test_mem_plan();
+    ukf_test_batch();
+    ukf_test_fix();
+    ukf_test_split();
+    ukf_test_queue();
+    ukf_test_parallel();
+    ukf_test_checkpoint();
+    ukf_test_replay();
+    ukf_test_smooth();
+    ukf_test_imm();
+    ukf_test_simplex();
+    ukf_test_partial();
+    ukf_test_health();
+    ukf_test_health_skip();
+#if defined(MTX_WIDE_INDEX)
+    ukf_test_wide();
+#endif
     printf("\nApp DONE\n");
 }
@@ -0,0 +1,334 @@
+/**
+ * @file mtxFix.c
+ * @brief Fixed-point matrix operations
+ */
+
+#include <stdint.h>
+#include "mtxFix.h"
+
+/**
+ * @brief Convert floating-point matrix to fixed-point with the frac of Dst
+ *
+ * @param pDst Fixed-point matrix, frac must be assigned
+ * @param pSrc Floating-point matrix of same size
+ * @return mtxResultInfo MTX_SATURATED if at least one element is out of range
+ */
+mtxResultInfo mtx_fix_from_float(tMatrixFix *pDst, const tMatrix *pSrc) {
+    mtxResultInfo ResultL = MTX_OPERATION_OK;
+    const mtxIdx nelem = (mtxIdx)pDst->nrow * pDst->ncol;
+    mtxIdx eIdx;
+
+    if (pDst->nrow != pSrc->nrow || pDst->ncol != pSrc->ncol) {
+        ResultL = MTX_SIZE_MISMATCH;
+    } else {
+        for (eIdx = 0; eIdx < nelem; eIdx++) {
+            const mtxFix value = mtx_fix_from_f(pSrc->val[eIdx], pDst->frac);
+
+            if (MTX_FIX_MAX == value || MTX_FIX_MIN == value) {
+                ResultL = MTX_SATURATED;
+            }
+            pDst->val[eIdx] = value;
+        }
+    }
+
+    return ResultL;
+}
+
+/**
+ * @brief Convert fixed-point matrix to floating-point
+ *
+ * @param pDst Floating-point matrix of same size
+ * @param pSrc Fixed-point matrix
+ * @return mtxResultInfo
+ */
+mtxResultInfo mtx_fix_to_float(tMatrix *pDst, const tMatrixFix *pSrc) {
+    mtxResultInfo ResultL = MTX_OPERATION_OK;
+    const mtxIdx nelem = (mtxIdx)pSrc->nrow * pSrc->ncol;
+    mtxIdx eIdx;
+
+    if (pDst->nrow != pSrc->nrow || pDst->ncol != pSrc->ncol) {
+        ResultL = MTX_SIZE_MISMATCH;
+    } else {
+        for (eIdx = 0; eIdx < nelem; eIdx++) {
+            pDst->val[eIdx] = mtx_fix_to_f(pSrc->val[eIdx], pSrc->frac);
+        }
+    }
+
+    return ResultL;
+}
+
+/**
+ * @brief Dst = Src rescaled to the frac of Dst
+ *
+ * @param pDst Destination matrix
+ * @param pSrc Source matrix of same size
+ * @return mtxResultInfo MTX_SATURATED if at least one element is out of range of Dst
+ */
+mtxResultInfo mtx_fix_cpy(tMatrixFix *pDst, const tMatrixFix *pSrc) {
+    mtxResultInfo ResultL = MTX_OPERATION_OK;
+    const mtxIdx nelem = (mtxIdx)pSrc->nrow * pSrc->ncol;
+    const int8_t shift = pSrc->frac - pDst->frac;
+    uint8_t sat = 0u;
+    mtxIdx eIdx;
+
+    if (pDst->nrow != pSrc->nrow || pDst->ncol != pSrc->ncol) {
+        ResultL = MTX_SIZE_MISMATCH;
+    } else {
+        for (eIdx = 0; eIdx < nelem; eIdx++) {
+            pDst->val[eIdx] = mtx_fix_sat_chk(mtx_fix_shr(pSrc->val[eIdx], shift), &sat);
+        }
+    }
+
+    if (0u != sat && MTX_OPERATION_OK == ResultL) {
+        ResultL = MTX_SATURATED;
+    }
+
+    return ResultL;
+}
+
+/**
+ * @brief Dst = Dst + Src, Src is rescaled to the frac of Dst
+ *
+ * @param pDst Destination matrix
+ * @param pSrc Source matrix of same size
+ * @return mtxResultInfo MTX_SATURATED if at least one element is out of range of Dst
+ */
+mtxResultInfo mtx_fix_add(tMatrixFix *pDst, const tMatrixFix *pSrc) {
+    mtxResultInfo ResultL = MTX_OPERATION_OK;
+    const mtxIdx nelem = (mtxIdx)pSrc->nrow * pSrc->ncol;
+    const int8_t shift = pSrc->frac - pDst->frac;
+    uint8_t sat = 0u;
+    mtxIdx eIdx;
+
+    if (pDst->nrow != pSrc->nrow || pDst->ncol != pSrc->ncol) {
+        ResultL = MTX_SIZE_MISMATCH;
+    } else {
+        for (eIdx = 0; eIdx < nelem; eIdx++) {
+            pDst->val[eIdx] = mtx_fix_sat_chk((mtxFixAcc)pDst->val[eIdx] + mtx_fix_shr(pSrc->val[eIdx], shift), &sat);
+        }
+    }
+
+    if (0u != sat && MTX_OPERATION_OK == ResultL) {
+        ResultL = MTX_SATURATED;
+    }
+
+    return ResultL;
+}
+
+/**
+ * @brief Dst = Dst - Src, Src is rescaled to the frac of Dst
+ *
+ * @param pDst Destination matrix
+ * @param pSrc Source matrix of same size
+ * @return mtxResultInfo MTX_SATURATED if at least one element is out of range of Dst
+ */
+mtxResultInfo mtx_fix_sub(tMatrixFix *pDst, const tMatrixFix *pSrc) {
+    mtxResultInfo ResultL = MTX_OPERATION_OK;
+    const mtxIdx nelem = (mtxIdx)pSrc->nrow * pSrc->ncol;
+    const int8_t shift = pSrc->frac - pDst->frac;
+    uint8_t sat = 0u;
+    mtxIdx eIdx;
+
+    if (pDst->nrow != pSrc->nrow || pDst->ncol != pSrc->ncol) {
+        ResultL = MTX_SIZE_MISMATCH;
+    } else {
+        for (eIdx = 0; eIdx < nelem; eIdx++) {
+            pDst->val[eIdx] = mtx_fix_sat_chk((mtxFixAcc)pDst->val[eIdx] - mtx_fix_shr(pSrc->val[eIdx], shift), &sat);
+        }
+    }
+
+    if (0u != sat && MTX_OPERATION_OK == ResultL) {
+        ResultL = MTX_SATURATED;
+    }
+
+    return ResultL;
+}
+
+/**
+ * @brief Dst = Src1 * Src2, every element is accumulated at full precision
+ * and rounded once to the frac of Dst
+ *
+ * @param pSrc1 Matrix (nrow x ninner)
+ * @param pSrc2 Matrix (ninner x ncol)
+ * @param pDst Matrix (nrow x ncol), must not alias the sources
+ * @return mtxResultInfo MTX_SATURATED if a sum of products or an element was clamped
+ */
+mtxResultInfo mtx_fix_mul(const tMatrixFix *pSrc1, const tMatrixFix *pSrc2, tMatrixFix *pDst) {
+    mtxResultInfo ResultL = MTX_OPERATION_OK;
+    const mtxDim nrow = pSrc1->nrow;
+    const mtxDim ninner = pSrc1->ncol;
+    const mtxDim ncol = pSrc2->ncol;
+    const int8_t shift = pSrc1->frac + pSrc2->frac - pDst->frac;
+    uint8_t sat = 0u;
+    mtxDim row, col, k;
+
+    if (ninner != pSrc2->nrow || nrow != pDst->nrow || ncol != pDst->ncol) {
+        ResultL = MTX_SIZE_MISMATCH;
+    } else {
+        for (row = 0; row < nrow; row++) {
+            for (col = 0; col < ncol; col++) {
+                mtxFixAcc acc = 0;
+
+                for (k = 0; k < ninner; k++) {
+                    acc = mtx_fix_mac(acc, pSrc1->val[ninner * row + k], pSrc2->val[ncol * k + col], &sat);
+                }
+                pDst->val[ncol * row + col] = mtx_fix_sat_chk(mtx_fix_shr(acc, shift), &sat);
+            }
+        }
+    }
+
+    if (0u != sat && MTX_OPERATION_OK == ResultL) {
+        ResultL = MTX_SATURATED;
+    }
+
+    return ResultL;
+}
+
+/**
+ * @brief Dst = Src1 * Src2'
+ *
+ * @param pSrc1 Matrix (nrow1 x ncol)
+ * @param pSrc2 Matrix (nrow2 x ncol)
+ * @param pDst Matrix (nrow1 x nrow2), must not alias the sources
+ * @return mtxResultInfo MTX_SATURATED if a sum of products or an element was clamped
+ */
+mtxResultInfo mtx_fix_mul_src2tr(const tMatrixFix *pSrc1, const tMatrixFix *pSrc2, tMatrixFix *pDst) {
+    mtxResultInfo ResultL = MTX_OPERATION_OK;
+    const mtxDim nrow1 = pSrc1->nrow;
+    const mtxDim nrow2 = pSrc2->nrow;
+    const mtxDim ncol = pSrc1->ncol;
+    const int8_t shift = pSrc1->frac + pSrc2->frac - pDst->frac;
+    uint8_t sat = 0u;
+    mtxDim row1, row2, k;
+
+    if (ncol != pSrc2->ncol || nrow1 != pDst->nrow || nrow2 != pDst->ncol) {
+        ResultL = MTX_SIZE_MISMATCH;
+    } else {
+        for (row1 = 0; row1 < nrow1; row1++) {
+            for (row2 = 0; row2 < nrow2; row2++) {
+                mtxFixAcc acc = 0;
+
+                for (k = 0; k < ncol; k++) {
+                    acc = mtx_fix_mac(acc, pSrc1->val[ncol * row1 + k], pSrc2->val[ncol * row2 + k], &sat);
+                }
+                pDst->val[nrow2 * row1 + row2] = mtx_fix_sat_chk(mtx_fix_shr(acc, shift), &sat);
+            }
+        }
+    }
+
+    if (0u != sat && MTX_OPERATION_OK == ResultL) {
+        ResultL = MTX_SATURATED;
+    }
+
+    return ResultL;
+}
+
+/**
+ * @brief Lower Cholesky factor in place, upper triangle is cleared. The factor
+ * keeps the frac of Src, so the format must also cover sqrt of the diagonal.
+ *
+ * @param pSrc Symmetric positive definite matrix, overwritten by lower factor
+ * @return mtxResultInfo MTX_SATURATED if the factor was clamped to the format
+ */
+mtxResultInfo mtx_fix_chol_lower(tMatrixFix *pSrc) {
+    mtxResultInfo ResultL = MTX_OPERATION_OK;
+    mtxFix *const pA = pSrc->val;
+    const mtxDim n = pSrc->nrow;
+    const int8_t frac = pSrc->frac;
+    uint8_t sat = 0u;
+    mtxDim row, col, k;
+
+    if (pSrc->ncol != n) {
+        ResultL = MTX_NOT_SQUARE;
+    } else {
+        for (col = 0; col < n && MTX_OPERATION_OK == ResultL; col++) {
+            //sums of products carry 2*frac fractional bits
+            mtxFixAcc acc = mtx_fix_shr(pA[n * col + col], -frac);
+
+            for (k = 0; k < col; k++) {
+                acc = mtx_fix_msu(acc, pA[n * col + k], pA[n * col + k], &sat);
+            }
+
+            if (acc <= 0) {
+                ResultL = MTX_NOT_POS_DEFINED;
+            } else {
+                const mtxFixAcc diag = mtx_fix_isqrt((mtxFixUAcc)acc);
+
+                pA[n * col + col] = mtx_fix_sat_chk(diag, &sat);
+
+                for (row = col + 1; row < n; row++) {
+                    acc = mtx_fix_shr(pA[n * row + col], -frac);
+
+                    for (k = 0; k < col; k++) {
+                        acc = mtx_fix_msu(acc, pA[n * row + k], pA[n * col + k], &sat);
+                    }
+                    pA[n * row + col] = mtx_fix_sat_chk(mtx_fix_divr(acc, diag), &sat);
+                    pA[n * col + row] = 0;
+                }
+            }
+        }
+    }
+
+    if (0u != sat && MTX_OPERATION_OK == ResultL) {
+        ResultL = MTX_SATURATED;
+    }
+
+    return ResultL;
+}
+
+/**
+ * @brief Dst = Src*inv(L*L') with lower Cholesky factor L, solved row by row with
+ * forward and backward substitution. Intermediate values use the frac of Dst.
+ *
+ * @param pL Lower Cholesky factor (n x n), e.g. result of mtx_fix_chol_lower
+ * @param pSrc Right hand side (m x n)
+ * @param pDst Solution (m x n), may be the same matrix as pSrc if fracs are equal
+ * @return mtxResultInfo MTX_SATURATED if an intermediate value or the solution was clamped
+ */
+mtxResultInfo mtx_fix_chol_subst(const tMatrixFix *pL, const tMatrixFix *pSrc, tMatrixFix *pDst) {
+    mtxResultInfo ResultL = MTX_OPERATION_OK;
+    mtxFix const *const pLv = pL->val;
+    const mtxDim n = pL->nrow;
+    const mtxDim nrow = pSrc->nrow;
+    //numerators carry frac(Dst) + frac(L) fractional bits, division by L(i,i) gives frac(Dst)
+    const int8_t shiftB = pSrc->frac - pDst->frac - pL->frac;
+    uint8_t sat = 0u;
+    mtxDim row, i, k;
+
+    if (pL->ncol != n) {
+        ResultL = MTX_NOT_SQUARE;
+    } else if (pSrc->ncol != n || pDst->ncol != n || pDst->nrow != nrow) {
+        ResultL = MTX_SIZE_MISMATCH;
+    } else {
+        for (row = 0; row < nrow; row++) {
+            mtxFix const *const pB = &pSrc->val[n * row];
+            mtxFix *const pX = &pDst->val[n * row];
+
+            //forward substitution L*z = b
+            for (i = 0; i < n; i++) {
+                mtxFixAcc acc = mtx_fix_shr(pB[i], shiftB);
+
+                for (k = 0; k < i; k++) {
+                    acc = mtx_fix_msu(acc, pLv[n * i + k], pX[k], &sat);
+                }
+                pX[i] = mtx_fix_sat_chk(mtx_fix_divr(acc, pLv[n * i + i]), &sat);
+            }
+
+            //backward substitution L'*x = z
+            for (i = n; i-- > 0;) {
+                mtxFixAcc acc = mtx_fix_shr(pX[i], -pL->frac);
+
+                for (k = i + 1; k < n; k++) {
+                    acc = mtx_fix_msu(acc, pLv[n * k + i], pX[k], &sat);
+                }
+                pX[i] = mtx_fix_sat_chk(mtx_fix_divr(acc, pLv[n * i + i]), &sat);
+            }
+        }
+    }
+
+    if (0u != sat && MTX_OPERATION_OK == ResultL) {
+        ResultL = MTX_SATURATED;
+    }
+
+    return ResultL;
+}
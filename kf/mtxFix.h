@@ -0,0 +1,220 @@
+/**
+ * @file mtxFix.h
+ * @brief Fixed-point matrix operations header (Q31 default, Q15 with MTX_FIX_Q15).
+ * Every matrix carries its own scaling: element value = val * 2^-frac. Results
+ * are rounded to the frac of the destination matrix and saturated to its range.
+ * Products are accumulated at full precision (int64_t for Q31, int32_t for Q15)
+ * with saturating sums, so formats should keep a few bits of headroom for sums
+ * over many products. Every operation returns MTX_SATURATED if a value had to be
+ * clamped, the result is still complete but clamped.
+ */
+
+#ifndef MTXFIX_FILE
+#define MTXFIX_FILE
+
+#include <stdint.h>
+#include "mtxLib.h"
+
+//! Element and accumulator type: Q15 fits 16x16->32 multipliers (Cortex-M0/M0+ MULS) without 64-bit arithmetic
+#if defined(MTX_FIX_Q15)
+typedef int16_t mtxFix;
+typedef int32_t mtxFixAcc;
+typedef uint32_t mtxFixUAcc;
+#define MTX_FIX_MAX INT16_MAX
+#define MTX_FIX_MIN INT16_MIN
+#define MTX_FIX_ACC_MAX INT32_MAX
+#else
+typedef int32_t mtxFix;
+typedef int64_t mtxFixAcc;
+typedef uint64_t mtxFixUAcc;
+#define MTX_FIX_MAX INT32_MAX
+#define MTX_FIX_MIN INT32_MIN
+#define MTX_FIX_ACC_MAX INT64_MAX
+#endif
+
+//! Value was out of range of the destination format and has been saturated
+#define MTX_SATURATED (250UL)
+
+typedef struct sMatrixFix {
+    mtxDim nrow;
+    mtxDim ncol;
+    int8_t frac;   //number of fractional bits, value = val * 2^-frac
+    mtxFix* val;
+} tMatrixFix;
+
+mtxResultInfo mtx_fix_from_float (tMatrixFix *pDst, const tMatrix *pSrc);
+mtxResultInfo mtx_fix_to_float   (tMatrix *pDst, const tMatrixFix *pSrc);
+mtxResultInfo mtx_fix_cpy        (tMatrixFix *pDst, const tMatrixFix *pSrc);
+mtxResultInfo mtx_fix_add        (tMatrixFix *pDst, const tMatrixFix *pSrc);
+mtxResultInfo mtx_fix_sub        (tMatrixFix *pDst, const tMatrixFix *pSrc);
+mtxResultInfo mtx_fix_mul        (const tMatrixFix *pSrc1, const tMatrixFix *pSrc2, tMatrixFix *pDst);
+mtxResultInfo mtx_fix_mul_src2tr (const tMatrixFix *pSrc1, const tMatrixFix *pSrc2, tMatrixFix *pDst);
+mtxResultInfo mtx_fix_chol_lower (tMatrixFix *pSrc);
+mtxResultInfo mtx_fix_chol_subst (const tMatrixFix *pL, const tMatrixFix *pSrc, tMatrixFix *pDst);
+
+/**
+ * @brief Saturate accumulator to element range
+ */
+MTX_INLINE mtxFix mtx_fix_sat(const mtxFixAcc acc) {
+    return (acc > MTX_FIX_MAX) ? MTX_FIX_MAX : ((acc < MTX_FIX_MIN) ? MTX_FIX_MIN : (mtxFix)acc);
+}
+
+/**
+ * @brief Saturate accumulator to element range, *pSat is set if the value was clamped
+ */
+MTX_INLINE mtxFix mtx_fix_sat_chk(const mtxFixAcc acc, uint8_t *const pSat) {
+    const mtxFix res = mtx_fix_sat(acc);
+
+    if (res != acc) {
+        *pSat = 1u;
+    }
+
+    return res;
+}
+
+/**
+ * @brief Saturated sum acc + term of accumulators in [-MTX_FIX_ACC_MAX, MTX_FIX_ACC_MAX],
+ * *pSat is set if the sum was clamped instead of overflowing
+ */
+MTX_INLINE mtxFixAcc mtx_fix_acc_adds(const mtxFixAcc acc, const mtxFixAcc term, uint8_t *const pSat) {
+    mtxFixAcc res;
+
+    if (term > 0 && acc > MTX_FIX_ACC_MAX - term) {
+        res = MTX_FIX_ACC_MAX;
+        *pSat = 1u;
+    } else if (term < 0 && acc < -MTX_FIX_ACC_MAX - term) {
+        res = -MTX_FIX_ACC_MAX;
+        *pSat = 1u;
+    } else {
+        res = acc + term;
+    }
+
+    return res;
+}
+
+/**
+ * @brief Saturated multiply-accumulate acc + a*b, a single product always fits the accumulator
+ */
+MTX_INLINE mtxFixAcc mtx_fix_mac(const mtxFixAcc acc, const mtxFix a, const mtxFix b, uint8_t *const pSat) {
+    return mtx_fix_acc_adds(acc, (mtxFixAcc)a * b, pSat);
+}
+
+/**
+ * @brief Saturated multiply-subtract acc - a*b
+ */
+MTX_INLINE mtxFixAcc mtx_fix_msu(const mtxFixAcc acc, const mtxFix a, const mtxFix b, uint8_t *const pSat) {
+    return mtx_fix_acc_adds(acc, -((mtxFixAcc)a * b), pSat);
+}
+
+/**
+ * @brief Rescale accumulator by 2^-shift, rounding to nearest; negative shift scales up
+ * and saturates to the accumulator range
+ */
+MTX_INLINE mtxFixAcc mtx_fix_shr(const mtxFixAcc acc, const int8_t shift) {
+    mtxFixAcc res;
+
+    if (shift > 0) {
+        //rounding bit is added after the shift, acc + 2^(shift-1) could overflow
+        res = (acc >> shift) + ((acc >> (shift - 1)) & 1);
+    } else if (0 == shift) {
+        res = acc;
+    } else {
+        const mtxFixAcc lim = MTX_FIX_ACC_MAX >> -shift;
+
+        res = (acc > lim) ? MTX_FIX_ACC_MAX : ((acc < -lim) ? -MTX_FIX_ACC_MAX : acc * ((mtxFixAcc)1 << -shift));
+    }
+
+    return res;
+}
+
+/**
+ * @brief Saturated sat(a * b * 2^-shift), e.g. shift = fracA + fracB - fracDst
+ */
+MTX_INLINE mtxFix mtx_fix_mulq(const mtxFix a, const mtxFix b, const int8_t shift) {
+    return mtx_fix_sat(mtx_fix_shr((mtxFixAcc)a * b, shift));
+}
+
+/**
+ * @brief Saturated sum a + b of two elements in the same format
+ */
+MTX_INLINE mtxFix mtx_fix_adds(const mtxFix a, const mtxFix b) {
+    return mtx_fix_sat((mtxFixAcc)a + b);
+}
+
+/**
+ * @brief Quotient num/den of accumulators rounded to nearest (den != 0), computed
+ * from quotient and remainder so that num +- den/2 cannot overflow
+ */
+MTX_INLINE mtxFixAcc mtx_fix_divr(const mtxFixAcc num, const mtxFixAcc den) {
+    const mtxFixAcc quot = num / den;
+    const mtxFixAcc rem = num % den;
+    const mtxFixAcc remAbs = (rem >= 0) ? rem : -rem;
+    const mtxFixAcc denAbs = (den >= 0) ? den : -den;
+    mtxFixAcc res = quot;
+
+    if (remAbs >= denAbs - remAbs) {
+        res = ((num >= 0) == (den > 0)) ? (quot + 1) : (quot - 1);
+    }
+
+    return res;
+}
+
+/**
+ * @brief Rounded quotient num/den of accumulators, saturated to element range (den != 0)
+ */
+MTX_INLINE mtxFix mtx_fix_div(const mtxFixAcc num, const mtxFixAcc den) {
+    return mtx_fix_sat(mtx_fix_divr(num, den));
+}
+
+/**
+ * @brief Integer square root floor(sqrt(acc)), bitwise without multiplication.
+ * sqrt of a value with 2*frac fractional bits has frac fractional bits.
+ */
+MTX_INLINE mtxFixAcc mtx_fix_isqrt(const mtxFixUAcc acc) {
+    mtxFixUAcc rem = acc;
+    mtxFixUAcc root = 0;
+    mtxFixUAcc bit = (mtxFixUAcc)1 << (sizeof(mtxFixUAcc) * 8u - 2u);
+
+    while (bit > rem) {
+        bit >>= 2;
+    }
+
+    while (0 != bit) {
+        if (rem >= root + bit) {
+            rem -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (mtxFixAcc)root;
+}
+
+/**
+ * @brief Convert floating-point value to fixed-point element with frac fractional bits (saturated)
+ */
+MTX_INLINE mtxFix mtx_fix_from_f(const mtxScalar value, const int8_t frac) {
+    const mtxScalar scaled = value * ((frac >= 0) ? (mtxScalar)((mtxFixAcc)1 << frac) : MTX_C(1.0) / (mtxScalar)((mtxFixAcc)1 << -frac));
+    mtxFix res;
+
+    if (scaled >= (mtxScalar)MTX_FIX_MAX) {
+        res = MTX_FIX_MAX;
+    } else if (scaled <= (mtxScalar)MTX_FIX_MIN) {
+        res = MTX_FIX_MIN;
+    } else {
+        res = (mtxFix)((scaled >= 0) ? (scaled + MTX_C(0.5)) : (scaled - MTX_C(0.5)));
+    }
+
+    return res;
+}
+
+/**
+ * @brief Convert fixed-point element with frac fractional bits to floating point
+ */
+MTX_INLINE mtxScalar mtx_fix_to_f(const mtxFix value, const int8_t frac) {
+    return (mtxScalar)value * ((frac >= 0) ? MTX_C(1.0) / (mtxScalar)((mtxFixAcc)1 << frac) : (mtxScalar)((mtxFixAcc)1 << -frac));
+}
+
+#endif
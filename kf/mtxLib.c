@@ -9,6 +9,28 @@
 #include <stdint.h>
 #include "mtxLib.h"
 
+#if defined(MTX_USE_CMSIS_DSP)
+/**
+ * @brief Translate CMSIS-DSP status to mtxResultInfo
+ * 
+ * @param status CMSIS-DSP function status
+ * @return mtxResultInfo 
+ */
+static mtxResultInfo mtx_arm_result(arm_status status) {
+    mtxResultInfo Result = MTX_OPERATION_ERROR;
+
+    if (ARM_MATH_SUCCESS == status) {
+        Result = MTX_OPERATION_OK;
+    } else if (ARM_MATH_SIZE_MISMATCH == status) {
+        Result = MTX_SIZE_MISMATCH;
+    } else if (ARM_MATH_SINGULAR == status) {
+        Result = MTX_SINGULAR;
+    }
+
+    return Result;
+}
+#endif
+
 /**
  * @brief 
  * 
@@ -16,17 +38,17 @@
  * @param diagsum 
  * @return mtxResultInfo 
  */
-mtxResultInfo mtx_diagsum(tMatrix *pSrc, float *diagsum) {
+mtxResultInfo mtx_diagsum(tMatrix *pSrc, mtxScalar *diagsum) {
     mtxResultInfo Result = MTX_OPERATION_OK;
-    float const *const pSrcL = (float *)pSrc->val;
-    const uint8_t ncol = pSrc->ncol;
-    uint16_t eIdx;
-    float sum = pSrcL[0];
-    const uint16_t nelem = pSrc->ncol * pSrc->nrow;
+    mtxScalar const *const pSrcL = (mtxScalar *)pSrc->val;
+    const mtxDim ncol = pSrc->ncol;
+    mtxIdx eIdx;
+    mtxScalar sum = pSrcL[0];
+    const mtxIdx nelem = (mtxIdx)pSrc->ncol * pSrc->nrow;
 
     if (pSrc->nrow == ncol) {
         for (eIdx = 1; eIdx < nelem; eIdx++) {
-            const uint16_t cmpLeft = (uint16_t)(eIdx / ncol);
+            const mtxIdx cmpLeft = (mtxIdx)(eIdx / ncol);
 
             sum += eIdx < ncol ? 0 : cmpLeft == eIdx % (cmpLeft * ncol) ? pSrcL[eIdx]
                                                                         : 0;
@@ -48,11 +70,11 @@ mtxResultInfo mtx_diagsum(tMatrix *pSrc, float *diagsum) {
  */
 mtxResultInfo mtx_transp_square(tMatrix *pSrc) {
     mtxResultInfo ResultL = MTX_OPERATION_OK;
-    const uint8_t nrow = pSrc->nrow;
-    const uint8_t ncol = pSrc->ncol;
-    float *const pSrcL = (float *)pSrc->val;
-    uint8_t row, col;
-    float temp;
+    const mtxDim nrow = pSrc->nrow;
+    const mtxDim ncol = pSrc->ncol;
+    mtxScalar *const pSrcL = (mtxScalar *)pSrc->val;
+    mtxDim row, col;
+    mtxScalar temp;
 
     if (nrow == ncol) {
         for (row = 0; row < nrow; row++) {
@@ -80,13 +102,13 @@ mtxResultInfo mtx_transp_square(tMatrix *pSrc) {
  */
 mtxResultInfo mtx_transp_dest(const tMatrix *pSrc, tMatrix *pDst) {
     mtxResultInfo ResultL = MTX_OPERATION_OK;
-    float const *const pSrcL = (float *)pSrc->val;
-    float *const pDstL = (float *)pDst->val;
-    const uint8_t nRowSrcL = pSrc->nrow;
-    const uint8_t nColSrcL = pSrc->ncol;
-    const uint8_t nRowDstL = pDst->nrow;
-    const uint8_t nColDstL = pDst->ncol;
-    uint8_t row, col;
+    mtxScalar const *const pSrcL = (mtxScalar *)pSrc->val;
+    mtxScalar *const pDstL = (mtxScalar *)pDst->val;
+    const mtxDim nRowSrcL = pSrc->nrow;
+    const mtxDim nColSrcL = pSrc->ncol;
+    const mtxDim nRowDstL = pDst->nrow;
+    const mtxDim nColDstL = pDst->ncol;
+    mtxDim row, col;
 
     if (nRowSrcL == nColDstL || nColSrcL == nRowDstL) {
         for (row = 0; row < nRowDstL; row++) {
@@ -111,22 +133,21 @@ mtxResultInfo mtx_transp_dest(const tMatrix *pSrc, tMatrix *pDst) {
  */
 mtxResultInfo mtx_mul(const tMatrix *pSrc1, const tMatrix *pSrc2, tMatrix *pDst) {
     mtxResultInfo ResultL = MTX_OPERATION_OK;
-    float const *const pSrc1L = (float *)pSrc1->val;
-    float const *const pSrc2L = (float *)pSrc2->val;
-    float *const pDstL = (float *)pDst->val;
-    uint8_t row, col, k;
-    float sum;
+    mtxScalar const *const pSrc1L = (mtxScalar *)pSrc1->val;
+    mtxScalar const *const pSrc2L = (mtxScalar *)pSrc2->val;
+    mtxScalar *const pDstL = (mtxScalar *)pDst->val;
 
     if (pSrc1->ncol == pSrc2->nrow) {
-        for (row = 0; row < pSrc1->nrow; row++) {
-            for (col = 0; col < pSrc2->ncol; col++) {
-                sum = 0;
-                for (k = 0; k < pSrc1->ncol; k++) {
-                    sum += pSrc1L[pSrc1->ncol * row + k] * pSrc2L[pSrc2->ncol * k + col];
-                }
-                pDstL[pDst->ncol * row + col] = sum;
-            }
-        }
+#if defined(MTX_USE_CMSIS_DSP)
+        arm_matrix_instance_f32 src1, src2, dst;
+
+        arm_mat_init_f32(&src1, pSrc1->nrow, pSrc1->ncol, (float32_t *)pSrc1L);
+        arm_mat_init_f32(&src2, pSrc2->nrow, pSrc2->ncol, (float32_t *)pSrc2L);
+        arm_mat_init_f32(&dst, pDst->nrow, pDst->ncol, pDstL);
+        ResultL = mtx_arm_result(arm_mat_mult_f32(&src1, &src2, &dst));
+#else
+        mtx_kernel_mul(pSrc1L, pSrc2L, pDstL, pSrc1->nrow, pSrc1->ncol, pSrc2->ncol);
+#endif
     } else {
         ResultL = MTX_SIZE_MISMATCH;
     }
@@ -147,22 +168,25 @@ mtxResultInfo mtx_mul(const tMatrix *pSrc1, const tMatrix *pSrc2, tMatrix *pDst)
  */
 mtxResultInfo mtx_mul_src2tr(const tMatrix *pSrc1, const tMatrix *pSrc2, tMatrix *pDst) {
     mtxResultInfo ResultL = MTX_OPERATION_OK;
-    float const *const pSrc1L = (float *)pSrc1->val;
-    float const *const pSrc2L = (float *)pSrc2->val;
-    float *const pDstL = (float *)pDst->val;
-    uint8_t rowSrc1, rowSrc2, k;
-    float sum;
+    mtxScalar const *const pSrc1L = (mtxScalar *)pSrc1->val;
+    mtxScalar const *const pSrc2L = (mtxScalar *)pSrc2->val;
+    mtxScalar *const pDstL = (mtxScalar *)pDst->val;
 
     if (pSrc1->ncol == pSrc2->ncol) {
+#if defined(MTX_USE_CMSIS_DSP)
+        mtxDim rowSrc1, rowSrc2;
+        mtxScalar sum;
+
         for (rowSrc1 = 0; rowSrc1 < pSrc1->nrow; rowSrc1++) {
             for (rowSrc2 = 0; rowSrc2 < pSrc2->nrow; rowSrc2++) {
-                sum = 0;
-                for (k = 0; k < pSrc1->ncol; k++) {
-                    sum += pSrc1L[pSrc1->ncol * rowSrc1 + k] * pSrc2L[pSrc2->ncol * rowSrc2 + k];
-                }
+                //rows of Src1 and Src2 are contiguous: one dot product per element
+                arm_dot_prod_f32(&pSrc1L[pSrc1->ncol * rowSrc1], &pSrc2L[pSrc2->ncol * rowSrc2], pSrc1->ncol, &sum);
                 pDstL[pDst->ncol * rowSrc1 + rowSrc2] = sum;
             }
         }
+#else
+        mtx_kernel_mul_src2tr(pSrc1L, pSrc2L, pDstL, pSrc1->nrow, pSrc2->nrow, pSrc1->ncol);
+#endif
     } else {
         ResultL = MTX_SIZE_MISMATCH;
     }
@@ -178,25 +202,40 @@ mtxResultInfo mtx_mul_src2tr(const tMatrix *pSrc1, const tMatrix *pSrc2, tMatrix
  */
 mtxResultInfo mtx_chol_lower(tMatrix *pSrc) {
     mtxResultInfo ResultL = MTX_OPERATION_OK;
-    float *const pSrcL = pSrc->val;
-    const uint8_t nrow = pSrc->nrow;
-    const uint8_t ncol = pSrc->ncol;
-    uint8_t col, row;
-    int8_t tmp;
-    float sum = 0;
 
-    if (ncol == nrow) {
-        const uint8_t mtxSize = nrow;
+    if (pSrc->ncol == pSrc->nrow) {
+        ResultL = mtx_kernel_chol_lower(pSrc->val, pSrc->nrow);
+    } else {
+        ResultL = MTX_NOT_SQUARE;
+    }
+
+    return ResultL;
+}
 
-        for (col = 0; col < mtxSize; col++) {
-            for (row = 0; row < mtxSize; row++) {
-                sum = pSrcL[mtxSize * col + row];
+/**
+ * @brief 
+ * 
+ * @param pSrc 
+ * @return mtxResultInfo 
+ */
+mtxResultInfo mtx_chol_upper(tMatrix *pSrc) {
+    mtxResultInfo ResultL = MTX_OPERATION_OK;
+    mtxScalar *const pSrcL = pSrc->val;
+    const mtxDim nrow = pSrc->nrow;
+    const mtxDim ncol = pSrc->ncol;
+    mtxDim col, row, k;
+    mtxScalar sum = 0;
+
+    if (ncol == nrow) {
+        for (row = 0; row < nrow; row++) {
+            for (col = 0; col < ncol; col++) {
+                sum = pSrcL[ncol * row + col];
 
-                for (tmp = (int8_t)(col - 1); tmp >= 0; tmp--) {
-                    sum -= pSrcL[mtxSize * row + tmp] * pSrcL[mtxSize * col + tmp];
+                for (k = row; k-- > 0;) {
+                    sum -= pSrcL[ncol * k + row] * pSrcL[ncol * k + col];
                 }
 
-                pSrcL[ncol * row + col] = (row == col) ? sqrt(sum) : (row > col) ? (sum / pSrcL[ncol * col + col])
+                pSrcL[ncol * row + col] = (row == col) ? MTX_SQRT(sum) : (row < col) ? (sum / pSrcL[ncol * row + row])
                                                                                  : 0;
 
                 if ((row == col) && (sum <= 0)) {
@@ -212,35 +251,195 @@ mtxResultInfo mtx_chol_lower(tMatrix *pSrc) {
 }
 
 /**
- * @brief 
+ * @brief Cholesky substitution Dst = Dst*inv(L*L')
+ * Every row b of Dst is replaced by the solution x of (L*L')*x' = b'
+ * using one forward (L) and one backward (L') substitution in place.
  * 
- * @param pSrc 
+ * @param pL Lower triangular Cholesky factor (n x n), e.g. result of mtx_chol_lower
+ * @param pDst Right hand side (m x n), overwritten by the solution
  * @return mtxResultInfo 
  */
-mtxResultInfo mtx_chol_upper(tMatrix *pSrc) {
+mtxResultInfo mtx_chol_subst(const tMatrix *pL, tMatrix *pDst) {
     mtxResultInfo ResultL = MTX_OPERATION_OK;
-    float *const pSrcL = pSrc->val;
-    const uint8_t nrow = pSrc->nrow;
-    const uint8_t ncol = pSrc->ncol;
-    uint8_t col, row;
-    int8_t tmp;
-    float sum = 0;
 
-    if (ncol == nrow) {
-        for (row = 0; row < nrow; row++) {
-            for (col = 0; col < ncol; col++) {
-                sum = pSrcL[ncol * row + col];
+    if (pL->nrow != pL->ncol) {
+        ResultL = MTX_NOT_SQUARE;
+    } else if (pDst->ncol != pL->nrow) {
+        ResultL = MTX_SIZE_MISMATCH;
+    } else {
+        mtx_kernel_chol_subst(pL->val, pDst->val, pDst->nrow, pL->nrow);
+    }
+
+    return ResultL;
+}
+
+/**
+ * @brief Solve Dst = Dst*inv(Src) for symmetric positive definite Src.
+ * Src is factorized in place (Src = L*L', lower triangle kept) and
+ * every row of Dst is solved with mtx_chol_subst. No identity matrix
+ * or copy of Src is required.
+ * 
+ * @param pSrc Symmetric positive definite matrix (n x n), overwritten by its lower Cholesky factor
+ * @param pDst Right hand side (m x n), overwritten by the solution
+ * @return mtxResultInfo 
+ */
+mtxResultInfo mtx_chol_solve(tMatrix *pSrc, tMatrix *pDst) {
+    mtxResultInfo ResultL = mtx_chol_lower(pSrc);
+
+    if (MTX_OPERATION_OK == ResultL) {
+        ResultL = mtx_chol_subst(pSrc, pDst);
+    }
+
+    return ResultL;
+}
+
+/**
+ * @brief Solve Dst = Dst*inv(Src) with Gauss-Jordan elimination on the columns of Src.
+ * Every column operation reducing Src to identity is applied to Dst as well, so the
+ * solution is obtained without an identity matrix, an explicit inverse or a copy of Src.
+ * Pivots are taken from the diagonal without exchange, like in mtx_inv. That is sufficient
+ * for symmetric positive definite Src (e.g. Pyy of the gain), whose diagonal pivots stay
+ * positive. Rows above the pivot are already unit rows and are not eliminated again.
+ * 
+ * @param pSrc Square matrix (n x n), reduced to identity
+ * @param pDst Right hand side (m x n), overwritten by the solution
+ * @return mtxResultInfo MTX_SINGULAR if a pivot is zero, Src and Dst are invalid then
+ */
+mtxResultInfo mtx_gj_subst(tMatrix *pSrc, tMatrix *pDst) {
+    mtxResultInfo ResultL = MTX_OPERATION_OK;
+    mtxScalar *const pA = pSrc->val;
+    mtxScalar *const pB = pDst->val;
+    const mtxDim n = pSrc->nrow;
+    const mtxDim nrow = pDst->nrow;
+    mtxDim j, row, col;
+
+    if (pSrc->ncol != n) {
+        ResultL = MTX_NOT_SQUARE;
+    } else if (pDst->ncol != n) {
+        ResultL = MTX_SIZE_MISMATCH;
+    } else {
+        for (j = 0; j < n && MTX_OPERATION_OK == ResultL; j++) {
+            mtxScalar *const pPivotRow = &pA[n * j];
+
+            if (0 == pPivotRow[j]) {
+                ResultL = MTX_SINGULAR;
+            } else {
+                const mtxScalar t = MTX_C(1.0) / pPivotRow[j];
 
-                for (tmp = (int8_t)(row - 1); tmp >= 0; tmp--)  // tmp could be calc negative
-                {
-                    sum -= pSrcL[ncol * tmp + row] * pSrcL[ncol * tmp + col];
+                //col(k) -= Src(j,k)*col(j) for k != j, cleared pivot leaves col(j) as it is
+                pPivotRow[j] = 0;
+
+                for (row = 0; row < nrow; row++) {
+                    mtxScalar *const pRow = &pB[n * row];
+                    const mtxScalar f = pRow[j] * t;
+
+                    for (col = 0; col < n; col++) {
+                        pRow[col] -= pPivotRow[col] * f;
+                    }
+                    pRow[j] = f;
                 }
+                for (row = j + 1; row < n; row++) {
+                    mtxScalar *const pRow = &pA[n * row];
+                    const mtxScalar f = pRow[j] * t;
 
-                pSrcL[ncol * row + col] = (row == col) ? sqrt(sum) : (row < col) ? (sum / pSrcL[ncol * row + row])
-                                                                                 : 0;
+                    for (col = 0; col < n; col++) {
+                        pRow[col] -= pPivotRow[col] * f;
+                    }
+                    pRow[j] = f;
+                }
 
-                if ((row == col) && (sum <= 0)) {
-                    ResultL = MTX_NOT_POS_DEFINED;
+                //pivot row is reduced to unit row j
+                for (col = 0; col < n; col++) {
+                    pPivotRow[col] = 0;
+                }
+                pPivotRow[j] = 1;
+            }
+        }
+    }
+
+    return ResultL;
+}
+
+/**
+ * @brief Dst = alpha*Src*Vec + beta*Dst
+ * 
+ * @param pSrc Matrix (nrow x ncol)
+ * @param pVec Column vector (ncol x 1)
+ * @param pDst Column vector (nrow x 1), must not alias the sources, not read for beta == 0
+ * @param alpha Scale of the product
+ * @param beta Scale of Dst
+ * @return mtxResultInfo 
+ */
+mtxResultInfo mtx_mul_vec(const tMatrix *pSrc, const tMatrix *pVec, tMatrix *pDst, mtxScalar alpha, mtxScalar beta) {
+    mtxResultInfo ResultL = MTX_OPERATION_OK;
+
+    if (pSrc->ncol != pVec->nrow || 1 != pVec->ncol || pSrc->nrow != pDst->nrow || 1 != pDst->ncol) {
+        ResultL = MTX_SIZE_MISMATCH;
+    } else {
+        mtx_kernel_mul_vec(pDst->val, pSrc->val, pVec->val, alpha, beta, pSrc->nrow, pSrc->ncol);
+    }
+
+    return ResultL;
+}
+
+/**
+ * @brief Dst = Dst - Src1*Src2'
+ * 
+ * @param pSrc1 Matrix (nrow1 x ncol)
+ * @param pSrc2 Matrix (nrow2 x ncol)
+ * @param pDst Matrix (nrow1 x nrow2), must not alias the sources
+ * @return mtxResultInfo 
+ */
+mtxResultInfo mtx_sub_mul_src2tr(const tMatrix *pSrc1, const tMatrix *pSrc2, tMatrix *pDst) {
+    mtxResultInfo ResultL = MTX_OPERATION_OK;
+
+    if (pSrc1->ncol != pSrc2->ncol || pSrc1->nrow != pDst->nrow || pSrc2->nrow != pDst->ncol) {
+        ResultL = MTX_SIZE_MISMATCH;
+    } else {
+        mtx_kernel_sub_mul_src2tr(pDst->val, pSrc1->val, pSrc2->val, pSrc1->nrow, pSrc2->nrow, pSrc1->ncol);
+    }
+
+    return ResultL;
+}
+
+/**
+ * @brief Lower Cholesky factor of a symmetric positive semi-definite matrix.
+ * Same as mtx_chol_lower, but a zero pivot produces a zero column instead of
+ * a division by zero, so e.g. singular noise covariances can be factorized.
+ * 
+ * @param pSrc Symmetric positive semi-definite matrix, overwritten by lower factor
+ * @return mtxResultInfo MTX_NOT_POS_DEFINED only if a pivot is negative
+ */
+mtxResultInfo mtx_chol_semidef(tMatrix *pSrc) {
+    mtxResultInfo ResultL = MTX_OPERATION_OK;
+    mtxScalar *const pSrcL = pSrc->val;
+    const mtxDim n = pSrc->nrow;
+    mtxDim col, row, k;
+
+    if (pSrc->ncol == n) {
+        for (col = 0; col < n; col++) {
+            mtxScalar diag = pSrcL[n * col + col];
+
+            for (k = 0; k < col; k++) {
+                diag -= pSrcL[n * col + k] * pSrcL[n * col + k];
+            }
+
+            if (diag < 0) {
+                ResultL = MTX_NOT_POS_DEFINED;
+            }
+            diag = (diag > 0) ? MTX_SQRT(diag) : 0;
+            pSrcL[n * col + col] = diag;
+
+            for (row = 0; row < n; row++) {
+                if (row < col) {
+                    pSrcL[n * row + col] = 0;
+                } else if (row > col) {
+                    mtxScalar sum = pSrcL[n * row + col];
+
+                    for (k = 0; k < col; k++) {
+                        sum -= pSrcL[n * row + k] * pSrcL[n * col + k];
+                    }
+                    pSrcL[n * row + col] = (diag > 0) ? (sum / diag) : 0;
                 }
             }
         }
@@ -251,29 +450,201 @@ mtxResultInfo mtx_chol_upper(tMatrix *pSrc) {
     return ResultL;
 }
 
+/**
+ * @brief Rank-1 Cholesky update/downdate: L*L' = L*L' + weight*v*v'
+ * Positive weight is an update with Givens rotations of the columns of L and v, a zero
+ * pivot is rotated like any other, so an update never fails.
+ * A downdate (negative weight) first solves L*p = sqrt(-weight)*v, it fails if L is
+ * singular or |p| >= 1 (L*L' - weight*v*v' would not be positive definite) and L is
+ * unchanged then. Otherwise the rotations which carry p into sqrt(1 - |p|^2) are applied
+ * to the rows of L (LINPACK dchdd), they can not fail.
+ * 
+ * @param pSrc Lower triangular Cholesky factor (n x n), updated in place
+ * @param pVec Vector v (n x 1), destroyed during calculation
+ * @param weight Scale of the rank-1 term
+ * @return mtxResultInfo MTX_NOT_POS_DEFINED if downdated matrix is not positive definite, L is unchanged
+ */
+mtxResultInfo mtx_chol_update(tMatrix *pSrc, tMatrix *pVec, mtxScalar weight) {
+    mtxResultInfo ResultL = MTX_OPERATION_OK;
+    mtxScalar *const pL = pSrc->val;
+    mtxScalar *const pV = pVec->val;
+    const mtxDim n = pSrc->nrow;
+    const mtxScalar scale = MTX_SQRT(MTX_FABS(weight));
+    mtxDim k, i;
+
+    if (pSrc->ncol != n) {
+        ResultL = MTX_NOT_SQUARE;
+    } else if (pVec->nrow * pVec->ncol != n) {
+        ResultL = MTX_SIZE_MISMATCH;
+    } else {
+        for (k = 0; k < n; k++) {
+            pV[k] *= scale;
+        }
+
+        if (weight >= 0) {
+            for (k = 0; k < n; k++) {
+                const mtxScalar Lkk = pL[n * k + k];
+                const mtxScalar r = MTX_SQRT(Lkk * Lkk + pV[k] * pV[k]);
+
+                if (r > 0) {
+                    //rotate column k of L and v: c = Lkk/r, s = v(k)/r
+                    const mtxScalar c = Lkk / r;
+                    const mtxScalar sn = pV[k] / r;
+
+                    pL[n * k + k] = r;
+
+                    for (i = k + 1; i < n; i++) {
+                        const mtxScalar Lik = pL[n * i + k];
+
+                        pL[n * i + k] = c * Lik + sn * pV[i];
+                        pV[i] = c * pV[i] - sn * Lik;
+                    }
+                }
+            }
+        } else {
+            mtxScalar norm2 = 0;
+
+            //p = inv(L)*v in place of v
+            for (k = 0; k < n && MTX_OPERATION_OK == ResultL; k++) {
+                mtxScalar sum = pV[k];
+
+                for (i = 0; i < k; i++) {
+                    sum -= pL[n * k + i] * pV[i];
+                }
+
+                if (pL[n * k + k] > 0) {
+                    pV[k] = sum / pL[n * k + k];
+                    norm2 += pV[k] * pV[k];
+                } else {
+                    ResultL = MTX_NOT_POS_DEFINED;
+                }
+            }
+
+            if (MTX_OPERATION_OK == ResultL && norm2 < MTX_C(1.0)) {
+                mtxScalar alpha = MTX_SQRT(MTX_C(1.0) - norm2);
+
+                //rotations which zero p(k) into alpha from the last element, v(k) keeps sine s(k)
+                for (k = n; k-- > 0;) {
+                    const mtxScalar r = MTX_SQRT(alpha * alpha + pV[k] * pV[k]);
+
+                    pV[k] /= r;
+                    alpha = r;
+                }
+
+                //row k of L: rotation i acts on L(k,i) and the carried term, cosine c(i) = sqrt(1 - s(i)^2)
+                for (k = 0; k < n; k++) {
+                    mtxScalar carry = 0;
+
+                    for (i = k + 1; i-- > 0;) {
+                        const mtxScalar sn = pV[i];
+                        const mtxScalar c = MTX_SQRT((MTX_C(1.0) - sn) * (MTX_C(1.0) + sn));
+                        const mtxScalar Lki = pL[n * k + i];
+
+                        pL[n * k + i] = c * Lki - sn * carry;
+                        carry = c * carry + sn * Lki;
+                    }
+                }
+            } else {
+                ResultL = MTX_NOT_POS_DEFINED;
+            }
+        }
+    }
+
+    return ResultL;
+}
+
+/**
+ * @brief Triangularization of a compound matrix: Dst*Dst' = Src*Src'
+ * Householder reflections are applied from the right to the rows of Src
+ * (LQ decomposition Src = L*Q, i.e. L = R' of qr(Src')). Dst receives L with
+ * non-negative diagonal.
+ * 
+ * @param pSrc Compound matrix (n x m), m >= n, destroyed during calculation
+ * @param pDst Lower triangular result (n x n)
+ * @return mtxResultInfo 
+ */
+mtxResultInfo mtx_qr_lower(tMatrix *pSrc, tMatrix *pDst) {
+    mtxResultInfo ResultL = MTX_OPERATION_OK;
+    mtxScalar *const pA = pSrc->val;
+    mtxScalar *const pL = pDst->val;
+    const mtxDim n = pSrc->nrow;
+    const mtxDim m = pSrc->ncol;
+    mtxDim i, row, k;
+
+    if (pDst->nrow != n || pDst->ncol != n || m < n) {
+        ResultL = MTX_SIZE_MISMATCH;
+    } else {
+        for (i = 0; i < n; i++) {
+            mtxScalar *const pU = &pA[m * i];
+            mtxScalar norm = 0;
+            mtxScalar alpha, uu;
+
+            for (k = i; k < m; k++) {
+                norm += pU[k] * pU[k];
+            }
+            norm = MTX_SQRT(norm);
+
+            if (norm > 0) {
+                //reflect row i onto its first element: u = v - alpha*e1
+                alpha = (pU[i] > 0) ? -norm : norm;
+                uu = 2 * norm * (norm + ((pU[i] > 0) ? pU[i] : -pU[i]));
+                pU[i] -= alpha;
+
+                for (row = i + 1; row < n; row++) {
+                    mtxScalar *const pR = &pA[m * row];
+                    mtxScalar dot = 0;
+
+                    for (k = i; k < m; k++) {
+                        dot += pR[k] * pU[k];
+                    }
+                    dot = 2 * dot / uu;
+
+                    for (k = i; k < m; k++) {
+                        pR[k] -= dot * pU[k];
+                    }
+                }
+
+                pU[i] = alpha;
+                for (k = i + 1; k < m; k++) {
+                    pU[k] = 0;
+                }
+            }
+        }
+
+        for (row = 0; row < n; row++) {
+            for (k = 0; k < n; k++) {
+                //flip column sign for negative diagonal, L*L' is unchanged
+                const mtxScalar sign = (pA[m * k + k] < 0) ? -MTX_C(1.0) : MTX_C(1.0);
+
+                pL[n * row + k] = (k <= row) ? sign * pA[m * row + k] : 0;
+            }
+        }
+    }
+
+    return ResultL;
+}
+
 /**
  * @brief Matrix inverse.
  * 
- * @param pSrc Square matrix
- * @param pDst At the begining should point to identity matrix!!
- * @note  
+ * @param pSrc Square matrix, reduced to identity
+ * @param pDst Inverse, initialized to identity by the function
+ * @note  Use mtx_gj_subst or mtx_chol_solve if only Dst*inv(Src) is required
  * @return mtxResultInfo 
  */
 mtxResultInfo mtx_inv(tMatrix *pSrc, tMatrix *pDst) {
     mtxResultInfo Result = MTX_OPERATION_OK;
-    const uint8_t nrow = pSrc->nrow;
-    const uint8_t ncol = pSrc->ncol;
-    uint8_t j, i;
-    uint8_t k = 0;
-    uint8_t l = 0;
-    float s = 0;
-    float t = 0;
-
-    /* TODO: implement pDst so it doesnt need to be initialized to an identity 
-    matrix beforehand, rather in this function IvanVnucec 
-    */
+    const mtxDim nrow = pSrc->nrow;
+    const mtxDim ncol = pSrc->ncol;
+    mtxDim j, i;
+    mtxDim k = 0;
+    mtxDim l = 0;
+    mtxScalar s = 0;
+    mtxScalar t = 0;
+
+    if (nrow == ncol && pDst->nrow == nrow && pDst->ncol == ncol) {
+        (void)mtx_identity(pDst);
 
-    if (nrow == ncol) {
         for (j = 0; j < nrow; j++) {
             for (i = j; i < nrow; i++) {
                 if (0 != pSrc->val[ncol * i + j]) {
@@ -306,7 +677,8 @@ mtxResultInfo mtx_inv(tMatrix *pSrc, tMatrix *pDst) {
                 }
                 break;
             }
-            if (0 == pSrc->val[ncol * l + k]) {
+            //pivot is normalized to 1 after elimination, it stays 0 only if column j was not eliminated
+            if (0 == pSrc->val[ncol * j + j]) {
                 Result = MTX_SINGULAR;
             }
         }
@@ -326,15 +698,24 @@ mtxResultInfo mtx_inv(tMatrix *pSrc, tMatrix *pDst) {
  */
 mtxResultInfo mtx_add(tMatrix *pDst, const tMatrix *pSrc) {
     uint8_t Result = MTX_OPERATION_OK;
-    float *const pDstL = (float *)pDst->val;
-    float const *const pSrcL = (float *)pSrc->val;
-    uint16_t eIdx;
-    const uint16_t nelem = pSrc->ncol * pSrc->nrow;
+    mtxScalar *const pDstL = (mtxScalar *)pDst->val;
+    mtxScalar const *const pSrcL = (mtxScalar *)pSrc->val;
+    mtxIdx eIdx;
+    const mtxIdx nelem = (mtxIdx)pSrc->ncol * pSrc->nrow;
 
     if (pDst->ncol == pSrc->ncol && pDst->nrow == pSrc->nrow) {
+#if defined(MTX_USE_CMSIS_DSP)
+        arm_matrix_instance_f32 dst, src;
+
+        arm_mat_init_f32(&dst, pDst->nrow, pDst->ncol, pDstL);
+        arm_mat_init_f32(&src, pSrc->nrow, pSrc->ncol, (float32_t *)pSrcL);
+        Result = mtx_arm_result(arm_mat_add_f32(&dst, &src, &dst));
+        (void)eIdx, (void)nelem;
+#else
         for (eIdx = 0; eIdx < nelem; eIdx++) {
             pDstL[eIdx] += pSrcL[eIdx];
         }
+#endif
     } else {
         Result = MTX_SIZE_MISMATCH;
     }
@@ -351,15 +732,24 @@ mtxResultInfo mtx_add(tMatrix *pDst, const tMatrix *pSrc) {
  */
 mtxResultInfo mtx_sub(tMatrix *pDst, const tMatrix *pSrc) {
     uint8_t Result = MTX_OPERATION_OK;
-    float *const pDstL = (float *)pDst->val;
-    float const *const pSrcL = (float *)pSrc->val;
-    uint16_t eIdx;
-    const uint16_t nelem = pSrc->ncol * pSrc->nrow;
+    mtxScalar *const pDstL = (mtxScalar *)pDst->val;
+    mtxScalar const *const pSrcL = (mtxScalar *)pSrc->val;
+    mtxIdx eIdx;
+    const mtxIdx nelem = (mtxIdx)pSrc->ncol * pSrc->nrow;
 
     if (pDst->ncol == pSrc->ncol && pDst->nrow == pSrc->nrow) {
+#if defined(MTX_USE_CMSIS_DSP)
+        arm_matrix_instance_f32 dst, src;
+
+        arm_mat_init_f32(&dst, pDst->nrow, pDst->ncol, pDstL);
+        arm_mat_init_f32(&src, pSrc->nrow, pSrc->ncol, (float32_t *)pSrcL);
+        Result = mtx_arm_result(arm_mat_sub_f32(&dst, &src, &dst));
+        (void)eIdx, (void)nelem;
+#else
         for (eIdx = 0; eIdx < nelem; eIdx++) {
             pDstL[eIdx] -= pSrcL[eIdx];
         }
+#endif
     } else {
         Result = MTX_SIZE_MISMATCH;
     }
@@ -374,15 +764,23 @@ mtxResultInfo mtx_sub(tMatrix *pDst, const tMatrix *pSrc) {
  * @param scalar 
  * @return mtxResultInfo 
  */
-mtxResultInfo mtx_mul_scalar(tMatrix *pSrc, float scalar) {
+mtxResultInfo mtx_mul_scalar(tMatrix *pSrc, mtxScalar scalar) {
     mtxResultInfo Result = MTX_OPERATION_OK;
-    float *const pDst = pSrc->val;
-    uint16_t eIdx;
-    const uint16_t nelem = pSrc->ncol * pSrc->nrow;
+    mtxScalar *const pDst = pSrc->val;
+    mtxIdx eIdx;
+    const mtxIdx nelem = (mtxIdx)pSrc->ncol * pSrc->nrow;
+
+#if defined(MTX_USE_CMSIS_DSP)
+    arm_matrix_instance_f32 src;
 
+    arm_mat_init_f32(&src, pSrc->nrow, pSrc->ncol, pDst);
+    Result = mtx_arm_result(arm_mat_scale_f32(&src, scalar, &src));
+    (void)eIdx, (void)nelem;
+#else
     for (eIdx = 0; eIdx < nelem; eIdx++) {
         pDst[eIdx] *= scalar;
     }
+#endif
 
     return Result;
 }
@@ -394,11 +792,11 @@ mtxResultInfo mtx_mul_scalar(tMatrix *pSrc, float scalar) {
  * @param scalar 
  * @return mtxResultInfo 
  */
-mtxResultInfo mtx_sub_scalar(tMatrix *pSrc, float scalar) {
+mtxResultInfo mtx_sub_scalar(tMatrix *pSrc, mtxScalar scalar) {
     mtxResultInfo Result = MTX_OPERATION_OK;
-    float *const pDst = pSrc->val;
-    uint16_t eIdx;
-    const uint16_t nelem = pSrc->ncol * pSrc->nrow;
+    mtxScalar *const pDst = pSrc->val;
+    mtxIdx eIdx;
+    const mtxIdx nelem = (mtxIdx)pSrc->ncol * pSrc->nrow;
 
     for (eIdx = 0; eIdx < nelem; eIdx++) {
         pDst[eIdx] -= scalar;
@@ -414,11 +812,11 @@ mtxResultInfo mtx_sub_scalar(tMatrix *pSrc, float scalar) {
  * @param scalar 
  * @return mtxResultInfo 
  */
-mtxResultInfo mtx_add_scalar(tMatrix *pSrc, float scalar) {
+mtxResultInfo mtx_add_scalar(tMatrix *pSrc, mtxScalar scalar) {
     mtxResultInfo Result = MTX_OPERATION_OK;
-    float *const pDst = pSrc->val;
-    uint16_t eIdx;
-    const uint16_t nelem = pSrc->ncol * pSrc->nrow;
+    mtxScalar *const pDst = pSrc->val;
+    mtxIdx eIdx;
+    const mtxIdx nelem = (mtxIdx)pSrc->ncol * pSrc->nrow;
 
     for (eIdx = 0; eIdx < nelem; eIdx++) {
         pDst[eIdx] += scalar;
@@ -436,10 +834,10 @@ mtxResultInfo mtx_add_scalar(tMatrix *pSrc, float scalar) {
  */
 mtxResultInfo mtx_cpy(tMatrix *pDst, const tMatrix *pSrc) {
     mtxResultInfo Result = MTX_OPERATION_OK;
-    float *const pDstL = pDst->val;
-    float const *const pSrcL = pSrc->val;
-    uint16_t eIdx;
-    const uint16_t nelem = pSrc->ncol * pSrc->nrow;
+    mtxScalar *const pDstL = pDst->val;
+    mtxScalar const *const pSrcL = pSrc->val;
+    mtxIdx eIdx;
+    const mtxIdx nelem = (mtxIdx)pSrc->ncol * pSrc->nrow;
 
     if (pDst->ncol == pSrc->ncol && pDst->nrow == pSrc->nrow) {
         for (eIdx = 0; eIdx < nelem; eIdx++) {
@@ -460,16 +858,16 @@ mtxResultInfo mtx_cpy(tMatrix *pDst, const tMatrix *pSrc) {
  */
 mtxResultInfo mtx_identity(tMatrix *pSrc) {
     mtxResultInfo Result = MTX_OPERATION_OK;
-    float *const pDst = (float *)pSrc->val;
-    const uint8_t nCol = pSrc->ncol;
-    uint16_t eIdx;
-    const uint16_t nelem = pSrc->ncol * pSrc->nrow;
+    mtxScalar *const pDst = (mtxScalar *)pSrc->val;
+    const mtxDim nCol = pSrc->ncol;
+    mtxIdx eIdx;
+    const mtxIdx nelem = (mtxIdx)pSrc->ncol * pSrc->nrow;
 
     if (pSrc->nrow == nCol) {
         pDst[0] = 1;
 
         for (eIdx = 1; eIdx < nelem; eIdx++) {
-            const uint16_t cmpLeft = (uint16_t)(eIdx / nCol);
+            const mtxIdx cmpLeft = (mtxIdx)(eIdx / nCol);
 
             /* TODO: Optimize this so we initialize matrix to all zeros and then with
              * the for loop only initialize diagonals to 1.0 */
@@ -491,9 +889,9 @@ mtxResultInfo mtx_identity(tMatrix *pSrc) {
  */
 mtxResultInfo mtx_zeros(tMatrix *pSrc) {
     mtxResultInfo Result = MTX_OPERATION_OK;
-    float *const pDst = (float *)pSrc->val;
-    uint16_t eIdx;
-    const uint16_t nelem = pSrc->ncol * pSrc->nrow;
+    mtxScalar *const pDst = (mtxScalar *)pSrc->val;
+    mtxIdx eIdx;
+    const mtxIdx nelem = (mtxIdx)pSrc->ncol * pSrc->nrow;
 
     for (eIdx = 0; eIdx < nelem; eIdx++) {
         pDst[eIdx] = 0;
@@ -514,7 +912,7 @@ mtxResultInfo mtx_print(const tMatrix *A) {
 
     for (i = 0; i < A->nrow; i++) {
         for (j = 0; j < A->ncol; j++) {
-            printf("% -3.5f ", A->val[A->ncol * i + j]);
+            printf("% -3.5f ", (double)A->val[A->ncol * i + j]);
         }
         printf("\n");
     }
@@ -522,3 +920,214 @@ mtxResultInfo mtx_print(const tMatrix *A) {
 
     return Result;
 }
+
+#if defined(MTX_WIDE_INDEX)
+//! End of the tile starting at start, clipped to len
+#define MTX_BLOCK_END(start, len) ((((len) - (start)) > MTX_BLOCK) ? ((start) + MTX_BLOCK) : (len))
+
+/**
+ * @brief Cache-blocked Dst(nrow x ncol) = Src1(nrow x ninner) * Src2(ninner x ncol).
+ * MTX_BLOCK x MTX_BLOCK tiles are accumulated into Dst, the innermost loop runs
+ * along contiguous rows of Src2 and Dst instead of striding through columns.
+ *
+ * @param pSrc1 Matrix (nrow x ninner)
+ * @param pSrc2 Matrix (ninner x ncol)
+ * @param pDst Matrix (nrow x ncol), must not alias the sources
+ */
+void mtx_mul_blocked(mtxScalar const *pSrc1, mtxScalar const *pSrc2, mtxScalar *pDst, const mtxDim nrow, const mtxDim ninner, const mtxDim ncol) {
+    const mtxIdx nelem = (mtxIdx)nrow * ncol;
+    mtxIdx eIdx, row0, k0, col0;
+    mtxIdx row, k, col;
+
+    for (eIdx = 0; eIdx < nelem; eIdx++) {
+        pDst[eIdx] = 0;
+    }
+
+    for (row0 = 0; row0 < nrow; row0 += MTX_BLOCK) {
+        const mtxIdx rowEnd = MTX_BLOCK_END(row0, nrow);
+
+        for (k0 = 0; k0 < ninner; k0 += MTX_BLOCK) {
+            const mtxIdx kEnd = MTX_BLOCK_END(k0, ninner);
+
+            for (col0 = 0; col0 < ncol; col0 += MTX_BLOCK) {
+                const mtxIdx colEnd = MTX_BLOCK_END(col0, ncol);
+
+                for (row = row0; row < rowEnd; row++) {
+                    mtxScalar const *const pA = &pSrc1[ninner * row];
+                    mtxScalar *const pD = &pDst[ncol * row];
+
+                    //four rows of Src2 per pass, every Dst element is loaded and stored once per pass
+                    for (k = k0; k + 3u < kEnd; k += 4u) {
+                        const mtxScalar a0 = pA[k];
+                        const mtxScalar a1 = pA[k + 1u];
+                        const mtxScalar a2 = pA[k + 2u];
+                        const mtxScalar a3 = pA[k + 3u];
+                        mtxScalar const *const pB0 = &pSrc2[ncol * k];
+                        mtxScalar const *const pB1 = &pB0[ncol];
+                        mtxScalar const *const pB2 = &pB1[ncol];
+                        mtxScalar const *const pB3 = &pB2[ncol];
+
+                        for (col = col0; col < colEnd; col++) {
+                            pD[col] += a0 * pB0[col] + a1 * pB1[col] + a2 * pB2[col] + a3 * pB3[col];
+                        }
+                    }
+                    for (; k < kEnd; k++) {
+                        const mtxScalar a = pA[k];
+                        mtxScalar const *const pB = &pSrc2[ncol * k];
+
+                        for (col = col0; col < colEnd; col++) {
+                            pD[col] += a * pB[col];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Cache-blocked Dst(nrow1 x nrow2) = Src1(nrow1 x ncol) * Src2(nrow2 x ncol)'.
+ * Partial dot products of MTX_BLOCK row tiles of both sources are accumulated into Dst.
+ *
+ * @param pSrc1 Matrix (nrow1 x ncol)
+ * @param pSrc2 Matrix (nrow2 x ncol)
+ * @param pDst Matrix (nrow1 x nrow2), must not alias the sources
+ */
+void mtx_mul_src2tr_blocked(mtxScalar const *pSrc1, mtxScalar const *pSrc2, mtxScalar *pDst, const mtxDim nrow1, const mtxDim nrow2, const mtxDim ncol) {
+    const mtxIdx nelem = (mtxIdx)nrow1 * nrow2;
+    mtxIdx eIdx, row10, row20, k0;
+    mtxIdx rowSrc1, rowSrc2, k;
+
+    for (eIdx = 0; eIdx < nelem; eIdx++) {
+        pDst[eIdx] = 0;
+    }
+
+    for (row10 = 0; row10 < nrow1; row10 += MTX_BLOCK) {
+        const mtxIdx row1End = MTX_BLOCK_END(row10, nrow1);
+
+        for (row20 = 0; row20 < nrow2; row20 += MTX_BLOCK) {
+            const mtxIdx row2End = MTX_BLOCK_END(row20, nrow2);
+
+            for (k0 = 0; k0 < ncol; k0 += MTX_BLOCK) {
+                const mtxIdx kEnd = MTX_BLOCK_END(k0, ncol);
+
+                for (rowSrc1 = row10; rowSrc1 < row1End; rowSrc1++) {
+                    mtxScalar const *const pA = &pSrc1[ncol * rowSrc1];
+                    mtxScalar *const pD = &pDst[nrow2 * rowSrc1];
+
+                    //four independent dot products share every element of the Src1 row
+                    for (rowSrc2 = row20; rowSrc2 + 3u < row2End; rowSrc2 += 4u) {
+                        mtxScalar const *const pB0 = &pSrc2[ncol * rowSrc2];
+                        mtxScalar const *const pB1 = &pB0[ncol];
+                        mtxScalar const *const pB2 = &pB1[ncol];
+                        mtxScalar const *const pB3 = &pB2[ncol];
+                        mtxScalar sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+
+                        for (k = k0; k < kEnd; k++) {
+                            const mtxScalar a = pA[k];
+
+                            sum0 += a * pB0[k];
+                            sum1 += a * pB1[k];
+                            sum2 += a * pB2[k];
+                            sum3 += a * pB3[k];
+                        }
+                        pD[rowSrc2] += sum0;
+                        pD[rowSrc2 + 1u] += sum1;
+                        pD[rowSrc2 + 2u] += sum2;
+                        pD[rowSrc2 + 3u] += sum3;
+                    }
+                    for (; rowSrc2 < row2End; rowSrc2++) {
+                        mtxScalar const *const pB = &pSrc2[ncol * rowSrc2];
+                        mtxScalar sum = 0;
+
+                        for (k = k0; k < kEnd; k++) {
+                            sum += pA[k] * pB[k];
+                        }
+                        pD[rowSrc2] += sum;
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Cache-blocked lower Cholesky factor of Src(n x n) in place, upper triangle is cleared.
+ * Left-looking: every panel of MTX_BLOCK columns is first updated with the factor columns
+ * left of it tile by tile, then factorized. All products are dot products of contiguous rows.
+ *
+ * @param pSrc Symmetric positive definite matrix (n x n), overwritten by lower factor
+ * @param n Matrix dimension
+ * @return mtxResultInfo MTX_NOT_POS_DEFINED if a pivot is not positive
+ */
+mtxResultInfo mtx_chol_lower_blocked(mtxScalar *pSrc, const mtxDim n) {
+    mtxResultInfo ResultL = MTX_OPERATION_OK;
+    mtxIdx col0, k0;
+    mtxIdx row, col, k;
+
+    //like mtx_kernel_chol_lower the symmetric input is taken from the upper triangle
+    for (row = 1; row < n; row++) {
+        for (col = 0; col < row; col++) {
+            pSrc[n * row + col] = pSrc[n * col + row];
+        }
+    }
+
+    for (col0 = 0; col0 < n; col0 += MTX_BLOCK) {
+        const mtxIdx colEnd = MTX_BLOCK_END(col0, n);
+
+        //panel update A(col0:n, col0:colEnd) -= L(col0:n, 0:col0) * L(col0:colEnd, 0:col0)'
+        for (k0 = 0; k0 < col0; k0 += MTX_BLOCK) {
+            const mtxIdx kEnd = MTX_BLOCK_END(k0, col0);
+
+            for (row = col0; row < n; row++) {
+                mtxScalar *const pR = &pSrc[n * row];
+                const mtxIdx rowColEnd = (row < colEnd) ? (row + 1u) : colEnd;
+
+                for (col = col0; col < rowColEnd; col++) {
+                    mtxScalar const *const pC = &pSrc[n * col];
+                    mtxScalar sum = 0;
+
+                    for (k = k0; k < kEnd; k++) {
+                        sum += pR[k] * pC[k];
+                    }
+                    pR[col] -= sum;
+                }
+            }
+        }
+
+        //unblocked factorization of the panel, remaining products are inside the panel
+        for (col = col0; col < colEnd; col++) {
+            mtxScalar *const pC = &pSrc[n * col];
+            mtxScalar diag = pC[col];
+
+            for (k = col0; k < col; k++) {
+                diag -= pC[k] * pC[k];
+            }
+
+            if (diag <= 0) {
+                ResultL = MTX_NOT_POS_DEFINED;
+            }
+            diag = MTX_SQRT(diag);
+            pC[col] = diag;
+
+            for (row = col + 1u; row < n; row++) {
+                mtxScalar *const pR = &pSrc[n * row];
+                mtxScalar sum = pR[col];
+
+                for (k = col0; k < col; k++) {
+                    sum -= pR[k] * pC[k];
+                }
+                pR[col] = sum / diag;
+            }
+        }
+    }
+
+    for (row = 0; row < n; row++) {
+        for (col = row + 1u; col < n; col++) {
+            pSrc[n * row + col] = 0;
+        }
+    }
+
+    return ResultL;
+}
+#endif
@@ -11,6 +11,71 @@
 #include <math.h>
 #include <stdint.h>
 
+//! Scalar type of tMatrix and of the whole filter: single precision by default, define
+//! MTX_DOUBLE for double precision. Math functions and literals follow the scalar type,
+//! so neither build converts between float and double.
+#if defined(MTX_DOUBLE)
+typedef double mtxScalar;
+#define MTX_C(x) ((mtxScalar)(x))
+#define MTX_FABS(x) fabs(x)
+#define MTX_SIN(x) sin(x)
+#define MTX_COS(x) cos(x)
+#define MTX_ATAN2(y, x) atan2(y, x)
+#define MTX_EXP(x) exp(x)
+#define MTX_LOG(x) log(x)
+#else
+typedef float mtxScalar;
+#define MTX_C(x) (x##F)
+#define MTX_FABS(x) fabsf(x)
+#define MTX_SIN(x) sinf(x)
+#define MTX_COS(x) cosf(x)
+#define MTX_ATAN2(y, x) atan2f(y, x)
+#define MTX_EXP(x) expf(x)
+#define MTX_LOG(x) logf(x)
+#endif
+
+//! Dimension and element index types: uint8_t dimensions by default (filters up to 127 states,
+//! sLen = 2*xLen+1 <= 255). Define MTX_WIDE_INDEX for host builds of large filters: dimensions
+//! become uint16_t, element counts uint32_t, and mtx_mul, mtx_mul_src2tr and the Cholesky
+//! factorization switch to cache-blocked loops above MTX_BLOCK rows/columns.
+#if defined(MTX_WIDE_INDEX)
+typedef uint16_t mtxDim;
+typedef uint32_t mtxIdx;
+#define MTX_DIM_MAX UINT16_MAX
+#else
+typedef uint8_t mtxDim;
+typedef uint16_t mtxIdx;
+#define MTX_DIM_MAX UINT8_MAX
+#endif
+
+//! Tile edge of the blocked kernels, a tile of MTX_BLOCK x MTX_BLOCK scalars per operand should fit in L1
+#if !defined(MTX_BLOCK)
+#define MTX_BLOCK (32u)
+#endif
+
+//! Backend selection: define MTX_USE_CMSIS_DSP to map mtx_mul, mtx_mul_src2tr, mtx_add,
+//! mtx_sub and mtx_mul_scalar onto CMSIS-DSP (Cortex-M4F). The portable C code stays
+//! the reference implementation.
+#if defined(MTX_USE_CMSIS_DSP)
+#if defined(MTX_DOUBLE)
+#error "MTX_USE_CMSIS_DSP maps onto the single precision arm_*_f32 functions, it can't be combined with MTX_DOUBLE"
+#endif
+#include "arm_math.h"
+#endif
+
+//! Square root of the scalar type, no promotion to double in the single precision build (VSQRT.F32 on Cortex-M4F)
+#if defined(MTX_DOUBLE)
+#if defined(__GNUC__)
+#define MTX_SQRT(x) __builtin_sqrt(x)
+#else
+#define MTX_SQRT(x) sqrt(x)
+#endif
+#elif defined(MTX_USE_CMSIS_DSP) || defined(__GNUC__)
+#define MTX_SQRT(x) __builtin_sqrtf(x)
+#else
+#define MTX_SQRT(x) sqrtf(x)
+#endif
+
 //! Macros definiton
 #define NCOL(arr) (sizeof(arr[0]) / sizeof(arr[0][0]))
 #define NROWS(arr) (sizeof(arr) / sizeof(arr[0]))
@@ -26,33 +91,390 @@
 typedef int mtxResultInfo;
 
 typedef struct sMatrix {
-    uint8_t nrow;
-    uint8_t ncol;
-    float* val;
+    mtxDim nrow;
+    mtxDim ncol;
+    mtxScalar* val;
 } tMatrix;
 
 typedef struct sMatrixBool {
-    uint8_t nrow;
-    uint8_t ncol;
+    mtxDim nrow;
+    mtxDim ncol;
     uint8_t* val;
 } tMatrixBool;
 
-mtxResultInfo mtx_diagsum   (tMatrix *pSrc, float *diagsum);
+mtxResultInfo mtx_diagsum   (tMatrix *pSrc, mtxScalar *diagsum);
 mtxResultInfo mtx_transp_square (tMatrix *pSrc);
 mtxResultInfo mtx_transp_dest   (const tMatrix *pSrc, tMatrix *pDst);
 mtxResultInfo mtx_mul           (const tMatrix *pSrc1, const tMatrix *pSrc2, tMatrix *pDst);
 mtxResultInfo mtx_mul_src2tr    (const tMatrix *pSrc1, const tMatrix *pSrc2, tMatrix *pDst);
 mtxResultInfo mtx_chol_lower    (tMatrix *pSrc);
 mtxResultInfo mtx_chol_upper    (tMatrix *pSrc);
+mtxResultInfo mtx_chol_subst    (const tMatrix *pL, tMatrix *pDst);
+mtxResultInfo mtx_chol_solve    (tMatrix *pSrc, tMatrix *pDst);
+mtxResultInfo mtx_gj_subst      (tMatrix *pSrc, tMatrix *pDst);
+mtxResultInfo mtx_mul_vec       (const tMatrix *pSrc, const tMatrix *pVec, tMatrix *pDst, mtxScalar alpha, mtxScalar beta);
+mtxResultInfo mtx_sub_mul_src2tr (const tMatrix *pSrc1, const tMatrix *pSrc2, tMatrix *pDst);
+mtxResultInfo mtx_chol_semidef  (tMatrix *pSrc);
+mtxResultInfo mtx_chol_update   (tMatrix *pSrc, tMatrix *pVec, mtxScalar weight);
+mtxResultInfo mtx_qr_lower      (tMatrix *pSrc, tMatrix *pDst);
 mtxResultInfo mtx_inv   (tMatrix *pSrc, tMatrix *pDst);
 mtxResultInfo mtx_add   (tMatrix *pDst, const tMatrix *pSrc);
 mtxResultInfo mtx_sub   (tMatrix *pDst, const tMatrix *pSrc);
-mtxResultInfo mtx_mul_scalar    (tMatrix *pSrc, float scalar);
-mtxResultInfo mtx_sub_scalar    (tMatrix *pSrc, float scalar);
-mtxResultInfo mtx_add_scalar    (tMatrix *pSrc, float scalar);
+mtxResultInfo mtx_mul_scalar    (tMatrix *pSrc, mtxScalar scalar);
+mtxResultInfo mtx_sub_scalar    (tMatrix *pSrc, mtxScalar scalar);
+mtxResultInfo mtx_add_scalar    (tMatrix *pSrc, mtxScalar scalar);
 mtxResultInfo mtx_cpy           (tMatrix *pDst, const tMatrix *pSrc);
 mtxResultInfo mtx_identity      (tMatrix *pSrc);
 mtxResultInfo mtx_zeros         (tMatrix *pSrc);
 mtxResultInfo mtx_print         (const tMatrix *A);
 
+#if defined(MTX_WIDE_INDEX)
+void          mtx_mul_blocked        (mtxScalar const *pSrc1, mtxScalar const *pSrc2, mtxScalar *pDst, mtxDim nrow, mtxDim ninner, mtxDim ncol);
+void          mtx_mul_src2tr_blocked (mtxScalar const *pSrc1, mtxScalar const *pSrc2, mtxScalar *pDst, mtxDim nrow1, mtxDim nrow2, mtxDim ncol);
+mtxResultInfo mtx_chol_lower_blocked (mtxScalar *pSrc, mtxDim n);
+#endif
+
+//! Inline kernels with explicit dimensions. mtxLib.c uses them with runtime sizes,
+//! callers passing compile-time constants (see UKF_SPEC_DIMS in ukfLib.c) get
+//! fully unrolled fixed-size code after inlining.
+#if defined(__GNUC__)
+#define MTX_INLINE static inline __attribute__((always_inline))
+#else
+#define MTX_INLINE static inline
+#endif
+
+/**
+ * @brief Dst(nrow x ncol) = Src1(nrow x ninner) * Src2(ninner x ncol)
+ */
+MTX_INLINE void mtx_kernel_mul(mtxScalar const *pSrc1, mtxScalar const *pSrc2, mtxScalar *pDst, const mtxDim nrow, const mtxDim ninner, const mtxDim ncol) {
+    mtxDim row, col, k;
+
+#if defined(MTX_WIDE_INDEX)
+    if (nrow > MTX_BLOCK || ninner > MTX_BLOCK || ncol > MTX_BLOCK) {
+        mtx_mul_blocked(pSrc1, pSrc2, pDst, nrow, ninner, ncol);
+    } else
+#endif
+    {
+        for (row = 0; row < nrow; row++) {
+            for (col = 0; col < ncol; col++) {
+                mtxScalar sum = 0;
+
+                for (k = 0; k < ninner; k++) {
+                    sum += pSrc1[ninner * row + k] * pSrc2[ncol * k + col];
+                }
+                pDst[ncol * row + col] = sum;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Dst(nrow1 x nrow2) = Src1(nrow1 x ncol) * Src2(nrow2 x ncol)'
+ */
+MTX_INLINE void mtx_kernel_mul_src2tr(mtxScalar const *pSrc1, mtxScalar const *pSrc2, mtxScalar *pDst, const mtxDim nrow1, const mtxDim nrow2, const mtxDim ncol) {
+    mtxDim rowSrc1, rowSrc2, k;
+
+#if defined(MTX_WIDE_INDEX)
+    if (nrow1 > MTX_BLOCK || nrow2 > MTX_BLOCK || ncol > MTX_BLOCK) {
+        mtx_mul_src2tr_blocked(pSrc1, pSrc2, pDst, nrow1, nrow2, ncol);
+    } else
+#endif
+    {
+        for (rowSrc1 = 0; rowSrc1 < nrow1; rowSrc1++) {
+            for (rowSrc2 = 0; rowSrc2 < nrow2; rowSrc2++) {
+                mtxScalar sum = 0;
+
+                for (k = 0; k < ncol; k++) {
+                    sum += pSrc1[ncol * rowSrc1 + k] * pSrc2[ncol * rowSrc2 + k];
+                }
+                pDst[nrow2 * rowSrc1 + rowSrc2] = sum;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Element-wise Dst = Src, Dst += Src and Dst -= Src for nelem elements
+ */
+MTX_INLINE void mtx_kernel_cpy(mtxScalar *pDst, mtxScalar const *pSrc, const mtxIdx nelem) {
+    mtxIdx eIdx;
+
+    for (eIdx = 0; eIdx < nelem; eIdx++) {
+        pDst[eIdx] = pSrc[eIdx];
+    }
+}
+
+MTX_INLINE void mtx_kernel_add(mtxScalar *pDst, mtxScalar const *pSrc, const mtxIdx nelem) {
+    mtxIdx eIdx;
+
+    for (eIdx = 0; eIdx < nelem; eIdx++) {
+        pDst[eIdx] += pSrc[eIdx];
+    }
+}
+
+MTX_INLINE void mtx_kernel_sub(mtxScalar *pDst, mtxScalar const *pSrc, const mtxIdx nelem) {
+    mtxIdx eIdx;
+
+    for (eIdx = 0; eIdx < nelem; eIdx++) {
+        pDst[eIdx] -= pSrc[eIdx];
+    }
+}
+
+/**
+ * @brief In place lower Cholesky factor of Src(n x n), upper triangle is cleared
+ * @return mtxResultInfo MTX_NOT_POS_DEFINED if a pivot is not positive
+ */
+MTX_INLINE mtxResultInfo mtx_kernel_chol_lower(mtxScalar *pSrc, const mtxDim n) {
+    mtxResultInfo ResultL = MTX_OPERATION_OK;
+    mtxDim col, row, k;
+
+#if defined(MTX_WIDE_INDEX)
+    if (n > MTX_BLOCK) {
+        ResultL = mtx_chol_lower_blocked(pSrc, n);
+    } else
+#endif
+    {
+        for (col = 0; col < n; col++) {
+            mtxScalar rDiag = 0;
+
+            for (row = 0; row < col; row++) {
+                pSrc[n * row + col] = 0;
+            }
+
+            for (row = col; row < n; row++) {
+                mtxScalar sum = pSrc[n * col + row];
+
+                for (k = col; k-- > 0;) {
+                    sum -= pSrc[n * row + k] * pSrc[n * col + k];
+                }
+
+                if (row == col) {
+                    if (sum <= 0) {
+                        ResultL = MTX_NOT_POS_DEFINED;
+                    }
+                    pSrc[n * row + col] = MTX_SQRT(sum);
+                    //one division per column, the elements below the pivot are scaled
+                    rDiag = MTX_C(1.0) / pSrc[n * row + col];
+                } else {
+                    pSrc[n * row + col] = sum * rDiag;
+                }
+            }
+        }
+    }
+
+    return ResultL;
+}
+
+/**
+ * @brief In place lower Cholesky factor of symmetric Src(n x n) like mtx_kernel_chol_lower, but the
+ * strict upper triangle is not written: it keeps the off-diagonal elements of Src.
+ * @return mtxResultInfo MTX_NOT_POS_DEFINED if a pivot is not positive
+ */
+MTX_INLINE mtxResultInfo mtx_kernel_chol_lower_keep(mtxScalar *pSrc, const mtxDim n) {
+    mtxResultInfo ResultL = MTX_OPERATION_OK;
+    mtxDim col, row, k;
+
+    for (col = 0; col < n; col++) {
+        mtxScalar rDiag = 0;
+
+        for (row = col; row < n; row++) {
+            //Src(row, col) is read from the upper triangle, which is never overwritten
+            mtxScalar sum = pSrc[n * col + row];
+
+            for (k = col; k-- > 0;) {
+                sum -= pSrc[n * row + k] * pSrc[n * col + k];
+            }
+
+            if (row == col) {
+                if (sum <= 0) {
+                    ResultL = MTX_NOT_POS_DEFINED;
+                }
+                pSrc[n * row + col] = MTX_SQRT(sum);
+                rDiag = MTX_C(1.0) / pSrc[n * row + col];
+            } else {
+                pSrc[n * row + col] = sum * rDiag;
+            }
+        }
+    }
+
+    return ResultL;
+}
+
+/**
+ * @brief In place Src(n x n) = L*L' of lower Cholesky factor L, inverse of mtx_kernel_chol_lower.
+ * Elements are evaluated backwards, so every factor element is read before it is overwritten.
+ */
+MTX_INLINE void mtx_kernel_chol_product(mtxScalar *pSrc, const mtxDim n) {
+    mtxDim row, col, k;
+
+    for (row = n; row-- > 0;) {
+        for (col = row + 1; col-- > 0;) {
+            mtxScalar sum = 0;
+
+            for (k = 0; k <= col; k++) {
+                sum += pSrc[n * row + k] * pSrc[n * col + k];
+            }
+            pSrc[n * row + col] = sum;
+            pSrc[n * col + row] = sum;
+        }
+    }
+}
+
+/**
+ * @brief Symmetric Dst(n x n) -= Src1(n x ncol) * Src2(n x ncol)', only the lower
+ * triangle is evaluated and mirrored, so Dst stays exactly symmetric
+ */
+MTX_INLINE void mtx_kernel_sub_mul_src2tr_sym(mtxScalar *pDst, mtxScalar const *pSrc1, mtxScalar const *pSrc2, const mtxDim n, const mtxDim ncol) {
+    mtxDim row, col, k;
+
+    for (row = 0; row < n; row++) {
+        for (col = 0; col <= row; col++) {
+            mtxScalar sum = 0;
+
+            for (k = 0; k < ncol; k++) {
+                sum += pSrc1[ncol * row + k] * pSrc2[ncol * col + k];
+            }
+            pDst[n * row + col] -= sum;
+            pDst[n * col + row] = pDst[n * row + col];
+        }
+    }
+}
+
+/**
+ * @brief Dst(nrow1 x nrow2) -= Src1(nrow1 x ncol) * Src2(nrow2 x ncol)', fused product
+ * and subtraction without a temporary matrix
+ */
+MTX_INLINE void mtx_kernel_sub_mul_src2tr(mtxScalar *pDst, mtxScalar const *pSrc1, mtxScalar const *pSrc2, const mtxDim nrow1, const mtxDim nrow2, const mtxDim ncol) {
+    mtxDim rowSrc1, rowSrc2, k;
+
+    for (rowSrc1 = 0; rowSrc1 < nrow1; rowSrc1++) {
+        for (rowSrc2 = 0; rowSrc2 < nrow2; rowSrc2++) {
+            mtxScalar sum = 0;
+
+            for (k = 0; k < ncol; k++) {
+                sum += pSrc1[ncol * rowSrc1 + k] * pSrc2[ncol * rowSrc2 + k];
+            }
+            pDst[nrow2 * rowSrc1 + rowSrc2] -= sum;
+        }
+    }
+}
+
+/**
+ * @brief Dst(nrow) = alpha*Src(nrow x ncol)*Vec(ncol) + beta*Dst(nrow),
+ * Dst is not read for beta == 0
+ */
+MTX_INLINE void mtx_kernel_mul_vec(mtxScalar *pDst, mtxScalar const *pSrc, mtxScalar const *pVec, const mtxScalar alpha, const mtxScalar beta, const mtxDim nrow, const mtxDim ncol) {
+    mtxDim row, k;
+
+    for (row = 0; row < nrow; row++) {
+        mtxScalar sum = 0;
+
+        for (k = 0; k < ncol; k++) {
+            sum += pSrc[ncol * row + k] * pVec[k];
+        }
+        pDst[row] = (0 == beta) ? (alpha * sum) : (alpha * sum + beta * pDst[row]);
+    }
+}
+
+/**
+ * @brief In place Src(nrow x ncol) -= mean*ones(1, ncol), every row is centered by its mean(nrow)
+ */
+MTX_INLINE void mtx_kernel_center_rows(mtxScalar *pSrc, mtxScalar const *pMean, const mtxDim nrow, const mtxDim ncol) {
+    mtxDim row, col;
+
+    for (row = 0; row < nrow; row++) {
+        mtxScalar *const pRow = &pSrc[ncol * row];
+        const mtxScalar mean = pMean[row];
+
+        for (col = 0; col < ncol; col++) {
+            pRow[col] -= mean;
+        }
+    }
+}
+
+/**
+ * @brief Weighted dot product sum(W(k)*Src1(k)*Src2(k)) of n elements
+ */
+MTX_INLINE mtxScalar mtx_kernel_wdot(mtxScalar const *pSrc1, mtxScalar const *pSrc2, mtxScalar const *pW, const mtxDim n) {
+    mtxScalar sum = 0;
+    mtxDim k;
+
+    for (k = 0; k < n; k++) {
+        sum += pW[k] * pSrc1[k] * pSrc2[k];
+    }
+
+    return sum;
+}
+
+/**
+ * @brief Dst(nrow x n) = Dst*inv(L*L') with lower Cholesky factor L(n x n)
+ * Column i of all rows of Dst is solved before column i+1, so the reciprocal of L(i,i) is
+ * taken once per column. Both passes read row i of L and the rows of Dst contiguously,
+ * the forward pass L*z = b as dot product with z(0:i-1), the backward pass L'*x = z by
+ * subtracting x(i)*L(i,0:i-1). Rows are solved in pairs to share the loads of L.
+ */
+MTX_INLINE void mtx_kernel_chol_subst(mtxScalar const *pL, mtxScalar *pDst, const mtxDim nrow, const mtxDim n) {
+    mtxDim row, i, k;
+
+    //forward substitution L*z = b
+    for (i = 0; i < n; i++) {
+        mtxScalar const *const pLi = &pL[n * i];
+        const mtxScalar rDiag = MTX_C(1.0) / pLi[i];
+
+        for (row = 0; row + 1u < nrow; row += 2u) {
+            mtxScalar *const pB0 = &pDst[n * row];
+            mtxScalar *const pB1 = &pB0[n];
+            mtxScalar sum0 = pB0[i];
+            mtxScalar sum1 = pB1[i];
+
+            for (k = 0; k < i; k++) {
+                sum0 -= pLi[k] * pB0[k];
+                sum1 -= pLi[k] * pB1[k];
+            }
+            pB0[i] = sum0 * rDiag;
+            pB1[i] = sum1 * rDiag;
+        }
+        if (row < nrow) {
+            mtxScalar *const pB0 = &pDst[n * row];
+            mtxScalar sum0 = pB0[i];
+
+            for (k = 0; k < i; k++) {
+                sum0 -= pLi[k] * pB0[k];
+            }
+            pB0[i] = sum0 * rDiag;
+        }
+    }
+
+    //backward substitution L'*x = z
+    for (i = n; i-- > 0;) {
+        mtxScalar const *const pLi = &pL[n * i];
+        const mtxScalar rDiag = MTX_C(1.0) / pLi[i];
+
+        for (row = 0; row + 1u < nrow; row += 2u) {
+            mtxScalar *const pB0 = &pDst[n * row];
+            mtxScalar *const pB1 = &pB0[n];
+            const mtxScalar x0 = pB0[i] * rDiag;
+            const mtxScalar x1 = pB1[i] * rDiag;
+
+            pB0[i] = x0;
+            pB1[i] = x1;
+            for (k = 0; k < i; k++) {
+                const mtxScalar l = pLi[k];
+
+                pB0[k] -= l * x0;
+                pB1[k] -= l * x1;
+            }
+        }
+        if (row < nrow) {
+            mtxScalar *const pB0 = &pDst[n * row];
+            const mtxScalar x0 = pB0[i] * rDiag;
+
+            pB0[i] = x0;
+            for (k = 0; k < i; k++) {
+                pB0[k] -= pLi[k] * x0;
+            }
+        }
+    }
+}
+
 #endif
@@ -0,0 +1,242 @@
+/**
+ * @file rngCfg.c
+ * @brief Config file of the rng model, generated by ukfGen.c from rng.ukf, do not edit.
+ * 
+ * State vector
+ * x[0] = n(k)
+ * x[1] = e(k)
+ * x[2] = ndot(k)
+ * x[3] = edot(k)
+ * 
+ * Measurement vector
+ * y[0] = y1(k)
+ * y[1] = y2(k)
+ */
+
+#include "rngCfg.h"
+#include <stdint.h>
+#include <math.h>
+
+static void FxBatch(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, mtxDim sigmaIdx, mtxDim sigmaCnt, mtxScalar dT);
+static void HyBatch(tMatrix* pu, tMatrix* pX_m, tMatrix* pY_m, mtxDim sigmaIdx, mtxDim sigmaCnt);
+
+#if defined(UKF_SIGMA_MAJOR)
+static void FxVec(mtxScalar const *pu_p, mtxScalar *px, mtxScalar dT);
+static void HyVec(mtxScalar const *pu, mtxScalar const *px_m, mtxScalar *py_m);
+#endif
+
+//! UKF Processing matrix
+static mtxScalar Sc_vector[1][3] = {{1, 2, 0}};
+static mtxScalar Wm_weight_vector[1][RNG_SLEN];
+static mtxScalar Wc_weight_vector[1][RNG_SLEN];
+static mtxScalar y_meas[RNG_LY][1];
+static uint8_t y_meas_valid[RNG_LY][1] = {{1}, {1}};
+static mtxScalar y_predicted_mean[RNG_LY][1];
+static mtxScalar x_system_states[RNG_LX][1] = {{0}, {0}, {50}, {50}};
+static mtxScalar x_system_states_ic[RNG_LX][1] = {{0}, {0}, {50}, {50}};
+#if defined(UKF_SIGMA_MAJOR)
+//! Sigma points X(k-1), X(k|k-1) and Y(k|k-1) = y_m: one row per sigma point
+static mtxScalar X_sigma_points[RNG_SLEN][RNG_LX];
+static mtxScalar Y_sigma_points[RNG_SLEN][RNG_LY];
+#else
+//! Sigma points X(k-1), X(k|k-1) and Y(k|k-1) = y_m
+static mtxScalar X_sigma_points[RNG_LX][RNG_SLEN];
+static mtxScalar Y_sigma_points[RNG_LY][RNG_SLEN];
+#endif
+
+//! State covariance  P(k|k-1) = P_m, P(k)= P
+static mtxScalar Pxx_error_covariance[RNG_LX][RNG_LX];
+
+//! State covariance initial values
+static mtxScalar Pxx0_init_error_covariance[RNG_LX][RNG_LX] =
+    {
+        /* n, e, ndot, edot */
+        {1, 0, 0, 0}, /* n */
+        {0, 1, 0, 0}, /* e */
+        {0, 0, 1, 0}, /* ndot */
+        {0, 0, 0, 1}, /* edot */
+};
+
+//! Process noise covariance Q
+static mtxScalar Qxx_process_noise_cov[RNG_LX][RNG_LX] =
+    {
+        /* n, e, ndot, edot */
+        {0, 0, 0, 0}, /* n */
+        {0, 0, 0, 0}, /* e */
+        {0, 0, 4, 0}, /* ndot */
+        {0, 0, 0, 4}, /* edot */
+};
+
+//! Output noise covariance R
+static mtxScalar Ryy0_init_out_covariance[RNG_LY][RNG_LY] =
+    {
+        /* y1, y2 */
+        {1, 0}, /* y1 */
+        {0, 1}, /* y2 */
+};
+
+//! Output covariance Pyy and cross-covariance of state and output Pxy
+static mtxScalar Pyy_out_covariance[RNG_LY][RNG_LY];
+static mtxScalar Pxy_cross_covariance[RNG_LX][RNG_LY];
+
+//! Square-root UKF buffers (UKF_MODE_SQRT): sqrt(Q), sqrt(R) and QR compound workspace of max(RNG_LX, RNG_LY) rows
+static mtxScalar Sqxx_process_noise_sqrt[RNG_LX][RNG_LX];
+static mtxScalar Sryy_out_noise_sqrt[RNG_LY][RNG_LY];
+static mtxScalar Sr_compound_workspace[RNG_LX][RNG_SLEN + RNG_LX];
+
+//! Kalman gain and the square-root downdate column have no arrays of their own: step temporaries
+//! with disjoint lifetimes share storage like in ukf_mem_layout()
+tUkfMatrix RngMatrixCfg = {
+    .Sc_vector                      = {NROWS(Sc_vector), NCOL(Sc_vector), &Sc_vector[0][0]},
+    .Wm_weight_vector               = {NROWS(Wm_weight_vector), NCOL(Wm_weight_vector), &Wm_weight_vector[0][0]},
+    .Wc_weight_vector               = {NROWS(Wc_weight_vector), NCOL(Wc_weight_vector), &Wc_weight_vector[0][0]},
+    .x_system_states                = {NROWS(x_system_states), NCOL(x_system_states), &x_system_states[0][0]},
+    .x_system_states_ic             = {NROWS(x_system_states_ic), NCOL(x_system_states_ic), &x_system_states_ic[0][0]},
+    .x_system_states_limits         = {0, 0, NULL},
+    .x_system_states_limits_enable  = {0, 0, NULL},
+    .x_system_states_correction     = {RNG_LX, 1, &Sr_compound_workspace[0][0]},
+    .u_system_input                 = {0, 0, NULL},
+    .u_prev_system_input            = {0, 0, NULL},
+    .X_sigma_points                 = {NROWS(X_sigma_points), NCOL(X_sigma_points), &X_sigma_points[0][0]},
+    .Y_sigma_points                 = {NROWS(Y_sigma_points), NCOL(Y_sigma_points), &Y_sigma_points[0][0]},
+    .y_predicted_mean               = {NROWS(y_predicted_mean), NCOL(y_predicted_mean), &y_predicted_mean[0][0]},
+    .y_meas                         = {NROWS(y_meas), NCOL(y_meas), &y_meas[0][0]},
+    .y_meas_valid                   = {NROWS(y_meas_valid), NCOL(y_meas_valid), &y_meas_valid[0][0]},
+    .Pyy_out_covariance             = {NROWS(Pyy_out_covariance), NCOL(Pyy_out_covariance), &Pyy_out_covariance[0][0]},
+    .Pyy_out_covariance_copy        = {0, 0, NULL},
+    .Ryy0_init_out_covariance       = {NROWS(Ryy0_init_out_covariance), NCOL(Ryy0_init_out_covariance), &Ryy0_init_out_covariance[0][0]},
+    .Pxy_cross_covariance           = {NROWS(Pxy_cross_covariance), NCOL(Pxy_cross_covariance), &Pxy_cross_covariance[0][0]},
+    .Pxx_error_covariance           = {NROWS(Pxx_error_covariance), NCOL(Pxx_error_covariance), &Pxx_error_covariance[0][0]},
+    .Pxx0_init_error_covariance     = {NROWS(Pxx0_init_error_covariance), NCOL(Pxx0_init_error_covariance), &Pxx0_init_error_covariance[0][0]},
+    .Qxx_process_noise_cov          = {NROWS(Qxx_process_noise_cov), NCOL(Qxx_process_noise_cov), &Qxx_process_noise_cov[0][0]},
+    .K_kalman_gain                  = {RNG_LX, RNG_LY, &Y_sigma_points[0][0]},
+    .I_identity_matrix              = {0, 0, NULL},
+    .Pxx_covariance_correction      = {0, 0, NULL},
+    .Sqxx_process_noise_sqrt        = {NROWS(Sqxx_process_noise_sqrt), NCOL(Sqxx_process_noise_sqrt), &Sqxx_process_noise_sqrt[0][0]},
+    .Sryy_out_noise_sqrt            = {NROWS(Sryy_out_noise_sqrt), NCOL(Sryy_out_noise_sqrt), &Sryy_out_noise_sqrt[0][0]},
+    .Sr_compound_workspace          = {NROWS(Sr_compound_workspace), NCOL(Sr_compound_workspace), &Sr_compound_workspace[0][0]},
+    .F_state_transition             = {0, 0, NULL},
+    .B_input_matrix                 = {0, 0, NULL},
+    .fcnPredict                     = NULL,
+    .fcnObserve                     = NULL,
+    .fcnPredictBatch                = &FxBatch,
+    .fcnObserveBatch                = &HyBatch,
+#if defined(UKF_SIGMA_MAJOR)
+    .fcnPredictVec                  = &FxVec,
+    .fcnObserveVec                  = &HyVec,
+#endif
+    .dT                             = MTX_C(0.1),
+    .filter_mode                    = UKF_MODE_STANDARD,
+    .update_mode                    = UKF_UPDATE_AUTO,
+    .sigma_scheme                   = UKF_SIGMA_SYMMETRIC
+};
+
+/**
+ * @brief Fused prediction of all states for sigma columns [sigmaIdx, sigmaIdx + sigmaCnt).
+ * n = n + dT*ndot
+ * e = e + dT*edot
+ * ndot = ndot
+ * edot = edot
+ * 
+ * @param pu_p Input u(k-1), NULL for this system
+ * @param pX_p Pointer to the sigma points array at (k-1) moment
+ * @param pX_m Pointer to the propagated sigma points array at (k|k-1) moment, same memory as pX_p
+ * @param sigmaIdx First sigma point index.
+ * @param sigmaCnt Number of sigma points to propagate.
+ * @param dT Sampling time.
+ */
+static void FxBatch(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, mtxDim sigmaIdx, mtxDim sigmaCnt, mtxScalar dT) {
+    const mtxDim sigmaEnd = sigmaIdx + sigmaCnt;
+    mtxDim sIdx;
+
+    for (sIdx = sigmaIdx; sIdx < sigmaEnd; sIdx++) {
+        const mtxScalar x_n = UKF_SIGMA_AT(pX_p, 0, sIdx);
+        const mtxScalar x_e = UKF_SIGMA_AT(pX_p, 1, sIdx);
+        const mtxScalar x_ndot = UKF_SIGMA_AT(pX_p, 2, sIdx);
+        const mtxScalar x_edot = UKF_SIGMA_AT(pX_p, 3, sIdx);
+
+        UKF_SIGMA_AT(pX_m, 0, sIdx) = x_n + dT * x_ndot;
+        UKF_SIGMA_AT(pX_m, 1, sIdx) = x_e + dT * x_edot;
+        //ndot(k|k-1) = ndot(k-1) stays in place
+        //edot(k|k-1) = edot(k-1) stays in place
+    }
+
+    (void)pu_p;
+}
+
+/**
+ * @brief Fused observation of all outputs for sigma columns [sigmaIdx, sigmaIdx + sigmaCnt).
+ * y1 = sqrt((n - N1)^2 + (e - E1)^2)
+ * y2 = sqrt((n - N2)^2 + (e - E2)^2)
+ * 
+ * @param pu Input u(k), NULL for this system
+ * @param pX_m Pointer to the propagated sigma points array at (k|k-1) moment
+ * @param pY_m Pointer to the output sigma points array at (k|k-1) moment
+ * @param sigmaIdx First sigma point index.
+ * @param sigmaCnt Number of sigma points to propagate.
+ */
+static void HyBatch(tMatrix* pu, tMatrix* pX_m, tMatrix* pY_m, mtxDim sigmaIdx, mtxDim sigmaCnt) {
+    const mtxDim sigmaEnd = sigmaIdx + sigmaCnt;
+    mtxDim sIdx;
+
+    for (sIdx = sigmaIdx; sIdx < sigmaEnd; sIdx++) {
+        const mtxScalar x_n = UKF_SIGMA_AT(pX_m, 0, sIdx);
+        const mtxScalar x_e = UKF_SIGMA_AT(pX_m, 1, sIdx);
+        const mtxScalar t0 = x_n - MTX_C(20.0);
+        const mtxScalar t1 = x_e - MTX_C(20.0);
+
+        UKF_SIGMA_AT(pY_m, 0, sIdx) = MTX_SQRT(t0 * t0 + x_e * x_e);
+        UKF_SIGMA_AT(pY_m, 1, sIdx) = MTX_SQRT(x_n * x_n + t1 * t1);
+    }
+
+    (void)pu;
+}
+
+#if defined(UKF_SIGMA_MAJOR)
+/**
+ * @brief Prediction of one dense sigma point (UKF_SIGMA_MAJOR).
+ * n = n + dT*ndot
+ * e = e + dT*edot
+ * ndot = ndot
+ * edot = edot
+ * 
+ * @param pu_p Input u(k-1), NULL for this system
+ * @param px Sigma point X_p(i) on entry, X_m(i) on return
+ * @param dT Sampling time.
+ */
+static void FxVec(mtxScalar const *pu_p, mtxScalar *px, mtxScalar dT) {
+    const mtxScalar x_n = px[0];
+    const mtxScalar x_e = px[1];
+    const mtxScalar x_ndot = px[2];
+    const mtxScalar x_edot = px[3];
+
+    px[0] = x_n + dT * x_ndot;
+    px[1] = x_e + dT * x_edot;
+    //ndot(k|k-1) = ndot(k-1) stays in place
+    //edot(k|k-1) = edot(k-1) stays in place
+
+    (void)pu_p;
+}
+
+/**
+ * @brief Observation of one dense sigma point (UKF_SIGMA_MAJOR).
+ * y1 = sqrt((n - N1)^2 + (e - E1)^2)
+ * y2 = sqrt((n - N2)^2 + (e - E2)^2)
+ * 
+ * @param pu Input u(k), NULL for this system
+ * @param px_m Propagated sigma point X_m(i)
+ * @param py_m Output sigma point Y_m(i)
+ */
+static void HyVec(mtxScalar const *pu, mtxScalar const *px_m, mtxScalar *py_m) {
+    const mtxScalar x_n = px_m[0];
+    const mtxScalar x_e = px_m[1];
+    const mtxScalar t0 = x_n - MTX_C(20.0);
+    const mtxScalar t1 = x_e - MTX_C(20.0);
+
+    py_m[0] = MTX_SQRT(t0 * t0 + x_e * x_e);
+    py_m[1] = MTX_SQRT(x_n * x_n + t1 * t1);
+
+    (void)pu;
+}
+
+#endif
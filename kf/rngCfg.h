@@ -0,0 +1,24 @@
+/**
+ * @file rngCfg.h
+ * @brief Config header of the rng model, generated by ukfGen.c from rng.ukf, do not edit.
+ */
+
+#ifndef RNGCFG_H
+#define RNGCFG_H
+
+#include "ukfLib.h"
+
+#define RNG_LX (4u)
+#define RNG_LY (2u)
+#define RNG_SLEN (9u)  //UKF_SIGMA_LEN(RNG_LX, UKF_SIGMA_SYMMETRIC)
+
+//! Dimensions ukf_step() is specialized for when ukfLib.c is built with -DUKF_SPEC_HEADER='"rngCfg.h"'
+#ifndef UKF_SPEC_DIMS
+#define UKF_SPEC_DIMS UKF_SPEC(RNG_LX, RNG_LY)
+#endif
+
+extern tUkfMatrix RngMatrixCfg;
+
+void ukf_test_rng(void);
+
+#endif /* RNGCFG_H */
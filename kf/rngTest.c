@@ -0,0 +1,94 @@
+/**
+ * @file rngTest.c
+ * @brief Regression test of the rng model, generated by ukfGen.c from rng.ukf, do not edit.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include "rngCfg.h"
+
+#define RNG_TEST_EPS (0.001)
+#define RNG_REF_LEN (14u)
+
+//! Measurements of the reference steps
+static const mtxScalar RngRefY[RNG_REF_LEN][RNG_LY] = {
+    {16.085992708563385, 16.75082142087498},
+    {12.714829185978214, 14.277640835870006},
+    {14.52850099445766, 16.32075405160052},
+    {19.105561355310275, 20.56046030350385},
+    {23.252820029388918, 24.827446289454556},
+    {29.282949862903255, 31.290961393448615},
+    {36.270058819651275, 36.85355345756021},
+    {44.244884173240955, 42.15728318345352},
+    {47.39424312112441, 49.38283523096149},
+    {55.98890545918046, 57.51631966968468},
+    {61.66745094156211, 65.6644962835091},
+    {68.62498030161365, 71.4287127557327},
+    {76.3379638723931, 79.24172089422308},
+    {82.61132569083516, 84.90276032891568}
+};
+
+//! Expected states x(k|k) of the reference steps
+static const mtxScalar RngRefX[RNG_REF_LEN][RNG_LX] = {
+    {4.901482729572258, 4.576939885855807, 49.99034292124646, 49.9581344633278},
+    {10.103304943868373, 9.40913572081583, 50.22654471620532, 49.75079500424223},
+    {15.132069573131298, 14.138974122835807, 50.4295408901476, 49.191128327737864},
+    {20.32282382434841, 19.09691976399138, 50.83686077243901, 49.18958020788674},
+    {24.940146120267713, 23.39975864710546, 49.57738659507256, 47.38381338266045},
+    {30.021901202161214, 27.88214508905012, 49.977568320123794, 46.551744562547626},
+    {34.84413703651911, 32.75389169343509, 49.47400620502736, 47.190693993547214},
+    {39.04878332941925, 38.499098203031146, 47.6061997253759, 50.00111373036392},
+    {43.88308549825616, 42.38333130768954, 47.20965723269507, 46.747611757031784},
+    {49.4799411902075, 47.25598055968778, 49.911944505272395, 47.887236233284476},
+    {55.928745858553086, 51.18027035791688, 53.47254296494413, 46.51055854324935},
+    {61.636426955126616, 55.27541564933416, 54.0521265226328, 45.2628153922652},
+    {67.75562236965202, 59.60209686866173, 55.881393486598796, 45.32676610450929},
+    {73.04576344496716, 63.83818785273999, 54.78215979134001, 44.29141509985664}
+};
+
+/**
+ * @brief Run the generated rng configuration against its reference steps in every filter mode of the model
+ */
+void ukf_test_rng(void) {
+    static const uint8_t filterMode[2] = {UKF_MODE_STANDARD, UKF_MODE_SQRT};
+    static const char *const modeName[2] = {"standard", "square-root"};
+    uint8_t mIdx;
+
+    for (mIdx = 0; mIdx < 2u; mIdx++) {
+        tUKF ukfIo;
+
+        RngMatrixCfg.filter_mode = filterMode[mIdx];
+        if (0 == ukf_init(&ukfIo, &RngMatrixCfg)) {
+            mtxScalar absErrAccum[RNG_LX] = {0};
+            uint32_t simLoop;
+            mtxDim idx;
+
+            for (simLoop = 0; simLoop < RNG_REF_LEN; simLoop++) {
+                for (idx = 0; idx < RNG_LY; idx++) {
+                    ukfIo.input.y.val[idx] = RngRefY[simLoop][idx];
+                }
+
+                (void) ukf_step(&ukfIo);
+
+                //accumulate the difference between the reference and the generated configuration
+                for (idx = 0; idx < RNG_LX; idx++) {
+                    absErrAccum[idx] += MTX_FABS(ukfIo.update.x.val[idx] - RngRefX[simLoop][idx]);
+                }
+            }
+
+            printf("Accumulated error between reference and rngCfg.c (%s)\n", modeName[mIdx]);
+            for (idx = 0; idx < RNG_LX; idx++) {
+                if (!(fabs(absErrAccum[idx]) <= RNG_TEST_EPS)) {
+                    printf("ERROR: Accumulated error absErrAccum[%u] is too big: %.6e > %.6e\n", (unsigned)idx, absErrAccum[idx], RNG_TEST_EPS);
+                } else {
+                    printf("%u. SUCCESS! %.6e < %.6e\n", (unsigned)idx + 1u, absErrAccum[idx], RNG_TEST_EPS);
+                }
+            }
+        } else {
+            printf("ERROR: initialization of rngCfg.c fails (%s)\n", modeName[mIdx]);
+        }
+    }
+    RngMatrixCfg.filter_mode = filterMode[0];
+}
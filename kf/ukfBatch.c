@@ -0,0 +1,605 @@
+/**
+ * @file ukfBatch.c
+ * @brief Lockstep additive noise UKF for many filters of the same model.
+ * States, covariances and sigma points of nFilt filters are interleaved in a
+ * structure of arrays layout: every matrix element owns nFilt contiguous lanes.
+ * All loops run over the lanes in the innermost position, so the compiler can
+ * vectorize sigma generation, means, covariances and the update across filters.
+ * The math follows ukf_step() in UKF_MODE_STANDARD with the Cholesky gain solve.
+ * Factorization faults are kept per lane, a faulty lane never feeds NaN into the others.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ukfBatch.h"
+#include "ukfMem.h"
+
+#define UKF_BATCH_ROUND(size) (((size) + (UKF_MEM_ALIGN - 1u)) & ~(uint32_t)(UKF_MEM_ALIGN - 1u))
+
+static uint32_t ukf_batch_assign    (tUkfBatch *pBatch, uint8_t *pBase, mtxDim xLen, mtxDim yLen, uint32_t nFilt);
+static uint8_t*     ukf_batch_take_bytes(uint8_t **ppCur, uint32_t *pUsed, uint32_t size);
+static mtxScalar*   ukf_batch_take      (uint8_t **ppCur, uint32_t *pUsed, uint32_t nelem);
+static void     ukf_batch_chol      (mtxScalar *pA, mtxDim n, uint32_t nFilt, mtxScalar *pInv, uint8_t *pFault, uint8_t fault);
+static void     ukf_batch_subst     (const mtxScalar *pL, mtxScalar *pB, mtxDim nrow, mtxDim n, uint32_t nFilt);
+
+/**
+ * @brief Reserve one aligned buffer
+ *
+ * @param ppCur Current position in memory block, NULL content if only size is calculated
+ * @param pUsed Accumulated number of bytes
+ * @param size Number of bytes
+ * @return uint8_t* Buffer address or NULL during size calculation
+ */
+static uint8_t* ukf_batch_take_bytes(uint8_t **ppCur, uint32_t *pUsed, uint32_t size) {
+    uint8_t *const pVal = *ppCur;
+
+    size = UKF_BATCH_ROUND(size);
+    if (NULL != *ppCur) {
+        *ppCur += size;
+    }
+    *pUsed += size;
+
+    return pVal;
+}
+
+/**
+ * @brief Reserve one aligned scalar buffer
+ *
+ * @param ppCur Current position in memory block, NULL content if only size is calculated
+ * @param pUsed Accumulated number of bytes
+ * @param nelem Number of scalar elements
+ * @return mtxScalar* Buffer address or NULL during size calculation
+ */
+static mtxScalar* ukf_batch_take(uint8_t **ppCur, uint32_t *pUsed, uint32_t nelem) {
+    return (mtxScalar *)(void *)ukf_batch_take_bytes(ppCur, pUsed, nelem * (uint32_t)sizeof(mtxScalar));
+}
+
+/**
+ * @brief Assign all batch buffers from memory block (or only count bytes if pBase is NULL)
+ *
+ * @param pBatch Batch working structure
+ * @param pBase Aligned memory block or NULL
+ * @param xLen Number of states
+ * @param yLen Number of measurements
+ * @param nFilt Number of filters
+ * @return uint32_t Number of bytes used
+ */
+static uint32_t ukf_batch_assign(tUkfBatch *pBatch, uint8_t *pBase, mtxDim xLen, mtxDim yLen, uint32_t nFilt) {
+    const uint32_t sLen = 2u * xLen + 1u;
+    uint8_t *pCur = pBase;
+    uint32_t used = 0;
+
+    pBatch->xLen = xLen;
+    pBatch->yLen = yLen;
+    pBatch->sLen = (mtxDim)sLen;
+    pBatch->nFilt = nFilt;
+    pBatch->Wm   = ukf_batch_take(&pCur, &used, sLen);
+    pBatch->Wc   = ukf_batch_take(&pCur, &used, sLen);
+    pBatch->Qxx  = ukf_batch_take(&pCur, &used, (uint32_t)xLen * xLen);
+    pBatch->Ryy0 = ukf_batch_take(&pCur, &used, (uint32_t)yLen * yLen);
+    pBatch->x    = ukf_batch_take(&pCur, &used, (uint32_t)xLen * nFilt);
+    pBatch->Pxx  = ukf_batch_take(&pCur, &used, (uint32_t)xLen * xLen * nFilt);
+    pBatch->X_p  = ukf_batch_take(&pCur, &used, (uint32_t)xLen * sLen * nFilt);
+    pBatch->X_m  = ukf_batch_take(&pCur, &used, (uint32_t)xLen * sLen * nFilt);
+    pBatch->Y_m  = ukf_batch_take(&pCur, &used, (uint32_t)yLen * sLen * nFilt);
+    pBatch->y_m  = ukf_batch_take(&pCur, &used, (uint32_t)yLen * nFilt);
+    pBatch->y    = ukf_batch_take(&pCur, &used, (uint32_t)yLen * nFilt);
+    pBatch->Pyy  = ukf_batch_take(&pCur, &used, (uint32_t)yLen * yLen * nFilt);
+    pBatch->Pxy  = ukf_batch_take(&pCur, &used, (uint32_t)xLen * yLen * nFilt);
+    pBatch->K    = ukf_batch_take(&pCur, &used, (uint32_t)xLen * yLen * nFilt);
+    pBatch->tmp  = ukf_batch_take(&pCur, &used, nFilt);
+    pBatch->fault = ukf_batch_take_bytes(&pCur, &used, nFilt);
+
+    return used;
+}
+
+/**
+ * @brief Number of bytes required by ukf_batch_init() for nFilt filters.
+ *
+ * @param xLen Number of states
+ * @param yLen Number of measurements
+ * @param nFilt Number of filters
+ * @return uint32_t Block size in bytes
+ */
+uint32_t ukf_batch_mem_size(mtxDim xLen, mtxDim yLen, uint32_t nFilt) {
+    tUkfBatch dummy;
+
+    return ukf_batch_assign(&dummy, NULL, xLen, yLen, nFilt);
+}
+
+/**
+ * @brief Initialize nFilt lockstep filters from one model configuration.
+ * Sc, x_system_states_ic, Pxx0, Qxx, Ryy0 and dT are taken from pUkfMatrix and
+ * shared by (or copied to) all filters. State limiters and system inputs are
+ * not supported by the batch engine.
+ *
+ * @param pBatch Batch working structure
+ * @param pMem Memory block aligned to UKF_MEM_ALIGN
+ * @param memSize Size of memory block, at least ukf_batch_mem_size()
+ * @param nFilt Number of filters
+ * @param pUkfMatrix Model configuration (same as used by ukf_init)
+ * @param pModel Structure of arrays model callbacks
+ * @return uint8_t
+ * 0 := OK
+ * 1 := NOK
+ */
+uint8_t ukf_batch_init(tUkfBatch *pBatch, void *pMem, uint32_t memSize, uint32_t nFilt, const tUkfMatrix *pUkfMatrix, const tUkfBatchModel *pModel) {
+    const mtxDim xLen = pUkfMatrix->x_system_states.nrow;
+    const mtxDim yLen = pUkfMatrix->y_predicted_mean.nrow;
+    uint8_t Result = 0;
+
+    if (NULL == pMem || 0 != ((uintptr_t)pMem & (UKF_MEM_ALIGN - 1u)) || 0 == nFilt ||
+        0 == xLen || 0 == yLen || xLen > UKF_STATE_LEN_MAX || memSize < ukf_batch_mem_size(xLen, yLen, nFilt) ||
+        NULL == pModel->fcnPredict || NULL == pModel->fcnObserve ||
+        NULL == pUkfMatrix->Sc_vector.val || NULL == pUkfMatrix->x_system_states_ic.val ||
+        pUkfMatrix->x_system_states_ic.nrow != xLen ||
+        pUkfMatrix->Pxx0_init_error_covariance.nrow != xLen || pUkfMatrix->Pxx0_init_error_covariance.ncol != xLen ||
+        pUkfMatrix->Qxx_process_noise_cov.nrow != xLen || pUkfMatrix->Qxx_process_noise_cov.ncol != xLen ||
+        pUkfMatrix->Ryy0_init_out_covariance.nrow != yLen || pUkfMatrix->Ryy0_init_out_covariance.ncol != yLen) {
+        Result = 1;
+    } else {
+        const mtxScalar alpha = pUkfMatrix->Sc_vector.val[alphaIdx];
+        const mtxScalar betha = pUkfMatrix->Sc_vector.val[bethaIdx];
+        const mtxScalar kappa = pUkfMatrix->Sc_vector.val[kappaIdx];
+        mtxScalar lambda;
+        uint32_t eIdx, fIdx;
+        mtxDim sigmaIdx;
+
+        (void)ukf_batch_assign(pBatch, (uint8_t *)pMem, xLen, yLen, nFilt);
+        pBatch->model = *pModel;
+        pBatch->dT = pUkfMatrix->dT;
+
+        //#1.3'(begin/end) Calculate scaling parameter
+        lambda = alpha * alpha * (mtxScalar)(xLen + kappa) - (mtxScalar)xLen;
+        pBatch->gamma = MTX_SQRT(xLen + lambda);
+
+        //#1.2'(begin) Calculate weight vectors
+        pBatch->Wm[0] = lambda / (xLen + lambda);
+        pBatch->Wc[0] = pBatch->Wm[0] + (1 - alpha * alpha + betha);
+
+        for (sigmaIdx = 1; sigmaIdx < pBatch->sLen; sigmaIdx++) {
+            pBatch->Wm[sigmaIdx] = 1 / (2 * (xLen + lambda));
+            pBatch->Wc[sigmaIdx] = pBatch->Wm[sigmaIdx];
+        }
+        //#1.2'(end) Calculate weight vectors
+
+        for (eIdx = 0; eIdx < (uint32_t)xLen * xLen; eIdx++) {
+            pBatch->Qxx[eIdx] = pUkfMatrix->Qxx_process_noise_cov.val[eIdx];
+
+            for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                pBatch->Pxx[eIdx * nFilt + fIdx] = pUkfMatrix->Pxx0_init_error_covariance.val[eIdx];
+            }
+        }
+
+        for (eIdx = 0; eIdx < (uint32_t)yLen * yLen; eIdx++) {
+            pBatch->Ryy0[eIdx] = pUkfMatrix->Ryy0_init_out_covariance.val[eIdx];
+        }
+
+        for (eIdx = 0; eIdx < xLen; eIdx++) {
+            for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                pBatch->x[eIdx * nFilt + fIdx] = pUkfMatrix->x_system_states_ic.val[eIdx];
+            }
+        }
+
+        for (eIdx = 0; eIdx < yLen * nFilt; eIdx++) {
+            pBatch->y[eIdx] = 0;
+        }
+
+        for (fIdx = 0; fIdx < nFilt; fIdx++) {
+            pBatch->fault[fIdx] = 0;
+        }
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Lane-wise lower Cholesky factorization in place, upper triangle is cleared.
+ * A lane that is not positive definite (or NaN) gets zero pivots instead of NaN
+ * and is marked in its fault mask.
+ *
+ * @param pA Matrix (n x n)[nFilt]
+ * @param n Matrix size
+ * @param nFilt Number of lanes
+ * @param pInv Lane scratch [nFilt]
+ * @param pFault Lane fault masks [nFilt]
+ * @param fault UKF_FAULT_* bit set in the mask of a failed lane
+ */
+static void ukf_batch_chol(mtxScalar *pA, mtxDim n, uint32_t nFilt, mtxScalar *pInv, uint8_t *pFault, uint8_t fault) {
+    mtxDim row, col, k;
+    uint32_t fIdx;
+
+    for (col = 0; col < n; col++) {
+        mtxScalar *const pAcc = &pA[((uint32_t)n * col + col) * nFilt];
+
+        for (k = 0; k < col; k++) {
+            mtxScalar const *const pAck = &pA[((uint32_t)n * col + k) * nFilt];
+
+            for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                pAcc[fIdx] -= pAck[fIdx] * pAck[fIdx];
+            }
+        }
+
+        for (fIdx = 0; fIdx < nFilt; fIdx++) {
+            const mtxScalar diag = (pAcc[fIdx] > 0) ? MTX_SQRT(pAcc[fIdx]) : 0;
+
+            pFault[fIdx] |= (diag > 0) ? 0 : fault;
+            pAcc[fIdx] = diag;
+            pInv[fIdx] = (diag > 0) ? (1 / diag) : 0;
+        }
+
+        for (row = col + 1; row < n; row++) {
+            mtxScalar *const pArc = &pA[((uint32_t)n * row + col) * nFilt];
+
+            for (k = 0; k < col; k++) {
+                mtxScalar const *const pArk = &pA[((uint32_t)n * row + k) * nFilt];
+                mtxScalar const *const pAck = &pA[((uint32_t)n * col + k) * nFilt];
+
+                for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                    pArc[fIdx] -= pArk[fIdx] * pAck[fIdx];
+                }
+            }
+
+            for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                pArc[fIdx] *= pInv[fIdx];
+            }
+
+            //clear upper triangle element (col,row)
+            for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                pA[((uint32_t)n * col + row) * nFilt + fIdx] = 0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Lane-wise Cholesky substitution B = B*inv(L*L'), zero pivots give zero elements
+ *
+ * @param pL Lower Cholesky factor (n x n)[nFilt]
+ * @param pB Right hand side (nrow x n)[nFilt], overwritten by the solution
+ * @param nrow Number of rows of B
+ * @param n Matrix size
+ * @param nFilt Number of lanes
+ */
+static void ukf_batch_subst(const mtxScalar *pL, mtxScalar *pB, mtxDim nrow, mtxDim n, uint32_t nFilt) {
+    mtxDim row, i, k;
+    uint32_t fIdx;
+
+    for (row = 0; row < nrow; row++) {
+        mtxScalar *const pBrow = &pB[(uint32_t)n * row * nFilt];
+
+        //forward substitution L*z = b
+        for (i = 0; i < n; i++) {
+            mtxScalar *const pBi = &pBrow[(uint32_t)i * nFilt];
+            mtxScalar const *const pLii = &pL[((uint32_t)n * i + i) * nFilt];
+
+            for (k = 0; k < i; k++) {
+                mtxScalar const *const pBk = &pBrow[(uint32_t)k * nFilt];
+                mtxScalar const *const pLik = &pL[((uint32_t)n * i + k) * nFilt];
+
+                for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                    pBi[fIdx] -= pLik[fIdx] * pBk[fIdx];
+                }
+            }
+
+            for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                pBi[fIdx] = (pLii[fIdx] > 0) ? (pBi[fIdx] / pLii[fIdx]) : 0;
+            }
+        }
+
+        //backward substitution L'*x = z
+        for (i = n; i-- > 0;) {
+            mtxScalar *const pBi = &pBrow[(uint32_t)i * nFilt];
+            mtxScalar const *const pLii = &pL[((uint32_t)n * i + i) * nFilt];
+
+            for (k = i + 1; k < n; k++) {
+                mtxScalar const *const pBk = &pBrow[(uint32_t)k * nFilt];
+                mtxScalar const *const pLki = &pL[((uint32_t)n * k + i) * nFilt];
+
+                for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                    pBi[fIdx] -= pLki[fIdx] * pBk[fIdx];
+                }
+            }
+
+            for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                pBi[fIdx] = (pLii[fIdx] > 0) ? (pBi[fIdx] / pLii[fIdx]) : 0;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Lockstep periodic task of all filters in the batch.
+ * Measurements of all filters should be loaded in pBatch->y before each call.
+ * Steps follow ukf_step(): sigma points, prediction, observation, covariances
+ * and measurement update, every one of them executed across all lanes.
+ * Faults are kept per lane in pBatch->fault. A lane with Pxx not positive definite
+ * (UKF_FAULT_SIGMAPOINT) draws its sigma points from the zero pivot factor, a lane with
+ * Pyy not positive definite (UKF_FAULT_GAIN) skips the measurement update like
+ * ukf_step(): x = x(k|k-1), Pxx = P(k|k-1).
+ *
+ * @param pBatch Batch working structure
+ * @return uint8_t 0 := OK, UKF_FAULT_* of any lane otherwise (see pBatch->fault)
+ */
+uint8_t ukf_batch_step(tUkfBatch *pBatch) {
+    const mtxDim xLen = pBatch->xLen;
+    const mtxDim yLen = pBatch->yLen;
+    const mtxDim sLen = pBatch->sLen;
+    const uint32_t nFilt = pBatch->nFilt;
+    const mtxScalar gamma = pBatch->gamma;
+    mtxScalar const *const pWm = pBatch->Wm;
+    mtxScalar const *const pWc = pBatch->Wc;
+    mtxScalar *const px = pBatch->x;
+    mtxScalar *const pPxx = pBatch->Pxx;
+    mtxScalar *const pX_p = pBatch->X_p;
+    mtxScalar *const pX_m = pBatch->X_m;
+    mtxScalar *const pY_m = pBatch->Y_m;
+    mtxScalar *const py_m = pBatch->y_m;
+    mtxScalar *const py = pBatch->y;
+    mtxScalar *const pPyy = pBatch->Pyy;
+    mtxScalar *const pPxy = pBatch->Pxy;
+    mtxScalar *const pK = pBatch->K;
+    uint8_t *const pFault = pBatch->fault;
+    uint8_t Result = 0;
+    mtxDim xIdx, xTrIdx, yIdx, yTrIdx, sigmaIdx, k;
+    uint32_t fIdx;
+
+    for (fIdx = 0; fIdx < nFilt; fIdx++) {
+        pFault[fIdx] = 0;
+    }
+
+    //#1.1(begin/end) Calculate error covariance matrix square root
+    ukf_batch_chol(pPxx, xLen, nFilt, pBatch->tmp, pFault, UKF_FAULT_SIGMAPOINT);
+
+    //#1.2(begin) Calculate the sigma-points
+    for (xIdx = 0; xIdx < xLen; xIdx++) {
+        mtxScalar const *const pxi = &px[(uint32_t)xIdx * nFilt];
+
+        for (sigmaIdx = 0; sigmaIdx < sLen; sigmaIdx++) {
+            mtxScalar *const pXis = &pX_p[((uint32_t)sLen * xIdx + sigmaIdx) * nFilt];
+
+            if (0 == sigmaIdx) {
+                for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                    pXis[fIdx] = pxi[fIdx];
+                }
+            } else if (sigmaIdx <= xLen) {
+                mtxScalar const *const pS = &pPxx[((uint32_t)xLen * xIdx + (sigmaIdx - 1)) * nFilt];
+
+                for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                    pXis[fIdx] = pxi[fIdx] + gamma * pS[fIdx];
+                }
+            } else {
+                mtxScalar const *const pS = &pPxx[((uint32_t)xLen * xIdx + (sigmaIdx - xLen - 1)) * nFilt];
+
+                for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                    pXis[fIdx] = pxi[fIdx] - gamma * pS[fIdx];
+                }
+            }
+        }
+    }
+    //#1.2(end) Calculate the sigma-points
+
+    //#2.1 Propagate each sigma-point through prediction
+    pBatch->model.fcnPredict(pX_p, pX_m, (uint32_t)sLen * nFilt, pBatch->dT);
+
+    //#3.1 Propagate each sigma-point through observation
+    pBatch->model.fcnObserve(pX_m, pY_m, (uint32_t)sLen * nFilt);
+
+    //#2.2 Calculate mean of predicted state and center sigma points: X_m = X_m - x_m
+    for (xIdx = 0; xIdx < xLen; xIdx++) {
+        mtxScalar *const pxi = &px[(uint32_t)xIdx * nFilt];
+
+        for (fIdx = 0; fIdx < nFilt; fIdx++) {
+            pxi[fIdx] = 0;
+        }
+
+        for (sigmaIdx = 0; sigmaIdx < sLen; sigmaIdx++) {
+            mtxScalar const *const pXis = &pX_m[((uint32_t)sLen * xIdx + sigmaIdx) * nFilt];
+            const mtxScalar wm = pWm[sigmaIdx];
+
+            for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                pxi[fIdx] += wm * pXis[fIdx];
+            }
+        }
+
+        for (sigmaIdx = 0; sigmaIdx < sLen; sigmaIdx++) {
+            mtxScalar *const pXis = &pX_m[((uint32_t)sLen * xIdx + sigmaIdx) * nFilt];
+
+            for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                pXis[fIdx] -= pxi[fIdx];
+            }
+        }
+    }
+
+    //#3.2 Calculate mean of predicted output and center sigma points: Y_m = Y_m - y_m
+    for (yIdx = 0; yIdx < yLen; yIdx++) {
+        mtxScalar *const pyi = &py_m[(uint32_t)yIdx * nFilt];
+
+        for (fIdx = 0; fIdx < nFilt; fIdx++) {
+            pyi[fIdx] = 0;
+        }
+
+        for (sigmaIdx = 0; sigmaIdx < sLen; sigmaIdx++) {
+            mtxScalar const *const pYis = &pY_m[((uint32_t)sLen * yIdx + sigmaIdx) * nFilt];
+            const mtxScalar wm = pWm[sigmaIdx];
+
+            for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                pyi[fIdx] += wm * pYis[fIdx];
+            }
+        }
+
+        for (sigmaIdx = 0; sigmaIdx < sLen; sigmaIdx++) {
+            mtxScalar *const pYis = &pY_m[((uint32_t)sLen * yIdx + sigmaIdx) * nFilt];
+
+            for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                pYis[fIdx] -= pyi[fIdx];
+            }
+        }
+    }
+
+    //#2.3 Calculate covariance of predicted state (lower triangle, mirrored): P_m = Q + sum(Wc*dX*dX')
+    for (xIdx = 0; xIdx < xLen; xIdx++) {
+        for (xTrIdx = 0; xTrIdx <= xIdx; xTrIdx++) {
+            mtxScalar *const pP = &pPxx[((uint32_t)xLen * xIdx + xTrIdx) * nFilt];
+            const mtxScalar q = pBatch->Qxx[xLen * xIdx + xTrIdx];
+
+            for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                pP[fIdx] = q;
+            }
+
+            for (sigmaIdx = 0; sigmaIdx < sLen; sigmaIdx++) {
+                mtxScalar const *const pA = &pX_m[((uint32_t)sLen * xIdx + sigmaIdx) * nFilt];
+                mtxScalar const *const pB = &pX_m[((uint32_t)sLen * xTrIdx + sigmaIdx) * nFilt];
+                const mtxScalar wc = pWc[sigmaIdx];
+
+                for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                    pP[fIdx] += wc * pA[fIdx] * pB[fIdx];
+                }
+            }
+
+            if (xTrIdx != xIdx) {
+                mtxScalar *const pPtr = &pPxx[((uint32_t)xLen * xTrIdx + xIdx) * nFilt];
+
+                for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                    pPtr[fIdx] = pP[fIdx];
+                }
+            }
+        }
+    }
+
+    //#3.3 Calculate covariance of predicted output: Pyy = R + sum(Wc*dY*dY')
+    for (yIdx = 0; yIdx < yLen; yIdx++) {
+        for (yTrIdx = 0; yTrIdx <= yIdx; yTrIdx++) {
+            mtxScalar *const pP = &pPyy[((uint32_t)yLen * yIdx + yTrIdx) * nFilt];
+            const mtxScalar r = pBatch->Ryy0[yLen * yIdx + yTrIdx];
+
+            for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                pP[fIdx] = r;
+            }
+
+            for (sigmaIdx = 0; sigmaIdx < sLen; sigmaIdx++) {
+                mtxScalar const *const pA = &pY_m[((uint32_t)sLen * yIdx + sigmaIdx) * nFilt];
+                mtxScalar const *const pB = &pY_m[((uint32_t)sLen * yTrIdx + sigmaIdx) * nFilt];
+                const mtxScalar wc = pWc[sigmaIdx];
+
+                for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                    pP[fIdx] += wc * pA[fIdx] * pB[fIdx];
+                }
+            }
+
+            if (yTrIdx != yIdx) {
+                mtxScalar *const pPtr = &pPyy[((uint32_t)yLen * yTrIdx + yIdx) * nFilt];
+
+                for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                    pPtr[fIdx] = pP[fIdx];
+                }
+            }
+        }
+    }
+
+    //#3.4 Calculate cross-covariance of state and output: Pxy = sum(Wc*dX*dY')
+    for (xIdx = 0; xIdx < xLen; xIdx++) {
+        for (yIdx = 0; yIdx < yLen; yIdx++) {
+            mtxScalar *const pP = &pPxy[((uint32_t)yLen * xIdx + yIdx) * nFilt];
+
+            for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                pP[fIdx] = 0;
+            }
+
+            for (sigmaIdx = 0; sigmaIdx < sLen; sigmaIdx++) {
+                mtxScalar const *const pA = &pX_m[((uint32_t)sLen * xIdx + sigmaIdx) * nFilt];
+                mtxScalar const *const pB = &pY_m[((uint32_t)sLen * yIdx + sigmaIdx) * nFilt];
+                const mtxScalar wc = pWc[sigmaIdx];
+
+                for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                    pP[fIdx] += wc * pA[fIdx] * pB[fIdx];
+                }
+            }
+        }
+    }
+
+    //#4.1 Calculate Kalman gain: K = Pxy*inv(L*L'), Pyy = L
+    for (fIdx = 0; fIdx < (uint32_t)xLen * yLen * nFilt; fIdx++) {
+        pK[fIdx] = pPxy[fIdx];
+    }
+    ukf_batch_chol(pPyy, yLen, nFilt, pBatch->tmp, pFault, UKF_FAULT_GAIN);
+    ukf_batch_subst(pPyy, pK, xLen, yLen, nFilt);
+
+    //lanes without gain keep K = 0: no state and no covariance update
+    for (xIdx = 0; xIdx < xLen; xIdx++) {
+        for (yIdx = 0; yIdx < yLen; yIdx++) {
+            mtxScalar *const pKxy = &pK[((uint32_t)yLen * xIdx + yIdx) * nFilt];
+
+            for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                pKxy[fIdx] = (0 != (pFault[fIdx] & UKF_FAULT_GAIN)) ? 0 : pKxy[fIdx];
+            }
+        }
+    }
+
+    //#4.2 Update state estimate: y = y - y_m, x = x_m + K*(y - y_m)
+    for (fIdx = 0; fIdx < (uint32_t)yLen * nFilt; fIdx++) {
+        py[fIdx] -= py_m[fIdx];
+    }
+
+    for (xIdx = 0; xIdx < xLen; xIdx++) {
+        mtxScalar *const pxi = &px[(uint32_t)xIdx * nFilt];
+
+        for (yIdx = 0; yIdx < yLen; yIdx++) {
+            mtxScalar const *const pKxy = &pK[((uint32_t)yLen * xIdx + yIdx) * nFilt];
+            mtxScalar const *const pyi = &py[(uint32_t)yIdx * nFilt];
+
+            for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                pxi[fIdx] += pKxy[fIdx] * pyi[fIdx];
+            }
+        }
+    }
+
+    //#4.3 Update error covariance: use Pxy for U = K*L, Pxx = P_m - U*U'
+    for (xIdx = 0; xIdx < xLen; xIdx++) {
+        for (yIdx = 0; yIdx < yLen; yIdx++) {
+            mtxScalar *const pU = &pPxy[((uint32_t)yLen * xIdx + yIdx) * nFilt];
+
+            for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                pU[fIdx] = 0;
+            }
+
+            for (k = yIdx; k < yLen; k++) {
+                mtxScalar const *const pKxk = &pK[((uint32_t)yLen * xIdx + k) * nFilt];
+                mtxScalar const *const pLky = &pPyy[((uint32_t)yLen * k + yIdx) * nFilt];
+
+                for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                    pU[fIdx] += pKxk[fIdx] * pLky[fIdx];
+                }
+            }
+        }
+    }
+
+    for (xIdx = 0; xIdx < xLen; xIdx++) {
+        for (xTrIdx = 0; xTrIdx <= xIdx; xTrIdx++) {
+            mtxScalar *const pP = &pPxx[((uint32_t)xLen * xIdx + xTrIdx) * nFilt];
+
+            for (yIdx = 0; yIdx < yLen; yIdx++) {
+                mtxScalar const *const pA = &pPxy[((uint32_t)yLen * xIdx + yIdx) * nFilt];
+                mtxScalar const *const pB = &pPxy[((uint32_t)yLen * xTrIdx + yIdx) * nFilt];
+
+                for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                    pP[fIdx] -= pA[fIdx] * pB[fIdx];
+                }
+            }
+
+            if (xTrIdx != xIdx) {
+                mtxScalar *const pPtr = &pPxx[((uint32_t)xLen * xTrIdx + xIdx) * nFilt];
+
+                for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                    pPtr[fIdx] = pP[fIdx];
+                }
+            }
+        }
+    }
+
+    for (fIdx = 0; fIdx < nFilt; fIdx++) {
+        Result |= pFault[fIdx];
+    }
+
+    return Result;
+}
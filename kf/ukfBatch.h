@@ -0,0 +1,54 @@
+/**
+ * @file ukfBatch.h
+ * @brief Lockstep UKF engine for many filters of the same model (structure of arrays).
+ */
+
+#ifndef UKFBATCH_H
+#define UKFBATCH_H
+
+#include <stdint.h>
+#include "ukfLib.h"
+
+//! Batched model callbacks working on structure of arrays storage.
+//! Row r of the sigma matrix starts at p[nCol * r], column c = sigmaIdx * nFilt + filterIdx,
+//! so every row is one contiguous vector of nCol = sLen * nFilt elements.
+typedef void (*tPredictSoaFcn)(mtxScalar const *pX_p, mtxScalar *pX_m, uint32_t nCol, mtxScalar dT);
+typedef void (*tObservSoaFcn)(mtxScalar const *pX_m, mtxScalar *pY_m, uint32_t nCol);
+
+typedef struct ukfBatchModel {
+    tPredictSoaFcn fcnPredict;
+    tObservSoaFcn fcnObserve;
+} tUkfBatchModel;
+
+//! All per-filter arrays are stored element major with nFilt contiguous lanes: a[eIdx * nFilt + filterIdx]
+typedef struct ukfBatch {
+    mtxDim xLen;     //length of state vector
+    mtxDim yLen;     //length of measurement vector
+    mtxDim sLen;     //length of sigma point
+    uint32_t nFilt;   //number of filters stepped in lockstep
+    mtxScalar gamma;  //sigma point spread sqrt(xLen + lambda)
+    mtxScalar dT;
+    mtxScalar *Wm;    //(sLen) shared weights
+    mtxScalar *Wc;    //(sLen) shared weights
+    mtxScalar *Qxx;   //(xLen x xLen) shared process noise
+    mtxScalar *Ryy0;  //(yLen x yLen) shared output noise
+    mtxScalar *x;     //(xLen)[nFilt] states x(k-1), x(k|k-1), x(k)
+    mtxScalar *Pxx;   //(xLen x xLen)[nFilt] error covariance, holds its lower Cholesky factor during the step
+    mtxScalar *X_p;   //(xLen x sLen)[nFilt] sigma points X(k-1)
+    mtxScalar *X_m;   //(xLen x sLen)[nFilt] propagated sigma points, centered after means are known
+    mtxScalar *Y_m;   //(yLen x sLen)[nFilt] output sigma points, centered after means are known
+    mtxScalar *y_m;   //(yLen)[nFilt] predicted output
+    mtxScalar *y;     //(yLen)[nFilt] measurements, innovation after the step
+    mtxScalar *Pyy;   //(yLen x yLen)[nFilt] output covariance, lower Cholesky factor after the step
+    mtxScalar *Pxy;   //(xLen x yLen)[nFilt] cross-covariance
+    mtxScalar *K;     //(xLen x yLen)[nFilt] Kalman gain
+    mtxScalar *tmp;   //[nFilt] lane scratch
+    uint8_t *fault;   //[nFilt] UKF_FAULT_* of every lane in the last step
+    tUkfBatchModel model;
+} tUkfBatch;
+
+uint32_t ukf_batch_mem_size (mtxDim xLen, mtxDim yLen, uint32_t nFilt);
+uint8_t  ukf_batch_init     (tUkfBatch *pBatch, void *pMem, uint32_t memSize, uint32_t nFilt, const tUkfMatrix *pUkfMatrix, const tUkfBatchModel *pModel);
+uint8_t  ukf_batch_step     (tUkfBatch *pBatch);
+
+#endif /* UKFBATCH_H */
@@ -0,0 +1,780 @@
+/**
+ * @file ukfBench.c
+ * @brief Host benchmark of ukf_step() and of every mtx_* kernel it relies on.
+ * Filters: the 4x2 example of ukfCfg.c and synthetic nx x ny models laid out
+ * with ukf_mem_layout(), both in standard and square-root mode, and the
+ * synthetic models with the spherical simplex sigma set in standard mode.
+ * The fixed-point engine (ukfFix.c) and the floating-point path are compared on the
+ * MATLAB reference log of the example: accuracy is printed, latency reported.
+ * Log replay (ukfReplay.c) of the example is reported per record, file I/O included.
+ * An IMM bank (ukfImm.c) of three synthetic models is reported per bank step with and
+ * without work sharing of the coincident models.
+ * The lockstep batch engine (ukfBatch.c) of the example is reported per filter step next to
+ * the same number of scalar ukf_step() calls.
+ * Results are printed as a table and written as CSV (default kfbench.csv):
+ * kind,name,mode,xLen,yLen,samples,mean_ns,p50_ns,p90_ns,p99_ns,max_ns,ops_per_s
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "ukfCfg.h"
+#include "ukfMem.h"
+#include "ukfBatch.h"
+#include "ukfFix.h"
+#include "ukfReplay.h"
+#include "ukfImm.h"
+#include "ukfRef.h"
+
+#define BENCH_STEP_WARMUP   (100u)
+#define BENCH_STEP_SAMPLES  (2000u)
+#define BENCH_MTX_SAMPLES   (500u)
+#define BENCH_LARGE_DIM     (32u)   //above this dimension (wide-index sizes) fewer samples are taken
+#define BENCH_LARGE_SAMPLES (20u)
+#define BENCH_MTX_REPS      (16u)   //kernel calls per timed sample, each on its own operand copy
+#if defined(MTX_WIDE_INDEX)
+#define BENCH_MTX_MAXN      (256u)
+#else
+#define BENCH_MTX_MAXN      (32u)
+#endif
+#define BENCH_REPLAY_PASSES  (10u)
+#define BENCH_REPLAY_RECORDS (20000u)  //records per replayed log
+#define BENCH_IMM_MODELS     (3u)
+#ifndef BENCH_BATCH_LANES
+#define BENCH_BATCH_LANES    (64u)  //lockstep filters, e.g. -DBENCH_BATCH_LANES=8u
+#endif
+#define BENCH_SCALAR_NAME   ((sizeof(mtxScalar) == sizeof(double)) ? "double" : "float")
+
+typedef struct benchCfg {
+    mtxDim xLen;
+    mtxDim yLen;
+} tBenchCfg;
+
+typedef void (*tBenchPrepareFcn)(mtxDim n, uint32_t rep);
+typedef void (*tBenchKernelFcn)(mtxDim n, uint32_t rep);
+
+typedef struct benchKernel {
+    const char *pName;
+    tBenchPrepareFcn fcnPrepare;  //NULL if operands are not modified by kernel
+    tBenchKernelFcn fcnKernel;
+} tBenchKernel;
+
+extern tUkfMatrix UkfMatrixCfg;
+extern tUkfBatchModel UkfBatchModelCfg;
+extern tUkfFixScale UkfFixScaleCfg;
+extern tUkfFixModel UkfFixModelCfg;
+
+#if defined(MTX_WIDE_INDEX)
+static const tBenchCfg BenchCfg[] = {{8, 4}, {16, 8}, {32, 16}, {64, 16}, {150, 32}};
+static const mtxDim BenchMtxDim[] = {4, 6, 8, 12, 16, 32, 64, 150, 256};
+
+static uint64_t BenchArena[524288];
+#else
+static const tBenchCfg BenchCfg[] = {{8, 4}, {16, 8}, {32, 16}};
+static const mtxDim BenchMtxDim[] = {4, 6, 8, 12, 16, 32};
+
+static uint64_t BenchArena[16384];
+#endif
+static uint32_t BenchSample[BENCH_STEP_SAMPLES];
+static uint32_t BenchLcg = 12345u;
+static FILE *pBenchCsv = NULL;
+static tUkfReplay BenchReplay;
+
+//! kernel operands: constant A, B, SPD S with factor L and per-rep in-place copies
+static mtxScalar MtxA[BENCH_MTX_MAXN * BENCH_MTX_MAXN];
+static mtxScalar MtxB[BENCH_MTX_MAXN * BENCH_MTX_MAXN];
+static mtxScalar MtxC[BENCH_MTX_MAXN * BENCH_MTX_MAXN];
+static mtxScalar MtxS[BENCH_MTX_MAXN * BENCH_MTX_MAXN];
+static mtxScalar MtxL[BENCH_MTX_MAXN * BENCH_MTX_MAXN];
+static mtxScalar MtxW[BENCH_MTX_MAXN * 2 * BENCH_MTX_MAXN];
+static mtxScalar MtxRep[BENCH_MTX_REPS][BENCH_MTX_MAXN * 2 * BENCH_MTX_MAXN];
+static mtxScalar MtxRepRhs[BENCH_MTX_REPS][BENCH_MTX_MAXN * BENCH_MTX_MAXN];
+static mtxScalar MtxRepVec[BENCH_MTX_REPS][BENCH_MTX_MAXN];
+
+/**
+ * @brief Uniform pseudo random number in [-1, 1)
+ */
+static mtxScalar bench_rand(void) {
+    BenchLcg = BenchLcg * 1664525u + 1013904223u;
+
+    return (mtxScalar)(BenchLcg >> 8) / (mtxScalar)(1u << 23) - MTX_C(1.0);
+}
+
+static int bench_cmp(const void *pA, const void *pB) {
+    const uint32_t a = *(const uint32_t *)pA;
+    const uint32_t b = *(const uint32_t *)pB;
+
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief Sort samples and report percentiles
+ *
+ * @param pKind "step" or "mtx"
+ * @param pName Benchmark name
+ * @param pMode Filter mode name or "-"
+ * @param xLen Number of states (kernel dimension for mtx)
+ * @param yLen Number of measurements (kernel dimension for mtx)
+ * @param pSample Latency samples in ns
+ * @param nSample Number of samples
+ * @param div Number of operations per sample
+ */
+static void bench_report(const char *pKind, const char *pName, const char *pMode, mtxDim xLen, mtxDim yLen,
+                         uint32_t *pSample, uint32_t nSample, uint32_t div) {
+    uint64_t sum = 0;
+    uint32_t idx;
+    double mean, p50, p90, p99, pmax;
+
+    qsort(pSample, nSample, sizeof(pSample[0]), &bench_cmp);
+
+    for (idx = 0; idx < nSample; idx++) {
+        sum += pSample[idx];
+    }
+
+    mean = (double)sum / nSample / div;
+    p50 = (double)pSample[(nSample * 50u) / 100u] / div;
+    p90 = (double)pSample[(nSample * 90u) / 100u] / div;
+    p99 = (double)pSample[(nSample * 99u) / 100u] / div;
+    pmax = (double)pSample[nSample - 1u] / div;
+
+    printf("%-5s %-16s %-9s %3ux%-3u mean %10.1f p50 %10.1f p90 %10.1f p99 %10.1f max %10.1f ns %12.0f /s\n",
+           pKind, pName, pMode, xLen, yLen, mean, p50, p90, p99, pmax, 1e9 / mean);
+
+    if (NULL != pBenchCsv) {
+        fprintf(pBenchCsv, "%s,%s,%s,%u,%u,%u,%.1f,%.1f,%.1f,%.1f,%.1f,%.0f\n",
+                pKind, pName, pMode, xLen, yLen, nSample, mean, p50, p90, p99, pmax, 1e9 / mean);
+    }
+}
+
+/**
+ * @brief Synthetic prediction: weakly coupled nonlinear chain x(i) += dT*(0.5*sin(x(i+1)) - 0.1*x(i))
+ */
+static void bench_fx(tMatrix *pu_p, tMatrix *pX_p, tMatrix *pX_m, mtxDim sigmaIdx, mtxDim sigmaCnt, mtxScalar dT) {
+    const mtxDim xLen = UKF_SIGMA_NELEM(pX_m);
+    const mtxDim sigmaEnd = sigmaIdx + sigmaCnt;
+    mtxDim xIdx, sIdx;
+
+    (void)pu_p;
+
+    for (xIdx = 0; xIdx < xLen; xIdx++) {
+        const mtxDim xNext = (xIdx + 1u) % xLen;
+
+        for (sIdx = sigmaIdx; sIdx < sigmaEnd; sIdx++) {
+            UKF_SIGMA_AT(pX_m, xIdx, sIdx) = UKF_SIGMA_AT(pX_p, xIdx, sIdx) +
+                dT * (MTX_C(0.5) * MTX_SIN(UKF_SIGMA_AT(pX_p, xNext, sIdx)) - MTX_C(0.1) * UKF_SIGMA_AT(pX_p, xIdx, sIdx));
+        }
+    }
+}
+
+/**
+ * @brief Synthetic observation: y(j) = x(j) + 0.1*x(j+1)^2
+ */
+static void bench_hy(tMatrix *pu, tMatrix *pX_m, tMatrix *pY_m, mtxDim sigmaIdx, mtxDim sigmaCnt) {
+    const mtxDim xLen = UKF_SIGMA_NELEM(pX_m);
+    const mtxDim yLen = UKF_SIGMA_NELEM(pY_m);
+    const mtxDim sigmaEnd = sigmaIdx + sigmaCnt;
+    mtxDim yIdx, sIdx;
+
+    (void)pu;
+
+    for (yIdx = 0; yIdx < yLen; yIdx++) {
+        const mtxDim xNext = (yIdx + 1u) % xLen;
+
+        for (sIdx = sigmaIdx; sIdx < sigmaEnd; sIdx++) {
+            const mtxScalar xn = UKF_SIGMA_AT(pX_m, xNext, sIdx);
+
+            UKF_SIGMA_AT(pY_m, yIdx, sIdx) = UKF_SIGMA_AT(pX_m, yIdx, sIdx) + MTX_C(0.1) * xn * xn;
+        }
+    }
+}
+
+/**
+ * @brief Time ukf_step() of one configuration. Measurements are the last predicted
+ * output with small noise, which keeps any model bounded.
+ *
+ * @param pUkfMatrix Filter configuration
+ * @param pName Benchmark name
+ */
+static void bench_step(tUkfMatrix *pUkfMatrix, const char *pName) {
+    const char *const pMode = (UKF_MODE_SQRT == pUkfMatrix->filter_mode) ? "sqrt" : "standard";
+    tUKF ukf;
+    uint32_t idx;
+
+    if (0 != ukf_init(&ukf, pUkfMatrix)) {
+        printf("step  %-16s %-9s init fail\n", pName, pMode);
+    } else {
+        const mtxDim yLen = ukf.par.yLen;
+        const uint32_t nSample = (ukf.par.xLen > BENCH_LARGE_DIM) ? BENCH_LARGE_SAMPLES : BENCH_STEP_SAMPLES;
+        mtxDim yIdx;
+
+        for (idx = 0; idx < BENCH_STEP_WARMUP + nSample; idx++) {
+            uint32_t t0;
+
+            for (yIdx = 0; yIdx < yLen; yIdx++) {
+                ukf.input.y.val[yIdx] = ukf.predict.y_m.val[yIdx] + MTX_C(0.01) * bench_rand();
+            }
+
+            t0 = ukf_prof_clock();
+            ukf_step(&ukf);
+
+            if (idx >= BENCH_STEP_WARMUP) {
+                BenchSample[idx - BENCH_STEP_WARMUP] = ukf_prof_clock() - t0;
+            }
+        }
+
+        bench_report("step", pName, pMode, ukf.par.xLen, yLen, BenchSample, nSample, 1);
+    }
+}
+
+/**
+ * @brief Time ukf_step() of a synthetic nx x ny model
+ */
+static void bench_step_synthetic(mtxDim xLen, mtxDim yLen, uint8_t filterMode, uint8_t sigmaScheme) {
+    tUkfMatrix cfg;
+    mtxDim idx;
+
+    if (0 != ukf_mem_layout(&cfg, BenchArena, sizeof(BenchArena), xLen, yLen, filterMode, sigmaScheme)) {
+        printf("step  synthetic        %3ux%-3u layout fail\n", xLen, yLen);
+    } else {
+        for (idx = 0; idx < xLen; idx++) {
+            cfg.Qxx_process_noise_cov.val[xLen * idx + idx] = 1e-3F;
+            cfg.x_system_states_ic.val[idx] = MTX_C(0.1) * bench_rand();
+        }
+        for (idx = 0; idx < yLen; idx++) {
+            cfg.Ryy0_init_out_covariance.val[yLen * idx + idx] = 1e-2F;
+        }
+        cfg.fcnPredictBatch = &bench_fx;
+        cfg.fcnObserveBatch = &bench_hy;
+        cfg.dT = MTX_C(0.01);
+
+        bench_step(&cfg, (UKF_SIGMA_SIMPLEX == sigmaScheme) ? "synthetic-simplex" : "synthetic");
+    }
+}
+
+/**
+ * @brief Replay the MATLAB reference log of the example in the floating-point path and in
+ * the fixed-point engine. Filters are reinitialized after every pass of the log,
+ * the accumulated state error of the first pass is printed.
+ */
+static void bench_ref(void) {
+    const uint32_t nLog = UKF_REF_LEN - 1u;
+    mtxScalar errFloat = 0;
+    mtxScalar errFix = 0;
+    tUKF ukf;
+    tUkfFix fix;
+    uint32_t idx;
+    mtxDim xIdx;
+
+    UkfMatrixCfg.filter_mode = UKF_MODE_STANDARD;
+
+    for (idx = 0; idx < BENCH_STEP_WARMUP + BENCH_STEP_SAMPLES; idx++) {
+        const uint32_t k = idx % nLog + 1u;
+        uint32_t t0;
+
+        if (1u == k) {
+            (void)ukf_init(&ukf, &UkfMatrixCfg);
+        }
+        ukf.input.y.val[0] = yt[0][k];
+        ukf.input.y.val[1] = yt[1][k];
+
+        t0 = ukf_prof_clock();
+        ukf_step(&ukf);
+
+        if (idx >= BENCH_STEP_WARMUP) {
+            BenchSample[idx - BENCH_STEP_WARMUP] = ukf_prof_clock() - t0;
+        }
+        for (xIdx = 0; xIdx < Lx && idx < nLog; xIdx++) {
+            errFloat += MTX_FABS(ukf.update.x.val[xIdx] - x_exp[k - 1u][xIdx]);
+        }
+    }
+    bench_report("step", "ukfCfg-ref", BENCH_SCALAR_NAME, Lx, Ly, BenchSample, BENCH_STEP_SAMPLES, 1);
+
+    for (idx = 0; idx < BENCH_STEP_WARMUP + BENCH_STEP_SAMPLES; idx++) {
+        const uint32_t k = idx % nLog + 1u;
+        uint32_t t0;
+
+        if (1u == k && 0 != ukf_fix_init(&fix, BenchArena, sizeof(BenchArena), &UkfMatrixCfg, &UkfFixScaleCfg, &UkfFixModelCfg)) {
+            printf("step  ukfCfg-ref       fixed     init fail\n");
+            break;
+        }
+        fix.y.val[0] = mtx_fix_from_f(yt[0][k], fix.y.frac);
+        fix.y.val[1] = mtx_fix_from_f(yt[1][k], fix.y.frac);
+
+        t0 = ukf_prof_clock();
+        ukf_fix_step(&fix);
+
+        if (idx >= BENCH_STEP_WARMUP) {
+            BenchSample[idx - BENCH_STEP_WARMUP] = ukf_prof_clock() - t0;
+        }
+        for (xIdx = 0; xIdx < Lx && idx < nLog; xIdx++) {
+            errFix += MTX_FABS(mtx_fix_to_f(fix.x.val[xIdx], fix.x.frac) - x_exp[k - 1u][xIdx]);
+        }
+    }
+    if (idx == BENCH_STEP_WARMUP + BENCH_STEP_SAMPLES) {
+        bench_report("step", "ukfCfg-ref", (2 == sizeof(mtxFix)) ? "q15" : "q31", Lx, Ly, BenchSample, BENCH_STEP_SAMPLES, 1);
+    }
+
+    printf("acc   ukfCfg-ref       accumulated state error vs ukf.m: %s %.6e %s %.6e\n",
+           BENCH_SCALAR_NAME, (double)errFloat, (2 == sizeof(mtxFix)) ? "q15" : "q31", (double)errFix);
+}
+
+/**
+ * @brief Replay a binary log of the example (reference measurements repeated) from a temporary
+ * file into a temporary estimate file, every sample times one pass of the log
+ */
+static void bench_replay(void) {
+    const tUkfLogHeader hdr = {UKF_LOG_MAGIC, UKF_LOG_VERSION, (uint8_t)sizeof(mtxScalar), 0, Ly, 0, 0};
+    FILE *const pLog = tmpfile();
+    FILE *const pEst = tmpfile();
+    uint32_t idx;
+    tUKF ukf;
+
+    UkfMatrixCfg.filter_mode = UKF_MODE_STANDARD;
+
+    if (NULL == pLog || NULL == pEst) {
+        printf("replay ukfCfg-ref      temporary file fail\n");
+    } else {
+        (void)fwrite(&hdr, sizeof(hdr), 1, pLog);
+        for (idx = 0; idx < BENCH_REPLAY_RECORDS; idx++) {
+            const uint32_t k = idx % (UKF_REF_LEN - 1u) + 1u;
+            const tUkfLogRecord rec = {idx, 3u};
+            const mtxScalar y[Ly] = {yt[0][k], yt[1][k]};
+
+            (void)fwrite(&rec, sizeof(rec), 1, pLog);
+            (void)fwrite(y, sizeof(y), 1, pLog);
+        }
+
+        for (idx = 0; idx < BENCH_REPLAY_PASSES; idx++) {
+            uint32_t samples = 0;
+            uint32_t t0;
+
+            rewind(pLog);
+            rewind(pEst);
+            (void)ukf_init(&ukf, &UkfMatrixCfg);
+
+            t0 = ukf_prof_clock();
+            if (0 != ukf_replay_stream(&BenchReplay, pLog, pEst, &ukf, 1, &samples) || BENCH_REPLAY_RECORDS != samples) {
+                printf("replay ukfCfg-ref      replay fail\n");
+            }
+            BenchSample[idx] = ukf_prof_clock() - t0;
+        }
+        bench_report("replay", "ukfCfg-ref", BENCH_SCALAR_NAME, Lx, Ly, BenchSample, BENCH_REPLAY_PASSES, BENCH_REPLAY_RECORDS);
+    }
+
+    if (NULL != pLog) {
+        (void)fclose(pLog);
+    }
+    if (NULL != pEst) {
+        (void)fclose(pEst);
+    }
+}
+
+/**
+ * @brief Time ukf_batch_step() of BENCH_BATCH_LANES filters of the example and the same number
+ * of scalar ukf_step() calls of filters laid out with ukf_mem_layout(), both reported per
+ * filter step on the reference measurements
+ */
+static void bench_batch(void) {
+    const uint32_t nFilt = BENCH_BATCH_LANES;
+    const uint32_t nLog = UKF_REF_LEN - 1u;
+    const uint32_t batchSize = (ukf_batch_mem_size(Lx, Ly, nFilt) + 7u) & ~7u;
+    const uint32_t filtSize = (ukf_mem_size(Lx, Ly, UKF_MODE_STANDARD, UKF_SIGMA_SYMMETRIC) + 7u) & ~7u;
+    uint8_t *const pArena = (uint8_t *)BenchArena;
+    tUkfMatrix cfg[BENCH_BATCH_LANES];
+    tUKF ukf[BENCH_BATCH_LANES];
+    tUkfBatch batch;
+    uint8_t Result = 0;
+    uint32_t idx, fIdx;
+
+    UkfMatrixCfg.filter_mode = UKF_MODE_STANDARD;
+    if (batchSize + filtSize * nFilt > sizeof(BenchArena)) {
+        Result = 1;
+    }
+
+    for (fIdx = 0; fIdx < nFilt && 0 == Result; fIdx++) {
+        tUkfMatrix *const pCfg = &cfg[fIdx];
+
+        if (0 != ukf_mem_layout(pCfg, &pArena[batchSize + filtSize * fIdx], filtSize, Lx, Ly, UKF_MODE_STANDARD, UKF_SIGMA_SYMMETRIC)) {
+            Result = 1;
+        } else {
+            (void)mtx_cpy(&pCfg->Sc_vector, &UkfMatrixCfg.Sc_vector);
+            (void)mtx_cpy(&pCfg->x_system_states_ic, &UkfMatrixCfg.x_system_states_ic);
+            (void)mtx_cpy(&pCfg->Pxx0_init_error_covariance, &UkfMatrixCfg.Pxx0_init_error_covariance);
+            (void)mtx_cpy(&pCfg->Qxx_process_noise_cov, &UkfMatrixCfg.Qxx_process_noise_cov);
+            (void)mtx_cpy(&pCfg->Ryy0_init_out_covariance, &UkfMatrixCfg.Ryy0_init_out_covariance);
+            pCfg->fcnPredictBatch = UkfMatrixCfg.fcnPredictBatch;
+            pCfg->fcnObserveBatch = UkfMatrixCfg.fcnObserveBatch;
+            pCfg->fcnPredictVec = UkfMatrixCfg.fcnPredictVec;
+            pCfg->fcnObserveVec = UkfMatrixCfg.fcnObserveVec;
+            pCfg->dT = UkfMatrixCfg.dT;
+        }
+    }
+
+    if (0 != Result || 0 != ukf_batch_init(&batch, BenchArena, batchSize, nFilt, &UkfMatrixCfg, &UkfBatchModelCfg)) {
+        printf("batch ukfCfg           init fail\n");
+        return;
+    }
+
+    for (idx = 0; idx < BENCH_STEP_WARMUP + BENCH_STEP_SAMPLES; idx++) {
+        const uint32_t k = idx % nLog + 1u;
+        uint32_t t0;
+
+        if (1u == k) {
+            (void)ukf_batch_init(&batch, BenchArena, batchSize, nFilt, &UkfMatrixCfg, &UkfBatchModelCfg);
+        }
+        for (fIdx = 0; fIdx < nFilt; fIdx++) {
+            batch.y[0 * nFilt + fIdx] = yt[0][k];
+            batch.y[1 * nFilt + fIdx] = yt[1][k];
+        }
+
+        t0 = ukf_prof_clock();
+        (void)ukf_batch_step(&batch);
+
+        if (idx >= BENCH_STEP_WARMUP) {
+            BenchSample[idx - BENCH_STEP_WARMUP] = ukf_prof_clock() - t0;
+        }
+    }
+    bench_report("batch", "ukfCfg-lanes", "standard", Lx, Ly, BenchSample, BENCH_STEP_SAMPLES, nFilt);
+
+    for (idx = 0; idx < BENCH_STEP_WARMUP + BENCH_STEP_SAMPLES; idx++) {
+        const uint32_t k = idx % nLog + 1u;
+        uint32_t t0;
+
+        if (1u == k) {
+            for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                (void)ukf_init(&ukf[fIdx], &cfg[fIdx]);
+            }
+        }
+        for (fIdx = 0; fIdx < nFilt; fIdx++) {
+            ukf[fIdx].input.y.val[0] = yt[0][k];
+            ukf[fIdx].input.y.val[1] = yt[1][k];
+        }
+
+        t0 = ukf_prof_clock();
+        for (fIdx = 0; fIdx < nFilt; fIdx++) {
+            (void)ukf_step(&ukf[fIdx]);
+        }
+
+        if (idx >= BENCH_STEP_WARMUP) {
+            BenchSample[idx - BENCH_STEP_WARMUP] = ukf_prof_clock() - t0;
+        }
+    }
+    bench_report("batch", "ukfCfg-scalar", "standard", Lx, Ly, BenchSample, BENCH_STEP_SAMPLES, nFilt);
+}
+
+/**
+ * @brief Time ukf_imm_step() of a bank of three synthetic nx x ny models which only differ
+ * in Qxx, with uniform transition probabilities all mixing weights coincide
+ *
+ * @param share Bank shares the work of coincident models
+ */
+static void bench_imm(mtxDim xLen, mtxDim yLen, uint8_t share) {
+    static const mtxScalar trans[BENCH_IMM_MODELS * BENCH_IMM_MODELS] = {
+        MTX_C(1.0) / 3, MTX_C(1.0) / 3, MTX_C(1.0) / 3,
+        MTX_C(1.0) / 3, MTX_C(1.0) / 3, MTX_C(1.0) / 3,
+        MTX_C(1.0) / 3, MTX_C(1.0) / 3, MTX_C(1.0) / 3,
+    };
+    const uint32_t modelSize = (ukf_mem_size(xLen, yLen, UKF_MODE_STANDARD, UKF_SIGMA_SYMMETRIC) + 7u) & ~7u;
+    uint8_t *const pArena = (uint8_t *)BenchArena;
+    tUKF model[BENCH_IMM_MODELS];
+    mtxScalar y[BENCH_MTX_MAXN];
+    tUkfImm imm;
+    uint8_t Result = 0;
+    uint32_t idx;
+    mtxDim k;
+
+    for (idx = 0; idx < BENCH_IMM_MODELS; idx++) {
+        tUkfMatrix cfg;
+
+        if (0 != ukf_mem_layout(&cfg, &pArena[modelSize * idx], modelSize, xLen, yLen, UKF_MODE_STANDARD, UKF_SIGMA_SYMMETRIC)) {
+            Result = 1;
+        } else {
+            for (k = 0; k < xLen; k++) {
+                cfg.Qxx_process_noise_cov.val[xLen * k + k] = MTX_C(1e-3) * (1u + 10u * idx);
+            }
+            for (k = 0; k < yLen; k++) {
+                cfg.Ryy0_init_out_covariance.val[yLen * k + k] = 1e-2F;
+            }
+            cfg.fcnPredictBatch = &bench_fx;
+            cfg.fcnObserveBatch = &bench_hy;
+            cfg.dT = MTX_C(0.01);
+            Result |= ukf_init(&model[idx], &cfg);
+        }
+    }
+
+    if (0 != Result || 0 != ukf_imm_init(&imm, &pArena[modelSize * BENCH_IMM_MODELS], sizeof(BenchArena) - modelSize * BENCH_IMM_MODELS,
+                                         model, BENCH_IMM_MODELS, trans, NULL)) {
+        printf("imm   synthetic        %3ux%-3u init fail\n", xLen, yLen);
+    } else {
+        imm.share = share;
+
+        for (idx = 0; idx < BENCH_STEP_WARMUP + BENCH_STEP_SAMPLES; idx++) {
+            uint32_t t0;
+
+            for (k = 0; k < yLen; k++) {
+                y[k] = model[0].predict.y_m.val[k] + MTX_C(0.01) * bench_rand();
+            }
+
+            t0 = ukf_prof_clock();
+            ukf_imm_step(&imm, y, NULL);
+
+            if (idx >= BENCH_STEP_WARMUP) {
+                BenchSample[idx - BENCH_STEP_WARMUP] = ukf_prof_clock() - t0;
+            }
+        }
+
+        bench_report("imm", (0 != share) ? "synthetic-shared" : "synthetic-apart", "standard", xLen, yLen, BenchSample, BENCH_STEP_SAMPLES, 1);
+    }
+}
+
+static void bench_prep_spd(mtxDim n, uint32_t rep) {
+    mtxIdx eIdx;
+
+    for (eIdx = 0; eIdx < (mtxIdx)n * n; eIdx++) {
+        MtxRep[rep][eIdx] = MtxS[eIdx];
+    }
+}
+
+static void bench_prep_spd_rhs(mtxDim n, uint32_t rep) {
+    mtxIdx eIdx;
+
+    bench_prep_spd(n, rep);
+    for (eIdx = 0; eIdx < (mtxIdx)n * n; eIdx++) {
+        MtxRepRhs[rep][eIdx] = MtxA[eIdx];
+    }
+}
+
+static void bench_prep_spd_identity(mtxDim n, uint32_t rep) {
+    mtxIdx eIdx;
+
+    bench_prep_spd(n, rep);
+    for (eIdx = 0; eIdx < (mtxIdx)n * n; eIdx++) {
+        MtxRepRhs[rep][eIdx] = (0 == eIdx % (n + 1u)) ? MTX_C(1.0) : MTX_C(0.0);
+    }
+}
+
+static void bench_prep_factor(mtxDim n, uint32_t rep) {
+    mtxIdx eIdx;
+
+    for (eIdx = 0; eIdx < (mtxIdx)n * n; eIdx++) {
+        MtxRep[rep][eIdx] = MtxL[eIdx];
+    }
+    for (eIdx = 0; eIdx < n; eIdx++) {
+        MtxRepVec[rep][eIdx] = MtxA[eIdx];
+    }
+}
+
+static void bench_prep_wide(mtxDim n, uint32_t rep) {
+    mtxIdx eIdx;
+
+    for (eIdx = 0; eIdx < (mtxIdx)n * 2u * n; eIdx++) {
+        MtxRep[rep][eIdx] = MtxW[eIdx];
+    }
+}
+
+static void bench_mtx_mul(mtxDim n, uint32_t rep) {
+    tMatrix a = {n, n, MtxA}, b = {n, n, MtxB}, c = {n, n, MtxC};
+
+    (void)rep;
+    (void)mtx_mul(&a, &b, &c);
+}
+
+static void bench_mtx_mul_src2tr(mtxDim n, uint32_t rep) {
+    tMatrix a = {n, n, MtxA}, b = {n, n, MtxB}, c = {n, n, MtxC};
+
+    (void)rep;
+    (void)mtx_mul_src2tr(&a, &b, &c);
+}
+
+static void bench_mtx_sub_mul_src2tr(mtxDim n, uint32_t rep) {
+    tMatrix a = {n, n, MtxA}, b = {n, n, MtxB}, c = {n, n, MtxC};
+
+    (void)rep;
+    (void)mtx_sub_mul_src2tr(&a, &b, &c);
+}
+
+static void bench_mtx_add(mtxDim n, uint32_t rep) {
+    tMatrix a = {n, n, MtxA}, c = {n, n, MtxC};
+
+    (void)rep;
+    (void)mtx_add(&c, &a);
+}
+
+static void bench_mtx_sub(mtxDim n, uint32_t rep) {
+    tMatrix a = {n, n, MtxA}, c = {n, n, MtxC};
+
+    (void)rep;
+    (void)mtx_sub(&c, &a);
+}
+
+static void bench_mtx_cpy(mtxDim n, uint32_t rep) {
+    tMatrix a = {n, n, MtxA}, c = {n, n, MtxC};
+
+    (void)rep;
+    (void)mtx_cpy(&c, &a);
+}
+
+static void bench_mtx_mul_scalar(mtxDim n, uint32_t rep) {
+    tMatrix c = {n, n, MtxC};
+
+    (void)rep;
+    (void)mtx_mul_scalar(&c, MTX_C(1.0));
+}
+
+static void bench_mtx_chol_lower(mtxDim n, uint32_t rep) {
+    tMatrix s = {n, n, MtxRep[rep]};
+
+    (void)mtx_chol_lower(&s);
+}
+
+static void bench_mtx_chol_semidef(mtxDim n, uint32_t rep) {
+    tMatrix s = {n, n, MtxRep[rep]};
+
+    (void)mtx_chol_semidef(&s);
+}
+
+static void bench_mtx_chol_solve(mtxDim n, uint32_t rep) {
+    tMatrix s = {n, n, MtxRep[rep]}, b = {n, n, MtxRepRhs[rep]};
+
+    (void)mtx_chol_solve(&s, &b);
+}
+
+static void bench_mtx_gj_subst(mtxDim n, uint32_t rep) {
+    tMatrix s = {n, n, MtxRep[rep]}, b = {n, n, MtxRepRhs[rep]};
+
+    (void)mtx_gj_subst(&s, &b);
+}
+
+static void bench_mtx_chol_update(mtxDim n, uint32_t rep) {
+    tMatrix l = {n, n, MtxRep[rep]}, v = {n, 1, MtxRepVec[rep]};
+
+    (void)mtx_chol_update(&l, &v, MTX_C(1.0));
+}
+
+static void bench_mtx_qr_lower(mtxDim n, uint32_t rep) {
+    tMatrix w = {n, (mtxDim)(2u * n), MtxRep[rep]}, c = {n, n, MtxC};
+
+    (void)mtx_qr_lower(&w, &c);
+}
+
+static void bench_mtx_inv(mtxDim n, uint32_t rep) {
+    tMatrix s = {n, n, MtxRep[rep]}, i = {n, n, MtxRepRhs[rep]};
+
+    (void)mtx_inv(&s, &i);
+}
+
+static const tBenchKernel BenchKernel[] = {
+    {"mtx_mul",          NULL,                     &bench_mtx_mul},
+    {"mtx_mul_src2tr",   NULL,                     &bench_mtx_mul_src2tr},
+    {"mtx_sub_mul_src2tr", NULL,                   &bench_mtx_sub_mul_src2tr},
+    {"mtx_add",          NULL,                     &bench_mtx_add},
+    {"mtx_sub",          NULL,                     &bench_mtx_sub},
+    {"mtx_cpy",          NULL,                     &bench_mtx_cpy},
+    {"mtx_mul_scalar",   NULL,                     &bench_mtx_mul_scalar},
+    {"mtx_chol_lower",   &bench_prep_spd,          &bench_mtx_chol_lower},
+    {"mtx_chol_semidef", &bench_prep_spd,          &bench_mtx_chol_semidef},
+    {"mtx_chol_solve",   &bench_prep_spd_rhs,      &bench_mtx_chol_solve},
+    {"mtx_gj_subst",     &bench_prep_spd_rhs,      &bench_mtx_gj_subst},
+    {"mtx_chol_update",  &bench_prep_factor,       &bench_mtx_chol_update},
+    {"mtx_qr_lower",     &bench_prep_wide,         &bench_mtx_qr_lower},
+    {"mtx_inv",          &bench_prep_spd_identity, &bench_mtx_inv},
+};
+
+/**
+ * @brief Fill kernel operands of dimension n: random A, B, W and SPD S = A*A' + n*I with factor L
+ */
+static void bench_mtx_operands(mtxDim n) {
+    tMatrix a = {n, n, MtxA}, s = {n, n, MtxS}, l = {n, n, MtxL};
+    mtxIdx eIdx;
+
+    for (eIdx = 0; eIdx < (mtxIdx)n * n; eIdx++) {
+        MtxA[eIdx] = bench_rand();
+        MtxB[eIdx] = bench_rand();
+        MtxC[eIdx] = 0;
+    }
+    for (eIdx = 0; eIdx < (mtxIdx)n * 2u * n; eIdx++) {
+        MtxW[eIdx] = bench_rand();
+    }
+
+    (void)mtx_mul_src2tr(&a, &a, &s);
+    for (eIdx = 0; eIdx < n; eIdx++) {
+        MtxS[(n + 1u) * eIdx] += n;
+    }
+    (void)mtx_cpy(&l, &s);
+    (void)mtx_chol_lower(&l);
+}
+
+/**
+ * @brief Time every kernel of BenchKernel for dimension n
+ */
+static void bench_mtx(mtxDim n) {
+    const uint32_t nSample = (n > BENCH_LARGE_DIM) ? BENCH_LARGE_SAMPLES : BENCH_MTX_SAMPLES;
+    mtxDim kIdx;
+    uint32_t sIdx, rep;
+
+    bench_mtx_operands(n);
+
+    for (kIdx = 0; kIdx < sizeof(BenchKernel) / sizeof(BenchKernel[0]); kIdx++) {
+        const tBenchKernel *const pK = &BenchKernel[kIdx];
+
+        for (sIdx = 0; sIdx < nSample; sIdx++) {
+            uint32_t t0;
+
+            if (NULL != pK->fcnPrepare) {
+                for (rep = 0; rep < BENCH_MTX_REPS; rep++) {
+                    pK->fcnPrepare(n, rep);
+                }
+            }
+
+            t0 = ukf_prof_clock();
+            for (rep = 0; rep < BENCH_MTX_REPS; rep++) {
+                pK->fcnKernel(n, rep);
+            }
+            BenchSample[sIdx] = ukf_prof_clock() - t0;
+        }
+
+        bench_report("mtx", pK->pName, "-", n, n, BenchSample, nSample, BENCH_MTX_REPS);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const char *const pCsvName = (argc > 1) ? argv[1] : "kfbench.csv";
+    mtxDim idx;
+
+    pBenchCsv = fopen(pCsvName, "w");
+    if (NULL == pBenchCsv) {
+        printf("can't open %s, CSV output disabled\n", pCsvName);
+    } else {
+        fprintf(pBenchCsv, "kind,name,mode,xLen,yLen,samples,mean_ns,p50_ns,p90_ns,p99_ns,max_ns,ops_per_s\n");
+    }
+
+    printf("scalar type: %s\n", BENCH_SCALAR_NAME);
+
+    UkfMatrixCfg.filter_mode = UKF_MODE_STANDARD;
+    bench_step(&UkfMatrixCfg, "ukfCfg");
+    UkfMatrixCfg.filter_mode = UKF_MODE_SQRT;
+    bench_step(&UkfMatrixCfg, "ukfCfg");
+    bench_ref();
+    bench_replay();
+    bench_batch();
+    bench_imm(16, 8, 0);
+    bench_imm(16, 8, 1);
+
+    for (idx = 0; idx < sizeof(BenchCfg) / sizeof(BenchCfg[0]); idx++) {
+        bench_step_synthetic(BenchCfg[idx].xLen, BenchCfg[idx].yLen, UKF_MODE_STANDARD, UKF_SIGMA_SYMMETRIC);
+        bench_step_synthetic(BenchCfg[idx].xLen, BenchCfg[idx].yLen, UKF_MODE_SQRT, UKF_SIGMA_SYMMETRIC);
+        bench_step_synthetic(BenchCfg[idx].xLen, BenchCfg[idx].yLen, UKF_MODE_STANDARD, UKF_SIGMA_SIMPLEX);
+    }
+
+    for (idx = 0; idx < sizeof(BenchMtxDim) / sizeof(BenchMtxDim[0]); idx++) {
+        bench_mtx(BenchMtxDim[idx]);
+    }
+
+    if (NULL != pBenchCsv) {
+        (void)fclose(pBenchCsv);
+    }
+
+    return 0;
+}
@@ -21,32 +21,55 @@
  */
 
 #include "ukfCfg.h"
+#include "ukfBatch.h"
+#include "ukfFix.h"
 #include <stdint.h>
 #include <math.h>
 
-static void Fx1(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, uint8_t sigmaIdx, float dT);
-static void Fx2(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, uint8_t sigmaIdx, float dT);
-static void Fx3(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, uint8_t sigmaIdx, float dT);
-static void Fx4(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, uint8_t sigmaIdx, float dT);
+static void Fx1(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, mtxDim sigmaIdx, mtxScalar dT);
+static void Fx2(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, mtxDim sigmaIdx, mtxScalar dT);
+static void Fx3(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, mtxDim sigmaIdx, mtxScalar dT);
+static void Fx4(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, mtxDim sigmaIdx, mtxScalar dT);
 
-static void Hy1(tMatrix* pu, tMatrix* pX_m, tMatrix* pY_m, uint8_t sigmaIdx);
-static void Hy2(tMatrix* pu, tMatrix* pX_m, tMatrix* pY_m, uint8_t sigmaIdx);
+static void Hy1(tMatrix* pu, tMatrix* pX_m, tMatrix* pY_m, mtxDim sigmaIdx);
+static void Hy2(tMatrix* pu, tMatrix* pX_m, tMatrix* pY_m, mtxDim sigmaIdx);
+
+static void FxBatch(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, mtxDim sigmaIdx, mtxDim sigmaCnt, mtxScalar dT);
+static void HyBatch(tMatrix* pu, tMatrix* pX_m, tMatrix* pY_m, mtxDim sigmaIdx, mtxDim sigmaCnt);
+
+static void FxSoa(mtxScalar const *pX_p, mtxScalar *pX_m, uint32_t nCol, mtxScalar dT);
+static void HySoa(mtxScalar const *pX_m, mtxScalar *pY_m, uint32_t nCol);
+
+static void FxFix(mtxFix *px, mtxFix dT);
+static void HyFix(mtxFix const *px_m, mtxFix *py_m);
+
+#if defined(UKF_SIGMA_MAJOR)
+static void FxVec(mtxScalar const *pu_p, mtxScalar *px, mtxScalar dT);
+static void HyVec(mtxScalar const *pu, mtxScalar const *px_m, mtxScalar *py_m);
+#endif
 
 static tPredictFcn PredictFcn[Lx] = {&Fx1, &Fx2, &Fx3, &Fx4};
 static tObservFcn ObservFcn[Ly] = {&Hy1, &Hy2};
 
 //! UKF Processing matrix
-static float Sc_vector[1][3] = {{1, 2, 0}};
-static float Wm_weight_vector[1][2*Lx + 1] = {{0, 0, 0, 0, 0, 0, 0, 0, 0}};
-static float Wc_weight_vector[1][2*Lx + 1] = {{0, 0, 0, 0, 0, 0, 0, 0, 0}};
+static mtxScalar Sc_vector[1][3] = {{1, 2, 0}};
+static mtxScalar Wm_weight_vector[1][2*Lx + 1] = {{0, 0, 0, 0, 0, 0, 0, 0, 0}};
+static mtxScalar Wc_weight_vector[1][2*Lx + 1] = {{0, 0, 0, 0, 0, 0, 0, 0, 0}};
 //static float u_system_input[4][1] = {{0},{0},{0},{0}};
 //static float u_prev_system_input[4][1] = {{0},{0},{0},{0}};
-static float y_meas[Ly][1] = {{0}, {0}};
-static float y_predicted_mean[Ly][1] = {{0}, {0}};
-static float x_system_states[Lx][1] = {{0}, {0}, {50}, {50}};
-static float x_system_states_ic[Lx][1] = {{0}, {0}, {50}, {50}};
-static float x_system_states_correction[Lx][1] = {{0}, {0}, {0}, {0}};
-static float X_sigma_points[Lx][2*Lx + 1] =
+static mtxScalar y_meas[Ly][1] = {{0}, {0}};
+static uint8_t y_meas_valid[Ly][1] = {{1}, {1}};
+static mtxScalar y_predicted_mean[Ly][1] = {{0}, {0}};
+static mtxScalar x_system_states[Lx][1] = {{0}, {0}, {50}, {50}};
+static mtxScalar x_system_states_ic[Lx][1] = {{0}, {0}, {50}, {50}};
+#if defined(UKF_SIGMA_MAJOR)
+//! Sigma points X(k-1), X(k|k-1): one row per sigma point
+static mtxScalar X_sigma_points[2*Lx + 1][Lx];
+
+//! Sigma points Y(k|k-1) = y_m: one row per sigma point
+static mtxScalar Y_sigma_points[2*Lx + 1][Ly];
+#else
+static mtxScalar X_sigma_points[Lx][2*Lx + 1] =
     {
         /*  s1  s2  s3  s4  s5  s6  s7  s8  s9        */
         {0, 0, 0, 0, 0, 0, 0, 0, 0}, /* x1 */
@@ -56,15 +79,16 @@ static float X_sigma_points[Lx][2*Lx + 1] =
 };
 
 //! Sigma points Y(k|k-1) = y_m
-static float Y_sigma_points[Ly][2*Lx + 1] =
+static mtxScalar Y_sigma_points[Ly][2*Lx + 1] =
     {
         /*  s1  s2  s3  s4  s5  s6  s7  s8  s9        */
         {0, 0, 0, 0, 0, 0, 0, 0, 0}, /* y1 */
         {0, 0, 0, 0, 0, 0, 0, 0, 0}, /* y2 */
 };
+#endif
 
 //! State covariance  P(k|k-1) = P_m, P(k)= P
-static float Pxx_error_covariance[Lx][Lx] =
+static mtxScalar Pxx_error_covariance[Lx][Lx] =
     {
         /*  x1, x2, x3, x4        */
         {0, 0, 0, 0}, /* x1 */
@@ -87,7 +111,7 @@ with the diagonal components corresponding to the expected variance
 in the corresponding state, i.e. how much deviation you might expect 
 in the initialization of that state.  If you have no idea where to start, 
 I recommend using an identity matrix rather than the zero matrix. */
-static float Pxx0_init_error_covariance[Lx][Lx] =
+static mtxScalar Pxx0_init_error_covariance[Lx][Lx] =
     {
         /*  x1, x2, x3, x4        */
         {1, 0, 0, 0}, /* x1 */
@@ -107,7 +131,7 @@ If you are very confident in your equations, you could set Q to zero.
 If you do that the filter will use
 the noise free model to predict the state vector and will ignore any 
 measurement data since your model is assumed perfect. */
-static float Qxx_process_noise_cov[Lx][Lx] =
+static mtxScalar Qxx_process_noise_cov[Lx][Lx] =
     {
         /*  x1, x2, x3, x4        */
         {0, 0, 0, 0}, /* x1 */
@@ -117,7 +141,7 @@ static float Qxx_process_noise_cov[Lx][Lx] =
 };
 
 //! Output noise covariance: initial noise assumptions
-static float Ryy0_init_out_covariance[Ly][Ly] =
+static mtxScalar Ryy0_init_out_covariance[Ly][Ly] =
     {
         /*  y1, y2         */
         {1, 0}, /* y1 */
@@ -125,22 +149,18 @@ static float Ryy0_init_out_covariance[Ly][Ly] =
 };
 
 //! Output covariance Pyy = R (initial assumption)
-static float Pyy_out_covariance[Ly][Ly] =
+static mtxScalar Pyy_out_covariance[Ly][Ly] =
     {
         /*  y1, y2         */
         {0, 0}, /* y1 */
         {0, 0}, /* y2 */
 };
 
-static float Pyy_out_covariance_copy[Ly][Ly] =
-    {
-        /*  y1, y2         */
-        {0, 0}, /* y1 */
-        {0, 0}, /* y2 */
-};
+//! Backup of Pyy for its repair by tUKF.health.recover
+static mtxScalar Pyy_out_covariance_copy[Ly][Ly];
 
 //! cross-covariance of state and output
-static float Pxy_cross_covariance[Lx][Ly] =
+static mtxScalar Pxy_cross_covariance[Lx][Ly] =
     {
         /*  y1, y2         */
         {0, 0}, /* x1 */
@@ -149,30 +169,13 @@ static float Pxy_cross_covariance[Lx][Ly] =
         {0, 0}, /* x4 */
 };
 
-//! Kalman gain matrix
-static float K_kalman_gain[Lx][Ly] =
-    {
-        {0, 0},
-        {0, 0},
-        {0, 0},
-        {0, 0},
-};
-
-static float Pxx_covariance_correction[Lx][Lx] =
-    {
-        /*  x1, x2, x3, x4        */
-        {0, 0, 0, 0}, /* x1 */
-        {0, 0, 0, 0}, /* x2 */
-        {0, 0, 0, 0}, /* x3 */
-        {0, 0, 0, 0}, /* x4 */
-};
-
-static float I_identity_matrix[Ly][Ly] =
-    {
-        {0, 0},
-        {0, 0},
-};
+//! Square-root UKF buffers (UKF_MODE_SQRT): sqrt(Q), sqrt(R) and QR compound workspace
+static mtxScalar Sqxx_process_noise_sqrt[Lx][Lx];
+static mtxScalar Sryy_out_noise_sqrt[Ly][Ly];
+static mtxScalar Sr_compound_workspace[Lx][2*Lx + 1 + Lx];
 
+//! Kalman gain and the square-root downdate column have no arrays of their own: step temporaries
+//! with disjoint lifetimes share storage like in ukf_mem_layout()
 tUkfMatrix UkfMatrixCfg = {
     .Sc_vector                      = {NROWS(Sc_vector),        NCOL(Sc_vector),        &Sc_vector[0][0]},
     .Wm_weight_vector               = {NROWS(Wm_weight_vector), NCOL(Wm_weight_vector), &Wm_weight_vector[0][0]},
@@ -181,13 +184,14 @@ tUkfMatrix UkfMatrixCfg = {
     .x_system_states_ic             = {NROWS(x_system_states_ic), NCOL(x_system_states_ic), &x_system_states_ic[0][0]},
     .x_system_states_limits         = {0, 0, NULL},
     .x_system_states_limits_enable  = {0, 0, NULL},
-    .x_system_states_correction     = {NROWS(x_system_states_correction), NCOL(x_system_states_correction), &x_system_states_correction[0][0]},
+    .x_system_states_correction     = {Lx, 1, &Sr_compound_workspace[0][0]},
     .u_system_input                 = {0, 0, NULL},
     .u_prev_system_input            = {0, 0, NULL},
     .X_sigma_points                 = {NROWS(X_sigma_points), NCOL(X_sigma_points), &X_sigma_points[0][0]},
     .Y_sigma_points                 = {NROWS(Y_sigma_points), NCOL(Y_sigma_points), &Y_sigma_points[0][0]},
     .y_predicted_mean               = {NROWS(y_predicted_mean), NCOL(y_predicted_mean), &y_predicted_mean[0][0]},
     .y_meas                         = {NROWS(y_meas), NCOL(y_meas), &y_meas[0][0]},
+    .y_meas_valid                   = {NROWS(y_meas_valid), NCOL(y_meas_valid), &y_meas_valid[0][0]},
     .Pyy_out_covariance             = {NROWS(Pyy_out_covariance), NCOL(Pyy_out_covariance), &Pyy_out_covariance[0][0]},
     .Pyy_out_covariance_copy        = {NROWS(Pyy_out_covariance_copy), NCOL(Pyy_out_covariance_copy), &Pyy_out_covariance_copy[0][0]},
     .Ryy0_init_out_covariance       = {NROWS(Ryy0_init_out_covariance), NCOL(Ryy0_init_out_covariance), &Ryy0_init_out_covariance[0][0]},
@@ -195,12 +199,65 @@ tUkfMatrix UkfMatrixCfg = {
     .Pxx_error_covariance           = {NROWS(Pxx_error_covariance), NCOL(Pxx_error_covariance), &Pxx_error_covariance[0][0]},
     .Pxx0_init_error_covariance     = {NROWS(Pxx0_init_error_covariance), NCOL(Pxx0_init_error_covariance), &Pxx0_init_error_covariance[0][0]},
     .Qxx_process_noise_cov          = {NROWS(Qxx_process_noise_cov), NCOL(Qxx_process_noise_cov), &Qxx_process_noise_cov[0][0]},
-    .K_kalman_gain                  = {NROWS(K_kalman_gain), NCOL(K_kalman_gain), &K_kalman_gain[0][0]},
-    .I_identity_matrix              = {NROWS(I_identity_matrix), NCOL(I_identity_matrix), &I_identity_matrix[0][0]},
-    .Pxx_covariance_correction      = {NROWS(Pxx_covariance_correction), NCOL(Pxx_covariance_correction), &Pxx_covariance_correction[0][0]},
+    .K_kalman_gain                  = {Lx, Ly, &Y_sigma_points[0][0]},
+    .I_identity_matrix              = {0, 0, NULL},
+    .Pxx_covariance_correction      = {0, 0, NULL},
+    .Sqxx_process_noise_sqrt        = {NROWS(Sqxx_process_noise_sqrt), NCOL(Sqxx_process_noise_sqrt), &Sqxx_process_noise_sqrt[0][0]},
+    .Sryy_out_noise_sqrt            = {NROWS(Sryy_out_noise_sqrt), NCOL(Sryy_out_noise_sqrt), &Sryy_out_noise_sqrt[0][0]},
+    .Sr_compound_workspace          = {NROWS(Sr_compound_workspace), NCOL(Sr_compound_workspace), &Sr_compound_workspace[0][0]},
+    .F_state_transition             = {0, 0, NULL},
+    .B_input_matrix                 = {0, 0, NULL},
     .fcnPredict                     = &PredictFcn[0],
     .fcnObserve                     = &ObservFcn[0],
-    .dT                             = 0.1F
+    .fcnPredictBatch                = &FxBatch,
+    .fcnObserveBatch                = &HyBatch,
+#if defined(UKF_SIGMA_MAJOR)
+    .fcnPredictVec                  = &FxVec,
+    .fcnObserveVec                  = &HyVec,
+#endif
+    .dT                             = MTX_C(0.1),
+    .filter_mode                    = UKF_MODE_STANDARD,
+    .update_mode                    = UKF_UPDATE_AUTO,
+    .sigma_scheme                   = UKF_SIGMA_SYMMETRIC
+};
+
+//! Structure of arrays callbacks of the same model for the lockstep batch engine (ukfBatch.c)
+tUkfBatchModel UkfBatchModelCfg = {
+    .fcnPredict                     = &FxSoa,
+    .fcnObserve                     = &HySoa
+};
+
+//! Q formats of the fixed-point engine (ukfFix.c): positions, velocities and ranges stay below 128 (Q15) or 2048 (Q31)
+#if defined(MTX_FIX_Q15)
+#define UKF_FIX_X_FRAC (8)
+#define UKF_FIX_Y_FRAC (8)
+#define UKF_FIX_P_FRAC (8)
+#define UKF_FIX_K_FRAC (12)
+#define UKF_FIX_W_FRAC (12)
+#define UKF_FIX_T_FRAC (14)
+#else
+#define UKF_FIX_X_FRAC (20)
+#define UKF_FIX_Y_FRAC (20)
+#define UKF_FIX_P_FRAC (20)
+#define UKF_FIX_K_FRAC (24)
+#define UKF_FIX_W_FRAC (24)
+#define UKF_FIX_T_FRAC (24)
+#endif
+
+tUkfFixScale UkfFixScaleCfg = {
+    .xFrac                          = UKF_FIX_X_FRAC,
+    .yFrac                          = UKF_FIX_Y_FRAC,
+    .pxxFrac                        = UKF_FIX_P_FRAC,
+    .pyyFrac                        = UKF_FIX_P_FRAC,
+    .kFrac                          = UKF_FIX_K_FRAC,
+    .wFrac                          = UKF_FIX_W_FRAC,
+    .tFrac                          = UKF_FIX_T_FRAC
+};
+
+//! Fixed-point callbacks of the same model for ukfFix.c
+tUkfFixModel UkfFixModelCfg = {
+    .fcnPredict                     = &FxFix,
+    .fcnObserve                     = &HyFix
 };
 
 /**
@@ -214,10 +271,8 @@ tUkfMatrix UkfMatrixCfg = {
  * @param sigmaIdx Sigma point index.
  * @param dT Sampling time.
  */
-static void Fx1(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, uint8_t sigmaIdx, float dT) {
-    const uint8_t nCol = pX_m->ncol;  //pX_m->ncol == pX_p->ncol == 9
-
-    pX_m->val[nCol * 0 + sigmaIdx] = pX_p->val[nCol * 0 + sigmaIdx] + dT * pX_p->val[nCol * 2 + sigmaIdx];
+static void Fx1(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, mtxDim sigmaIdx, mtxScalar dT) {
+    UKF_SIGMA_AT(pX_m, 0, sigmaIdx) = UKF_SIGMA_AT(pX_p, 0, sigmaIdx) + dT * UKF_SIGMA_AT(pX_p, 2, sigmaIdx);
 
     pu_p = pu_p;
 }
@@ -233,10 +288,8 @@ static void Fx1(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, uint8_t sigmaIdx, f
  * @param sigmaIdx Sigma point index.
  * @param dT Sampling time.
  */
-static void Fx2(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, uint8_t sigmaIdx, float dT) {
-    const uint8_t nCol = pX_m->ncol;  //pX_m->ncol == pX_p->ncol == 9
-
-    pX_m->val[nCol * 1 + sigmaIdx] = pX_p->val[nCol * 1 + sigmaIdx] + dT * pX_p->val[nCol * 3 + sigmaIdx];
+static void Fx2(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, mtxDim sigmaIdx, mtxScalar dT) {
+    UKF_SIGMA_AT(pX_m, 1, sigmaIdx) = UKF_SIGMA_AT(pX_p, 1, sigmaIdx) + dT * UKF_SIGMA_AT(pX_p, 3, sigmaIdx);
 
     pu_p = pu_p;
 }
@@ -252,10 +305,8 @@ static void Fx2(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, uint8_t sigmaIdx, f
  * @param sigmaIdx Sigma point index.
  * @param dT Sampling time.
  */
-static void Fx3(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, uint8_t sigmaIdx, float dT) {
-    const uint8_t nCol = pX_m->ncol;  //pX_m->ncol == pX_p->ncol == 9
-
-    pX_m->val[nCol * 2 + sigmaIdx] = pX_p->val[nCol * 2 + sigmaIdx];
+static void Fx3(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, mtxDim sigmaIdx, mtxScalar dT) {
+    UKF_SIGMA_AT(pX_m, 2, sigmaIdx) = UKF_SIGMA_AT(pX_p, 2, sigmaIdx);
 
     pu_p = pu_p;
     dT = dT;
@@ -272,10 +323,8 @@ static void Fx3(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, uint8_t sigmaIdx, f
  * @param sigmaIdx Sigma point index.
  * @param dT Sampling time.
  */
-static void Fx4(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, uint8_t sigmaIdx, float dT) {
-    const uint8_t nCol = pX_m->ncol;  //pX_m->ncol == pX_p->ncol == 9
-
-    pX_m->val[nCol * 3 + sigmaIdx] = pX_p->val[nCol * 3 + sigmaIdx];
+static void Fx4(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, mtxDim sigmaIdx, mtxScalar dT) {
+    UKF_SIGMA_AT(pX_m, 3, sigmaIdx) = UKF_SIGMA_AT(pX_p, 3, sigmaIdx);
 
     pu_p = pu_p;
     dT = dT;
@@ -284,27 +333,26 @@ static void Fx4(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, uint8_t sigmaIdx, f
 /**
  * @brief  Calculate predicted state 3 for each sigma point. 
  * This problem has a nonlinear observation 
- * Y_m[0][sigmaIdx] = h1(X_m, u) = y1(k)  = sqrtf((n(k)-N1)^2+(e(k)-E1)^2)   
+ * Y_m[0][sigmaIdx] = h1(X_m, u) = y1(k)  = MTX_SQRT((n(k)-N1)^2+(e(k)-E1)^2)   
  * 
  * @param pu NULL for this system, be sure that is not used in calc
  * @param pX_m Pointer to the predicted output at (k|k-1) moment (i.e prediction in moment k based on states in (k-1))
  * @param pY_m Pointer to the propagetad sigma points array at (k|k-1) moment (i.e prediction in moment k based on states in (k-1))
  * @param sigmaIdx Sigma point index.
  */
-static void Hy1(tMatrix* pu, tMatrix* pX_m, tMatrix* pY_m, uint8_t sigmaIdx) {
-    static const float N1 = 20;
-    static const float E1 = 0;
-    float term1;
-    float term2;
-    const uint8_t nCol = pY_m->ncol;
-
-    term1 = pX_m->val[nCol * 0 + sigmaIdx] - N1;
+static void Hy1(tMatrix* pu, tMatrix* pX_m, tMatrix* pY_m, mtxDim sigmaIdx) {
+    static const mtxScalar N1 = 20;
+    static const mtxScalar E1 = 0;
+    mtxScalar term1;
+    mtxScalar term2;
+
+    term1 = UKF_SIGMA_AT(pX_m, 0, sigmaIdx) - N1;
     term1 *= term1;
 
-    term2 = pX_m->val[nCol * 1 + sigmaIdx] - E1;
+    term2 = UKF_SIGMA_AT(pX_m, 1, sigmaIdx) - E1;
     term2 *= term2;
 
-    pY_m->val[sigmaIdx] = sqrtf(term1 + term2);
+    UKF_SIGMA_AT(pY_m, 0, sigmaIdx) = MTX_SQRT(term1 + term2);
 
     pu = pu;
 }
@@ -312,27 +360,199 @@ static void Hy1(tMatrix* pu, tMatrix* pX_m, tMatrix* pY_m, uint8_t sigmaIdx) {
 /**
  * @brief Calculate predicted state 3 for each sigma point. 
  * This problem has a nonlinear observation 
- * Y_m[1][sigmaIdx] = h2(X_m[0&1][sigmaIdx], u) = y2(k)  = sqrtf( (n(k) - N2)^2 + (e(k) - E2)^2 )    
+ * Y_m[1][sigmaIdx] = h2(X_m[0&1][sigmaIdx], u) = y2(k)  = MTX_SQRT( (n(k) - N2)^2 + (e(k) - E2)^2 )    
  * 
  * @param pu NULL for this system, be sure that is not used in calc
  * @param pX_m Pointer to the predicted output at (k|k-1) moment (i.e prediction in moment k based on states in (k-1))
  * @param pY_m Pointer to the propagetad sigma points array at (k|k-1) moment (i.e prediction in moment k based on states in (k-1))
  * @param sigmaIdx Sigma point index.
  */
-static void Hy2(tMatrix* pu, tMatrix* pX_m, tMatrix* pY_m, uint8_t sigmaIdx) {
-    static const float N2 = 0;
-    static const float E2 = 20;
-    float term1;
-    float term2;
-    const uint8_t nCol = pY_m->ncol;
-
-    term1 = pX_m->val[nCol * 0 + sigmaIdx] - N2;
+static void Hy2(tMatrix* pu, tMatrix* pX_m, tMatrix* pY_m, mtxDim sigmaIdx) {
+    static const mtxScalar N2 = 0;
+    static const mtxScalar E2 = 20;
+    mtxScalar term1;
+    mtxScalar term2;
+
+    term1 = UKF_SIGMA_AT(pX_m, 0, sigmaIdx) - N2;
     term1 *= term1;
 
-    term2 = pX_m->val[nCol * 1 + sigmaIdx] - E2;
+    term2 = UKF_SIGMA_AT(pX_m, 1, sigmaIdx) - E2;
     term2 *= term2;
 
-    pY_m->val[nCol * 1 + sigmaIdx] = sqrtf(term1 + term2);
+    UKF_SIGMA_AT(pY_m, 1, sigmaIdx) = MTX_SQRT(term1 + term2);
 
     pu = pu;
 }
+
+/**
+ * @brief Batched prediction of all states for sigma columns [sigmaIdx, sigmaIdx + sigmaCnt).
+ * Same model as Fx1..Fx4, evaluated in one call.
+ * 
+ * @param pu_p NULL for this system, be sure that is not used in calc
+ * @param pX_p Pointer to the sigma points array at (k-1) moment 
+ * @param pX_m Pointer to the propagetad sigma points array at (k|k-1) moment, same memory as pX_p
+ * @param sigmaIdx First sigma point index.
+ * @param sigmaCnt Number of sigma points to propagate.
+ * @param dT Sampling time.
+ */
+static void FxBatch(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, mtxDim sigmaIdx, mtxDim sigmaCnt, mtxScalar dT) {
+    const mtxDim sigmaEnd = sigmaIdx + sigmaCnt;
+    mtxDim sIdx;
+
+    for (sIdx = sigmaIdx; sIdx < sigmaEnd; sIdx++) {
+        //ndot(k) = ndot(k-1), edot(k) = edot(k-1): states 2 and 3 stay in place
+        UKF_SIGMA_AT(pX_m, 0, sIdx) = UKF_SIGMA_AT(pX_p, 0, sIdx) + dT * UKF_SIGMA_AT(pX_p, 2, sIdx);
+        UKF_SIGMA_AT(pX_m, 1, sIdx) = UKF_SIGMA_AT(pX_p, 1, sIdx) + dT * UKF_SIGMA_AT(pX_p, 3, sIdx);
+    }
+
+    pu_p = pu_p;
+}
+
+/**
+ * @brief Batched observation of both outputs for sigma columns [sigmaIdx, sigmaIdx + sigmaCnt).
+ * Same model as Hy1 and Hy2, evaluated in one call.
+ * 
+ * @param pu NULL for this system, be sure that is not used in calc
+ * @param pX_m Pointer to the propagetad sigma points array at (k|k-1) moment
+ * @param pY_m Pointer to the output sigma points array at (k|k-1) moment
+ * @param sigmaIdx First sigma point index.
+ * @param sigmaCnt Number of sigma points to propagate.
+ */
+static void HyBatch(tMatrix* pu, tMatrix* pX_m, tMatrix* pY_m, mtxDim sigmaIdx, mtxDim sigmaCnt) {
+    static const mtxScalar N1 = 20;
+    static const mtxScalar E1 = 0;
+    static const mtxScalar N2 = 0;
+    static const mtxScalar E2 = 20;
+    const mtxDim sigmaEnd = sigmaIdx + sigmaCnt;
+    mtxDim sIdx;
+
+    for (sIdx = sigmaIdx; sIdx < sigmaEnd; sIdx++) {
+        const mtxScalar dN1 = UKF_SIGMA_AT(pX_m, 0, sIdx) - N1;
+        const mtxScalar dE1 = UKF_SIGMA_AT(pX_m, 1, sIdx) - E1;
+        const mtxScalar dN2 = UKF_SIGMA_AT(pX_m, 0, sIdx) - N2;
+        const mtxScalar dE2 = UKF_SIGMA_AT(pX_m, 1, sIdx) - E2;
+
+        UKF_SIGMA_AT(pY_m, 0, sIdx) = MTX_SQRT(dN1 * dN1 + dE1 * dE1);
+        UKF_SIGMA_AT(pY_m, 1, sIdx) = MTX_SQRT(dN2 * dN2 + dE2 * dE2);
+    }
+
+    pu = pu;
+}
+
+#if defined(UKF_SIGMA_MAJOR)
+/**
+ * @brief Prediction of one dense sigma point (UKF_SIGMA_MAJOR), same model as Fx1..Fx4.
+ * 
+ * @param pu_p NULL for this system, be sure that is not used in calc
+ * @param px Sigma point X_p(i) on entry, X_m(i) on return
+ * @param dT Sampling time.
+ */
+static void FxVec(mtxScalar const *pu_p, mtxScalar *px, mtxScalar dT) {
+    //ndot(k) = ndot(k-1), edot(k) = edot(k-1)
+    px[0] += dT * px[2];
+    px[1] += dT * px[3];
+
+    pu_p = pu_p;
+}
+
+/**
+ * @brief Observation of one dense sigma point (UKF_SIGMA_MAJOR), same model as Hy1 and Hy2.
+ * 
+ * @param pu NULL for this system, be sure that is not used in calc
+ * @param px_m Propagated sigma point X_m(i)
+ * @param py_m Output sigma point Y_m(i)
+ */
+static void HyVec(mtxScalar const *pu, mtxScalar const *px_m, mtxScalar *py_m) {
+    static const mtxScalar N1 = 20;
+    static const mtxScalar E1 = 0;
+    static const mtxScalar N2 = 0;
+    static const mtxScalar E2 = 20;
+    const mtxScalar dN1 = px_m[0] - N1;
+    const mtxScalar dE1 = px_m[1] - E1;
+    const mtxScalar dN2 = px_m[0] - N2;
+    const mtxScalar dE2 = px_m[1] - E2;
+
+    py_m[0] = MTX_SQRT(dN1 * dN1 + dE1 * dE1);
+    py_m[1] = MTX_SQRT(dN2 * dN2 + dE2 * dE2);
+
+    pu = pu;
+}
+#endif
+
+/**
+ * @brief Structure of arrays prediction of all states for all sigma points of all filters.
+ * Same model as Fx1..Fx4, each state row is one contiguous vector of nCol elements.
+ * 
+ * @param pX_p Sigma points at (k-1) moment (xLen x nCol)
+ * @param pX_m Propagated sigma points at (k|k-1) moment (xLen x nCol)
+ * @param nCol Number of sigma points times number of filters
+ * @param dT Sampling time.
+ */
+static void FxSoa(mtxScalar const *pX_p, mtxScalar *pX_m, uint32_t nCol, mtxScalar dT) {
+    uint32_t cIdx;
+
+    for (cIdx = 0; cIdx < nCol; cIdx++) {
+        pX_m[nCol * 0 + cIdx] = pX_p[nCol * 0 + cIdx] + dT * pX_p[nCol * 2 + cIdx];
+        pX_m[nCol * 1 + cIdx] = pX_p[nCol * 1 + cIdx] + dT * pX_p[nCol * 3 + cIdx];
+        pX_m[nCol * 2 + cIdx] = pX_p[nCol * 2 + cIdx];
+        pX_m[nCol * 3 + cIdx] = pX_p[nCol * 3 + cIdx];
+    }
+}
+
+/**
+ * @brief Structure of arrays observation of both outputs for all sigma points of all filters.
+ * Same model as Hy1 and Hy2.
+ * 
+ * @param pX_m Propagated sigma points at (k|k-1) moment (xLen x nCol)
+ * @param pY_m Output sigma points at (k|k-1) moment (yLen x nCol)
+ * @param nCol Number of sigma points times number of filters
+ */
+static void HySoa(mtxScalar const *pX_m, mtxScalar *pY_m, uint32_t nCol) {
+    static const mtxScalar N1 = 20;
+    static const mtxScalar E1 = 0;
+    static const mtxScalar N2 = 0;
+    static const mtxScalar E2 = 20;
+    uint32_t cIdx;
+
+    for (cIdx = 0; cIdx < nCol; cIdx++) {
+        const mtxScalar dN1 = pX_m[nCol * 0 + cIdx] - N1;
+        const mtxScalar dE1 = pX_m[nCol * 1 + cIdx] - E1;
+        const mtxScalar dN2 = pX_m[nCol * 0 + cIdx] - N2;
+        const mtxScalar dE2 = pX_m[nCol * 1 + cIdx] - E2;
+
+        pY_m[nCol * 0 + cIdx] = MTX_SQRT(dN1 * dN1 + dE1 * dE1);
+        pY_m[nCol * 1 + cIdx] = MTX_SQRT(dN2 * dN2 + dE2 * dE2);
+    }
+}
+
+/**
+ * @brief Fixed-point prediction of one dense sigma point, same model as Fx1..Fx4.
+ * 
+ * @param px Sigma point X_p(i) on entry, X_m(i) on return (UKF_FIX_X_FRAC)
+ * @param dT Sampling time (UKF_FIX_T_FRAC)
+ */
+static void FxFix(mtxFix *px, mtxFix dT) {
+    //ndot(k) = ndot(k-1), edot(k) = edot(k-1)
+    px[0] = mtx_fix_adds(px[0], mtx_fix_mulq(dT, px[2], UKF_FIX_T_FRAC));
+    px[1] = mtx_fix_adds(px[1], mtx_fix_mulq(dT, px[3], UKF_FIX_T_FRAC));
+}
+
+/**
+ * @brief Fixed-point observation of one dense sigma point, same model as Hy1 and Hy2.
+ * 
+ * @param px_m Propagated sigma point X_m(i) (UKF_FIX_X_FRAC)
+ * @param py_m Output sigma point Y_m(i) (UKF_FIX_Y_FRAC)
+ */
+static void HyFix(mtxFix const *px_m, mtxFix *py_m) {
+    const mtxFix N1 = (mtxFix)(20 << UKF_FIX_X_FRAC);
+    const mtxFix E2 = (mtxFix)(20 << UKF_FIX_X_FRAC);
+    const mtxFixAcc dN1 = (mtxFixAcc)px_m[0] - N1;
+    const mtxFixAcc dE1 = px_m[1];
+    const mtxFixAcc dN2 = px_m[0];
+    const mtxFixAcc dE2 = (mtxFixAcc)px_m[1] - E2;
+    //squares carry 2*UKF_FIX_X_FRAC fractional bits, their sqrt UKF_FIX_X_FRAC
+    const int8_t shift = 2 * (UKF_FIX_X_FRAC - UKF_FIX_Y_FRAC);
+
+    py_m[0] = mtx_fix_sat(mtx_fix_isqrt((mtxFixUAcc)mtx_fix_shr(dN1 * dN1 + dE1 * dE1, shift)));
+    py_m[1] = mtx_fix_sat(mtx_fix_isqrt((mtxFixUAcc)mtx_fix_shr(dN2 * dN2 + dE2 * dE2, shift)));
+}
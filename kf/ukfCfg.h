@@ -13,5 +13,10 @@
 #define Lx (4u)
 #define Ly (2u)
 
+//! Dimensions ukf_step() is specialized for when ukfLib.c is built with -DUKF_SPEC_HEADER='"ukfCfg.h"'
+#ifndef UKF_SPEC_DIMS
+#define UKF_SPEC_DIMS UKF_SPEC(Lx, Ly)
+#endif
+
 #endif /* UKFCFG_H */
 
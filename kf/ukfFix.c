@@ -0,0 +1,383 @@
+/**
+ * @file ukfFix.c
+ * @brief Fixed-point additive noise UKF for MCUs without FPU headroom.
+ * The math follows ukf_step() in UKF_MODE_STANDARD with the symmetric sigma set
+ * and the Cholesky gain solve. All step arithmetic is integer: every matrix has
+ * its own Q format (tUkfFixScale), products are accumulated at full precision,
+ * rounded once to the destination format and saturated. Only ukf_fix_init()
+ * uses floating point, to convert the shared tUkfMatrix configuration.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ukfFix.h"
+#include "ukfMem.h"
+
+#define UKF_FIX_ROUND(size) (((size) + (UKF_MEM_ALIGN - 1u)) & ~(uint32_t)(UKF_MEM_ALIGN - 1u))
+#define UKF_FIX_FRAC_MAX ((int8_t)(sizeof(mtxFix) * 8u - 1u))
+
+static uint32_t ukf_fix_assign  (tUkfFix *pFix, uint8_t *pBase, mtxDim xLen, mtxDim yLen);
+static void     ukf_fix_take    (uint8_t **ppCur, uint32_t *pUsed, tMatrixFix *pMtx, mtxDim nrow, mtxDim ncol, int8_t frac);
+static void     ukf_fix_mean    (tMatrixFix *pZ, const tMatrixFix *pWm, tMatrixFix *pz, uint8_t *pSat);
+static void     ukf_fix_cov     (const tMatrixFix *pA, const tMatrixFix *pB, const tMatrixFix *pWc, const tMatrixFix *pN, tMatrixFix *pP, uint8_t *pSat);
+
+/**
+ * @brief Reserve one aligned fixed-point matrix
+ *
+ * @param ppCur Current position in memory block, NULL content if only size is calculated
+ * @param pUsed Accumulated number of bytes
+ * @param pMtx Matrix descriptor
+ * @param nrow Number of rows
+ * @param ncol Number of columns
+ * @param frac Number of fractional bits
+ */
+static void ukf_fix_take(uint8_t **ppCur, uint32_t *pUsed, tMatrixFix *pMtx, mtxDim nrow, mtxDim ncol, int8_t frac) {
+    const uint32_t size = UKF_FIX_ROUND((uint32_t)nrow * ncol * (uint32_t)sizeof(mtxFix));
+
+    pMtx->nrow = nrow;
+    pMtx->ncol = ncol;
+    pMtx->frac = frac;
+    pMtx->val = (mtxFix *)*ppCur;
+
+    if (NULL != *ppCur) {
+        *ppCur += size;
+    }
+    *pUsed += size;
+}
+
+/**
+ * @brief Assign all fixed-point buffers from memory block (or only count bytes if pBase is NULL)
+ *
+ * @param pFix Fixed-point filter, scale must be assigned
+ * @param pBase Aligned memory block or NULL
+ * @param xLen Number of states
+ * @param yLen Number of measurements
+ * @return uint32_t Number of bytes used
+ */
+static uint32_t ukf_fix_assign(tUkfFix *pFix, uint8_t *pBase, mtxDim xLen, mtxDim yLen) {
+    const mtxDim sLen = 2u * xLen + 1u;
+    const tUkfFixScale *const pS = &pFix->scale;
+    uint8_t *pCur = pBase;
+    uint32_t used = 0;
+
+    pFix->xLen = xLen;
+    pFix->yLen = yLen;
+    pFix->sLen = sLen;
+    ukf_fix_take(&pCur, &used, &pFix->Wm,   1,    sLen, pS->wFrac);
+    ukf_fix_take(&pCur, &used, &pFix->Wc,   1,    sLen, pS->wFrac);
+    ukf_fix_take(&pCur, &used, &pFix->Qxx,  xLen, xLen, pS->pxxFrac);
+    ukf_fix_take(&pCur, &used, &pFix->Ryy0, yLen, yLen, pS->pyyFrac);
+    ukf_fix_take(&pCur, &used, &pFix->x,    xLen, 1,    pS->xFrac);
+    ukf_fix_take(&pCur, &used, &pFix->Pxx,  xLen, xLen, pS->pxxFrac);
+    ukf_fix_take(&pCur, &used, &pFix->X,    sLen, xLen, pS->xFrac);
+    ukf_fix_take(&pCur, &used, &pFix->Y,    sLen, yLen, pS->yFrac);
+    ukf_fix_take(&pCur, &used, &pFix->y_m,  yLen, 1,    pS->yFrac);
+    ukf_fix_take(&pCur, &used, &pFix->y,    yLen, 1,    pS->yFrac);
+    ukf_fix_take(&pCur, &used, &pFix->Pyy,  yLen, yLen, pS->pyyFrac);
+    ukf_fix_take(&pCur, &used, &pFix->Pxy,  xLen, yLen, pS->pyyFrac);
+    ukf_fix_take(&pCur, &used, &pFix->K,    xLen, yLen, pS->kFrac);
+
+    return used;
+}
+
+/**
+ * @brief Number of bytes required by ukf_fix_init().
+ *
+ * @param xLen Number of states
+ * @param yLen Number of measurements
+ * @return uint32_t Block size in bytes
+ */
+uint32_t ukf_fix_mem_size(mtxDim xLen, mtxDim yLen) {
+    tUkfFix dummy;
+
+    dummy.scale = (tUkfFixScale){0, 0, 0, 0, 0, 0, 0};
+
+    return ukf_fix_assign(&dummy, NULL, xLen, yLen);
+}
+
+/**
+ * @brief Initialize fixed-point filter from the floating-point model configuration.
+ * Sc, x_system_states_ic, Pxx0, Qxx, Ryy0 and dT are taken from pUkfMatrix and
+ * converted to the formats of pScale. Only UKF_SIGMA_SYMMETRIC is supported;
+ * filter_mode and update_mode are ignored, the core always runs the standard
+ * formulation with the Cholesky gain solve. State limiters and system inputs
+ * are not supported by the fixed-point engine.
+ *
+ * @param pFix Fixed-point filter
+ * @param pMem Memory block aligned to UKF_MEM_ALIGN
+ * @param memSize Size of memory block, at least ukf_fix_mem_size()
+ * @param pUkfMatrix Model configuration (same as used by ukf_init)
+ * @param pScale Number of fractional bits of every quantity
+ * @param pModel Fixed-point model callbacks
+ * @return uint8_t
+ * 0 := OK
+ * 1 := NOK (also if a configuration value or weight saturates in its format)
+ */
+uint8_t ukf_fix_init(tUkfFix *pFix, void *pMem, uint32_t memSize, const tUkfMatrix *pUkfMatrix, const tUkfFixScale *pScale, const tUkfFixModel *pModel) {
+    const mtxDim xLen = pUkfMatrix->x_system_states.nrow;
+    const mtxDim yLen = pUkfMatrix->y_predicted_mean.nrow;
+    int8_t const *const pFrac = &pScale->xFrac;
+    uint8_t Result = 0;
+    mtxDim idx;
+
+    for (idx = 0; idx < sizeof(tUkfFixScale) / sizeof(int8_t); idx++) {
+        if (pFrac[idx] < 0 || pFrac[idx] > UKF_FIX_FRAC_MAX) {
+            Result |= 1;
+        }
+    }
+
+    if (0 != Result || NULL == pMem || 0 != ((uintptr_t)pMem & (UKF_MEM_ALIGN - 1u)) ||
+        0 == xLen || 0 == yLen || xLen > UKF_STATE_LEN_MAX || memSize < ukf_fix_mem_size(xLen, yLen) ||
+        UKF_SIGMA_SYMMETRIC != pUkfMatrix->sigma_scheme ||
+        NULL == pModel->fcnPredict || NULL == pModel->fcnObserve ||
+        NULL == pUkfMatrix->Sc_vector.val || NULL == pUkfMatrix->x_system_states_ic.val ||
+        pUkfMatrix->x_system_states_ic.nrow != xLen ||
+        pUkfMatrix->Pxx0_init_error_covariance.nrow != xLen || pUkfMatrix->Pxx0_init_error_covariance.ncol != xLen ||
+        pUkfMatrix->Qxx_process_noise_cov.nrow != xLen || pUkfMatrix->Qxx_process_noise_cov.ncol != xLen ||
+        pUkfMatrix->Ryy0_init_out_covariance.nrow != yLen || pUkfMatrix->Ryy0_init_out_covariance.ncol != yLen) {
+        Result = 1;
+    } else {
+        const mtxScalar alpha = pUkfMatrix->Sc_vector.val[alphaIdx];
+        const mtxScalar betha = pUkfMatrix->Sc_vector.val[bethaIdx];
+        const mtxScalar kappa = pUkfMatrix->Sc_vector.val[kappaIdx];
+        mtxScalar lambda, wm0, wc0, wi, wMax;
+        mtxDim sigmaIdx;
+
+        pFix->scale = *pScale;
+        (void)ukf_fix_assign(pFix, (uint8_t *)pMem, xLen, yLen);
+        pFix->model = *pModel;
+        pFix->saturated = 0u;
+
+        //#1.3'(begin/end) Calculate scaling parameter
+        lambda = alpha * alpha * (mtxScalar)(xLen + kappa) - (mtxScalar)xLen;
+
+        //#1.2'(begin) Calculate weight vectors
+        wm0 = lambda / (xLen + lambda);
+        wc0 = wm0 + (1 - alpha * alpha + betha);
+        wi = 1 / (2 * (xLen + lambda));
+
+        pFix->Wm.val[0] = mtx_fix_from_f(wm0, pScale->wFrac);
+        pFix->Wc.val[0] = mtx_fix_from_f(wc0, pScale->wFrac);
+
+        for (sigmaIdx = 1; sigmaIdx < pFix->sLen; sigmaIdx++) {
+            pFix->Wm.val[sigmaIdx] = mtx_fix_from_f(wi, pScale->wFrac);
+            pFix->Wc.val[sigmaIdx] = pFix->Wm.val[sigmaIdx];
+        }
+        //#1.2'(end) Calculate weight vectors
+
+        pFix->gamma = mtx_fix_from_f(MTX_SQRT(xLen + lambda), pScale->wFrac);
+        pFix->dT = mtx_fix_from_f(pUkfMatrix->dT, pScale->tFrac);
+
+        //weights and gamma must be representable in wFrac, dT must not vanish in tFrac
+        wMax = mtx_fix_to_f(MTX_FIX_MAX, pScale->wFrac);
+        if (MTX_FABS(wm0) >= wMax || MTX_FABS(wc0) >= wMax || MTX_SQRT(xLen + lambda) >= wMax ||
+            MTX_FIX_MAX == pFix->dT || 0 == pFix->dT) {
+            Result |= 1;
+        }
+
+        if (MTX_OPERATION_OK != mtx_fix_from_float(&pFix->Qxx, &pUkfMatrix->Qxx_process_noise_cov) ||
+            MTX_OPERATION_OK != mtx_fix_from_float(&pFix->Ryy0, &pUkfMatrix->Ryy0_init_out_covariance) ||
+            MTX_OPERATION_OK != mtx_fix_from_float(&pFix->Pxx, &pUkfMatrix->Pxx0_init_error_covariance) ||
+            MTX_OPERATION_OK != mtx_fix_from_float(&pFix->x, &pUkfMatrix->x_system_states_ic)) {
+            Result |= 1;
+        }
+
+        for (idx = 0; idx < yLen; idx++) {
+            pFix->y.val[idx] = 0;
+            pFix->y_m.val[idx] = 0;
+        }
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Weighted mean z = sum(Wm*Z(i)) of sigma points stored one per row, then Z(i) = Z(i) - z
+ *
+ * @param pZ Sigma points (sLen x n), centered on return
+ * @param pWm Mean weights (1 x sLen)
+ * @param pz Mean (n x 1), same frac as Z
+ * @param pSat Set if a value was clamped
+ */
+static void ukf_fix_mean(tMatrixFix *pZ, const tMatrixFix *pWm, tMatrixFix *pz, uint8_t *pSat) {
+    const mtxDim sLen = pZ->nrow;
+    const mtxDim n = pZ->ncol;
+    mtxDim eIdx, sigmaIdx;
+
+    for (eIdx = 0; eIdx < n; eIdx++) {
+        mtxFixAcc acc = 0;
+
+        for (sigmaIdx = 0; sigmaIdx < sLen; sigmaIdx++) {
+            acc = mtx_fix_mac(acc, pWm->val[sigmaIdx], pZ->val[n * sigmaIdx + eIdx], pSat);
+        }
+        pz->val[eIdx] = mtx_fix_sat_chk(mtx_fix_shr(acc, pWm->frac), pSat);
+    }
+
+    for (sigmaIdx = 0; sigmaIdx < sLen; sigmaIdx++) {
+        mtxFix *const pZi = &pZ->val[n * sigmaIdx];
+
+        for (eIdx = 0; eIdx < n; eIdx++) {
+            pZi[eIdx] = mtx_fix_sat_chk((mtxFixAcc)pZi[eIdx] - pz->val[eIdx], pSat);
+        }
+    }
+}
+
+/**
+ * @brief P = N + sum(Wc*dA(i)*dB(i)') of centered sigma points stored one per row.
+ * If pN is NULL, P is a cross-covariance without noise; otherwise A and B are the
+ * same matrix and only the lower triangle is accumulated and mirrored.
+ *
+ * @param pA Centered sigma points (sLen x na)
+ * @param pB Centered sigma points (sLen x nb)
+ * @param pWc Covariance weights (1 x sLen)
+ * @param pN Noise covariance (na x na) with frac of P or NULL
+ * @param pP Result (na x nb)
+ * @param pSat Set if a value was clamped
+ */
+static void ukf_fix_cov(const tMatrixFix *pA, const tMatrixFix *pB, const tMatrixFix *pWc, const tMatrixFix *pN, tMatrixFix *pP, uint8_t *pSat) {
+    const mtxDim sLen = pA->nrow;
+    const mtxDim na = pA->ncol;
+    const mtxDim nb = pB->ncol;
+    const int8_t shift = pA->frac + pB->frac - pP->frac;
+    mtxDim aIdx, bIdx, sigmaIdx;
+
+    for (aIdx = 0; aIdx < na; aIdx++) {
+        const mtxDim bEnd = (NULL != pN) ? (aIdx + 1u) : nb;
+
+        for (bIdx = 0; bIdx < bEnd; bIdx++) {
+            mtxFixAcc acc = 0;
+
+            for (sigmaIdx = 0; sigmaIdx < sLen; sigmaIdx++) {
+                //Wc*dA is rounded to the frac of A first, the triple product would not fit the accumulator
+                const mtxFix wda = mtx_fix_mulq(pWc->val[sigmaIdx], pA->val[na * sigmaIdx + aIdx], pWc->frac);
+
+                acc = mtx_fix_mac(acc, wda, pB->val[nb * sigmaIdx + bIdx], pSat);
+            }
+
+            if (NULL != pN) {
+                const mtxFix p = mtx_fix_sat_chk((mtxFixAcc)pN->val[nb * aIdx + bIdx] + mtx_fix_sat_chk(mtx_fix_shr(acc, shift), pSat), pSat);
+
+                pP->val[nb * aIdx + bIdx] = p;
+                pP->val[nb * bIdx + aIdx] = p;
+            } else {
+                pP->val[nb * aIdx + bIdx] = mtx_fix_sat_chk(mtx_fix_shr(acc, shift), pSat);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Fixed-point periodic task, same steps as ukf_step().
+ * Measurements (yFrac) should be loaded in pFix->y before each call. If Pxx or
+ * Pyy is not positive definite in its format the step stops like ukf_step()
+ * and the states are not updated. Clamped values do not stop the step, they are
+ * reported in pFix->saturated.
+ *
+ * @param pFix Fixed-point filter
+ */
+void ukf_fix_step(tUkfFix *pFix) {
+    const mtxDim xLen = pFix->xLen;
+    const mtxDim yLen = pFix->yLen;
+    const mtxDim sLen = pFix->sLen;
+    const tUkfFixScale *const pS = &pFix->scale;
+    mtxFix *const px = pFix->x.val;
+    mtxFix *const pPxx = pFix->Pxx.val;
+    mtxFix *const pX = pFix->X.val;
+    mtxFix *const pY = pFix->Y.val;
+    mtxFix *const py = pFix->y.val;
+    uint8_t sat = 0u;
+    mtxResultInfo ResultL;
+    mtxDim xIdx, xTrIdx, yIdx, sigmaIdx;
+
+    //#1.1(begin/end) Calculate error covariance matrix square root
+    ResultL = mtx_fix_chol_lower(&pFix->Pxx);
+    sat |= (MTX_SATURATED == ResultL) ? 1u : 0u;
+
+    if (MTX_OPERATION_OK == ResultL || MTX_SATURATED == ResultL) {
+        //gamma*L(i,j) carries wFrac + pxxFrac fractional bits
+        const int8_t shiftL = pS->wFrac + pS->pxxFrac - pS->xFrac;
+
+        //#1.2(begin) Calculate the sigma-points
+        for (xIdx = 0; xIdx < xLen; xIdx++) {
+            pX[xIdx] = px[xIdx];
+
+            for (sigmaIdx = 1; sigmaIdx <= xLen; sigmaIdx++) {
+                const mtxFix dx = mtx_fix_sat_chk(mtx_fix_shr((mtxFixAcc)pFix->gamma * pPxx[xLen * xIdx + (sigmaIdx - 1u)], shiftL), &sat);
+
+                pX[xLen * sigmaIdx + xIdx] = mtx_fix_sat_chk((mtxFixAcc)px[xIdx] + dx, &sat);
+                pX[xLen * (sigmaIdx + xLen) + xIdx] = mtx_fix_sat_chk((mtxFixAcc)px[xIdx] - dx, &sat);
+            }
+        }
+        //#1.2(end) Calculate the sigma-points
+
+        for (sigmaIdx = 0; sigmaIdx < sLen; sigmaIdx++) {
+            //#2.1 Propagate each sigma-point through prediction
+            pFix->model.fcnPredict(&pX[xLen * sigmaIdx], pFix->dT);
+
+            //#3.1 Propagate each sigma-point through observation
+            pFix->model.fcnObserve(&pX[xLen * sigmaIdx], &pY[yLen * sigmaIdx]);
+        }
+
+        //#2.2 Calculate mean of predicted state and center sigma points: X_m = X_m - x_m
+        ukf_fix_mean(&pFix->X, &pFix->Wm, &pFix->x, &sat);
+
+        //#3.2 Calculate mean of predicted output and center sigma points: Y_m = Y_m - y_m
+        ukf_fix_mean(&pFix->Y, &pFix->Wm, &pFix->y_m, &sat);
+
+        //#2.3 Calculate covariance of predicted state: P_m = Q + sum(Wc*dX*dX')
+        ukf_fix_cov(&pFix->X, &pFix->X, &pFix->Wc, &pFix->Qxx, &pFix->Pxx, &sat);
+
+        //#3.3 Calculate covariance of predicted output: Pyy = R + sum(Wc*dY*dY')
+        ukf_fix_cov(&pFix->Y, &pFix->Y, &pFix->Wc, &pFix->Ryy0, &pFix->Pyy, &sat);
+
+        //#3.4 Calculate cross-covariance of state and output: Pxy = sum(Wc*dX*dY')
+        ukf_fix_cov(&pFix->X, &pFix->Y, &pFix->Wc, NULL, &pFix->Pxy, &sat);
+
+        //#4.1 Calculate Kalman gain: K = Pxy*inv(L*L'), Pyy = L
+        ResultL = mtx_fix_chol_lower(&pFix->Pyy);
+        sat |= (MTX_SATURATED == ResultL) ? 1u : 0u;
+
+        if (MTX_OPERATION_OK == ResultL || MTX_SATURATED == ResultL) {
+            ResultL = mtx_fix_chol_subst(&pFix->Pyy, &pFix->Pxy, &pFix->K);
+            sat |= (MTX_SATURATED == ResultL) ? 1u : 0u;
+        }
+
+        if (MTX_OPERATION_OK == ResultL || MTX_SATURATED == ResultL) {
+            mtxFix const *const pK = pFix->K.val;
+            mtxFix const *const pPxy = pFix->Pxy.val;
+
+            //#4.2 Update state estimate: y = y - y_m, x = x_m + K*(y - y_m)
+            for (yIdx = 0; yIdx < yLen; yIdx++) {
+                py[yIdx] = mtx_fix_sat_chk((mtxFixAcc)py[yIdx] - pFix->y_m.val[yIdx], &sat);
+            }
+
+            for (xIdx = 0; xIdx < xLen; xIdx++) {
+                mtxFixAcc acc = 0;
+
+                for (yIdx = 0; yIdx < yLen; yIdx++) {
+                    acc = mtx_fix_mac(acc, pK[yLen * xIdx + yIdx], py[yIdx], &sat);
+                }
+                acc = mtx_fix_sat_chk(mtx_fix_shr(acc, pS->kFrac + pS->yFrac - pS->xFrac), &sat);
+                px[xIdx] = mtx_fix_sat_chk((mtxFixAcc)px[xIdx] + acc, &sat);
+            }
+
+            //#4.3 Update error covariance: Pxx = P_m - K*Pxy' (= P_m - K*Pyy*K'), lower triangle mirrored
+            for (xIdx = 0; xIdx < xLen; xIdx++) {
+                for (xTrIdx = 0; xTrIdx <= xIdx; xTrIdx++) {
+                    mtxFixAcc acc = 0;
+                    mtxFix p;
+
+                    for (yIdx = 0; yIdx < yLen; yIdx++) {
+                        acc = mtx_fix_mac(acc, pK[yLen * xIdx + yIdx], pPxy[yLen * xTrIdx + yIdx], &sat);
+                    }
+                    acc = mtx_fix_sat_chk(mtx_fix_shr(acc, pS->kFrac + pS->pyyFrac - pS->pxxFrac), &sat);
+                    p = mtx_fix_sat_chk((mtxFixAcc)pPxx[xLen * xIdx + xTrIdx] - acc, &sat);
+                    pPxx[xLen * xIdx + xTrIdx] = p;
+                    pPxx[xLen * xTrIdx + xIdx] = p;
+                }
+            }
+        }
+    }
+
+    pFix->saturated = sat;
+}
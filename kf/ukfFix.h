@@ -0,0 +1,62 @@
+/**
+ * @file ukfFix.h
+ * @brief Fixed-point additive noise UKF (Q31 default, Q15 with MTX_FIX_Q15).
+ */
+
+#ifndef UKFFIX_H
+#define UKFFIX_H
+
+#include <stdint.h>
+#include "mtxFix.h"
+#include "ukfLib.h"
+
+//! Fixed-point model callbacks for one dense sigma point, values use the formats of tUkfFixScale.
+//! Prediction works in place: px holds X_p(i) on entry and X_m(i) on return, dT has tFrac fractional bits.
+typedef void (*tPredictFixFcn)(mtxFix *px, mtxFix dT);
+typedef void (*tObservFixFcn)(mtxFix const *px_m, mtxFix *py_m);
+
+typedef struct ukfFixModel {
+    tPredictFixFcn fcnPredict;
+    tObservFixFcn fcnObserve;
+} tUkfFixModel;
+
+//! Number of fractional bits of every quantity, value = raw * 2^-frac
+typedef struct ukfFixScale {
+    int8_t xFrac;    //states x, sigma points X and their deviations
+    int8_t yFrac;    //measurements y, output sigma points Y, y_m and innovation
+    int8_t pxxFrac;  //Pxx, Qxx and the lower Cholesky factor of Pxx
+    int8_t pyyFrac;  //Pyy, Ryy0, Pxy and the lower Cholesky factor of Pyy
+    int8_t kFrac;    //Kalman gain K
+    int8_t wFrac;    //weights Wm, Wc and sigma spread gamma
+    int8_t tFrac;    //sampling time dT
+} tUkfFixScale;
+
+typedef struct ukfFix {
+    mtxDim xLen;     //length of state vector
+    mtxDim yLen;     //length of measurement vector
+    mtxDim sLen;     //length of sigma point
+    mtxFix gamma;     //sigma point spread sqrt(xLen + lambda) (wFrac)
+    mtxFix dT;        //sampling time (tFrac)
+    tUkfFixScale scale;
+    tMatrixFix Wm;    //(1 x sLen)
+    tMatrixFix Wc;    //(1 x sLen)
+    tMatrixFix Qxx;   //(xLen x xLen)
+    tMatrixFix Ryy0;  //(yLen x yLen)
+    tMatrixFix x;     //(xLen x 1) states x(k-1), x(k|k-1), x(k)
+    tMatrixFix Pxx;   //(xLen x xLen) error covariance, holds its lower Cholesky factor during the step
+    tMatrixFix X;     //(sLen x xLen) sigma points, one per row: X(k-1), X(k|k-1), centered after x(k|k-1) is known
+    tMatrixFix Y;     //(sLen x yLen) output sigma points, one per row, centered after y(k|k-1) is known
+    tMatrixFix y_m;   //(yLen x 1) predicted output
+    tMatrixFix y;     //(yLen x 1) measurements, innovation after the step
+    tMatrixFix Pyy;   //(yLen x yLen) output covariance, lower Cholesky factor after the step
+    tMatrixFix Pxy;   //(xLen x yLen) cross-covariance
+    tMatrixFix K;     //(xLen x yLen) Kalman gain
+    tUkfFixModel model;
+    uint8_t saturated; //1 := a value was clamped to its format in the last step
+} tUkfFix;
+
+uint32_t ukf_fix_mem_size (mtxDim xLen, mtxDim yLen);
+uint8_t  ukf_fix_init     (tUkfFix *pFix, void *pMem, uint32_t memSize, const tUkfMatrix *pUkfMatrix, const tUkfFixScale *pScale, const tUkfFixModel *pModel);
+void     ukf_fix_step     (tUkfFix *pFix);
+
+#endif /* UKFFIX_H */
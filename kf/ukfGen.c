@@ -0,0 +1,1604 @@
+/**
+ * @file ukfGen.c
+ * @brief Host generator of a filter configuration from a compact model description.
+ * ./kfgen model.ukf outDir writes for the model <name>:
+ * <name>Cfg.h  dimensions, UKF_SPEC_DIMS and the exported tUkfMatrix <Name>MatrixCfg
+ * <name>Cfg.c  exactly sized static storage, the configuration and fused prediction and
+ *              observation kernels (fcnPredictBatch/fcnObserveBatch, fcnPredictVec/fcnObserveVec
+ *              under UKF_SIGMA_MAJOR)
+ * <name>Test.c regression test ukf_test_<name>() of the reference steps in every listed mode
+ * The f and h expressions of one kernel form one expression graph: equal subexpressions
+ * (operands of + and * are ordered) are one node, nodes used more than once are computed
+ * once into a temporary, constants are folded and x^n is unrolled into multiplications.
+ * All inputs of a sigma point are loaded before the first store, so the kernels are
+ * correct with X_p and X_m in the same memory and have no dependency between sigma points.
+ *
+ * Model description, one statement per line, # starts a comment:
+ * model  rng                        name of the files and symbols
+ * state  n e ndot edot              state names, rows and columns of x0, P0 and Q in this order
+ * meas   y1 y2                      measurement names, rows and columns of R
+ * input  v                          NOT MANDATORY input names: u(k-1) in f, u(k) in h, at most one per state
+ * const  N1 20 E1 0                 named constants, folded into the expressions
+ * dT     0.1                        sampling time, dT in the f expressions
+ * alpha, beta, kappa <value>        sigma point parameters, default 1, 2, 0
+ * scheme symmetric|simplex          sigma point set, default symmetric
+ * mode   standard sqrt              filter modes of the test, the first one is configured,
+ *                                   square-root storage only if sqrt is listed
+ * update auto|batch|sequential      measurement update, default auto
+ * f n  = n + dT*ndot                prediction of every state
+ * h y1 = sqrt((n - N1)^2 + (e - E1)^2)   observation of every measurement
+ * x0     0 0 50 50                  initial state
+ * P0|Q|R diag <values> or one "P0|Q|R row <values>" statement per row
+ * eps    1e-3                       tolerance of the accumulated absolute state error of the test
+ * ref    <y> <u> <x>                one reference step: measurements, inputs and expected x(k|k)
+ * Operators + - * / ^ (constant integer exponent 1..8), functions sqrt sin cos exp log abs atan2.
+ */
+
+#include <ctype.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GEN_NAME_LEN   (32u)
+#define GEN_DIM_MAX    (32u)    //states, measurements, inputs and constants of one model
+#define GEN_NODE_MAX   (4096u)
+#define GEN_REF_MAX    (1024u)
+#define GEN_LINE_LEN   (1024u)
+#define GEN_PATH_LEN   (512u)
+#define GEN_POW_MAX    (8)
+
+//! Expression graph operations, leafs first
+enum {
+    GEN_OP_NUM = 0,
+    GEN_OP_STATE,
+    GEN_OP_INPUT,
+    GEN_OP_DT,
+    GEN_OP_ADD,
+    GEN_OP_SUB,
+    GEN_OP_MUL,
+    GEN_OP_DIV,
+    GEN_OP_NEG,
+    GEN_OP_SQRT,
+    GEN_OP_SIN,
+    GEN_OP_COS,
+    GEN_OP_EXP,
+    GEN_OP_LOG,
+    GEN_OP_ABS,
+    GEN_OP_ATAN2
+};
+
+//! Kernels emitted per model
+enum {
+    GEN_KER_PRED_BATCH = 0,
+    GEN_KER_OBS_BATCH,
+    GEN_KER_PRED_VEC,
+    GEN_KER_OBS_VEC
+};
+
+typedef struct genNode {
+    uint8_t op;
+    int32_t a;     //first operand, state or input index of a leaf
+    int32_t b;     //second operand, -1 if unary
+    double val;    //GEN_OP_NUM
+} tGenNode;
+
+typedef struct genFunc {
+    const char *pName;
+    uint8_t op;
+    uint8_t nArg;
+    const char *pMacro;
+} tGenFunc;
+
+typedef struct genModel {
+    char name[GEN_NAME_LEN];
+    char state[GEN_DIM_MAX][GEN_NAME_LEN];
+    char meas[GEN_DIM_MAX][GEN_NAME_LEN];
+    char input[GEN_DIM_MAX][GEN_NAME_LEN];
+    char cnst[GEN_DIM_MAX][GEN_NAME_LEN];
+    double cnstVal[GEN_DIM_MAX];
+    uint32_t nx, ny, nu, nc;
+    double dT, alpha, beta, kappa, eps;
+    uint8_t dTSet;
+    uint8_t simplex;
+    uint8_t mode[2];        //0 := standard, 1 := sqrt
+    uint8_t nMode;
+    uint8_t update;         //0 := auto, 1 := batch, 2 := sequential
+    int32_t f[GEN_DIM_MAX]; //root node of every prediction, -1 until assigned
+    int32_t h[GEN_DIM_MAX]; //root node of every observation, -1 until assigned
+    char fSrc[GEN_DIM_MAX][GEN_LINE_LEN];
+    char hSrc[GEN_DIM_MAX][GEN_LINE_LEN];
+    double x0[GEN_DIM_MAX];
+    double P0[GEN_DIM_MAX * GEN_DIM_MAX];
+    double Q[GEN_DIM_MAX * GEN_DIM_MAX];
+    double R[GEN_DIM_MAX * GEN_DIM_MAX];
+    uint32_t x0Set, P0Rows, QRows, RRows;
+    uint32_t nRef;
+} tGenModel;
+
+//! Emission state of one kernel
+typedef struct genKernel {
+    uint8_t kind;
+    int32_t root[GEN_DIM_MAX];   //-1 := output is not stored (identity prediction)
+    uint32_t nRoot;
+    uint8_t reach[GEN_NODE_MAX];
+    uint16_t uses[GEN_NODE_MAX];
+    int32_t temp[GEN_NODE_MAX];  //temporary index of a shared node, -1 := inlined
+    uint32_t nTemp;
+    uint8_t useDt;
+    uint8_t useIn;
+} tGenKernel;
+
+static const tGenFunc GenFunc[] = {
+    {"sqrt",  GEN_OP_SQRT,  1, "MTX_SQRT"},
+    {"sin",   GEN_OP_SIN,   1, "MTX_SIN"},
+    {"cos",   GEN_OP_COS,   1, "MTX_COS"},
+    {"exp",   GEN_OP_EXP,   1, "MTX_EXP"},
+    {"log",   GEN_OP_LOG,   1, "MTX_LOG"},
+    {"abs",   GEN_OP_ABS,   1, "MTX_FABS"},
+    {"atan2", GEN_OP_ATAN2, 2, "MTX_ATAN2"},
+};
+#define GEN_FUNC_NUM (sizeof(GenFunc) / sizeof(GenFunc[0]))
+
+static tGenNode GenNode[GEN_NODE_MAX];
+static uint32_t GenNodeNum;
+static tGenModel GenModel;
+static double GenRef[GEN_REF_MAX][3u * GEN_DIM_MAX];
+static tGenKernel GenKernel;
+static const char *pGenFile;
+static uint32_t GenLine;
+
+static void     gen_fail     (const char *pFmt, ...);
+static int32_t  gen_node     (uint8_t op, int32_t a, int32_t b, double val);
+static int32_t  gen_parse_expr (const char **ppCur, uint8_t inPred);
+static void     gen_num      (char *pBuf, double val);
+static uint8_t  gen_ident    (const char *pName);
+
+/**
+ * @brief Print an error of the model description and exit.
+ *
+ * @param pFmt printf format
+ */
+static void gen_fail(const char *pFmt, ...) {
+    va_list args;
+
+    va_start(args, pFmt);
+    if (GenLine > 0) {
+        fprintf(stderr, "%s:%u: ", pGenFile, (unsigned)GenLine);
+    }
+    vfprintf(stderr, pFmt, args);
+    fprintf(stderr, "\n");
+    va_end(args);
+    exit(1);
+}
+
+/**
+ * @brief Node of the expression graph: folds constants and neutral elements, orders the
+ * operands of commutative operations and returns an existing equal node if there is one.
+ *
+ * @param op GEN_OP_*
+ * @param a First operand (or index of a leaf)
+ * @param b Second operand, -1 if unary
+ * @param val Value of GEN_OP_NUM
+ * @return int32_t Node index
+ */
+static int32_t gen_node(uint8_t op, int32_t a, int32_t b, double val) {
+    const uint8_t numA = (op >= GEN_OP_ADD && GEN_OP_NUM == GenNode[a].op);
+    const uint8_t numB = (b >= 0 && GEN_OP_NUM == GenNode[b].op);
+    const double va = numA ? GenNode[a].val : 0.0;
+    const double vb = numB ? GenNode[b].val : 0.0;
+    uint32_t nIdx;
+
+    //fold constant operands
+    if (numA && (b < 0 || numB)) {
+        switch (op) {
+        case GEN_OP_ADD:   return gen_node(GEN_OP_NUM, 0, -1, va + vb);
+        case GEN_OP_SUB:   return gen_node(GEN_OP_NUM, 0, -1, va - vb);
+        case GEN_OP_MUL:   return gen_node(GEN_OP_NUM, 0, -1, va * vb);
+        case GEN_OP_DIV:   if (vb != 0.0) { return gen_node(GEN_OP_NUM, 0, -1, va / vb); } break;
+        case GEN_OP_NEG:   return gen_node(GEN_OP_NUM, 0, -1, -va);
+        case GEN_OP_SQRT:  if (va >= 0.0) { return gen_node(GEN_OP_NUM, 0, -1, sqrt(va)); } break;
+        case GEN_OP_SIN:   return gen_node(GEN_OP_NUM, 0, -1, sin(va));
+        case GEN_OP_COS:   return gen_node(GEN_OP_NUM, 0, -1, cos(va));
+        case GEN_OP_EXP:   return gen_node(GEN_OP_NUM, 0, -1, exp(va));
+        case GEN_OP_LOG:   if (va > 0.0) { return gen_node(GEN_OP_NUM, 0, -1, log(va)); } break;
+        case GEN_OP_ABS:   return gen_node(GEN_OP_NUM, 0, -1, fabs(va));
+        case GEN_OP_ATAN2: return gen_node(GEN_OP_NUM, 0, -1, atan2(va, vb));
+        default: break;
+        }
+    }
+
+    //neutral and absorbing elements
+    switch (op) {
+    case GEN_OP_ADD:
+        if (numA && 0.0 == va) { return b; }
+        if (numB && 0.0 == vb) { return a; }
+        break;
+    case GEN_OP_SUB:
+        if (numB && 0.0 == vb) { return a; }
+        if (numA && 0.0 == va) { return gen_node(GEN_OP_NEG, b, -1, 0.0); }
+        if (a == b) { return gen_node(GEN_OP_NUM, 0, -1, 0.0); }
+        break;
+    case GEN_OP_MUL:
+        if ((numA && 0.0 == va) || (numB && 0.0 == vb)) { return gen_node(GEN_OP_NUM, 0, -1, 0.0); }
+        if (numA && 1.0 == va) { return b; }
+        if (numB && 1.0 == vb) { return a; }
+        if (numA && -1.0 == va) { return gen_node(GEN_OP_NEG, b, -1, 0.0); }
+        if (numB && -1.0 == vb) { return gen_node(GEN_OP_NEG, a, -1, 0.0); }
+        break;
+    case GEN_OP_DIV:
+        if (numB && 1.0 == vb) { return a; }
+        break;
+    case GEN_OP_NEG:
+        if (GEN_OP_NEG == GenNode[a].op) { return GenNode[a].a; }
+        break;
+    default:
+        break;
+    }
+
+    if ((GEN_OP_ADD == op || GEN_OP_MUL == op) && a > b) {
+        const int32_t swp = a;
+
+        a = b;
+        b = swp;
+    }
+
+    for (nIdx = 0; nIdx < GenNodeNum; nIdx++) {
+        tGenNode const *const pNode = &GenNode[nIdx];
+
+        if (pNode->op == op && pNode->a == a && pNode->b == b && (GEN_OP_NUM != op || pNode->val == val)) {
+            return (int32_t)nIdx;
+        }
+    }
+
+    if (GenNodeNum >= GEN_NODE_MAX) {
+        gen_fail("more than %u expression nodes", (unsigned)GEN_NODE_MAX);
+    }
+    GenNode[GenNodeNum].op = op;
+    GenNode[GenNodeNum].a = a;
+    GenNode[GenNodeNum].b = b;
+    GenNode[GenNodeNum].val = val;
+
+    return (int32_t)GenNodeNum++;
+}
+
+/**
+ * @brief Skip white space of an expression.
+ *
+ * @param ppCur Parse position
+ */
+static void gen_skip(const char **ppCur) {
+    while (isspace((unsigned char)**ppCur)) {
+        (*ppCur)++;
+    }
+}
+
+/**
+ * @brief Read an identifier.
+ *
+ * @param ppCur Parse position at the first character
+ * @param pName Identifier, GEN_NAME_LEN bytes
+ */
+static void gen_read_ident(const char **ppCur, char *pName) {
+    uint32_t len = 0;
+
+    while (isalnum((unsigned char)**ppCur) || '_' == **ppCur) {
+        if (len + 1u >= GEN_NAME_LEN) {
+            gen_fail("identifier longer than %u characters", (unsigned)(GEN_NAME_LEN - 1u));
+        }
+        pName[len++] = *(*ppCur)++;
+    }
+    pName[len] = '\0';
+}
+
+/**
+ * @brief Index of a name in a name list.
+ *
+ * @param pList Names
+ * @param nName Number of names
+ * @param pName Searched name
+ * @return int32_t Index or -1
+ */
+static int32_t gen_find(char (*pList)[GEN_NAME_LEN], uint32_t nName, const char *pName) {
+    uint32_t idx;
+
+    for (idx = 0; idx < nName; idx++) {
+        if (0 == strcmp(pList[idx], pName)) {
+            return (int32_t)idx;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief primary = number | name | func '(' expr {',' expr} ')' | '(' expr ')'
+ *
+ * @param ppCur Parse position
+ * @param inPred 1 := f expression (dT allowed), 0 := h expression
+ * @return int32_t Node index
+ */
+static int32_t gen_parse_primary(const char **ppCur, uint8_t inPred) {
+    tGenModel *const pMdl = &GenModel;
+    int32_t node = -1;
+
+    gen_skip(ppCur);
+    if (isdigit((unsigned char)**ppCur) || '.' == **ppCur) {
+        char *pEnd;
+        const double val = strtod(*ppCur, &pEnd);
+
+        if (pEnd == *ppCur) {
+            gen_fail("invalid number at '%s'", *ppCur);
+        }
+        *ppCur = pEnd;
+        node = gen_node(GEN_OP_NUM, 0, -1, val);
+    } else if ('(' == **ppCur) {
+        (*ppCur)++;
+        node = gen_parse_expr(ppCur, inPred);
+        gen_skip(ppCur);
+        if (')' != **ppCur) {
+            gen_fail("missing ')' at '%s'", *ppCur);
+        }
+        (*ppCur)++;
+    } else if (isalpha((unsigned char)**ppCur) || '_' == **ppCur) {
+        char name[GEN_NAME_LEN];
+        int32_t idx;
+
+        gen_read_ident(ppCur, name);
+        gen_skip(ppCur);
+        if ('(' == **ppCur) {
+            int32_t arg[2] = {-1, -1};
+            uint32_t fIdx, aIdx;
+
+            for (fIdx = 0; fIdx < GEN_FUNC_NUM && 0 != strcmp(GenFunc[fIdx].pName, name); fIdx++) {
+            }
+            if (fIdx == GEN_FUNC_NUM) {
+                gen_fail("unknown function '%s'", name);
+            }
+            (*ppCur)++;
+            for (aIdx = 0; aIdx < GenFunc[fIdx].nArg; aIdx++) {
+                arg[aIdx] = gen_parse_expr(ppCur, inPred);
+                gen_skip(ppCur);
+                if (**ppCur != ((aIdx + 1u < GenFunc[fIdx].nArg) ? ',' : ')')) {
+                    gen_fail("%s() takes %u argument(s)", name, (unsigned)GenFunc[fIdx].nArg);
+                }
+                (*ppCur)++;
+            }
+            node = gen_node(GenFunc[fIdx].op, arg[0], arg[1], 0.0);
+        } else if (0 == strcmp(name, "dT")) {
+            if (0 == inPred) {
+                gen_fail("dT is only defined in f expressions");
+            }
+            node = gen_node(GEN_OP_DT, 0, -1, 0.0);
+        } else if ((idx = gen_find(pMdl->state, pMdl->nx, name)) >= 0) {
+            node = gen_node(GEN_OP_STATE, idx, -1, 0.0);
+        } else if ((idx = gen_find(pMdl->input, pMdl->nu, name)) >= 0) {
+            node = gen_node(GEN_OP_INPUT, idx, -1, 0.0);
+        } else if ((idx = gen_find(pMdl->cnst, pMdl->nc, name)) >= 0) {
+            node = gen_node(GEN_OP_NUM, 0, -1, pMdl->cnstVal[idx]);
+        } else {
+            gen_fail("unknown name '%s'", name);
+        }
+    } else {
+        gen_fail("unexpected '%s'", ('\0' != **ppCur) ? *ppCur : "end of line");
+    }
+
+    return node;
+}
+
+/**
+ * @brief power = primary ['^' integer], x^n is unrolled by squaring
+ *
+ * @param ppCur Parse position
+ * @param inPred 1 := f expression, 0 := h expression
+ * @return int32_t Node index
+ */
+static int32_t gen_parse_power(const char **ppCur, uint8_t inPred) {
+    int32_t node = gen_parse_primary(ppCur, inPred);
+
+    gen_skip(ppCur);
+    if ('^' == **ppCur) {
+        char *pEnd;
+        long expo;
+        int32_t result = -1;
+
+        (*ppCur)++;
+        gen_skip(ppCur);
+        expo = strtol(*ppCur, &pEnd, 10);
+        if (pEnd == *ppCur || expo < 1 || expo > GEN_POW_MAX) {
+            gen_fail("exponent must be an integer 1..%d", GEN_POW_MAX);
+        }
+        *ppCur = pEnd;
+        while (expo > 0) {
+            if (0 != (expo & 1)) {
+                result = (result < 0) ? node : gen_node(GEN_OP_MUL, result, node, 0.0);
+            }
+            expo >>= 1;
+            if (expo > 0) {
+                node = gen_node(GEN_OP_MUL, node, node, 0.0);
+            }
+        }
+        node = result;
+    }
+
+    return node;
+}
+
+/**
+ * @brief unary = '-' unary | power
+ *
+ * @param ppCur Parse position
+ * @param inPred 1 := f expression, 0 := h expression
+ * @return int32_t Node index
+ */
+static int32_t gen_parse_unary(const char **ppCur, uint8_t inPred) {
+    gen_skip(ppCur);
+    if ('-' == **ppCur) {
+        (*ppCur)++;
+        return gen_node(GEN_OP_NEG, gen_parse_unary(ppCur, inPred), -1, 0.0);
+    }
+    if ('+' == **ppCur) {
+        (*ppCur)++;
+        return gen_parse_unary(ppCur, inPred);
+    }
+
+    return gen_parse_power(ppCur, inPred);
+}
+
+/**
+ * @brief term = unary {('*' | '/') unary}
+ *
+ * @param ppCur Parse position
+ * @param inPred 1 := f expression, 0 := h expression
+ * @return int32_t Node index
+ */
+static int32_t gen_parse_term(const char **ppCur, uint8_t inPred) {
+    int32_t node = gen_parse_unary(ppCur, inPred);
+
+    gen_skip(ppCur);
+    while ('*' == **ppCur || '/' == **ppCur) {
+        const uint8_t op = ('*' == **ppCur) ? GEN_OP_MUL : GEN_OP_DIV;
+
+        (*ppCur)++;
+        node = gen_node(op, node, gen_parse_unary(ppCur, inPred), 0.0);
+        gen_skip(ppCur);
+    }
+
+    return node;
+}
+
+/**
+ * @brief expr = term {('+' | '-') term}
+ *
+ * @param ppCur Parse position
+ * @param inPred 1 := f expression, 0 := h expression
+ * @return int32_t Node index
+ */
+static int32_t gen_parse_expr(const char **ppCur, uint8_t inPred) {
+    int32_t node = gen_parse_term(ppCur, inPred);
+
+    gen_skip(ppCur);
+    while ('+' == **ppCur || '-' == **ppCur) {
+        const uint8_t op = ('+' == **ppCur) ? GEN_OP_ADD : GEN_OP_SUB;
+
+        (*ppCur)++;
+        node = gen_node(op, node, gen_parse_term(ppCur, inPred), 0.0);
+        gen_skip(ppCur);
+    }
+
+    return node;
+}
+
+/**
+ * @brief Check a new state, measurement, input or constant name.
+ *
+ * @param pName Name
+ * @return uint8_t 1 := valid and not used yet
+ */
+static uint8_t gen_ident(const char *pName) {
+    tGenModel *const pMdl = &GenModel;
+    uint32_t idx;
+
+    if (!(isalpha((unsigned char)pName[0]) || '_' == pName[0])) {
+        return 0;
+    }
+    for (idx = 1; '\0' != pName[idx]; idx++) {
+        if (!(isalnum((unsigned char)pName[idx]) || '_' == pName[idx])) {
+            return 0;
+        }
+    }
+    for (idx = 0; idx < GEN_FUNC_NUM; idx++) {
+        if (0 == strcmp(GenFunc[idx].pName, pName)) {
+            return 0;
+        }
+    }
+
+    return (0 != strcmp(pName, "dT") && strlen(pName) < GEN_NAME_LEN
+            && gen_find(pMdl->state, pMdl->nx, pName) < 0 && gen_find(pMdl->meas, pMdl->ny, pName) < 0
+            && gen_find(pMdl->input, pMdl->nu, pName) < 0 && gen_find(pMdl->cnst, pMdl->nc, pName) < 0);
+}
+
+/**
+ * @brief Read numbers of a statement.
+ *
+ * @param pVal Values
+ * @param nMax Capacity of pVal
+ * @return uint32_t Number of values read
+ */
+static uint32_t gen_values(double *pVal, uint32_t nMax) {
+    uint32_t nVal = 0;
+    const char *pTok;
+
+    while (NULL != (pTok = strtok(NULL, " \t\r\n"))) {
+        char *pEnd;
+
+        if (nVal >= nMax) {
+            gen_fail("more than %u values", (unsigned)nMax);
+        }
+        pVal[nVal++] = strtod(pTok, &pEnd);
+        if ('\0' != *pEnd) {
+            gen_fail("invalid number '%s'", pTok);
+        }
+    }
+
+    return nVal;
+}
+
+/**
+ * @brief Read one row (or the diagonal) of a covariance matrix statement.
+ *
+ * @param pMtx Matrix (n x n)
+ * @param pRows Rows assigned so far
+ * @param n Dimension
+ * @param pKey Statement name
+ */
+static void gen_matrix(double *pMtx, uint32_t *pRows, uint32_t n, const char *pKey) {
+    const char *pTok = strtok(NULL, " \t\r\n");
+    double val[GEN_DIM_MAX];
+    uint32_t idx;
+
+    if (0 == n) {
+        gen_fail("%s before its dimension", pKey);
+    }
+    if (NULL != pTok && 0 == strcmp(pTok, "diag") && 0 == *pRows) {
+        if (gen_values(val, GEN_DIM_MAX) != n) {
+            gen_fail("%s diag needs %u values", pKey, (unsigned)n);
+        }
+        for (idx = 0; idx < n; idx++) {
+            pMtx[n * idx + idx] = val[idx];
+        }
+        *pRows = n;
+    } else if (NULL != pTok && 0 == strcmp(pTok, "row") && *pRows < n) {
+        if (gen_values(val, GEN_DIM_MAX) != n) {
+            gen_fail("%s row needs %u values", pKey, (unsigned)n);
+        }
+        for (idx = 0; idx < n; idx++) {
+            pMtx[n * *pRows + idx] = val[idx];
+        }
+        (*pRows)++;
+    } else {
+        gen_fail("expected '%s diag <values>' or %u '%s row <values>' statements", pKey, (unsigned)n, pKey);
+    }
+}
+
+/**
+ * @brief Read a list of names.
+ *
+ * @param pList Names
+ * @param pNum Number of names
+ * @param pKey Statement name
+ */
+static void gen_names(char (*pList)[GEN_NAME_LEN], uint32_t *pNum, const char *pKey) {
+    const char *pTok;
+
+    if (0 != *pNum) {
+        gen_fail("%s is already defined", pKey);
+    }
+    while (NULL != (pTok = strtok(NULL, " \t\r\n"))) {
+        if (*pNum >= GEN_DIM_MAX) {
+            gen_fail("more than %u names in %s", (unsigned)GEN_DIM_MAX, pKey);
+        }
+        if (0 == gen_ident(pTok)) {
+            gen_fail("invalid or duplicate name '%s'", pTok);
+        }
+        strcpy(pList[(*pNum)++], pTok);
+    }
+}
+
+/**
+ * @brief Read a scalar parameter statement.
+ *
+ * @param pKey Statement name
+ * @return double Value
+ */
+static double gen_scalar(const char *pKey) {
+    double val;
+
+    if (1 != gen_values(&val, 1)) {
+        gen_fail("%s needs one value", pKey);
+    }
+
+    return val;
+}
+
+/**
+ * @brief Read an f or h statement: '<name> = <expression>'.
+ *
+ * @param pRest Text after the statement name
+ * @param inPred 1 := f, 0 := h
+ */
+static void gen_equation(const char *pRest, uint8_t inPred) {
+    tGenModel *const pMdl = &GenModel;
+    const char *pCur = pRest;
+    char name[GEN_NAME_LEN];
+    int32_t *const pRoot = inPred ? pMdl->f : pMdl->h;
+    char (*const pSrc)[GEN_LINE_LEN] = inPred ? pMdl->fSrc : pMdl->hSrc;
+    int32_t idx;
+    size_t len;
+
+    gen_skip(&pCur);
+    gen_read_ident(&pCur, name);
+    idx = inPred ? gen_find(pMdl->state, pMdl->nx, name) : gen_find(pMdl->meas, pMdl->ny, name);
+    if (idx < 0) {
+        gen_fail("'%s' is not a %s", name, inPred ? "state" : "measurement");
+    }
+    if (pRoot[idx] >= 0) {
+        gen_fail("%s %s is already defined", inPred ? "f" : "h", name);
+    }
+    gen_skip(&pCur);
+    if ('=' != *pCur) {
+        gen_fail("expected '=' after '%s'", name);
+    }
+    pCur++;
+    gen_skip(&pCur);
+
+    //source text of the doc comment
+    len = strlen(pCur);
+    while (len > 0 && isspace((unsigned char)pCur[len - 1u])) {
+        len--;
+    }
+    memcpy(pSrc[idx], pCur, len);
+    pSrc[idx][len] = '\0';
+
+    pRoot[idx] = gen_parse_expr(&pCur, inPred);
+    gen_skip(&pCur);
+    if ('\0' != *pCur) {
+        gen_fail("unexpected '%s'", pCur);
+    }
+}
+
+/**
+ * @brief Read the model description.
+ *
+ * @param pFile Model file name
+ */
+static void gen_read(const char *pFile) {
+    tGenModel *const pMdl = &GenModel;
+    char line[GEN_LINE_LEN];
+    FILE *pIn = fopen(pFile, "r");
+    uint32_t idx;
+
+    pGenFile = pFile;
+    if (NULL == pIn) {
+        gen_fail("can't open %s", pFile);
+    }
+
+    memset(pMdl, 0, sizeof(*pMdl));
+    pMdl->alpha = 1.0;
+    pMdl->beta = 2.0;
+    pMdl->kappa = 0.0;
+    pMdl->eps = 1e-3;
+    for (idx = 0; idx < GEN_DIM_MAX; idx++) {
+        pMdl->f[idx] = -1;
+        pMdl->h[idx] = -1;
+    }
+
+    while (NULL != fgets(line, sizeof(line), pIn)) {
+        char stmt[GEN_LINE_LEN];
+        char *const pHash = strchr(line, '#');
+        const char *pKey;
+
+        GenLine++;
+        if (NULL != pHash) {
+            *pHash = '\0';
+        }
+        strcpy(stmt, line);
+        pKey = strtok(stmt, " \t\r\n");
+        if (NULL == pKey) {
+            continue;
+        }
+
+        if (0 == strcmp(pKey, "model")) {
+            const char *const pName = strtok(NULL, " \t\r\n");
+
+            if (NULL == pName || 0 == gen_ident(pName) || '\0' != pMdl->name[0]) {
+                gen_fail("model needs one valid name");
+            }
+            strcpy(pMdl->name, pName);
+        } else if (0 == strcmp(pKey, "state")) {
+            gen_names(pMdl->state, &pMdl->nx, pKey);
+        } else if (0 == strcmp(pKey, "meas")) {
+            gen_names(pMdl->meas, &pMdl->ny, pKey);
+        } else if (0 == strcmp(pKey, "input")) {
+            gen_names(pMdl->input, &pMdl->nu, pKey);
+        } else if (0 == strcmp(pKey, "const")) {
+            const char *pTok;
+
+            while (NULL != (pTok = strtok(NULL, " \t\r\n"))) {
+                const char *const pVal = strtok(NULL, " \t\r\n");
+                char *pEnd;
+
+                if (NULL == pVal || 0 == gen_ident(pTok) || pMdl->nc >= GEN_DIM_MAX) {
+                    gen_fail("const needs unique name value pairs");
+                }
+                strcpy(pMdl->cnst[pMdl->nc], pTok);
+                pMdl->cnstVal[pMdl->nc++] = strtod(pVal, &pEnd);
+                if ('\0' != *pEnd) {
+                    gen_fail("invalid number '%s'", pVal);
+                }
+            }
+        } else if (0 == strcmp(pKey, "dT")) {
+            pMdl->dT = gen_scalar(pKey);
+            pMdl->dTSet = 1;
+        } else if (0 == strcmp(pKey, "alpha")) {
+            pMdl->alpha = gen_scalar(pKey);
+        } else if (0 == strcmp(pKey, "beta")) {
+            pMdl->beta = gen_scalar(pKey);
+        } else if (0 == strcmp(pKey, "kappa")) {
+            pMdl->kappa = gen_scalar(pKey);
+        } else if (0 == strcmp(pKey, "eps")) {
+            pMdl->eps = gen_scalar(pKey);
+        } else if (0 == strcmp(pKey, "scheme")) {
+            const char *const pTok = strtok(NULL, " \t\r\n");
+
+            if (NULL == pTok || (0 != strcmp(pTok, "symmetric") && 0 != strcmp(pTok, "simplex"))) {
+                gen_fail("scheme is symmetric or simplex");
+            }
+            pMdl->simplex = (0 == strcmp(pTok, "simplex"));
+        } else if (0 == strcmp(pKey, "update")) {
+            static const char *const updateName[3] = {"auto", "batch", "sequential"};
+            const char *const pTok = strtok(NULL, " \t\r\n");
+
+            for (idx = 0; idx < 3u && (NULL == pTok || 0 != strcmp(pTok, updateName[idx])); idx++) {
+            }
+            if (idx == 3u) {
+                gen_fail("update is auto, batch or sequential");
+            }
+            pMdl->update = (uint8_t)idx;
+        } else if (0 == strcmp(pKey, "mode")) {
+            const char *pTok;
+
+            while (NULL != (pTok = strtok(NULL, " \t\r\n"))) {
+                const uint8_t mode = (0 == strcmp(pTok, "sqrt"));
+
+                if ((0 == mode && 0 != strcmp(pTok, "standard")) || pMdl->nMode >= 2u
+                    || (1u == pMdl->nMode && pMdl->mode[0] == mode)) {
+                    gen_fail("mode lists standard and/or sqrt once");
+                }
+                pMdl->mode[pMdl->nMode++] = mode;
+            }
+        } else if (0 == strcmp(pKey, "f") || 0 == strcmp(pKey, "h")) {
+            gen_equation(strstr(line, pKey) + 1, ('f' == pKey[0]));
+        } else if (0 == strcmp(pKey, "x0")) {
+            pMdl->x0Set = gen_values(pMdl->x0, GEN_DIM_MAX);
+            if (pMdl->x0Set != pMdl->nx || 0 == pMdl->nx) {
+                gen_fail("x0 needs one value per state");
+            }
+        } else if (0 == strcmp(pKey, "P0")) {
+            gen_matrix(pMdl->P0, &pMdl->P0Rows, pMdl->nx, pKey);
+        } else if (0 == strcmp(pKey, "Q")) {
+            gen_matrix(pMdl->Q, &pMdl->QRows, pMdl->nx, pKey);
+        } else if (0 == strcmp(pKey, "R")) {
+            gen_matrix(pMdl->R, &pMdl->RRows, pMdl->ny, pKey);
+        } else if (0 == strcmp(pKey, "ref")) {
+            const uint32_t refLen = pMdl->ny + pMdl->nu + pMdl->nx;
+
+            if (pMdl->nRef >= GEN_REF_MAX) {
+                gen_fail("more than %u reference steps", (unsigned)GEN_REF_MAX);
+            }
+            if (0 == pMdl->nx || 0 == pMdl->ny || gen_values(GenRef[pMdl->nRef], 3u * GEN_DIM_MAX) != refLen) {
+                gen_fail("ref needs %u measurements, %u inputs and %u states", (unsigned)pMdl->ny,
+                         (unsigned)pMdl->nu, (unsigned)pMdl->nx);
+            }
+            pMdl->nRef++;
+        } else {
+            gen_fail("unknown statement '%s'", pKey);
+        }
+    }
+    (void)fclose(pIn);
+    GenLine = 0;
+
+    //completeness of the description
+    if ('\0' == pMdl->name[0] || 0 == pMdl->nx || 0 == pMdl->ny) {
+        gen_fail("%s: model, state and meas are mandatory", pFile);
+    }
+    for (idx = 0; idx < pMdl->nx; idx++) {
+        if (pMdl->f[idx] < 0) {
+            gen_fail("%s: no f for state %s", pFile, pMdl->state[idx]);
+        }
+    }
+    for (idx = 0; idx < pMdl->ny; idx++) {
+        if (pMdl->h[idx] < 0) {
+            gen_fail("%s: no h for measurement %s", pFile, pMdl->meas[idx]);
+        }
+    }
+    if (0 == pMdl->dTSet || 0 == pMdl->x0Set || pMdl->P0Rows != pMdl->nx || pMdl->QRows != pMdl->nx || pMdl->RRows != pMdl->ny) {
+        gen_fail("%s: dT, x0, P0, Q and R are mandatory", pFile);
+    }
+    if (pMdl->nu > pMdl->nx) {
+        gen_fail("%s: more inputs than states", pFile);
+    }
+    if (0 == pMdl->nMode) {
+        pMdl->nMode = 1;
+    }
+}
+
+/**
+ * @brief Shortest decimal text of a number that reads back to the same double.
+ *
+ * @param pBuf Text, 32 bytes
+ * @param val Number
+ */
+static void gen_num(char *pBuf, double val) {
+    int prec;
+
+    for (prec = 1; prec <= 17; prec++) {
+        (void)snprintf(pBuf, 32, "%.*g", prec, val);
+        if (strtod(pBuf, NULL) == val) {
+            break;
+        }
+    }
+
+    //plain decimals instead of an exponent for moderate magnitudes, e.g. 20 instead of 2e+01
+    if (NULL != strchr(pBuf, 'e') && fabs(val) >= 1e-4 && fabs(val) < 1e15) {
+        char dec[32];
+
+        for (prec = 0; prec <= 17; prec++) {
+            (void)snprintf(dec, sizeof(dec), "%.*f", prec, val);
+            if (strtod(dec, NULL) == val) {
+                strcpy(pBuf, dec);
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Literal of an expression: MTX_C() needs a decimal point or an exponent.
+ *
+ * @param pBuf Text, 40 bytes
+ * @param val Number, not negative
+ */
+static void gen_literal(char *pBuf, double val) {
+    char num[32];
+
+    gen_num(num, val);
+    if (NULL == strpbrk(num, ".e")) {
+        strcat(num, ".0");
+    }
+    (void)snprintf(pBuf, 40, "MTX_C(%s)", num);
+}
+
+/**
+ * @brief Operator precedence of a node in the emitted C expression.
+ *
+ * @param pNode Node
+ * @return uint8_t 1 := + -, 2 := * /, 3 := unary minus, 4 := operand or call
+ */
+static uint8_t gen_prec(tGenNode const *pNode) {
+    switch (pNode->op) {
+    case GEN_OP_ADD:
+    case GEN_OP_SUB:
+        return 1;
+    case GEN_OP_MUL:
+    case GEN_OP_DIV:
+        return 2;
+    case GEN_OP_NEG:
+        return 3;
+    case GEN_OP_NUM:
+        return (pNode->val < 0.0) ? 3 : 4;
+    default:
+        return 4;
+    }
+}
+
+/**
+ * @brief Emit the C expression of a node, shared nodes are referenced by their temporary.
+ *
+ * @param pOut Output file
+ * @param pKer Kernel
+ * @param node Node index
+ */
+static void gen_expr(FILE *pOut, tGenKernel const *pKer, int32_t node) {
+    tGenNode const *const pNode = &GenNode[node];
+    static const char opChar[] = {'+', '-', '*', '/'};
+    char lit[40];
+
+    if (pKer->temp[node] >= 0) {
+        fprintf(pOut, "t%d", (int)pKer->temp[node]);
+        return;
+    }
+
+    switch (pNode->op) {
+    case GEN_OP_NUM:
+        gen_literal(lit, fabs(pNode->val));
+        fprintf(pOut, "%s%s", (pNode->val < 0.0) ? "-" : "", lit);
+        break;
+    case GEN_OP_STATE:
+        fprintf(pOut, "x_%s", GenModel.state[pNode->a]);
+        break;
+    case GEN_OP_INPUT:
+        fprintf(pOut, "u_%s", GenModel.input[pNode->a]);
+        break;
+    case GEN_OP_DT:
+        fprintf(pOut, "dT");
+        break;
+    case GEN_OP_ADD:
+    case GEN_OP_SUB:
+    case GEN_OP_MUL:
+    case GEN_OP_DIV: {
+        const uint8_t prec = gen_prec(pNode);
+        //temporaries are operands of highest precedence
+        const uint8_t precA = (pKer->temp[pNode->a] >= 0) ? 4 : gen_prec(&GenNode[pNode->a]);
+        const uint8_t precB = (pKer->temp[pNode->b] >= 0) ? 4 : gen_prec(&GenNode[pNode->b]);
+        const uint8_t parA = (precA < prec);
+        const uint8_t parB = (precB < prec || (precB == prec && (GEN_OP_SUB == pNode->op || GEN_OP_DIV == pNode->op)));
+
+        fprintf(pOut, "%s", parA ? "(" : "");
+        gen_expr(pOut, pKer, pNode->a);
+        fprintf(pOut, "%s %c %s", parA ? ")" : "", opChar[pNode->op - GEN_OP_ADD], parB ? "(" : "");
+        gen_expr(pOut, pKer, pNode->b);
+        fprintf(pOut, "%s", parB ? ")" : "");
+        break;
+    }
+    case GEN_OP_NEG: {
+        const uint8_t par = (pKer->temp[pNode->a] < 0 && gen_prec(&GenNode[pNode->a]) < 4);
+
+        fprintf(pOut, "-%s", par ? "(" : "");
+        gen_expr(pOut, pKer, pNode->a);
+        fprintf(pOut, "%s", par ? ")" : "");
+        break;
+    }
+    default: {
+        uint32_t fIdx;
+
+        for (fIdx = 0; GenFunc[fIdx].op != pNode->op; fIdx++) {
+        }
+        fprintf(pOut, "%s(", GenFunc[fIdx].pMacro);
+        gen_expr(pOut, pKer, pNode->a);
+        if (pNode->b >= 0) {
+            fprintf(pOut, ", ");
+            gen_expr(pOut, pKer, pNode->b);
+        }
+        fprintf(pOut, ")");
+        break;
+    }
+    }
+}
+
+/**
+ * @brief Mark the nodes reachable from a root and count their uses.
+ *
+ * @param pKer Kernel
+ * @param node Node index
+ */
+static void gen_reach(tGenKernel *pKer, int32_t node) {
+    tGenNode const *const pNode = &GenNode[node];
+
+    pKer->uses[node]++;
+    if (0 != pKer->reach[node]) {
+        return;
+    }
+    pKer->reach[node] = 1;
+    if (pNode->op >= GEN_OP_ADD) {
+        gen_reach(pKer, pNode->a);
+        if (pNode->b >= 0) {
+            gen_reach(pKer, pNode->b);
+        }
+    } else if (GEN_OP_DT == pNode->op) {
+        pKer->useDt = 1;
+    } else if (GEN_OP_INPUT == pNode->op) {
+        pKer->useIn = 1;
+    }
+}
+
+/**
+ * @brief Plan one kernel: outputs, reachable nodes and temporaries of shared nodes.
+ *
+ * @param pKer Kernel
+ * @param kind GEN_KER_*
+ */
+static void gen_plan(tGenKernel *pKer, uint8_t kind) {
+    tGenModel const *const pMdl = &GenModel;
+    const uint8_t pred = (GEN_KER_PRED_BATCH == kind || GEN_KER_PRED_VEC == kind);
+    uint32_t idx;
+
+    memset(pKer, 0, sizeof(*pKer));
+    pKer->kind = kind;
+    pKer->nRoot = pred ? pMdl->nx : pMdl->ny;
+    for (idx = 0; idx < pKer->nRoot; idx++) {
+        const int32_t root = pred ? pMdl->f[idx] : pMdl->h[idx];
+
+        //x(k|k-1) = x(k-1) stays in place
+        const uint8_t same = pred && GEN_OP_STATE == GenNode[root].op && (uint32_t)GenNode[root].a == idx;
+
+        pKer->root[idx] = same ? -1 : root;
+        if (!same) {
+            gen_reach(pKer, root);
+        }
+    }
+    for (idx = 0; idx < GenNodeNum; idx++) {
+        pKer->temp[idx] = -1;
+        if (0 != pKer->reach[idx] && GenNode[idx].op >= GEN_OP_ADD && pKer->uses[idx] > 1u) {
+            pKer->temp[idx] = (int32_t)pKer->nTemp++;
+        }
+    }
+}
+
+/**
+ * @brief Emit the model equations of a kernel into its doc comment.
+ *
+ * @param pOut Output file
+ * @param pred 1 := f, 0 := h
+ */
+static void gen_doc_model(FILE *pOut, uint8_t pred) {
+    tGenModel const *const pMdl = &GenModel;
+    const uint32_t nOut = pred ? pMdl->nx : pMdl->ny;
+    uint32_t idx;
+
+    for (idx = 0; idx < nOut; idx++) {
+        fprintf(pOut, " * %s = %s\n", pred ? pMdl->state[idx] : pMdl->meas[idx], pred ? pMdl->fSrc[idx] : pMdl->hSrc[idx]);
+    }
+}
+
+/**
+ * @brief Emit one kernel.
+ *
+ * @param pOut Output file
+ * @param kind GEN_KER_*
+ */
+static void gen_kernel(FILE *pOut, uint8_t kind) {
+    tGenModel const *const pMdl = &GenModel;
+    tGenKernel *const pKer = &GenKernel;
+    const uint8_t pred = (GEN_KER_PRED_BATCH == kind || GEN_KER_PRED_VEC == kind);
+    const uint8_t batch = (GEN_KER_PRED_BATCH == kind || GEN_KER_OBS_BATCH == kind);
+    const char *const pInd = batch ? "        " : "    ";
+    const char *const pU = pred ? "pu_p" : "pu";
+    uint32_t nDecl = 0;
+    uint32_t idx;
+
+    gen_plan(pKer, kind);
+
+    //signature and doc comment in the form of the hand written callbacks of ukfCfg.c
+    fprintf(pOut, "/**\n");
+    if (batch) {
+        fprintf(pOut, " * @brief Fused %s for sigma columns [sigmaIdx, sigmaIdx + sigmaCnt).\n",
+                pred ? "prediction of all states" : "observation of all outputs");
+    } else {
+        fprintf(pOut, " * @brief %s of one dense sigma point (UKF_SIGMA_MAJOR).\n", pred ? "Prediction" : "Observation");
+    }
+    gen_doc_model(pOut, pred);
+    fprintf(pOut, " * \n");
+    if (pred) {
+        fprintf(pOut, " * @param pu_p Input u(k-1)%s\n", (0 == pMdl->nu) ? ", NULL for this system" : "");
+    } else {
+        fprintf(pOut, " * @param pu Input u(k)%s\n", (0 == pMdl->nu) ? ", NULL for this system" : "");
+    }
+    switch (kind) {
+    case GEN_KER_PRED_BATCH:
+        fprintf(pOut, " * @param pX_p Pointer to the sigma points array at (k-1) moment\n");
+        fprintf(pOut, " * @param pX_m Pointer to the propagated sigma points array at (k|k-1) moment, same memory as pX_p\n");
+        fprintf(pOut, " * @param sigmaIdx First sigma point index.\n");
+        fprintf(pOut, " * @param sigmaCnt Number of sigma points to propagate.\n");
+        fprintf(pOut, " * @param dT Sampling time.\n */\n");
+        fprintf(pOut, "static void FxBatch(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, mtxDim sigmaIdx, mtxDim sigmaCnt, mtxScalar dT) {\n");
+        break;
+    case GEN_KER_OBS_BATCH:
+        fprintf(pOut, " * @param pX_m Pointer to the propagated sigma points array at (k|k-1) moment\n");
+        fprintf(pOut, " * @param pY_m Pointer to the output sigma points array at (k|k-1) moment\n");
+        fprintf(pOut, " * @param sigmaIdx First sigma point index.\n");
+        fprintf(pOut, " * @param sigmaCnt Number of sigma points to propagate.\n */\n");
+        fprintf(pOut, "static void HyBatch(tMatrix* pu, tMatrix* pX_m, tMatrix* pY_m, mtxDim sigmaIdx, mtxDim sigmaCnt) {\n");
+        break;
+    case GEN_KER_PRED_VEC:
+        fprintf(pOut, " * @param px Sigma point X_p(i) on entry, X_m(i) on return\n");
+        fprintf(pOut, " * @param dT Sampling time.\n */\n");
+        fprintf(pOut, "static void FxVec(mtxScalar const *pu_p, mtxScalar *px, mtxScalar dT) {\n");
+        break;
+    default:
+        fprintf(pOut, " * @param px_m Propagated sigma point X_m(i)\n");
+        fprintf(pOut, " * @param py_m Output sigma point Y_m(i)\n */\n");
+        fprintf(pOut, "static void HyVec(mtxScalar const *pu, mtxScalar const *px_m, mtxScalar *py_m) {\n");
+        break;
+    }
+
+    //inputs are common to all sigma points
+    for (idx = 0; idx < GenNodeNum; idx++) {
+        if (0 != pKer->reach[idx] && GEN_OP_INPUT == GenNode[idx].op) {
+            fprintf(pOut, "    const mtxScalar u_%s = %s%s[%d];\n", pMdl->input[GenNode[idx].a], pU, batch ? "->val" : "",
+                    (int)GenNode[idx].a);
+        }
+    }
+    if (batch) {
+        fprintf(pOut, "    const mtxDim sigmaEnd = sigmaIdx + sigmaCnt;\n");
+        fprintf(pOut, "    mtxDim sIdx;\n\n");
+        fprintf(pOut, "    for (sIdx = sigmaIdx; sIdx < sigmaEnd; sIdx++) {\n");
+    }
+
+    //load every sigma point element before the first store
+    for (idx = 0; idx < pMdl->nx; idx++) {
+        uint32_t nIdx;
+
+        for (nIdx = 0; nIdx < GenNodeNum && !(GEN_OP_STATE == GenNode[nIdx].op && (uint32_t)GenNode[nIdx].a == idx); nIdx++) {
+        }
+        if (nIdx < GenNodeNum && 0 != pKer->reach[nIdx]) {
+            fprintf(pOut, "%sconst mtxScalar x_%s = ", pInd, pMdl->state[idx]);
+            switch (kind) {
+            case GEN_KER_PRED_BATCH: fprintf(pOut, "UKF_SIGMA_AT(pX_p, %u, sIdx);\n", (unsigned)idx); break;
+            case GEN_KER_OBS_BATCH:  fprintf(pOut, "UKF_SIGMA_AT(pX_m, %u, sIdx);\n", (unsigned)idx); break;
+            case GEN_KER_PRED_VEC:   fprintf(pOut, "px[%u];\n", (unsigned)idx); break;
+            default:                 fprintf(pOut, "px_m[%u];\n", (unsigned)idx); break;
+            }
+            nDecl++;
+        }
+    }
+
+    //shared subexpressions in dependency order
+    for (idx = 0; idx < GenNodeNum; idx++) {
+        if (pKer->temp[idx] >= 0) {
+            const int32_t tIdx = pKer->temp[idx];
+
+            fprintf(pOut, "%sconst mtxScalar t%d = ", pInd, (int)tIdx);
+            pKer->temp[idx] = -1;
+            gen_expr(pOut, pKer, (int32_t)idx);
+            pKer->temp[idx] = tIdx;
+            fprintf(pOut, ";\n");
+            nDecl++;
+        }
+    }
+    if (nDecl > 0u) {
+        fprintf(pOut, "\n");
+    }
+
+    for (idx = 0; idx < pKer->nRoot; idx++) {
+        if (pKer->root[idx] >= 0) {
+            switch (kind) {
+            case GEN_KER_PRED_BATCH: fprintf(pOut, "%sUKF_SIGMA_AT(pX_m, %u, sIdx) = ", pInd, (unsigned)idx); break;
+            case GEN_KER_OBS_BATCH:  fprintf(pOut, "%sUKF_SIGMA_AT(pY_m, %u, sIdx) = ", pInd, (unsigned)idx); break;
+            case GEN_KER_PRED_VEC:   fprintf(pOut, "%spx[%u] = ", pInd, (unsigned)idx); break;
+            default:                 fprintf(pOut, "%spy_m[%u] = ", pInd, (unsigned)idx); break;
+            }
+            gen_expr(pOut, pKer, pKer->root[idx]);
+            fprintf(pOut, ";\n");
+        } else {
+            fprintf(pOut, "%s//%s(k|k-1) = %s(k-1) stays in place\n", pInd, pMdl->state[idx], pMdl->state[idx]);
+        }
+    }
+    if (batch) {
+        fprintf(pOut, "    }\n");
+    }
+
+    //unused parameters
+    if (0 == pKer->useIn || (pred && 0 == pKer->useDt)) {
+        fprintf(pOut, "\n");
+    }
+    if (0 == pKer->useIn) {
+        fprintf(pOut, "    (void)%s;\n", pU);
+    }
+    if (pred && 0 == pKer->useDt) {
+        fprintf(pOut, "    (void)dT;\n");
+    }
+    fprintf(pOut, "}\n\n");
+}
+
+/**
+ * @brief Emit a (rows x cols) initialized array with the state or measurement names as comments.
+ *
+ * @param pOut Output file
+ * @param pDecl Declaration up to '='
+ * @param pVal Values (rows x cols)
+ * @param rows Number of rows
+ * @param cols Number of columns
+ * @param pName Row and column names
+ */
+static void gen_array(FILE *pOut, const char *pDecl, const double *pVal, uint32_t rows, uint32_t cols, char (*pName)[GEN_NAME_LEN]) {
+    char num[32];
+    uint32_t rIdx, cIdx;
+
+    fprintf(pOut, "%s =\n    {\n", pDecl);
+    if (cols > 1u) {
+        fprintf(pOut, "        /* ");
+        for (cIdx = 0; cIdx < cols; cIdx++) {
+            fprintf(pOut, "%s%s", pName[cIdx], (cIdx + 1u < cols) ? ", " : " */\n");
+        }
+    }
+    for (rIdx = 0; rIdx < rows; rIdx++) {
+        fprintf(pOut, "        {");
+        for (cIdx = 0; cIdx < cols; cIdx++) {
+            gen_num(num, pVal[cols * rIdx + cIdx]);
+            fprintf(pOut, "%s%s", num, (cIdx + 1u < cols) ? ", " : "");
+        }
+        fprintf(pOut, "}, /* %s */\n", pName[rIdx]);
+    }
+    fprintf(pOut, "};\n\n");
+}
+
+/**
+ * @brief Open an output file <outDir>/<model><suffix>.
+ *
+ * @param pDir Output directory
+ * @param pSuffix File name suffix
+ * @param pPath Path, GEN_PATH_LEN bytes
+ * @return FILE* Opened file
+ */
+static FILE *gen_open(const char *pDir, const char *pSuffix, char *pPath) {
+    FILE *pOut;
+
+    (void)snprintf(pPath, GEN_PATH_LEN, "%s/%s%s", pDir, GenModel.name, pSuffix);
+    pOut = fopen(pPath, "w");
+    if (NULL == pOut) {
+        gen_fail("can't write %s", pPath);
+    }
+
+    return pOut;
+}
+
+/**
+ * @brief Emit <model>Cfg.h.
+ *
+ * @param pDir Output directory
+ * @param pSrc Model file name
+ * @param pUp Upper case model name
+ * @param pCap Capitalized model name
+ */
+static void gen_header(const char *pDir, const char *pSrc, const char *pUp, const char *pCap) {
+    tGenModel const *const pMdl = &GenModel;
+    const uint32_t sLen = pMdl->simplex ? (pMdl->nx + 2u) : (2u * pMdl->nx + 1u);
+    char path[GEN_PATH_LEN];
+    FILE *const pOut = gen_open(pDir, "Cfg.h", path);
+
+    fprintf(pOut, "/**\n");
+    fprintf(pOut, " * @file %sCfg.h\n", pMdl->name);
+    fprintf(pOut, " * @brief Config header of the %s model, generated by ukfGen.c from %s, do not edit.\n", pMdl->name, pSrc);
+    fprintf(pOut, " */\n\n");
+    fprintf(pOut, "#ifndef %sCFG_H\n#define %sCFG_H\n\n", pUp, pUp);
+    fprintf(pOut, "#include \"ukfLib.h\"\n\n");
+    fprintf(pOut, "#define %s_LX (%uu)\n", pUp, (unsigned)pMdl->nx);
+    fprintf(pOut, "#define %s_LY (%uu)\n", pUp, (unsigned)pMdl->ny);
+    if (pMdl->nu > 0u) {
+        fprintf(pOut, "#define %s_LU (%uu)\n", pUp, (unsigned)pMdl->nu);
+    }
+    fprintf(pOut, "#define %s_SLEN (%uu)  //UKF_SIGMA_LEN(%s_LX, %s)\n", pUp, (unsigned)sLen, pUp,
+            pMdl->simplex ? "UKF_SIGMA_SIMPLEX" : "UKF_SIGMA_SYMMETRIC");
+    fprintf(pOut, "\n//! Dimensions ukf_step() is specialized for when ukfLib.c is built with -DUKF_SPEC_HEADER='\"%sCfg.h\"'\n", pMdl->name);
+    fprintf(pOut, "#ifndef UKF_SPEC_DIMS\n#define UKF_SPEC_DIMS UKF_SPEC(%s_LX, %s_LY)\n#endif\n\n", pUp, pUp);
+    fprintf(pOut, "extern tUkfMatrix %sMatrixCfg;\n\n", pCap);
+    fprintf(pOut, "void ukf_test_%s(void);\n\n", pMdl->name);
+    fprintf(pOut, "#endif /* %sCFG_H */\n", pUp);
+    (void)fclose(pOut);
+}
+
+/**
+ * @brief Emit <model>Cfg.c.
+ *
+ * @param pDir Output directory
+ * @param pSrc Model file name
+ * @param pUp Upper case model name
+ * @param pCap Capitalized model name
+ */
+static void gen_config(const char *pDir, const char *pSrc, const char *pUp, const char *pCap) {
+    static const char *const updateName[3] = {"UKF_UPDATE_AUTO", "UKF_UPDATE_BATCH", "UKF_UPDATE_SEQUENTIAL"};
+    tGenModel *const pMdl = &GenModel;
+    const uint8_t withSqrt = (1u == pMdl->mode[0] || (2u == pMdl->nMode && 1u == pMdl->mode[1]));
+    const char *const pN = (pMdl->nx >= pMdl->ny) ? "LX" : "LY";
+    char path[GEN_PATH_LEN];
+    char decl[GEN_LINE_LEN];
+    char num[3][32];
+    FILE *const pOut = gen_open(pDir, "Cfg.c", path);
+    uint32_t idx;
+
+    fprintf(pOut, "/**\n");
+    fprintf(pOut, " * @file %sCfg.c\n", pMdl->name);
+    fprintf(pOut, " * @brief Config file of the %s model, generated by ukfGen.c from %s, do not edit.\n", pMdl->name, pSrc);
+    fprintf(pOut, " * \n * State vector\n");
+    for (idx = 0; idx < pMdl->nx; idx++) {
+        fprintf(pOut, " * x[%u] = %s(k)\n", (unsigned)idx, pMdl->state[idx]);
+    }
+    fprintf(pOut, " * \n * Measurement vector\n");
+    for (idx = 0; idx < pMdl->ny; idx++) {
+        fprintf(pOut, " * y[%u] = %s(k)\n", (unsigned)idx, pMdl->meas[idx]);
+    }
+    if (pMdl->nu > 0u) {
+        fprintf(pOut, " * \n * Input vector\n");
+        for (idx = 0; idx < pMdl->nu; idx++) {
+            fprintf(pOut, " * u[%u] = %s(k)\n", (unsigned)idx, pMdl->input[idx]);
+        }
+    }
+    fprintf(pOut, " */\n\n");
+    fprintf(pOut, "#include \"%sCfg.h\"\n#include <stdint.h>\n#include <math.h>\n\n", pMdl->name);
+    fprintf(pOut, "static void FxBatch(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, mtxDim sigmaIdx, mtxDim sigmaCnt, mtxScalar dT);\n");
+    fprintf(pOut, "static void HyBatch(tMatrix* pu, tMatrix* pX_m, tMatrix* pY_m, mtxDim sigmaIdx, mtxDim sigmaCnt);\n\n");
+    fprintf(pOut, "#if defined(UKF_SIGMA_MAJOR)\n");
+    fprintf(pOut, "static void FxVec(mtxScalar const *pu_p, mtxScalar *px, mtxScalar dT);\n");
+    fprintf(pOut, "static void HyVec(mtxScalar const *pu, mtxScalar const *px_m, mtxScalar *py_m);\n");
+    fprintf(pOut, "#endif\n\n");
+
+    //storage
+    gen_num(num[0], pMdl->alpha);
+    gen_num(num[1], pMdl->beta);
+    gen_num(num[2], pMdl->kappa);
+    fprintf(pOut, "//! UKF Processing matrix\n");
+    fprintf(pOut, "static mtxScalar Sc_vector[1][3] = {{%s, %s, %s}};\n", num[0], num[1], num[2]);
+    fprintf(pOut, "static mtxScalar Wm_weight_vector[1][%s_SLEN];\n", pUp);
+    fprintf(pOut, "static mtxScalar Wc_weight_vector[1][%s_SLEN];\n", pUp);
+    if (pMdl->nu > 0u) {
+        //ukf_init() checks the input as (xLen x 1), u(k-1) of the prediction is kept in the same array
+        fprintf(pOut, "static mtxScalar u_system_input[%s_LX][1];  //elements %s_LU.. are not used\n", pUp, pUp);
+    }
+    fprintf(pOut, "static mtxScalar y_meas[%s_LY][1];\n", pUp);
+    fprintf(pOut, "static uint8_t y_meas_valid[%s_LY][1] = {", pUp);
+    for (idx = 0; idx < pMdl->ny; idx++) {
+        fprintf(pOut, "{1}%s", (idx + 1u < pMdl->ny) ? ", " : "};\n");
+    }
+    fprintf(pOut, "static mtxScalar y_predicted_mean[%s_LY][1];\n", pUp);
+    for (idx = 0; idx < 2u; idx++) {
+        uint32_t xIdx;
+
+        fprintf(pOut, "static mtxScalar %s[%s_LX][1] = {", (0u == idx) ? "x_system_states" : "x_system_states_ic", pUp);
+        for (xIdx = 0; xIdx < pMdl->nx; xIdx++) {
+            gen_num(num[0], pMdl->x0[xIdx]);
+            fprintf(pOut, "{%s}%s", num[0], (xIdx + 1u < pMdl->nx) ? ", " : "};\n");
+        }
+    }
+    fprintf(pOut, "#if defined(UKF_SIGMA_MAJOR)\n");
+    fprintf(pOut, "//! Sigma points X(k-1), X(k|k-1) and Y(k|k-1) = y_m: one row per sigma point\n");
+    fprintf(pOut, "static mtxScalar X_sigma_points[%s_SLEN][%s_LX];\n", pUp, pUp);
+    fprintf(pOut, "static mtxScalar Y_sigma_points[%s_SLEN][%s_LY];\n", pUp, pUp);
+    fprintf(pOut, "#else\n");
+    fprintf(pOut, "//! Sigma points X(k-1), X(k|k-1) and Y(k|k-1) = y_m\n");
+    fprintf(pOut, "static mtxScalar X_sigma_points[%s_LX][%s_SLEN];\n", pUp, pUp);
+    fprintf(pOut, "static mtxScalar Y_sigma_points[%s_LY][%s_SLEN];\n", pUp, pUp);
+    fprintf(pOut, "#endif\n\n");
+    fprintf(pOut, "//! State covariance  P(k|k-1) = P_m, P(k)= P\n");
+    fprintf(pOut, "static mtxScalar Pxx_error_covariance[%s_LX][%s_LX];\n\n", pUp, pUp);
+    fprintf(pOut, "//! State covariance initial values\n");
+    (void)snprintf(decl, sizeof(decl), "static mtxScalar Pxx0_init_error_covariance[%s_LX][%s_LX]", pUp, pUp);
+    gen_array(pOut, decl, pMdl->P0, pMdl->nx, pMdl->nx, pMdl->state);
+    fprintf(pOut, "//! Process noise covariance Q\n");
+    (void)snprintf(decl, sizeof(decl), "static mtxScalar Qxx_process_noise_cov[%s_LX][%s_LX]", pUp, pUp);
+    gen_array(pOut, decl, pMdl->Q, pMdl->nx, pMdl->nx, pMdl->state);
+    fprintf(pOut, "//! Output noise covariance R\n");
+    (void)snprintf(decl, sizeof(decl), "static mtxScalar Ryy0_init_out_covariance[%s_LY][%s_LY]", pUp, pUp);
+    gen_array(pOut, decl, pMdl->R, pMdl->ny, pMdl->ny, pMdl->meas);
+    fprintf(pOut, "//! Output covariance Pyy and cross-covariance of state and output Pxy\n");
+    fprintf(pOut, "static mtxScalar Pyy_out_covariance[%s_LY][%s_LY];\n", pUp, pUp);
+    fprintf(pOut, "static mtxScalar Pxy_cross_covariance[%s_LX][%s_LY];\n\n", pUp, pUp);
+    if (withSqrt) {
+        fprintf(pOut, "//! Square-root UKF buffers (UKF_MODE_SQRT): sqrt(Q), sqrt(R) and QR compound workspace of max(%s_LX, %s_LY) rows\n", pUp, pUp);
+        fprintf(pOut, "static mtxScalar Sqxx_process_noise_sqrt[%s_LX][%s_LX];\n", pUp, pUp);
+        fprintf(pOut, "static mtxScalar Sryy_out_noise_sqrt[%s_LY][%s_LY];\n", pUp, pUp);
+        fprintf(pOut, "static mtxScalar Sr_compound_workspace[%s_%s][%s_SLEN + %s_%s];\n\n", pUp, pN, pUp, pUp, pN);
+    }
+
+    //configuration
+    fprintf(pOut, "//! Kalman gain%s no arrays of their own: step temporaries\n",
+            withSqrt ? " and the square-root downdate column have" : " has");
+    fprintf(pOut, "//! with disjoint lifetimes share storage like in ukf_mem_layout()\n");
+    fprintf(pOut, "tUkfMatrix %sMatrixCfg = {\n", pCap);
+#define GEN_CFG_MTX(field, arr) \
+    fprintf(pOut, "    .%-31s= {NROWS(%s), NCOL(%s), &%s[0][0]},\n", field, arr, arr, arr)
+#define GEN_CFG_NULL(field) \
+    fprintf(pOut, "    .%-31s= {0, 0, NULL},\n", field)
+    GEN_CFG_MTX("Sc_vector", "Sc_vector");
+    GEN_CFG_MTX("Wm_weight_vector", "Wm_weight_vector");
+    GEN_CFG_MTX("Wc_weight_vector", "Wc_weight_vector");
+    GEN_CFG_MTX("x_system_states", "x_system_states");
+    GEN_CFG_MTX("x_system_states_ic", "x_system_states_ic");
+    GEN_CFG_NULL("x_system_states_limits");
+    GEN_CFG_NULL("x_system_states_limits_enable");
+    if (withSqrt) {
+        fprintf(pOut, "    .%-31s= {%s_LX, 1, &Sr_compound_workspace[0][0]},\n", "x_system_states_correction", pUp);
+    } else {
+        GEN_CFG_NULL("x_system_states_correction");
+    }
+    if (pMdl->nu > 0u) {
+        GEN_CFG_MTX("u_system_input", "u_system_input");
+    } else {
+        GEN_CFG_NULL("u_system_input");
+    }
+    GEN_CFG_NULL("u_prev_system_input");
+    GEN_CFG_MTX("X_sigma_points", "X_sigma_points");
+    GEN_CFG_MTX("Y_sigma_points", "Y_sigma_points");
+    GEN_CFG_MTX("y_predicted_mean", "y_predicted_mean");
+    GEN_CFG_MTX("y_meas", "y_meas");
+    GEN_CFG_MTX("y_meas_valid", "y_meas_valid");
+    GEN_CFG_MTX("Pyy_out_covariance", "Pyy_out_covariance");
+    GEN_CFG_NULL("Pyy_out_covariance_copy");
+    GEN_CFG_MTX("Ryy0_init_out_covariance", "Ryy0_init_out_covariance");
+    GEN_CFG_MTX("Pxy_cross_covariance", "Pxy_cross_covariance");
+    GEN_CFG_MTX("Pxx_error_covariance", "Pxx_error_covariance");
+    GEN_CFG_MTX("Pxx0_init_error_covariance", "Pxx0_init_error_covariance");
+    GEN_CFG_MTX("Qxx_process_noise_cov", "Qxx_process_noise_cov");
+    fprintf(pOut, "    .%-31s= {%s_LX, %s_LY, &Y_sigma_points[0][0]},\n", "K_kalman_gain", pUp, pUp);
+    GEN_CFG_NULL("I_identity_matrix");
+    GEN_CFG_NULL("Pxx_covariance_correction");
+    if (withSqrt) {
+        GEN_CFG_MTX("Sqxx_process_noise_sqrt", "Sqxx_process_noise_sqrt");
+        GEN_CFG_MTX("Sryy_out_noise_sqrt", "Sryy_out_noise_sqrt");
+        GEN_CFG_MTX("Sr_compound_workspace", "Sr_compound_workspace");
+    } else {
+        GEN_CFG_NULL("Sqxx_process_noise_sqrt");
+        GEN_CFG_NULL("Sryy_out_noise_sqrt");
+        GEN_CFG_NULL("Sr_compound_workspace");
+    }
+    GEN_CFG_NULL("F_state_transition");
+    GEN_CFG_NULL("B_input_matrix");
+#undef GEN_CFG_MTX
+#undef GEN_CFG_NULL
+    fprintf(pOut, "    .%-31s= NULL,\n", "fcnPredict");
+    fprintf(pOut, "    .%-31s= NULL,\n", "fcnObserve");
+    fprintf(pOut, "    .%-31s= &FxBatch,\n", "fcnPredictBatch");
+    fprintf(pOut, "    .%-31s= &HyBatch,\n", "fcnObserveBatch");
+    fprintf(pOut, "#if defined(UKF_SIGMA_MAJOR)\n");
+    fprintf(pOut, "    .%-31s= &FxVec,\n", "fcnPredictVec");
+    fprintf(pOut, "    .%-31s= &HyVec,\n", "fcnObserveVec");
+    fprintf(pOut, "#endif\n");
+    gen_literal(decl, pMdl->dT);
+    fprintf(pOut, "    .%-31s= %s,\n", "dT", decl);
+    fprintf(pOut, "    .%-31s= %s,\n", "filter_mode", (1u == pMdl->mode[0]) ? "UKF_MODE_SQRT" : "UKF_MODE_STANDARD");
+    fprintf(pOut, "    .%-31s= %s,\n", "update_mode", updateName[pMdl->update]);
+    fprintf(pOut, "    .%-31s= %s\n", "sigma_scheme", pMdl->simplex ? "UKF_SIGMA_SIMPLEX" : "UKF_SIGMA_SYMMETRIC");
+    fprintf(pOut, "};\n\n");
+
+    //kernels
+    gen_kernel(pOut, GEN_KER_PRED_BATCH);
+    gen_kernel(pOut, GEN_KER_OBS_BATCH);
+    fprintf(pOut, "#if defined(UKF_SIGMA_MAJOR)\n");
+    gen_kernel(pOut, GEN_KER_PRED_VEC);
+    gen_kernel(pOut, GEN_KER_OBS_VEC);
+    fprintf(pOut, "#endif\n");
+    (void)fclose(pOut);
+}
+
+/**
+ * @brief Emit <model>Test.c: the reference steps in the style of ukf_test() of main.c.
+ *
+ * @param pDir Output directory
+ * @param pSrc Model file name
+ * @param pUp Upper case model name
+ * @param pCap Capitalized model name
+ */
+static void gen_test(const char *pDir, const char *pSrc, const char *pUp, const char *pCap) {
+    static const char *const modeMacro[2] = {"UKF_MODE_STANDARD", "UKF_MODE_SQRT"};
+    static const char *const modeName[2] = {"standard", "square-root"};
+    tGenModel const *const pMdl = &GenModel;
+    char path[GEN_PATH_LEN];
+    char num[32];
+    FILE *const pOut = gen_open(pDir, "Test.c", path);
+    uint32_t rIdx, idx;
+
+    fprintf(pOut, "/**\n");
+    fprintf(pOut, " * @file %sTest.c\n", pMdl->name);
+    fprintf(pOut, " * @brief Regression test of the %s model, generated by ukfGen.c from %s, do not edit.\n", pMdl->name, pSrc);
+    fprintf(pOut, " */\n\n");
+    fprintf(pOut, "#include <math.h>\n#include <stdio.h>\n#include <stdint.h>\n\n");
+    fprintf(pOut, "#include \"%sCfg.h\"\n\n", pMdl->name);
+    gen_num(num, pMdl->eps);
+    fprintf(pOut, "#define %s_TEST_EPS (%s)\n", pUp, num);
+    fprintf(pOut, "#define %s_REF_LEN (%uu)\n\n", pUp, (unsigned)pMdl->nRef);
+
+    if (pMdl->nRef > 0u) {
+        //reference steps: measurements, inputs, expected x(k|k)
+        static const char *const partName[3] = {"y", "u", "x"};
+        const uint32_t partLen[3] = {pMdl->ny, pMdl->nu, pMdl->nx};
+        const uint32_t partOff[3] = {0, pMdl->ny, pMdl->ny + pMdl->nu};
+        static const char *const partDoc[3] = {"Measurements", "Inputs", "Expected states x(k|k)"};
+        static const char *const partDim[3] = {"LY", "LU", "LX"};
+        uint8_t pIdx;
+
+        for (pIdx = 0; pIdx < 3u; pIdx++) {
+            if (0u == partLen[pIdx]) {
+                continue;
+            }
+            fprintf(pOut, "//! %s of the reference steps\n", partDoc[pIdx]);
+            fprintf(pOut, "static const mtxScalar %sRef%c[%s_REF_LEN][%s_%s] = {\n", pCap, toupper((unsigned char)partName[pIdx][0]),
+                    pUp, pUp, partDim[pIdx]);
+            for (rIdx = 0; rIdx < pMdl->nRef; rIdx++) {
+                fprintf(pOut, "    {");
+                for (idx = 0; idx < partLen[pIdx]; idx++) {
+                    gen_num(num, GenRef[rIdx][partOff[pIdx] + idx]);
+                    fprintf(pOut, "%s%s", num, (idx + 1u < partLen[pIdx]) ? ", " : "");
+                }
+                fprintf(pOut, "}%s\n", (rIdx + 1u < pMdl->nRef) ? "," : "");
+            }
+            fprintf(pOut, "};\n\n");
+        }
+    }
+
+    fprintf(pOut, "/**\n");
+    fprintf(pOut, " * @brief Run the generated %s configuration against its reference steps in every filter mode of the model\n", pMdl->name);
+    fprintf(pOut, " */\n");
+    fprintf(pOut, "void ukf_test_%s(void) {\n", pMdl->name);
+    fprintf(pOut, "    static const uint8_t filterMode[%u] = {", (unsigned)pMdl->nMode);
+    for (idx = 0; idx < pMdl->nMode; idx++) {
+        fprintf(pOut, "%s%s", modeMacro[pMdl->mode[idx]], (idx + 1u < pMdl->nMode) ? ", " : "};\n");
+    }
+    fprintf(pOut, "    static const char *const modeName[%u] = {", (unsigned)pMdl->nMode);
+    for (idx = 0; idx < pMdl->nMode; idx++) {
+        fprintf(pOut, "\"%s\"%s", modeName[pMdl->mode[idx]], (idx + 1u < pMdl->nMode) ? ", " : "};\n");
+    }
+    fprintf(pOut, "    uint8_t mIdx;\n\n");
+    fprintf(pOut, "    for (mIdx = 0; mIdx < %uu; mIdx++) {\n", (unsigned)pMdl->nMode);
+    fprintf(pOut, "        tUKF ukfIo;\n\n");
+    fprintf(pOut, "        %sMatrixCfg.filter_mode = filterMode[mIdx];\n", pCap);
+    fprintf(pOut, "        if (0 == ukf_init(&ukfIo, &%sMatrixCfg)) {\n", pCap);
+    fprintf(pOut, "            mtxScalar absErrAccum[%s_LX] = {0};\n", pUp);
+    fprintf(pOut, "            uint32_t simLoop;\n");
+    fprintf(pOut, "            mtxDim idx;\n\n");
+    fprintf(pOut, "            for (simLoop = 0; simLoop < %s_REF_LEN; simLoop++) {\n", pUp);
+    if (pMdl->nRef > 0u) {
+        fprintf(pOut, "                for (idx = 0; idx < %s_LY; idx++) {\n", pUp);
+        fprintf(pOut, "                    ukfIo.input.y.val[idx] = %sRefY[simLoop][idx];\n", pCap);
+        fprintf(pOut, "                }\n");
+        if (pMdl->nu > 0u) {
+            fprintf(pOut, "                for (idx = 0; idx < %s_LU; idx++) {\n", pUp);
+            fprintf(pOut, "                    ukfIo.input.u.val[idx] = %sRefU[simLoop][idx];\n", pCap);
+            fprintf(pOut, "                }\n");
+        }
+        fprintf(pOut, "\n                (void) ukf_step(&ukfIo);\n\n");
+        fprintf(pOut, "                //accumulate the difference between the reference and the generated configuration\n");
+        fprintf(pOut, "                for (idx = 0; idx < %s_LX; idx++) {\n", pUp);
+        fprintf(pOut, "                    absErrAccum[idx] += MTX_FABS(ukfIo.update.x.val[idx] - %sRefX[simLoop][idx]);\n", pCap);
+        fprintf(pOut, "                }\n");
+    }
+    fprintf(pOut, "            }\n\n");
+    fprintf(pOut, "            printf(\"Accumulated error between reference and %sCfg.c (%%s)\\n\", modeName[mIdx]);\n", pMdl->name);
+    fprintf(pOut, "            for (idx = 0; idx < %s_LX; idx++) {\n", pUp);
+    fprintf(pOut, "                if (!(fabs(absErrAccum[idx]) <= %s_TEST_EPS)) {\n", pUp);
+    fprintf(pOut, "                    printf(\"ERROR: Accumulated error absErrAccum[%%u] is too big: %%.6e > %%.6e\\n\", (unsigned)idx, absErrAccum[idx], %s_TEST_EPS);\n", pUp);
+    fprintf(pOut, "                } else {\n");
+    fprintf(pOut, "                    printf(\"%%u. SUCCESS! %%.6e < %%.6e\\n\", (unsigned)idx + 1u, absErrAccum[idx], %s_TEST_EPS);\n", pUp);
+    fprintf(pOut, "                }\n");
+    fprintf(pOut, "            }\n");
+    fprintf(pOut, "        } else {\n");
+    fprintf(pOut, "            printf(\"ERROR: initialization of %sCfg.c fails (%%s)\\n\", modeName[mIdx]);\n", pMdl->name);
+    fprintf(pOut, "        }\n");
+    fprintf(pOut, "    }\n");
+    fprintf(pOut, "    %sMatrixCfg.filter_mode = filterMode[0];\n", pCap);
+    fprintf(pOut, "}\n");
+    (void)fclose(pOut);
+}
+
+int main(int argc, char *argv[]) {
+    char up[GEN_NAME_LEN];
+    char cap[GEN_NAME_LEN];
+    const char *pSrc;
+    uint32_t idx;
+
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s model.ukf outDir\n", argv[0]);
+        return 1;
+    }
+    gen_read(argv[1]);
+
+    //file name of the model without directory for the generated comments
+    pSrc = strrchr(argv[1], '/');
+    pSrc = (NULL != pSrc) ? (pSrc + 1) : argv[1];
+    for (idx = 0; '\0' != GenModel.name[idx]; idx++) {
+        up[idx] = (char)toupper((unsigned char)GenModel.name[idx]);
+        cap[idx] = (0 == idx) ? up[idx] : GenModel.name[idx];
+    }
+    up[idx] = '\0';
+    cap[idx] = '\0';
+
+    gen_header(argv[2], pSrc, up, cap);
+    gen_config(argv[2], pSrc, up, cap);
+    gen_test(argv[2], pSrc, up, cap);
+    printf("%s: %u states, %u measurements, %u expression nodes -> %s/%sCfg.h, %sCfg.c, %sTest.c\n", pSrc,
+           (unsigned)GenModel.nx, (unsigned)GenModel.ny, (unsigned)GenNodeNum, argv[2], GenModel.name, GenModel.name,
+           GenModel.name);
+
+    return 0;
+}
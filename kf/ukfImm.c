@@ -0,0 +1,551 @@
+/**
+ * @file ukfImm.c
+ * @brief Interacting multiple model (IMM) bank of filters with a common state space.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "ukfImm.h"
+
+static uint8_t ukf_imm_coincide   (const tUkfImm *pImm, uint8_t lead, uint8_t model);
+static uint8_t ukf_imm_same_input (const tMatrix *pA, const tMatrix *pB);
+static uint8_t ukf_imm_same_lim   (const tUKFpar *pA, const tUKFpar *pB);
+static uint8_t ukf_imm_same_prop  (const tUKF *pLead, const tUKF *pUkf);
+static uint8_t ukf_imm_same_obs   (const tUKF *pLead, const tUKF *pUkf);
+static void    ukf_imm_mirror     (mtxScalar *pP, mtxDim n);
+static void    ukf_imm_diag_factor (mtxScalar *pP, mtxDim n);
+static void    ukf_imm_mix_elem   (tUkfImm *pImm, mtxScalar *pV, uint8_t isCov, mtxIdx idx);
+static void    ukf_imm_mix        (tUkfImm *pImm);
+static void    ukf_imm_link       (tUkfImm *pImm);
+static void    ukf_imm_combine    (tUkfImm *pImm);
+
+/**
+ * @brief Number of bytes required by ukf_imm_init()
+ *
+ * @param nModel Number of models
+ * @param xLen Number of states
+ * @param yLen Number of measurements
+ * @param sLen Largest number of sigma points of the models
+ * @return uint32_t Block size in bytes
+ */
+uint32_t ukf_imm_mem_size(uint8_t nModel, mtxDim xLen, mtxDim yLen, mtxDim sLen) {
+    const uint32_t perModel = ((uint32_t)xLen + yLen) * sLen + (uint32_t)yLen * yLen + yLen;
+
+    return ((uint32_t)nModel * perModel + (uint32_t)xLen * xLen + xLen) * (uint32_t)sizeof(mtxScalar);
+}
+
+/**
+ * @brief Attach initialized filters (ukf_init() or ukf_restore()) to a bank, the combined
+ * estimate is evaluated immediately. The filters must not be re-initialized while they
+ * belong to the bank, ukf_init() and ukf_restore() detach them.
+ *
+ * @param pImm Bank to initialize
+ * @param pMem Memory block aligned for mtxScalar
+ * @param memSize Size of memory block, at least ukf_imm_mem_size()
+ * @param pModel nModel filters with equal xLen and yLen
+ * @param nModel Number of models, 1 .. UKF_IMM_MODELS_MAX
+ * @param pTrans (nModel x nModel) Markov transition probabilities p(i,j), row i sums up to 1
+ * @param pMu0 Initial mode probabilities, NOT MANDATORY assign NULL if not required (uniform)
+ * @return uint8_t
+ * 0 := OK
+ * 1 := NOK (invalid model count or dimensions, memory block too small or misaligned)
+ */
+uint8_t ukf_imm_init(tUkfImm *pImm, void *pMem, uint32_t memSize, tUKF *pModel, uint8_t nModel, mtxScalar const *pTrans,
+                     mtxScalar const *pMu0) {
+    mtxScalar *pBase = (mtxScalar *)pMem;
+    mtxDim sLen = 0;
+    uint8_t Result = 0;
+    uint8_t j;
+
+    if (NULL == pBase || 0 != ((uintptr_t)pBase & (sizeof(mtxScalar) - 1u)) || NULL == pModel || NULL == pTrans || 0 == nModel ||
+        nModel > UKF_IMM_MODELS_MAX) {
+        Result = 1;
+    }
+
+    for (j = 0; j < nModel && 0 == Result; j++) {
+        if (pModel[j].par.xLen != pModel[0].par.xLen || pModel[j].par.yLen != pModel[0].par.yLen) {
+            Result = 1;
+        }
+        sLen = (pModel[j].par.sLen > sLen) ? pModel[j].par.sLen : sLen;
+    }
+
+    if (0 == Result && memSize < ukf_imm_mem_size(nModel, pModel[0].par.xLen, pModel[0].par.yLen, sLen)) {
+        Result = 1;
+    }
+
+    if (0 == Result) {
+        const mtxDim xLen = pModel[0].par.xLen;
+        const mtxDim yLen = pModel[0].par.yLen;
+
+        pImm->pModel = pModel;
+        pImm->nModel = nModel;
+        pImm->xLen = xLen;
+        pImm->yLen = yLen;
+        pImm->share = 1;
+        pImm->mixTol = 0;
+        pImm->pTrans = pTrans;
+        pImm->px = pBase;
+        pBase += xLen;
+        pImm->pP = pBase;
+        pBase += (uint32_t)xLen * xLen;
+
+        for (j = 0; j < nModel; j++) {
+            tUkfImmPort *const pPort = &pImm->port[j];
+
+            pPort->share = (tUkfShare){0};
+            pPort->share.pXput = pBase;
+            pBase += (uint32_t)xLen * pModel[j].par.sLen;
+            pPort->share.pYput = pBase;
+            pBase += (uint32_t)yLen * pModel[j].par.sLen;
+            pPort->share.pZ = pBase;
+            pBase += yLen;
+            pPort->share.pW = pBase;
+            pBase += (uint32_t)yLen * yLen;
+            pPort->status = 0;
+
+            pImm->mu[j] = (NULL != pMu0) ? pMu0[j] : MTX_C(1.0) / nModel;
+            pImm->lead[j] = j;
+            pImm->used[j] = 0;
+            pModel[j].pShare = &pPort->share;
+        }
+
+        ukf_imm_combine(pImm);
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Mixed estimates of two models coincide: equal filter formulation and mixing weights
+ * within mixTol
+ *
+ * @param pImm Bank
+ * @param lead Leading model
+ * @param model Model
+ * @return uint8_t 1 := model can start from the mixed estimate of lead
+ */
+static uint8_t ukf_imm_coincide(const tUkfImm *pImm, uint8_t lead, uint8_t model) {
+    tUKF const *const pLead = &pImm->pModel[lead];
+    tUKF const *const pUkf = &pImm->pModel[model];
+    const uint8_t nModel = pImm->nModel;
+    uint8_t Result = (pLead->par.mode == pUkf->par.mode && (NULL == pLead->par.Fxx.val) == (NULL == pUkf->par.Fxx.val)) ? 1 : 0;
+    uint8_t i;
+
+    for (i = 0; i < nModel && 0 != Result; i++) {
+        if (MTX_FABS(pImm->mix[nModel * i + lead] - pImm->mix[nModel * i + model]) > pImm->mixTol) {
+            Result = 0;
+        }
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Optional input vectors are both missing or equal
+ *
+ * @param pA Input
+ * @param pB Input
+ * @return uint8_t 1 := equal
+ */
+static uint8_t ukf_imm_same_input(const tMatrix *pA, const tMatrix *pB) {
+    uint8_t Result = (NULL == pA->val && NULL == pB->val) ? 1 : 0;
+
+    if (NULL != pA->val && NULL != pB->val && pA->nrow == pB->nrow &&
+        0 == memcmp(pA->val, pB->val, (size_t)pA->nrow * sizeof(mtxScalar))) {
+        Result = 1;
+    }
+
+    return Result;
+}
+
+/**
+ * @brief State limiters of the sigma points are both disabled or equal
+ *
+ * @param pA Parameters
+ * @param pB Parameters
+ * @return uint8_t 1 := equal
+ */
+static uint8_t ukf_imm_same_lim(const tUKFpar *pA, const tUKFpar *pB) {
+    const mtxDim xLen = pA->xLen;
+    uint8_t Result = 1;
+    mtxDim xIdx;
+
+    for (xIdx = 0; xIdx < xLen; xIdx++) {
+        const uint8_t a = (NULL != pA->xLim.val && NULL != pA->xLimEnbl.val) ? pA->xLimEnbl.val[xIdx] : 0u;
+        const uint8_t b = (NULL != pB->xLim.val && NULL != pB->xLimEnbl.val) ? pB->xLimEnbl.val[xIdx] : 0u;
+
+        if (a != b || (0 != a && (pA->xLim.val[pA->xLim.ncol * xIdx + xMinIdx] != pB->xLim.val[pB->xLim.ncol * xIdx + xMinIdx] ||
+                                  pA->xLim.val[pA->xLim.ncol * xIdx + xMaxIdx] != pB->xLim.val[pB->xLim.ncol * xIdx + xMaxIdx]))) {
+            Result = 0;
+        }
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Both filters draw the same sigma points from the same mixed estimate and
+ * propagate them through the same prediction model and inputs
+ *
+ * @param pLead UKF - Leading model
+ * @param pUkf UKF - Model
+ * @return uint8_t 1 := propagated sigma points of pLead can be reused
+ */
+static uint8_t ukf_imm_same_prop(const tUKF *pLead, const tUKF *pUkf) {
+    tUKFpar const *const pA = &pLead->par;
+    tUKFpar const *const pB = &pUkf->par;
+
+    //a prediction hook of pUkf (e.g. the smoother) observes the propagation, it is not skipped then
+    return (NULL == pA->Fxx.val && NULL == pB->Fxx.val && NULL == pUkf->pHook && pA->sLen == pB->sLen && pA->scheme == pB->scheme &&
+            pA->alpha == pB->alpha && pA->betha == pB->betha && pA->kappa == pB->kappa && pA->dT == pB->dT &&
+            0 != ukf_imm_same_lim(pA, pB) &&
+            pLead->predict.pFcnPredict == pUkf->predict.pFcnPredict && pLead->predict.pFcnPredictBatch == pUkf->predict.pFcnPredictBatch &&
+            pLead->predict.pFcnPredictVec == pUkf->predict.pFcnPredictVec && 0 != ukf_imm_same_input(&pLead->prev.u_p, &pUkf->prev.u_p))
+               ? 1
+               : 0;
+}
+
+/**
+ * @brief Both filters observe the same propagated sigma points through the same observation model
+ *
+ * @param pLead UKF - Leading model
+ * @param pUkf UKF - Model
+ * @return uint8_t 1 := observed sigma points of pLead can be reused
+ */
+static uint8_t ukf_imm_same_obs(const tUKF *pLead, const tUKF *pUkf) {
+    return (0 != ukf_imm_same_prop(pLead, pUkf) && pLead->predict.pFcnObserv == pUkf->predict.pFcnObserv &&
+            pLead->predict.pFcnObservBatch == pUkf->predict.pFcnObservBatch && pLead->predict.pFcnObservVec == pUkf->predict.pFcnObservVec &&
+            (NULL == pLead->input.yValid.val) == (NULL == pUkf->input.yValid.val) && 0 != ukf_imm_same_input(&pLead->input.u, &pUkf->input.u))
+               ? 1
+               : 0;
+}
+
+/**
+ * @brief Copy lower triangle of P(n x n) to the upper one
+ *
+ * @param pP Matrix
+ * @param n Dimension
+ */
+static void ukf_imm_mirror(mtxScalar *pP, mtxDim n) {
+    mtxDim row, col;
+
+    for (row = 0; row < n; row++) {
+        for (col = 0; col < row; col++) {
+            pP[n * col + row] = pP[n * row + col];
+        }
+    }
+}
+
+/**
+ * @brief Replace covariance P(n x n) by the factor of its diagonal, lower Cholesky
+ * factor of a mixed covariance that could not be factorized (correlations dropped)
+ *
+ * @param pP Covariance, diagonal factor on return
+ * @param n Dimension
+ */
+static void ukf_imm_diag_factor(mtxScalar *pP, mtxDim n) {
+    mtxDim row, col;
+
+    for (row = 0; row < n; row++) {
+        for (col = 0; col < n; col++) {
+            pP[n * row + col] = (row == col) ? MTX_SQRT(MTX_FABS(pP[n * row + col])) : MTX_C(0.0);
+        }
+    }
+}
+
+/**
+ * @brief Mix element idx of the state (isCov = 0) or the covariance buffer of all models
+ * into the leading models: the element of every model is gathered before one is overwritten
+ *
+ * @param pImm Bank
+ * @param pV Gather buffer (nModel)
+ * @param isCov Element of update.Pxx instead of update.x
+ * @param idx Element index
+ */
+static void ukf_imm_mix_elem(tUkfImm *pImm, mtxScalar *pV, uint8_t isCov, mtxIdx idx) {
+    const uint8_t nModel = pImm->nModel;
+    uint8_t i, j;
+
+    for (i = 0; i < nModel; i++) {
+        pV[i] = (0 != isCov) ? pImm->pModel[i].update.Pxx.val[idx] : pImm->pModel[i].update.x.val[idx];
+    }
+
+    for (j = 0; j < nModel; j++) {
+        if (j == pImm->lead[j]) {
+            mtxScalar sum = 0;
+
+            for (i = 0; i < nModel; i++) {
+                sum += pImm->mix[nModel * i + j] * pV[i];
+            }
+
+            if (0 != isCov) {
+                pImm->pModel[j].update.Pxx.val[idx] = sum;
+            } else {
+                pImm->pModel[j].update.x.val[idx] = sum;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Mixing in place: second moments S(i) = P(i) + (x(i)-r)*(x(i)-r)' about the
+ * combined state r are mixed element by element, P0(j) = S0(j) - (x0(j)-r)*(x0(j)-r)'.
+ * Leading models are factorized once (Sqxx layout in UKF_MODE_SQRT, UKF_SHARE_CHOL for
+ * unscented prediction in UKF_MODE_STANDARD), following models copy the result.
+ * A failed factorization in UKF_MODE_SQRT is counted and repaired with the health
+ * settings of the model (ukf_health_chol()), unrepaired it leaves the factor of the
+ * diagonal and UKF_FAULT_SIGMAPOINT in tUkfImmPort.status. In UKF_MODE_STANDARD the
+ * covariance is restored and factorized by the sigma point step, which reports it.
+ *
+ * @param pImm Bank
+ */
+static void ukf_imm_mix(tUkfImm *pImm) {
+    const uint8_t nModel = pImm->nModel;
+    const mtxDim xLen = pImm->xLen;
+    mtxScalar const *const pr = pImm->px;
+    mtxScalar v[UKF_IMM_MODELS_MAX];
+    mtxDim xIdx, xTrIdx;
+    uint8_t i, j;
+
+    for (i = 0; i < nModel; i++) {
+        mtxScalar *const pP = pImm->pModel[i].update.Pxx.val;
+        mtxScalar const *const px = pImm->pModel[i].update.x.val;
+
+        if (UKF_MODE_SQRT == pImm->pModel[i].par.mode) {
+            //P = S*S'
+            mtx_kernel_chol_product(pP, xLen);
+        }
+
+        for (xIdx = 0; xIdx < xLen; xIdx++) {
+            for (xTrIdx = 0; xTrIdx <= xIdx; xTrIdx++) {
+                pP[xLen * xIdx + xTrIdx] += (px[xIdx] - pr[xIdx]) * (px[xTrIdx] - pr[xTrIdx]);
+            }
+        }
+    }
+
+    for (xIdx = 0; xIdx < xLen; xIdx++) {
+        ukf_imm_mix_elem(pImm, v, 0, xIdx);
+
+        for (xTrIdx = 0; xTrIdx <= xIdx; xTrIdx++) {
+            ukf_imm_mix_elem(pImm, v, 1, (mtxIdx)xLen * xIdx + xTrIdx);
+        }
+    }
+
+    for (j = 0; j < nModel; j++) {
+        tUKF *const pUkf = &pImm->pModel[j];
+        mtxScalar *const pP = pUkf->update.Pxx.val;
+        mtxScalar const *const px = pUkf->update.x.val;
+
+        if (j == pImm->lead[j]) {
+            for (xIdx = 0; xIdx < xLen; xIdx++) {
+                for (xTrIdx = 0; xTrIdx <= xIdx; xTrIdx++) {
+                    pP[xLen * xIdx + xTrIdx] -= (px[xIdx] - pr[xIdx]) * (px[xTrIdx] - pr[xTrIdx]);
+                }
+            }
+            ukf_imm_mirror(pP, xLen);
+
+            if (UKF_MODE_SQRT == pUkf->par.mode) {
+                //counted and repaired like the sigma point factor of the step, pP is the workspace
+                if (MTX_OPERATION_OK != ukf_health_chol(pUkf, pP, pImm->pP, xLen, UKF_FAULT_SIGMAPOINT)) {
+                    ukf_imm_diag_factor(pP, xLen);
+                    pImm->port[j].status |= UKF_FAULT_SIGMAPOINT;
+                }
+            } else if (NULL == pUkf->par.Fxx.val) {
+                mtx_kernel_cpy(pImm->pP, pP, (mtxIdx)xLen * xLen);
+
+                if (MTX_OPERATION_OK == mtx_kernel_chol_lower(pP, xLen)) {
+                    //the sigma point step takes the factor as it is
+                    pImm->port[j].share.get |= UKF_SHARE_CHOL;
+                } else {
+                    //the step factorizes the covariance itself and reports or repairs the fault
+                    mtx_kernel_cpy(pP, pImm->pP, (mtxIdx)xLen * xLen);
+                }
+            } else {
+            }
+        } else {
+            tUKF const *const pLead = &pImm->pModel[pImm->lead[j]];
+
+            mtx_kernel_cpy(pUkf->update.x.val, pLead->update.x.val, xLen);
+            mtx_kernel_cpy(pP, pLead->update.Pxx.val, (mtxIdx)xLen * xLen);
+            pImm->port[j].share.get |= pImm->port[pImm->lead[j]].share.get & UKF_SHARE_CHOL;
+            pImm->port[j].status |= pImm->port[pImm->lead[j]].status;
+        }
+    }
+}
+
+/**
+ * @brief Publish the propagated and observed sigma points of leading models to the
+ * following models with equal sigma points, models and inputs
+ *
+ * @param pImm Bank
+ */
+static void ukf_imm_link(tUkfImm *pImm) {
+    uint8_t j;
+
+    for (j = 0; j < pImm->nModel; j++) {
+        const uint8_t lead = pImm->lead[j];
+
+        if (j != lead && 0 != ukf_imm_same_prop(&pImm->pModel[lead], &pImm->pModel[j])) {
+            pImm->port[lead].share.put |= UKF_SHARE_PROP;
+            pImm->port[j].share.get |= UKF_SHARE_PROP;
+            pImm->port[j].share.pXget = pImm->port[lead].share.pXput;
+
+            if (0 != ukf_imm_same_obs(&pImm->pModel[lead], &pImm->pModel[j])) {
+                pImm->port[lead].share.put |= UKF_SHARE_OBS;
+                pImm->port[j].share.get |= UKF_SHARE_OBS;
+                pImm->port[j].share.pYget = pImm->port[lead].share.pYput;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Combined estimate x = sum(mu(j)*x(j)), P = sum(mu(j)*(P(j) + (x(j)-x)*(x(j)-x)'))
+ *
+ * @param pImm Bank
+ */
+static void ukf_imm_combine(tUkfImm *pImm) {
+    const mtxDim xLen = pImm->xLen;
+    mtxScalar *const px = pImm->px;
+    mtxScalar *const pP = pImm->pP;
+    mtxDim xIdx, xTrIdx, k;
+    uint8_t j;
+
+    for (xIdx = 0; xIdx < xLen; xIdx++) {
+        px[xIdx] = 0;
+        for (j = 0; j < pImm->nModel; j++) {
+            px[xIdx] += pImm->mu[j] * pImm->pModel[j].update.x.val[xIdx];
+        }
+    }
+
+    for (xIdx = 0; xIdx < xLen; xIdx++) {
+        for (xTrIdx = 0; xTrIdx <= xIdx; xTrIdx++) {
+            mtxScalar sum = 0;
+
+            for (j = 0; j < pImm->nModel; j++) {
+                tUKF const *const pUkf = &pImm->pModel[j];
+                mtxScalar const *const pPj = pUkf->update.Pxx.val;
+                mtxScalar const *const pxj = pUkf->update.x.val;
+                mtxScalar p = pPj[xLen * xIdx + xTrIdx];
+
+                if (UKF_MODE_SQRT == pUkf->par.mode) {
+                    //P(j) = S*S'
+                    p = 0;
+                    for (k = 0; k <= xTrIdx; k++) {
+                        p += pPj[xLen * xIdx + k] * pPj[xLen * xTrIdx + k];
+                    }
+                }
+                sum += pImm->mu[j] * (p + (pxj[xIdx] - px[xIdx]) * (pxj[xTrIdx] - px[xTrIdx]));
+            }
+            pP[xLen * xIdx + xTrIdx] = sum;
+        }
+    }
+    ukf_imm_mirror(pP, xLen);
+}
+
+/**
+ * @brief IMM cycle: mixing, ukf_step() of every model with the same measurement, mode
+ * probabilities and combination (px, pP). Inputs u of the models are assigned by the
+ * caller as for ukf_step().
+ *
+ * @param pImm Bank
+ * @param py Measurement (yLen)
+ * @param pValid Measurement present flags (yLen), NOT MANDATORY assign NULL if all are present.
+ * Copied to models with y_meas_valid, assign it to every model to use partial measurements.
+ * @return uint8_t 0 := OK, UKF_FAULT_* of any model otherwise (tUkfImmPort.status of every model)
+ */
+uint8_t ukf_imm_step(tUkfImm *pImm, mtxScalar const *py, uint8_t const *pValid) {
+    const uint8_t nModel = pImm->nModel;
+    mtxScalar const *const pTrans = pImm->pTrans;
+    mtxScalar lMax, sum;
+    uint8_t status = 0;
+    uint8_t nLik;
+    mtxDim yIdx;
+    uint8_t i, j;
+
+    //#1 predicted mode probabilities c(j) and mixing weights mu(i|j)
+    for (j = 0; j < nModel; j++) {
+        mtxScalar c = 0;
+
+        for (i = 0; i < nModel; i++) {
+            c += pTrans[nModel * i + j] * pImm->mu[i];
+        }
+        pImm->c[j] = c;
+
+        for (i = 0; i < nModel; i++) {
+            pImm->mix[nModel * i + j] = (c > 0) ? (pTrans[nModel * i + j] * pImm->mu[i] / c) : ((i == j) ? MTX_C(1.0) : MTX_C(0.0));
+        }
+
+        pImm->lead[j] = j;
+        for (i = 0; i < j && 0 != pImm->share && j == pImm->lead[j]; i++) {
+            if (i == pImm->lead[i] && 0 != ukf_imm_coincide(pImm, i, j)) {
+                uint8_t k;
+
+                //model j starts from the mixed estimate of model i
+                pImm->lead[j] = i;
+                for (k = 0; k < nModel; k++) {
+                    pImm->mix[nModel * k + j] = pImm->mix[nModel * k + i];
+                }
+            }
+        }
+
+        pImm->port[j].share.put = 0;
+        pImm->port[j].share.get = 0;
+        pImm->port[j].share.logLik = 0;
+        pImm->port[j].share.lik = 0;
+        pImm->port[j].status = 0;
+    }
+
+    //#2 mixed initial conditions
+    ukf_imm_mix(pImm);
+    ukf_imm_link(pImm);
+
+    //#3 model steps, leading models run first
+    for (j = 0; j < nModel; j++) {
+        tUKF *const pUkf = &pImm->pModel[j];
+
+        if (0 != (pImm->port[j].share.get & UKF_SHARE_PROP) && 0 != (pImm->port[pImm->lead[j]].status & UKF_FAULT_SIGMAPOINT)) {
+            //the leading model may have skipped its step without sigma points, nothing is published
+            pImm->port[j].share.get &= (uint8_t)~(UKF_SHARE_PROP | UKF_SHARE_OBS);
+        }
+
+        for (yIdx = 0; yIdx < pImm->yLen; yIdx++) {
+            pUkf->input.y.val[yIdx] = py[yIdx];
+            if (NULL != pUkf->input.yValid.val) {
+                pUkf->input.yValid.val[yIdx] = (NULL != pValid) ? pValid[yIdx] : 1u;
+            }
+        }
+        pImm->port[j].status |= ukf_step(pUkf);
+        status |= pImm->port[j].status;
+    }
+
+    //#4 mode probabilities mu(j) = c(j)*L(j)/sum(c*L), scaled by the largest likelihood against underflow
+    lMax = 0;
+    nLik = 0;
+    for (j = 0; j < nModel; j++) {
+        if (0 != pImm->port[j].share.lik) {
+            lMax = (0 == nLik || pImm->port[j].share.logLik > lMax) ? pImm->port[j].share.logLik : lMax;
+            nLik++;
+        }
+    }
+
+    sum = 0;
+    for (j = 0; j < nModel; j++) {
+        //a model without likelihood gets none of the mode probability while others have one
+        pImm->mu[j] = (0 != pImm->port[j].share.lik) ? (pImm->c[j] * MTX_EXP(pImm->port[j].share.logLik - lMax)) : MTX_C(0.0);
+        sum += pImm->mu[j];
+    }
+
+    for (j = 0; j < nModel; j++) {
+        pImm->mu[j] = (sum > 0) ? (pImm->mu[j] / sum) : pImm->c[j];
+        pImm->used[j] = pImm->port[j].share.get;
+        pImm->port[j].share.put = 0;
+        pImm->port[j].share.get = 0;
+    }
+
+    //#5 combined estimate
+    ukf_imm_combine(pImm);
+
+    return status;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file ukfImm.h
+ * @brief Interacting multiple model (IMM) bank of filters with a common state space.
+ * Every ukf_imm_step() mixes the model estimates with the Markov transition
+ * probabilities p(i,j), steps every model with ukf_step(), updates the mode
+ * probabilities from the measurement likelihoods and combines the estimates:
+ * c(j)    = sum(p(i,j)*mu(i)),  mu(i|j) = p(i,j)*mu(i)/c(j)
+ * x0(j)   = sum(mu(i|j)*x(i)),  P0(j) = sum(mu(i|j)*(P(i) + (x(i)-x0(j))*(x(i)-x0(j))'))
+ * mu(j)   = c(j)*N(y; y(j|k-1), Pyy(j)) / sum(..), N := 0 for a model without likelihood
+ *           (update failed), mu(j) = c(j) if no model has one (e.g. no measurement present)
+ * x       = sum(mu(j)*x(j)),    P = sum(mu(j)*(P(j) + (x(j)-x)*(x(j)-x)'))
+ * Mixing runs in place in the state and covariance buffers of the models. Models
+ * with coincident mixing weights get the same x0, P0: the Cholesky factor is computed
+ * once for them, and models with equal sigma point settings, prediction model and
+ * inputs take the propagated (and with equal observation model the observed) sigma
+ * points of the leading model instead of evaluating their callbacks again, e.g. models
+ * which only differ in Qxx or Ryy0.
+ */
+
+#ifndef UKFIMM_H
+#define UKFIMM_H
+
+#include <stdint.h>
+#include "ukfLib.h"
+
+//! Maximum number of models of one bank
+#ifndef UKF_IMM_MODELS_MAX
+#define UKF_IMM_MODELS_MAX (8u)
+#endif
+
+//! Link of one model to the bank, share is assigned to tUKF.pShare by ukf_imm_init(). Following
+//! models take UKF_SHARE_CHOL from the mixing and UKF_SHARE_PROP/OBS from the share of the leading model.
+typedef struct ukfImmPort {
+    tUkfShare share;                //work and likelihood exchanged with ukf_step() of this model
+    uint8_t status;                 //UKF_FAULT_* of the mixing and of ukf_step() of this model in the last step
+} tUkfImmPort;
+
+typedef struct ukfImm {
+    tUKF *pModel;                   //nModel initialized filters with equal xLen and yLen
+    uint8_t nModel;
+    mtxDim xLen;
+    mtxDim yLen;
+    uint8_t share;                  //1 := share the work of models with coincident mixing weights (default), 0 := off
+    mtxScalar mixTol;               //mixing weights differing at most by mixTol coincide, 0 := only equal ones (default)
+    mtxScalar const *pTrans;        //(nModel x nModel) p(i,j) = P(model j at k | model i at k-1), rows sum up to 1
+    mtxScalar mu[UKF_IMM_MODELS_MAX];   //mode probabilities
+    mtxScalar c[UKF_IMM_MODELS_MAX];    //predicted mode probabilities of the current step
+    mtxScalar mix[UKF_IMM_MODELS_MAX * UKF_IMM_MODELS_MAX];  //mu(i|j) at [nModel * i + j]
+    uint8_t lead[UKF_IMM_MODELS_MAX];   //model the mixed estimate of model j is taken from
+    uint8_t used[UKF_IMM_MODELS_MAX];   //UKF_SHARE_* work model j did not evaluate itself in the last step
+    tUkfImmPort port[UKF_IMM_MODELS_MAX];
+    mtxScalar *px;                  //(xLen) combined state, also the reference point of the mixing
+    mtxScalar *pP;                  //(xLen x xLen) combined covariance, workspace of the mixing during ukf_imm_step()
+} tUkfImm;
+
+uint32_t ukf_imm_mem_size (uint8_t nModel, mtxDim xLen, mtxDim yLen, mtxDim sLen);
+uint8_t  ukf_imm_init     (tUkfImm *pImm, void *pMem, uint32_t memSize, tUKF *pModel, uint8_t nModel, mtxScalar const *pTrans,
+                           mtxScalar const *pMu0);
+uint8_t  ukf_imm_step     (tUkfImm *pImm, mtxScalar const *py, uint8_t const *pValid);
+
+#endif /* UKFIMM_H */
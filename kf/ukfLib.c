@@ -8,13 +8,74 @@
 #include "ukfLib.h"
 #include <stdint.h>
 
+#if defined(UKF_SPEC_HEADER)
+#include UKF_SPEC_HEADER
+#endif
+
+//! Step phases get the dimensions as arguments and are forced inline into ukf_step_core(),
+//! so every UKF_SPEC(nx, ny) entry produces a copy with constant loop bounds.
+#if defined(__GNUC__)
+#define UKF_INLINE static inline __attribute__((always_inline))
+#else
+#define UKF_INLINE static inline
+#endif
+
+#if defined(MTX_USE_CMSIS_DSP)
+#define UKF_MUL(pA, pB, pC, nrow, ninner, ncol)     (void)mtx_mul((pA), (pB), (pC))
+#define UKF_MUL_SRC2TR(pA, pB, pC, nrow1, nrow2, ncol) (void)mtx_mul_src2tr((pA), (pB), (pC))
+#define UKF_ADD(pA, pB, nelem)                      (void)mtx_add((pA), (pB))
+#define UKF_SUB(pA, pB, nelem)                      (void)mtx_sub((pA), (pB))
+#else
+#define UKF_MUL(pA, pB, pC, nrow, ninner, ncol)     mtx_kernel_mul((pA)->val, (pB)->val, (pC)->val, (nrow), (ninner), (ncol))
+#define UKF_MUL_SRC2TR(pA, pB, pC, nrow1, nrow2, ncol) mtx_kernel_mul_src2tr((pA)->val, (pB)->val, (pC)->val, (nrow1), (nrow2), (ncol))
+#define UKF_ADD(pA, pB, nelem)                      mtx_kernel_add((pA)->val, (pB)->val, (nelem))
+#define UKF_SUB(pA, pB, nelem)                      mtx_kernel_sub((pA)->val, (pB)->val, (nelem))
+#endif
+
+//! Stages of one filter cycle executed by ukf_run()
+#define UKF_STAGE_PREDICT (1u)
+#define UKF_STAGE_UPDATE  (2u)
+
+//! Work of the current step is taken from or written to tUKF.pShare
+#define UKF_SHARE_GET(pUkf, work) (NULL != (pUkf)->pShare && 0 != ((pUkf)->pShare->get & (work)))
+#define UKF_SHARE_PUT(pUkf, work) (NULL != (pUkf)->pShare && 0 != ((pUkf)->pShare->put & (work)))
+#define UKF_LOG_2PI (MTX_C(1.8378770664093453))
+
+//! Call hook fcn of the prediction observer if one is attached
+#define UKF_HOOK(pUkf, fcn) do { \
+        if (NULL != (pUkf)->pHook && NULL != (pUkf)->pHook->fcn) { \
+            (pUkf)->pHook->fcn((pUkf)->pHook->pCtx, (pUkf)); \
+        } \
+    } while (0)
+
+//! Measurement yIdx is present in this step, NULL mask means all measurements are present
+#define UKF_Y_VALID(pValid, yIdx) (NULL == (pValid) || 0 != (pValid)[(yIdx)])
+
 static uint8_t  ukf_dimension_check (tUKF *pUkf);
-static void     ukf_meas_update     (tUKF *pUkf);
-static void     ukf_sigmapoint      (tUKF *pUkf);
-static void     ukf_mean_pred_state     (tUKF *pUkf);
-static void     ukf_mean_pred_output    (tUKF *pUkf);
-static void     ukf_calc_covariances    (tUKF *pUkf);
-static float    ukf_state_limiter(float state, float min, float max, uint8_t enbl);
+static void     ukf_bind            (tUKF *pUkf, tUkfMatrix *pUkfMatrix);
+static uint32_t ukf_ckpt_crc        (uint8_t const *pData, uint32_t len);
+static void     ukf_ckpt_header     (const tUKF *pUkf, tUkfCkptHeader *pHdr);
+static uint8_t  ukf_run             (tUKF *pUkf, const uint8_t stages);
+UKF_INLINE void ukf_step_core       (tUKF *pUkf, const mtxDim xLen, const mtxDim yLen, const mtxDim sLen, const uint8_t stages);
+UKF_INLINE void ukf_meas_update     (tUKF *pUkf, const mtxDim xLen, const mtxDim yLen);
+UKF_INLINE void ukf_meas_update_seq (tUKF *pUkf, const mtxDim xLen, const mtxDim yLen);
+UKF_INLINE mtxResultInfo ukf_sigmapoint (tUKF *pUkf, const mtxDim xLen, const mtxDim sLen, const uint8_t keep);
+UKF_INLINE void ukf_mean_pred_state     (tUKF *pUkf, const mtxDim xLen, const mtxDim sigmaLen);
+UKF_INLINE void ukf_cov_pred_state      (tUKF *pUkf, const mtxDim xLen, const mtxDim sigmaLen);
+UKF_INLINE void ukf_linear_pred_state   (tUKF *pUkf, const mtxDim xLen);
+UKF_INLINE void ukf_mean_pred_output    (tUKF *pUkf, const mtxDim yLen, const mtxDim sigmaLen);
+UKF_INLINE void ukf_calc_covariances    (tUKF *pUkf, const mtxDim xLen, const mtxDim yLen, const mtxDim sigmaLen, const uint8_t withPxx);
+UKF_INLINE void ukf_sym_mirror      (mtxScalar *pP, const mtxDim n);
+UKF_INLINE void ukf_innov_lik       (tUKF *pUkf, mtxScalar const *pL, const mtxDim yLen);
+UKF_INLINE void ukf_sigma_mean      (mtxScalar const *pZ, mtxScalar const *pW, mtxScalar *pz, const mtxDim nElem, const mtxDim sigmaLen, uint8_t const *pValid);
+UKF_INLINE void ukf_sigma_center    (mtxScalar *pZ, mtxScalar const *pz, const mtxDim nElem, const mtxDim sigmaLen, uint8_t const *pValid);
+static void         ukf_prop_state_range  (void *pArg, mtxDim sigmaIdx, mtxDim sigmaCnt);
+static void         ukf_prop_output_range (void *pArg, mtxDim sigmaIdx, mtxDim sigmaCnt);
+static mtxScalar    ukf_state_limiter(mtxScalar state, mtxScalar min, mtxScalar max, uint8_t enbl);
+static mtxResultInfo ukf_sqrt_covariance(tUKF *pUkf, const tMatrix *pZ, const tMatrix *pz, const tMatrix *pN, uint8_t const *pValid, tMatrix *pS);
+static mtxResultInfo ukf_repair_chol    (tUKF *pUkf, mtxScalar *pP, mtxScalar *pBak, const mtxDim n);
+static mtxResultInfo ukf_repair_factor  (tUKF *pUkf, mtxScalar *pS, const mtxDim n);
+static void          ukf_fault          (tUKF *pUkf, const uint8_t fault, const mtxResultInfo mtxResult);
 
 /**
  * @brief Clamp system states in permitted range  
@@ -23,10 +84,10 @@ static float    ukf_state_limiter(float state, float min, float max, uint8_t enb
  * @param min lower state range
  * @param max higher state range 
  * @param enbl limiter enable flag
- * @return float clamp
+ * @return mtxScalar clamp
  */
-static float ukf_state_limiter(const float state, const float min, const float max, const uint8_t enbl) {
-    float clamp = state;
+static mtxScalar ukf_state_limiter(const mtxScalar state, const mtxScalar min, const mtxScalar max, const uint8_t enbl) {
+    mtxScalar clamp = state;
 
     if (0 != enbl) {
         if (min > state) {
@@ -41,6 +102,99 @@ static float ukf_state_limiter(const float state, const float min, const float m
     return clamp;
 }
 
+/**
+ * @brief Copy lower triangle of symmetric P(n x n) into upper triangle
+ * 
+ * @param pP Symmetric matrix with valid lower triangle
+ * @param n Matrix dimension
+ */
+UKF_INLINE void ukf_sym_mirror(mtxScalar *pP, const mtxDim n) {
+    mtxDim row, col;
+
+    for (row = 1; row < n; row++) {
+        for (col = 0; col < row; col++) {
+            pP[n * col + row] = pP[n * row + col];
+        }
+    }
+}
+
+/**
+ * @brief Weighted mean of sigma points z = sum(W(i)*Z(i)), unit stride in both storage orders
+ * 
+ * @param pZ Sigma matrix of nElem elements per sigma point
+ * @param pW Weights (sigmaLen)
+ * @param pz Mean (nElem), elements not marked in pValid are 0
+ * @param nElem Number of elements per sigma point
+ * @param sigmaLen Number of sigma points
+ * @param pValid Element mask (nElem) or NULL if all elements are used
+ */
+UKF_INLINE void ukf_sigma_mean(mtxScalar const *pZ, mtxScalar const *pW, mtxScalar *pz, const mtxDim nElem, const mtxDim sigmaLen, uint8_t const *pValid) {
+    mtxDim sigmaIdx, eIdx;
+
+#if defined(UKF_SIGMA_MAJOR)
+    for (eIdx = 0; eIdx < nElem; eIdx++) {
+        pz[eIdx] = 0;
+    }
+
+    for (sigmaIdx = 0; sigmaIdx < sigmaLen; sigmaIdx++) {
+        mtxScalar const *const pZi = &pZ[UKF_SIGMA_IDX(nElem, sigmaLen, 0, sigmaIdx)];
+
+        for (eIdx = 0; eIdx < nElem; eIdx++) {
+            pz[eIdx] += UKF_Y_VALID(pValid, eIdx) ? pW[sigmaIdx] * pZi[eIdx] : 0;
+        }
+    }
+#else
+    for (eIdx = 0; eIdx < nElem; eIdx++) {
+        mtxScalar const *const pZrow = &pZ[UKF_SIGMA_IDX(nElem, sigmaLen, eIdx, 0)];
+        mtxScalar sum = 0;
+
+        for (sigmaIdx = 0; sigmaIdx < sigmaLen && UKF_Y_VALID(pValid, eIdx); sigmaIdx++) {
+            sum += pW[sigmaIdx] * pZrow[sigmaIdx];
+        }
+        pz[eIdx] = sum;
+    }
+#endif
+}
+
+/**
+ * @brief In place Z(i) = Z(i) - z for all sigma points, elements not marked in pValid are cleared
+ * 
+ * @param pZ Sigma matrix of nElem elements per sigma point
+ * @param pz Mean (nElem)
+ * @param nElem Number of elements per sigma point
+ * @param sigmaLen Number of sigma points
+ * @param pValid Element mask (nElem) or NULL if all elements are used
+ */
+UKF_INLINE void ukf_sigma_center(mtxScalar *pZ, mtxScalar const *pz, const mtxDim nElem, const mtxDim sigmaLen, uint8_t const *pValid) {
+    mtxDim eIdx;
+
+#if defined(UKF_SIGMA_MAJOR)
+    mtxDim sigmaIdx;
+
+    for (sigmaIdx = 0; sigmaIdx < sigmaLen; sigmaIdx++) {
+        mtxScalar *const pZi = &pZ[UKF_SIGMA_IDX(nElem, sigmaLen, 0, sigmaIdx)];
+
+        for (eIdx = 0; eIdx < nElem; eIdx++) {
+            pZi[eIdx] = UKF_Y_VALID(pValid, eIdx) ? (pZi[eIdx] - pz[eIdx]) : 0;
+        }
+    }
+#else
+    for (eIdx = 0; eIdx < nElem; eIdx++) {
+        mtxScalar *const pZrow = &pZ[UKF_SIGMA_IDX(nElem, sigmaLen, eIdx, 0)];
+
+        if (UKF_Y_VALID(pValid, eIdx)) {
+            mtx_kernel_center_rows(pZrow, &pz[eIdx], 1, sigmaLen);
+        } else {
+            mtxDim sigmaIdx;
+
+            for (sigmaIdx = 0; sigmaIdx < sigmaLen; sigmaIdx++) {
+                pZrow[sigmaIdx] = 0;
+            }
+        }
+    }
+#endif
+}
+
 /**
  * @brief Check if working matrix size defined in ukfCfg.c 
  * match to defined system expectation(verification of all 
@@ -52,11 +206,16 @@ static float ukf_state_limiter(const float state, const float min, const float m
  * 1 := NOK
  */
 static uint8_t ukf_dimension_check(tUKF *pUkf) {
-    const uint8_t stateLen = pUkf->par.xLen;
+    const mtxDim stateLen = pUkf->par.xLen;
     //const uint8_t  measLen = pUkf->par.yLen;
-    const uint8_t sigmaLen = pUkf->par.sLen;
+    const mtxDim sigmaLen = pUkf->par.sLen;
     uint8_t Result = 0;
 
+    //sLen = 2*xLen+1 must fit mtxDim
+    if (0 == stateLen || stateLen > UKF_STATE_LEN_MAX) {
+        Result |= 1;
+    }
+
     //check system input vector size if exist: (xLen x 1)
     if (NULL != pUkf->input.u.val && NULL != pUkf->prev.u_p.val) {
         if ((pUkf->input.u.nrow != stateLen || pUkf->input.u.ncol != 1) &&
@@ -76,6 +235,15 @@ static uint8_t ukf_dimension_check(tUKF *pUkf) {
         Result |= 1;
     }
 
+    if (NULL != pUkf->input.yValid.val) {
+        //check measurement present flags size: (yLen x 1)
+        if (pUkf->input.yValid.nrow != pUkf->par.yLen || pUkf->input.yValid.ncol != 1) {
+            Result |= 1;
+        }
+    } else {
+        //measurement present flags are NOT MANDATORY, all measurements are used
+    }
+
     if (NULL != pUkf->par.Wm.val && NULL != pUkf->par.Wc.val) {
         //check Wm,Wc sigma weight matrix size: (1 x sLen)
         if ((pUkf->par.Wm.nrow != 1 || pUkf->par.Wm.ncol != sigmaLen) &&
@@ -114,8 +282,13 @@ static uint8_t ukf_dimension_check(tUKF *pUkf) {
     }
 
     if (NULL != pUkf->predict.X_m.val) {
-        //check X sigma point matrix size: (xLen x 2*xLen+1)
+#if defined(UKF_SIGMA_MAJOR)
+        //check X sigma point matrix size: (sLen x xLen)
+        if (pUkf->predict.X_m.nrow != pUkf->par.sLen || pUkf->predict.X_m.ncol != stateLen) {
+#else
+        //check X sigma point matrix size: (xLen x sLen)
         if (pUkf->predict.X_m.nrow != stateLen || pUkf->predict.X_m.ncol != pUkf->par.sLen) {
+#endif
             Result |= 1;
         }
     } else {
@@ -123,14 +296,26 @@ static uint8_t ukf_dimension_check(tUKF *pUkf) {
     }
 
     if (NULL != pUkf->predict.Y_m.val) {
-        //check Y sigma point matrix size: (yLen x 2*xLen+1) , Y(k|k-1) = y_m
+#if defined(UKF_SIGMA_MAJOR)
+        //check Y sigma point matrix size: (sLen x yLen) , Y(k|k-1) = y_m
+        if (pUkf->predict.Y_m.nrow != pUkf->par.sLen || pUkf->predict.Y_m.ncol != pUkf->par.yLen) {
+#else
+        //check Y sigma point matrix size: (yLen x sLen) , Y(k|k-1) = y_m
         if (pUkf->predict.Y_m.nrow != pUkf->par.yLen || pUkf->predict.Y_m.ncol != pUkf->par.sLen) {
+#endif
             Result |= 1;
         }
     } else {
         Result |= 1;
     }
 
+#if !defined(UKF_SIGMA_MAJOR)
+    if (NULL != pUkf->predict.pFcnPredictVec || NULL != pUkf->predict.pFcnObservVec) {
+        //dense sigma point callbacks require sigma-major storage
+        Result |= 1;
+    }
+#endif
+
     if (NULL != pUkf->predict.P_m.val) {
         //check state/error covariance matrix size: (xLen x xLen) , Pxx_p == P_m == Pxx
         if (pUkf->predict.P_m.nrow != stateLen || pUkf->predict.P_m.ncol != stateLen) {
@@ -140,10 +325,9 @@ static uint8_t ukf_dimension_check(tUKF *pUkf) {
         Result |= 1;
     }
 
-    if (NULL != pUkf->update.Pyy.val && NULL != pUkf->update.Pyy_cpy.val) {
-        //check Output covariance and it's copy size
-        if ((pUkf->update.Pyy.nrow != pUkf->par.yLen || pUkf->update.Pyy.ncol != pUkf->par.yLen) &&
-            (pUkf->update.Pyy_cpy.nrow != pUkf->par.yLen || pUkf->update.Pyy_cpy.ncol != pUkf->par.yLen)) {
+    if (NULL != pUkf->update.Pyy.val) {
+        //check Output covariance size, the gain is solved in place so copy and identity buffers are not used
+        if (pUkf->update.Pyy.nrow != pUkf->par.yLen || pUkf->update.Pyy.ncol != pUkf->par.yLen) {
             Result |= 1;
         }
     } else {
@@ -159,21 +343,53 @@ static uint8_t ukf_dimension_check(tUKF *pUkf) {
         Result |= 1;
     }
 
-    if (NULL != pUkf->update.Pxx_corr.val) {
-        //check Pxx covariance correction: (xLen x xLen)
-        if (pUkf->update.Pxx_corr.nrow != stateLen || pUkf->update.Pxx_corr.ncol != stateLen) {
+    if (NULL != pUkf->update.K.val) {
+        //check Kalman gain matrix (xLen x yLen)
+        if (pUkf->update.K.nrow != stateLen || pUkf->update.K.ncol != pUkf->par.yLen) {
             Result |= 1;
         }
     } else {
         Result |= 1;
     }
 
-    if (NULL != pUkf->update.K.val) {
-        //check Kalman gain matrix (xLen x yLen)
-        if (pUkf->update.K.nrow != stateLen || pUkf->update.K.ncol != pUkf->par.yLen) {
+    if (UKF_MODE_SQRT == pUkf->par.mode) {
+        const mtxDim maxLen = (stateLen > pUkf->par.yLen) ? stateLen : pUkf->par.yLen;
+
+        if (NULL != pUkf->par.Sqxx.val && NULL != pUkf->par.Sryy.val && NULL != pUkf->update.Acmp.val && NULL != pUkf->update.x_corr.val) {
+            //check noise square roots (xLen x xLen),(yLen x yLen), compound workspace of n x (sLen + n) elements
+            //and the column buffer of the covariance downdate (xLen x 1)
+            if ((pUkf->par.Sqxx.nrow != stateLen || pUkf->par.Sqxx.ncol != stateLen) ||
+                (pUkf->update.x_corr.nrow != stateLen) ||
+                (pUkf->par.Sryy.nrow != pUkf->par.yLen || pUkf->par.Sryy.ncol != pUkf->par.yLen) ||
+                ((mtxIdx)pUkf->update.Acmp.nrow * pUkf->update.Acmp.ncol < (mtxIdx)maxLen * (sigmaLen + maxLen))) {
+                Result |= 1;
+            }
+        } else {
             Result |= 1;
         }
-    } else {
+    } else if (UKF_MODE_STANDARD != pUkf->par.mode) {
+        Result |= 1;
+    }
+
+    if (UKF_SIGMA_SYMMETRIC != pUkf->par.scheme && UKF_SIGMA_SIMPLEX != pUkf->par.scheme) {
+        Result |= 1;
+    }
+
+    if (NULL != pUkf->par.Fxx.val) {
+        //check linear prediction F: (xLen x xLen), B: (xLen x uLen) if assigned
+        if (pUkf->par.Fxx.nrow != stateLen || pUkf->par.Fxx.ncol != stateLen) {
+            Result |= 1;
+        }
+        if (NULL != pUkf->par.Bxu.val &&
+            (NULL == pUkf->prev.u_p.val || pUkf->par.Bxu.nrow != stateLen || pUkf->par.Bxu.ncol != pUkf->prev.u_p.nrow)) {
+            Result |= 1;
+        }
+    } else if (NULL != pUkf->par.Bxu.val) {
+        //input matrix is only used by linear prediction
+        Result |= 1;
+    }
+
+    if (UKF_UPDATE_BATCH != pUkf->par.updateMode && UKF_UPDATE_SEQUENTIAL != pUkf->par.updateMode) {
         Result |= 1;
     }
 
@@ -181,18 +397,17 @@ static uint8_t ukf_dimension_check(tUKF *pUkf) {
 }
 
 /**
- * @brief 
+ * @brief Attach the working structure to the buffers and parameters of the configuration,
+ * resolve the update mode and sanitize the state limiters. Derived values (lambda,
+ * weights, noise factors) and the filter state are left to the caller.
  * 
  * @param pUkf UKF - Working structure with all in,out,par
  * @param pUkfMatrix UKF - Structure with all filter matrix
- * @return uint8_t 
  */
-uint8_t ukf_init(tUKF *pUkf, tUkfMatrix *pUkfMatrix) {
-    uint8_t xIdx;
+static void ukf_bind(tUKF *pUkf, tUkfMatrix *pUkfMatrix) {
+    mtxDim xIdx;
     tUKFpar *const pPar = (tUKFpar *)&pUkf->par;
     tUKFprev *const pPrev = (tUKFprev *)&pUkf->prev;
-    const uint8_t WmLen = pUkfMatrix->Wm_weight_vector.ncol;
-    const uint8_t WcLen = pUkfMatrix->Wc_weight_vector.ncol;
 
     pPar->xLim      = pUkfMatrix->x_system_states_limits;
     pPar->xLimEnbl  = pUkfMatrix->x_system_states_limits_enable;
@@ -207,14 +422,40 @@ uint8_t ukf_init(tUKF *pUkf, tUkfMatrix *pUkfMatrix) {
     pPar->kappa     = pUkfMatrix->Sc_vector.val[kappaIdx];
     pPar->xLen      = pUkfMatrix->x_system_states.nrow;
     pPar->yLen      = pUkfMatrix->y_predicted_mean.nrow;
-    pPar->sLen      = 2 * pPar->xLen + 1;
+    pPar->scheme    = pUkfMatrix->sigma_scheme;
+    pPar->sLen      = UKF_SIGMA_LEN(pPar->xLen, pPar->scheme);
     pPar->dT        = pUkfMatrix->dT;
+    pPar->mode      = pUkfMatrix->filter_mode;
+    pPar->Sqxx      = pUkfMatrix->Sqxx_process_noise_sqrt;
+    pPar->Sryy      = pUkfMatrix->Sryy_out_noise_sqrt;
+    pPar->Fxx       = pUkfMatrix->F_state_transition;
+    pPar->Bxu       = pUkfMatrix->B_input_matrix;
+    pPar->updateMode = pUkfMatrix->update_mode;
+
+    if (UKF_UPDATE_AUTO == pPar->updateMode) {
+        mtxDim row, col;
+
+        //independent measurements (diagonal R) are processed one at a time
+        pPar->updateMode = UKF_UPDATE_SEQUENTIAL;
+        for (row = 0; row < pPar->Ryy0.nrow && NULL != pPar->Ryy0.val; row++) {
+            for (col = 0; col < pPar->Ryy0.ncol; col++) {
+                if (row != col && 0 != pPar->Ryy0.val[pPar->Ryy0.ncol * row + col]) {
+                    pPar->updateMode = UKF_UPDATE_BATCH;
+                }
+            }
+        }
+    }
+
+    if (UKF_MODE_SQRT == pPar->mode) {
+        //square-root UKF keeps Sy, measurement update is always batched
+        pPar->updateMode = UKF_UPDATE_BATCH;
+    }
 
     if (NULL != pUkf->par.xLimEnbl.val && NULL != pUkf->par.xLim.val) {
         for (xIdx = 0; xIdx < pPar->xLim.nrow; xIdx++) {
-            const float xMin = pPar->xLim.val[pPar->xLim.ncol * xIdx + xMinIdx];
-            const float xMax = pPar->xLim.val[pPar->xLim.ncol * xIdx + xMaxIdx];
-            const float xEps = pPar->xLim.val[pPar->xLim.ncol * xIdx + xEpsIdx];
+            const mtxScalar xMin = pPar->xLim.val[pPar->xLim.ncol * xIdx + xMinIdx];
+            const mtxScalar xMax = pPar->xLim.val[pPar->xLim.ncol * xIdx + xMaxIdx];
+            const mtxScalar xEps = pPar->xLim.val[pPar->xLim.ncol * xIdx + xEpsIdx];
 
             if (0 != pPar->xLimEnbl.val[xIdx] && ((xMin + xEps) > xMax)) {
                 //limiter range too low -> disable limiter for this state
@@ -225,31 +466,9 @@ uint8_t ukf_init(tUKF *pUkf, tUkfMatrix *pUkfMatrix) {
         //limiter arrays are not defined in CFG file
     }
 
-    //#1.3'(begin) Calculate scaling parameter
-    pPar->lambda = pPar->alpha * pPar->alpha;
-    pPar->lambda *= (float)(pPar->xLen + pPar->kappa);
-    pPar->lambda -= (float)pPar->xLen;
-    //#1.3'(end) Calculate scaling parameter
-
-    //#1.2'(begin) Calculate weight vectors
-    if (WmLen == pPar->sLen && WcLen == WmLen) {
-        uint8_t col;
-        const float Wm0 = pPar->lambda / (pPar->xLen + pPar->lambda);
-
-        pPar->Wm.val[0] = Wm0;
-        pPar->Wc.val[0] = Wm0 + (1 - pPar->alpha * pPar->alpha + pPar->betha);
-
-        for (col = 1; col < WmLen; col++) {
-            pPar->Wm.val[col] = 1 / (2 * (pPar->xLen + pPar->lambda));
-            pPar->Wc.val[col] = pPar->Wm.val[col];
-        }
-    } else {
-        //UKF init fail
-    }
-    //#1.2'(end) Calculate weight vectors
-
     pUkf->input.u = pUkfMatrix->u_system_input;
     pUkf->input.y = pUkfMatrix->y_meas;
+    pUkf->input.yValid = pUkfMatrix->y_meas_valid;
 
     pPrev->Pxx_p = pUkfMatrix->Pxx_error_covariance;
     pPrev->X_p = pUkfMatrix->X_sigma_points;  //share same memory with X_m
@@ -263,8 +482,11 @@ uint8_t ukf_init(tUKF *pUkf, tUkfMatrix *pUkfMatrix) {
     pUkf->predict.y_m = pUkfMatrix->y_predicted_mean;
     pUkf->predict.pFcnPredict = pUkfMatrix->fcnPredict;
     pUkf->predict.pFcnObserv = pUkfMatrix->fcnObserve;
+    pUkf->predict.pFcnPredictBatch = pUkfMatrix->fcnPredictBatch;
+    pUkf->predict.pFcnObservBatch = pUkfMatrix->fcnObserveBatch;
+    pUkf->predict.pFcnPredictVec = pUkfMatrix->fcnPredictVec;
+    pUkf->predict.pFcnObservVec = pUkfMatrix->fcnObserveVec;
 
-    pUkf->update.Iyy = pUkfMatrix->I_identity_matrix;
     pUkf->update.K = pUkfMatrix->K_kalman_gain;
     pUkf->update.Pxx = pUkfMatrix->Pxx_error_covariance;
     pUkf->update.Pxy = pUkfMatrix->Pxy_cross_covariance;
@@ -272,12 +494,89 @@ uint8_t ukf_init(tUKF *pUkf, tUkfMatrix *pUkfMatrix) {
     pUkf->update.Pyy_cpy = pUkfMatrix->Pyy_out_covariance_copy;
     pUkf->update.x = pUkfMatrix->x_system_states;  //&px = &px_m = &px_p
     pUkf->update.x_corr = pUkfMatrix->x_system_states_correction;
-    pUkf->update.Pxx_corr = pUkfMatrix->Pxx_covariance_correction;
+    pUkf->update.Acmp = pUkfMatrix->Sr_compound_workspace;
+    pUkf->pProf = NULL;
+    pUkf->pExec = NULL;
+    pUkf->pHook = NULL;
+    pUkf->pShare = NULL;
+    pUkf->predicted = 0;
+    pUkf->health = (tUkfHealth){0};
+    pUkf->health.retryMax = UKF_RECOVER_RETRY;
+    pUkf->health.jitter = UKF_RECOVER_JITTER;
+}
+
+/**
+ * @brief 
+ * 
+ * @param pUkf UKF - Working structure with all in,out,par
+ * @param pUkfMatrix UKF - Structure with all filter matrix
+ * @return uint8_t 
+ */
+uint8_t ukf_init(tUKF *pUkf, tUkfMatrix *pUkfMatrix) {
+    uint8_t Result;
+    tUKFpar *const pPar = (tUKFpar *)&pUkf->par;
+    const mtxDim WmLen = pUkfMatrix->Wm_weight_vector.ncol;
+    const mtxDim WcLen = pUkfMatrix->Wc_weight_vector.ncol;
+
+    ukf_bind(pUkf, pUkfMatrix);
+
+    //#1.3'(begin) Calculate scaling parameter
+    pPar->lambda = pPar->alpha * pPar->alpha;
+    pPar->lambda *= (mtxScalar)(pPar->xLen + pPar->kappa);
+    pPar->lambda -= (mtxScalar)pPar->xLen;
+    //#1.3'(end) Calculate scaling parameter
+
+    //#1.2'(begin) Calculate weight vectors
+    if (WmLen == pPar->sLen && WcLen == WmLen && UKF_SIGMA_SIMPLEX == pPar->scheme) {
+        mtxDim col;
+        const mtxScalar alpha2 = pPar->alpha * pPar->alpha;
+        //spherical simplex with W0 = 0, Wi = 1/(L+1), scaled by alpha: Wi' = Wi/alpha^2, W0' = 1 - 1/alpha^2
+        const mtxScalar Wm0 = 1 - 1 / alpha2;
+
+        pPar->Wm.val[0] = Wm0;
+        pPar->Wc.val[0] = Wm0 + (1 - alpha2 + pPar->betha);
+
+        for (col = 1; col < WmLen; col++) {
+            pPar->Wm.val[col] = 1 / ((pPar->xLen + 1) * alpha2);
+            pPar->Wc.val[col] = pPar->Wm.val[col];
+        }
+    } else if (WmLen == pPar->sLen && WcLen == WmLen) {
+        mtxDim col;
+        const mtxScalar Wm0 = pPar->lambda / (pPar->xLen + pPar->lambda);
+
+        pPar->Wm.val[0] = Wm0;
+        pPar->Wc.val[0] = Wm0 + (1 - pPar->alpha * pPar->alpha + pPar->betha);
+
+        for (col = 1; col < WmLen; col++) {
+            pPar->Wm.val[col] = 1 / (2 * (pPar->xLen + pPar->lambda));
+            pPar->Wc.val[col] = pPar->Wm.val[col];
+        }
+    } else {
+        //UKF init fail
+    }
+    //#1.2'(end) Calculate weight vectors
 
     mtx_cpy(&pUkf->prev.Pxx_p, &pPar->Pxx0);  //init also P_m, Pxx
     mtx_cpy(&pUkf->prev.x_p, &pPar->x0);
 
-    return ukf_dimension_check(pUkf);
+    Result = ukf_dimension_check(pUkf);
+
+    if (0 == Result && UKF_MODE_SQRT == pPar->mode) {
+        //square-root UKF works with lower Cholesky factors of Pxx0, Qxx and Ryy0
+        if (MTX_OPERATION_OK != mtx_chol_lower(&pUkf->prev.Pxx_p)) {
+            Result |= 1;
+        }
+
+        (void)mtx_cpy(&pPar->Sqxx, &pPar->Qxx);
+        (void)mtx_cpy(&pPar->Sryy, &pPar->Ryy0);
+
+        if (MTX_OPERATION_OK != mtx_chol_semidef(&pPar->Sqxx) ||
+            MTX_OPERATION_OK != mtx_chol_semidef(&pPar->Sryy)) {
+            Result |= 1;
+        }
+    }
+
+    return Result;
 }
 
 /**
@@ -287,267 +586,1519 @@ uint8_t ukf_init(tUKF *pUkf, tUkfMatrix *pUkfMatrix) {
  * UKF processing is separated on two sub-steps
  * - Predict
  * - Measurement update
+ * Same as ukf_predict() with the configured dT followed by ukf_update().
  * 
  * @param pUkf UKF - Working structure with reference to all in,out,states,par
+ * @return uint8_t 0 := OK, UKF_FAULT_* left in this step otherwise (see tUKF.health)
  */
-void ukf_step(tUKF *pUkf) {
-    ukf_sigmapoint(pUkf);
-    ukf_mean_pred_state(pUkf);
-    ukf_mean_pred_output(pUkf);
-    ukf_calc_covariances(pUkf);
-    ukf_meas_update(pUkf);
-
-    if (NULL != pUkf->input.u.val && NULL != pUkf->prev.u_p.val) {
-        float *const pu_p = pUkf->prev.u_p.val;
-        const float *const pu = pUkf->input.u.val;
-        const uint8_t uLen = pUkf->prev.u_p.nrow;
-        uint8_t u8Idx;
-
-        for (u8Idx = 0; u8Idx < uLen; u8Idx++) {
-            //store prev inputs required for next step calculation
-            pu_p[u8Idx] = pu[u8Idx];
-        }
-    }
+uint8_t ukf_step(tUKF *pUkf) {
+    return ukf_run(pUkf, UKF_STAGE_PREDICT | UKF_STAGE_UPDATE);
 }
 
 /**
- * @brief Step 1:  Generate the Sigma-Points
- * #1.1 Calculate error covariance matrix square root : sqrt(Pxx_p) = chol(Pxx_p) 
- * #1.2 Calculate the sigma-points : X_p[L][2L+1] == X(k-1) ,wher L is number of system states xLen      
+ * @brief Time update: x(k|k-1), P(k|k-1) become the new x, Pxx.
+ * Can be called any number of times between measurement updates.
  * 
  * @param pUkf UKF - Working structure with reference to all in,out,states,par
+ * @param dT Time since previous prediction, also used by following ukf_step() calls
+ * @return uint8_t 0 := OK, UKF_FAULT_* left in this call otherwise (see tUKF.health)
  */
-static void ukf_sigmapoint(tUKF *pUkf) {
-    float *const pPxx_p = pUkf->prev.Pxx_p.val;
-    float *const pX_p = pUkf->prev.X_p.val;
-    float *const px_p = pUkf->prev.x_p.val;
-    const float lambda = pUkf->par.lambda;
-    const uint8_t sLen = pUkf->par.sLen;
-    const uint8_t xLen = pUkf->par.xLen;
-    uint8_t xIdx;
-    uint8_t sigmaIdx = 0;
-    mtxResultInfo mtxResult;
-
-    //#1.1(begin/end) Calculate error covariance matrix square root
-    mtxResult = mtx_chol_lower(&pUkf->prev.Pxx_p);
-
-    if (MTX_OPERATION_OK == mtxResult) {
-        //#1.2(begin) Calculate the sigma-points
-        for (xIdx = 0; xIdx < xLen; xIdx++) {
-            float xMin = 0;
-            float xMax = 0;
-            uint8_t xLimEnbl = 0;
-
-            if (NULL != pUkf->par.xLimEnbl.val && NULL != pUkf->par.xLim.val) {
-                xMin = pUkf->par.xLim.val[pUkf->par.xLim.ncol * xIdx + xMinIdx];
-                xMax = pUkf->par.xLim.val[pUkf->par.xLim.ncol * xIdx + xMaxIdx];
-                xLimEnbl = pUkf->par.xLimEnbl.val[xIdx];
-            }
-
-            //first column of sigma point matrix is equal of previous state value
-            pX_p[sLen * xIdx + sigmaIdx] = ukf_state_limiter(px_p[xIdx], xMin, xMax, xLimEnbl);
-        }
-
-        (void)mtx_mul_scalar(&pUkf->prev.Pxx_p, sqrt(xLen + lambda));
-
-        for (sigmaIdx = 1; sigmaIdx < sLen; sigmaIdx++) {
-            for (xIdx = 0; xIdx < xLen; xIdx++) {
-                float xMin = 0;
-                float xMax = 0;
-                uint8_t xLimEnbl = 0;
+uint8_t ukf_predict(tUKF *pUkf, mtxScalar dT) {
+    pUkf->par.dT = dT;
+    return ukf_run(pUkf, UKF_STAGE_PREDICT);
+}
 
-                if (NULL != pUkf->par.xLimEnbl.val && NULL != pUkf->par.xLim.val) {
-                    xMin = pUkf->par.xLim.val[pUkf->par.xLim.ncol * xIdx + xMinIdx];
-                    xMax = pUkf->par.xLim.val[pUkf->par.xLim.ncol * xIdx + xMaxIdx];
-                    xLimEnbl = pUkf->par.xLimEnbl.val[xIdx];
-                }
+/**
+ * @brief Measurement update with input.y (only measurements marked in input.yValid if
+ * assigned), skipped if no measurement is present. Uses the sigma points of the last
+ * ukf_predict(), if the state was already updated since then, sigma points are
+ * redrawn from current x, Pxx without propagation.
+ * 
+ * @param pUkf UKF - Working structure with reference to all in,out,states,par
+ * @return uint8_t 0 := OK, UKF_FAULT_* left in this call otherwise (see tUKF.health)
+ */
+uint8_t ukf_update(tUKF *pUkf) {
+    return ukf_run(pUkf, UKF_STAGE_UPDATE);
+}
 
-                if (sigmaIdx <= xLen) {
-                    pX_p[sLen * xIdx + sigmaIdx] = ukf_state_limiter(px_p[xIdx] + pPxx_p[xLen * xIdx + (sigmaIdx - 1)], xMin, xMax, xLimEnbl);
-                } else {
-                    pX_p[sLen * xIdx + sigmaIdx] = ukf_state_limiter(px_p[xIdx] - pPxx_p[xLen * xIdx + (sigmaIdx - xLen - 1)], xMin, xMax, xLimEnbl);
-                }
-            }
+/**
+ * @brief CRC-32 (IEEE 802.3, reflected) of a byte block
+ * 
+ * @param pData Data
+ * @param len Number of bytes
+ * @return uint32_t CRC
+ */
+static uint32_t ukf_ckpt_crc(uint8_t const *pData, const uint32_t len) {
+    uint32_t crc = 0xFFFFFFFFu;
+    uint32_t bIdx;
+    uint8_t bit;
+
+    for (bIdx = 0; bIdx < len; bIdx++) {
+        crc ^= pData[bIdx];
+        for (bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
         }
-        //#1.2(end) Calculate the sigma-points
-    } else {
     }
+
+    return ~crc;
 }
 
 /**
- * @brief Step 2: Prediction Transformation (APPENDIX A:IMPLEMENTATION OF THE ADDITIVE NOISE UKF)
- * #2.1 Propagate each sigma-point through prediction  : X_m = f(X_p, u_p)
- * #2.2 Calculate mean of predicted state              : x_m = sum(Wm(i)*X_m(i)) , i=0,..2L
+ * @brief Checkpoint header of the filter: format, dimensions and resolved modes; crc is 0
  * 
- * @param pUkf UKF - Working structure with reference to all in,out,states,par
+ * @param pUkf UKF - Working structure
+ * @param pHdr Header
  */
-static void ukf_mean_pred_state(tUKF *pUkf) {
-    tUKFpar const *const pPar = (tUKFpar *)&pUkf->par;
-    const uint8_t xLen = pPar->xLen;
-    const uint8_t sigmaLen = pPar->sLen;
-    float *const px_m = pUkf->predict.x_m.val;
-    float const *const pX_m = pUkf->predict.X_m.val;
-    float const *const pWm = pPar->Wm.val;
-    uint8_t sigmaIdx, xIdx;
-
-    for (xIdx = 0; xIdx < xLen; xIdx++) {
-        px_m[xIdx] = 0;
+static void ukf_ckpt_header(const tUKF *pUkf, tUkfCkptHeader *pHdr) {
+    const uint32_t xLen = pUkf->par.xLen;
+    const uint32_t yLen = pUkf->par.yLen;
+    const uint32_t uLen = (NULL != pUkf->prev.u_p.val) ? pUkf->prev.u_p.nrow : 0;
+    //lambda, dT, x, lower triangle of Pxx, u_p, Wm, Wc (+ lower triangles of Sqxx, Sryy)
+    uint32_t nScalar = 2 + xLen + xLen * (xLen + 1) / 2 + uLen + 2u * pUkf->par.sLen;
+    uint8_t bIdx;
+
+    if (UKF_MODE_SQRT == pUkf->par.mode) {
+        nScalar += xLen * (xLen + 1) / 2 + yLen * (yLen + 1) / 2;
+    }
 
-        for (sigmaIdx = 0; sigmaIdx < sigmaLen; sigmaIdx++) {
-            if (pUkf->predict.pFcnPredict[xIdx] != NULL) {
-                //#2.1 Propagate each sigma-point through prediction
-                pUkf->predict.pFcnPredict[xIdx](&pUkf->prev.u_p, &pUkf->prev.X_p, &pUkf->predict.X_m, sigmaIdx, pUkf->par.dT);
-            }
-            //#2.2 Calculate mean of predicted state
-            px_m[xIdx] += pWm[sigmaIdx] * pX_m[sigmaLen * xIdx + sigmaIdx];
-        }
+    pHdr->crc = 0;
+    pHdr->magic = UKF_CKPT_MAGIC;
+    pHdr->size = (uint32_t)sizeof(tUkfCkptHeader) + nScalar * (uint32_t)sizeof(mtxScalar);
+    pHdr->version = UKF_CKPT_VERSION;
+    pHdr->xLen = (uint16_t)xLen;
+    pHdr->yLen = (uint16_t)yLen;
+    pHdr->uLen = (uint16_t)uLen;
+    pHdr->sLen = (uint16_t)pUkf->par.sLen;
+    pHdr->scalarSize = (uint8_t)sizeof(mtxScalar);
+    pHdr->mode = pUkf->par.mode;
+    pHdr->scheme = pUkf->par.scheme;
+    pHdr->updateMode = pUkf->par.updateMode;
+    for (bIdx = 0; bIdx < sizeof(pHdr->reserved); bIdx++) {
+        pHdr->reserved[bIdx] = 0;
     }
 }
 
 /**
- * @brief Step 3: Observation Transformation (APPENDIX A:IMPLEMENTATION OF THE ADDITIVE NOISE UKF)
- * #2.3 Calculate covariance of predicted state        : P_m = Wc(sigmaIdx)*(X_m-x_m)*(X_m-x_m)' P(k|k-1)
- * #3.1 Propagate each sigma-point through observation : Y_m = h(X_m, u)
- * #3.2 Calculate mean of predicted output             : y_m = sum(Wm(i)*Y_m(i))
+ * @brief Number of bytes written by ukf_checkpoint_save()
  * 
- * @param pUkf UKF - Working structure with reference to all in,out,states,par
+ * @param pUkf UKF - Working structure after ukf_init()
+ * @return uint32_t Checkpoint size in bytes
  */
-static void ukf_mean_pred_output(tUKF *pUkf) {
-    tUKFpar const *const pPar = (tUKFpar *)&pUkf->par;
-    float const *const pWm = pPar->Wm.val;
-    float const *const pWc = pPar->Wc.val;
-    float const *const pX_m = pUkf->predict.X_m.val;
-    float *const pY_m = pUkf->predict.Y_m.val;
-    float *const pP_m = pUkf->predict.P_m.val;
-    float *const px_m = pUkf->predict.x_m.val;
-    float *py_m = pUkf->predict.y_m.val;
-    const uint8_t sigmaLen = pPar->sLen;
-    const uint8_t xLen = pPar->xLen;
-    const uint8_t yLen = pPar->yLen;
-    uint8_t sigmaIdx, xIdx, xTrIdx, yIdx;
-
-    mtx_zeros(&pUkf->predict.y_m);
-
-    //P(k|k-1) = Q(k-1)
-    mtx_cpy(&pUkf->predict.P_m, &pUkf->par.Qxx);
+uint32_t ukf_checkpoint_size(const tUKF *pUkf) {
+    tUkfCkptHeader hdr;
 
-    for (sigmaIdx = 0; sigmaIdx < sigmaLen; sigmaIdx++) {
-        for (xIdx = 0; xIdx < xLen; xIdx++) {
-            for (xTrIdx = 0; xTrIdx < xLen; xTrIdx++) {
-                float term1 = (pX_m[sigmaLen * xIdx + sigmaIdx] - px_m[xIdx]);
-                float term2 = (pX_m[sigmaLen * xTrIdx + sigmaIdx] - px_m[xTrIdx]);
-
-                //#2.3 Calculate covariance of predicted state
-                //Perform multiplication with accumulation for each covariance matrix index
-                pP_m[xLen * xIdx + xTrIdx] += pWc[sigmaIdx] * term1 * term2;
-            }
-        }
+    ukf_ckpt_header(pUkf, &hdr);
 
-        for (yIdx = 0; yIdx < yLen; yIdx++) {
-            if (pUkf->predict.pFcnObserv[yIdx] != NULL) {
-                //#3.1 Propagate each sigma-point through observation
-                pUkf->predict.pFcnObserv[yIdx](&pUkf->input.u, &pUkf->predict.X_m, &pUkf->predict.Y_m, sigmaIdx);
-            } else {
-                //assign 0 if observation function is not specified
-                pY_m[sigmaLen * sigmaIdx + yIdx] = 0;
-            }
-            //#3.2 Calculate mean of predicted output
-            py_m[yIdx] += pWm[sigmaIdx] * pY_m[sigmaLen * yIdx + sigmaIdx];
-        }
-    }
+    return hdr.size;
 }
 
 /**
- * @brief # 3.3 Calculate covariance of predicted output       : Pyy = Wc(sigmaIdx)*(Y_m-y_m)*(Y_m-y_m)'
- *        # 3.4 Calculate cross-covariance of state and output : Pxy = Q + sum(Wc*()*()')
+ * @brief Serialize the live filter state for a warm restart (backup SRAM, flash, memory
+ * mapped file): x, Pxx (lower Cholesky factor with UKF_MODE_SQRT), u_p and the derived
+ * lambda, Wm, Wc (and Sqxx, Sryy with UKF_MODE_SQRT), guarded by a versioned header and
+ * a CRC. A checkpoint taken between ukf_predict() and ukf_update() resumes with sigma
+ * points redrawn from x(k|k-1), P(k|k-1) instead of the propagated ones.
  * 
- * @param pUkf UKF - Working structure with reference to all in,out,states,par
+ * @param pUkf UKF - Working structure after ukf_init()
+ * @param pMem Destination aligned for mtxScalar
+ * @param memSize Size of destination, at least ukf_checkpoint_size()
+ * @return uint8_t 
+ * 0 := OK
+ * 1 := NOK (destination too small or misaligned, nothing written)
  */
-static void ukf_calc_covariances(tUKF *pUkf) {
-    tUKFpar const *const pPar = (tUKFpar *)&pUkf->par;
-    float const *const pWc = pPar->Wc.val;
-    float const *const pX_m = pUkf->predict.X_m.val;
-    float *const pY_m = pUkf->predict.Y_m.val;
-    float *const pPyy = pUkf->update.Pyy.val;
-    float *const pPxy = pUkf->update.Pxy.val;
-    float *const px_m = pUkf->predict.x_m.val;
-    float *py_m = pUkf->predict.y_m.val;
-    const uint8_t sigmaLen = pPar->sLen;
-    const uint8_t xLen = pPar->xLen;
-    const uint8_t yLen = pPar->yLen;
-    uint8_t sigmaIdx, xIdx, yIdx, yTrIdx;
-
-    mtx_cpy(&pUkf->update.Pyy, &pPar->Ryy0);  //Pyy(k|k-1) = R(k)
-
-    mtx_zeros(&pUkf->update.Pxy);
+uint8_t ukf_checkpoint_save(const tUKF *pUkf, void *pMem, const uint32_t memSize) {
+    tUkfCkptHeader *const pHdr = (tUkfCkptHeader *)pMem;
+    const mtxDim xLen = pUkf->par.xLen;
+    const mtxDim yLen = pUkf->par.yLen;
+    uint8_t Result = 0;
+    tUkfCkptHeader hdr;
 
-    for (sigmaIdx = 0; sigmaIdx < sigmaLen; sigmaIdx++) {
-        for (yIdx = 0; yIdx < yLen; yIdx++) {
-            for (yTrIdx = 0; yTrIdx < yLen; yTrIdx++) {
-                //loop col of COV[L][:]
-                float term1 = (pY_m[sigmaLen * yIdx + sigmaIdx] - py_m[yIdx]);
-                float term2 = (pY_m[sigmaLen * yTrIdx + sigmaIdx] - py_m[yTrIdx]);
+    ukf_ckpt_header(pUkf, &hdr);
+
+    if (NULL == pHdr || 0 != ((uintptr_t)pMem & (sizeof(mtxScalar) - 1u)) || memSize < hdr.size) {
+        Result = 1;
+    } else {
+        mtxScalar *pVal = (mtxScalar *)(pHdr + 1);
+        mtxDim row, col, idx;
 
-                //#3.3 Calculate covariance of predicted output
-                //Perform multiplication with accumulation for each covariance matrix index
-                pPyy[yLen * yIdx + yTrIdx] += pWc[sigmaIdx] * term1 * term2;
+        *pVal++ = pUkf->par.lambda;
+        *pVal++ = pUkf->par.dT;
+        for (idx = 0; idx < xLen; idx++) {
+            *pVal++ = pUkf->update.x.val[idx];
+        }
+        for (row = 0; row < xLen; row++) {
+            for (col = 0; col <= row; col++) {
+                *pVal++ = pUkf->update.Pxx.val[xLen * row + col];
             }
         }
-
-        for (xIdx = 0; xIdx < xLen; xIdx++) {
-            for (yTrIdx = 0; yTrIdx < yLen; yTrIdx++) {
-                float term1 = (pX_m[sigmaLen * xIdx + sigmaIdx] - px_m[xIdx]);
-                float term2 = (pY_m[sigmaLen * yTrIdx + sigmaIdx] - py_m[yTrIdx]);
-
-                //#3.4 Calculate cross-covariance of state and output
-                pPxy[yLen * xIdx + yTrIdx] += pWc[sigmaIdx] * term1 * term2;
+        for (idx = 0; idx < hdr.uLen; idx++) {
+            *pVal++ = pUkf->prev.u_p.val[idx];
+        }
+        for (idx = 0; idx < pUkf->par.sLen; idx++) {
+            *pVal++ = pUkf->par.Wm.val[idx];
+        }
+        for (idx = 0; idx < pUkf->par.sLen; idx++) {
+            *pVal++ = pUkf->par.Wc.val[idx];
+        }
+        if (UKF_MODE_SQRT == pUkf->par.mode) {
+            for (row = 0; row < xLen; row++) {
+                for (col = 0; col <= row; col++) {
+                    *pVal++ = pUkf->par.Sqxx.val[xLen * row + col];
+                }
+            }
+            for (row = 0; row < yLen; row++) {
+                for (col = 0; col <= row; col++) {
+                    *pVal++ = pUkf->par.Sryy.val[yLen * row + col];
+                }
             }
         }
+
+        *pHdr = hdr;
+        pHdr->crc = ukf_ckpt_crc((uint8_t const *)pHdr + sizeof(pHdr->crc), hdr.size - (uint32_t)sizeof(pHdr->crc));
     }
+
+    return Result;
 }
 
 /**
- * @brief Step 4: Measurement Update (APPENDIX A:IMPLEMENTATION OF THE ADDITIVE NOISE UKF)
- *        #4.1 Calculate Kalman gain   : K = Pxy*inv(Pyy)
- *        #4.2 Update state estimate   : x = x_m + K(y - y_m)
- *        #4.3 Update error covariance : Pxx = Pxx_m - K*Pyy*K'
+ * @brief Warm restart: attach the filter to the configuration like ukf_init() and resume
+ * from a checkpoint of ukf_checkpoint_save() instead of x0, Pxx0. Derived parameters are
+ * taken from the checkpoint and the dimension check is skipped, the configuration must be
+ * the one ukf_init() accepted when the checkpoint was taken. The upper triangle of Pxx is
+ * mirrored (UKF_MODE_STANDARD) or cleared (UKF_MODE_SQRT).
  * 
- * @param pUkf UKF - Working structure with reference to all in,out,states,par
- */
-static void ukf_meas_update(tUKF *pUkf) {
-    tUKFupdate *const pUpdate = (tUKFupdate *)&pUkf->update;
+ * @param pUkf UKF - Working structure
+ * @param pUkfMatrix UKF - Structure with all filter matrix
+ * @param pMem Checkpoint aligned for mtxScalar
+ * @param memSize Size of the checkpoint memory
+ * @return uint8_t 
+ * 0 := OK
+ * 1 := NOK (no valid checkpoint of this configuration: corrupted, other version, format
+ *      or dimensions; the filter state is undefined, run ukf_init())
+ */
+uint8_t ukf_restore(tUKF *pUkf, tUkfMatrix *pUkfMatrix, const void *pMem, const uint32_t memSize) {
+    tUkfCkptHeader const *const pHdr = (tUkfCkptHeader const *)pMem;
+    uint8_t Result = 0;
+    tUkfCkptHeader hdr;
+
+    ukf_bind(pUkf, pUkfMatrix);
+    ukf_ckpt_header(pUkf, &hdr);
+
+    if (NULL == pHdr || 0 != ((uintptr_t)pMem & (sizeof(mtxScalar) - 1u)) || memSize < hdr.size) {
+        Result = 1;
+    } else if (pHdr->magic != hdr.magic || pHdr->version != hdr.version || pHdr->size != hdr.size ||
+               pHdr->xLen != hdr.xLen || pHdr->yLen != hdr.yLen || pHdr->uLen != hdr.uLen || pHdr->sLen != hdr.sLen ||
+               pHdr->scalarSize != hdr.scalarSize || pHdr->mode != hdr.mode || pHdr->scheme != hdr.scheme ||
+               pHdr->updateMode != hdr.updateMode ||
+               pHdr->crc != ukf_ckpt_crc((uint8_t const *)pHdr + sizeof(pHdr->crc), hdr.size - (uint32_t)sizeof(pHdr->crc))) {
+        Result = 1;
+    } else {
+        const mtxDim xLen = pUkf->par.xLen;
+        const mtxDim yLen = pUkf->par.yLen;
+        mtxScalar const *pVal = (mtxScalar const *)(pHdr + 1);
+        mtxScalar *const pPxx = pUkf->update.Pxx.val;
+        mtxDim row, col, idx;
+
+        pUkf->par.lambda = *pVal++;
+        pUkf->par.dT = *pVal++;
+        for (idx = 0; idx < xLen; idx++) {
+            pUkf->update.x.val[idx] = *pVal++;
+        }
+        for (row = 0; row < xLen; row++) {
+            for (col = 0; col <= row; col++) {
+                pPxx[xLen * row + col] = *pVal;
+                pPxx[xLen * col + row] = (UKF_MODE_SQRT == pUkf->par.mode && row != col) ? 0 : *pVal;
+                pVal++;
+            }
+        }
+        for (idx = 0; idx < hdr.uLen; idx++) {
+            pUkf->prev.u_p.val[idx] = *pVal++;
+        }
+        for (idx = 0; idx < pUkf->par.sLen; idx++) {
+            pUkf->par.Wm.val[idx] = *pVal++;
+        }
+        for (idx = 0; idx < pUkf->par.sLen; idx++) {
+            pUkf->par.Wc.val[idx] = *pVal++;
+        }
+        if (UKF_MODE_SQRT == pUkf->par.mode) {
+            for (row = 0; row < xLen; row++) {
+                for (col = 0; col < xLen; col++) {
+                    pUkf->par.Sqxx.val[xLen * row + col] = (col <= row) ? *pVal++ : 0;
+                }
+            }
+            for (row = 0; row < yLen; row++) {
+                for (col = 0; col < yLen; col++) {
+                    pUkf->par.Sryy.val[yLen * row + col] = (col <= row) ? *pVal++ : 0;
+                }
+            }
+        }
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Run stages of one filter cycle. Dimensions listed in UKF_SPEC_DIMS (X-macro of
+ * UKF_SPEC(nx, ny) entries, e.g. from the header given by UKF_SPEC_HEADER) run
+ * a copy of the cycle specialized for them, all other filters run the generic
+ * copy with runtime dimensions.
+ * 
+ * @param pUkf UKF - Working structure with reference to all in,out,states,par
+ * @param stages UKF_STAGE_PREDICT and/or UKF_STAGE_UPDATE
+ * @return uint8_t UKF_FAULT_* left after the stages, 0 := OK
+ */
+static uint8_t ukf_run(tUKF *pUkf, const uint8_t stages) {
+    const mtxDim xLen = pUkf->par.xLen;
+    const mtxDim yLen = pUkf->par.yLen;
+    const mtxDim sLen = pUkf->par.sLen;
+    uint8_t run = stages & UKF_STAGE_PREDICT;
+    mtxDim yIdx;
+    UKF_PROF_START(pUkf->pProf, tStep);
+
+    pUkf->health.status = 0;
+    pUkf->health.repaired = 0;
+    pUkf->health.steps++;
+
+    for (yIdx = 0; yIdx < yLen && 0 != (stages & UKF_STAGE_UPDATE); yIdx++) {
+        if (UKF_Y_VALID(pUkf->input.yValid.val, yIdx)) {
+            //update only if at least one measurement is present
+            run |= UKF_STAGE_UPDATE;
+        }
+    }
+
+#if defined(UKF_SPEC_DIMS)
+#define UKF_SPEC(nx, ny)                                                 \
+    if ((nx) == xLen && (ny) == yLen && (2 * (nx) + 1) == sLen) {        \
+        ukf_step_core(pUkf, (nx), (ny), (2 * (nx) + 1), run);            \
+    } else
+    UKF_SPEC_DIMS
+#undef UKF_SPEC
+#endif
+    {
+        ukf_step_core(pUkf, xLen, yLen, sLen, run);
+    }
+
+    if (0 != (stages & UKF_STAGE_PREDICT) && NULL != pUkf->input.u.val && NULL != pUkf->prev.u_p.val) {
+        mtxScalar *const pu_p = pUkf->prev.u_p.val;
+        const mtxScalar *const pu = pUkf->input.u.val;
+        const mtxDim uLen = pUkf->prev.u_p.nrow;
+        mtxDim u8Idx;
+
+        for (u8Idx = 0; u8Idx < uLen; u8Idx++) {
+            //store prev inputs required for next step calculation
+            pu_p[u8Idx] = pu[u8Idx];
+        }
+    }
+
+    if (0 != pUkf->health.status) {
+        pUkf->health.faultSteps++;
+    }
+
+    UKF_PROF_STOP(pUkf->pProf, tStep, UKF_PHASE_STEP);
+
+    return pUkf->health.status;
+}
+
+/**
+ * @brief Predict and measurement update phases of one step
+ * 
+ * @param pUkf UKF - Working structure with reference to all in,out,states,par
+ * @param xLen Number of states
+ * @param yLen Number of measurements
+ * @param sLen Number of sigma points
+ * @param stages UKF_STAGE_PREDICT and/or UKF_STAGE_UPDATE
+ */
+UKF_INLINE void ukf_step_core(tUKF *pUkf, const mtxDim xLen, const mtxDim yLen, const mtxDim sLen, const uint8_t stages) {
+    //full standard cycle: P_m is evaluated by the fused statistics sweep of the update
+    const uint8_t withPxx = (UKF_STAGE_PREDICT | UKF_STAGE_UPDATE) == stages && UKF_MODE_STANDARD == pUkf->par.mode &&
+                            NULL == pUkf->par.Fxx.val;
+    UKF_PROF_START(pUkf->pProf, tPhase);
+
+    if (0 != (stages & UKF_STAGE_PREDICT) && NULL != pUkf->par.Fxx.val) {
+        //closed form prediction, sigma points are drawn by the update from x(k|k-1), P(k|k-1)
+        UKF_HOOK(pUkf, fcnPrior);
+        ukf_linear_pred_state(pUkf, xLen);
+        UKF_HOOK(pUkf, fcnCross);
+        UKF_HOOK(pUkf, fcnPred);
+        UKF_PROF_MARK(pUkf->pProf, tPhase, UKF_PHASE_PRED_STATE);
+        pUkf->predicted = 0;
+    } else if (0 != (stages & UKF_STAGE_PREDICT) && UKF_SHARE_GET(pUkf, UKF_SHARE_PROP)) {
+        //sigma points and prediction model equal those of the leading model
+        mtx_kernel_cpy(pUkf->predict.X_m.val, pUkf->pShare->pXget, (mtxIdx)xLen * sLen);
+        ukf_sigma_mean(pUkf->predict.X_m.val, pUkf->par.Wm.val, pUkf->predict.x_m.val, xLen, sLen, NULL);
+        if (0 == withPxx) {
+            ukf_cov_pred_state(pUkf, xLen, sLen);
+        }
+        UKF_PROF_MARK(pUkf->pProf, tPhase, UKF_PHASE_PRED_STATE);
+        pUkf->predicted = 1;
+    } else if (0 != (stages & UKF_STAGE_PREDICT)) {
+        if (MTX_OPERATION_OK != ukf_sigmapoint(pUkf, xLen, sLen, 0)) {
+            //x(k-1|k-1) and Pxx(k-1|k-1) are kept, nothing to propagate or update
+            pUkf->predicted = 0;
+            return;
+        }
+        UKF_PROF_MARK(pUkf->pProf, tPhase, UKF_PHASE_SIGMAPOINT);
+        UKF_HOOK(pUkf, fcnPrior);
+        ukf_mean_pred_state(pUkf, xLen, sLen);
+        UKF_HOOK(pUkf, fcnCross);
+        if (UKF_SHARE_PUT(pUkf, UKF_SHARE_PROP)) {
+            mtx_kernel_cpy(pUkf->pShare->pXput, pUkf->predict.X_m.val, (mtxIdx)xLen * sLen);
+        }
+        if (0 == withPxx) {
+            ukf_cov_pred_state(pUkf, xLen, sLen);
+            UKF_HOOK(pUkf, fcnPred);
+        }
+        UKF_PROF_MARK(pUkf->pProf, tPhase, UKF_PHASE_PRED_STATE);
+        pUkf->predicted = 1;
+    }
+
+    if (0 != (stages & UKF_STAGE_UPDATE)) {
+        if (0 == pUkf->predicted) {
+            //X_m is stale: sigma points of current x, Pxx without propagation (standard: Pxx stays a covariance)
+            if (MTX_OPERATION_OK != ukf_sigmapoint(pUkf, xLen, sLen, UKF_MODE_STANDARD == pUkf->par.mode)) {
+                return;
+            }
+            UKF_PROF_MARK(pUkf->pProf, tPhase, UKF_PHASE_SIGMAPOINT);
+        }
+
+        if (UKF_SHARE_GET(pUkf, UKF_SHARE_OBS)) {
+            //observation model and propagated sigma points equal those of the leading model
+            mtx_kernel_cpy(pUkf->predict.Y_m.val, pUkf->pShare->pYget, (mtxIdx)yLen * sLen);
+            ukf_sigma_mean(pUkf->predict.Y_m.val, pUkf->par.Wm.val, pUkf->predict.y_m.val, yLen, sLen, pUkf->input.yValid.val);
+        } else {
+            ukf_mean_pred_output(pUkf, yLen, sLen);
+            if (UKF_SHARE_PUT(pUkf, UKF_SHARE_OBS)) {
+                mtx_kernel_cpy(pUkf->pShare->pYput, pUkf->predict.Y_m.val, (mtxIdx)yLen * sLen);
+            }
+        }
+        UKF_PROF_MARK(pUkf->pProf, tPhase, UKF_PHASE_PRED_OUTPUT);
+        ukf_calc_covariances(pUkf, xLen, yLen, sLen, withPxx);
+        if (0 != withPxx) {
+            //P(k|k-1) of the fused sweep completes the prediction
+            UKF_HOOK(pUkf, fcnPred);
+        }
+        UKF_PROF_MARK(pUkf->pProf, tPhase, UKF_PHASE_COVARIANCES);
+        if (UKF_UPDATE_SEQUENTIAL == pUkf->par.updateMode) {
+            ukf_meas_update_seq(pUkf, xLen, yLen);
+        } else {
+            ukf_meas_update(pUkf, xLen, yLen);
+        }
+        UKF_PROF_MARK(pUkf->pProf, tPhase, UKF_PHASE_MEAS_UPDATE);
+        pUkf->predicted = 0;
+    }
+}
+
+/**
+ * @brief Step 1:  Generate the Sigma-Points
+ * #1.1 Calculate error covariance matrix square root : sqrt(Pxx_p) = chol(Pxx_p) 
+ * #1.2 Calculate the sigma-points : X_p[L][2L+1] == X(k-1) ,wher L is number of system states xLen      
+ * UKF_SIGMA_SIMPLEX: X_p[L][L+2], X(i) = x + alpha*chol(Pxx_p)*Z(i) with the spherical simplex
+ * vectors Z(i), component j of Z(i) is -c(j) for i <= j, j*c(j) for i == j+1 and 0 otherwise,
+ * c(j) = sqrt((L+1)/(j*(j+1))). The sum of c(j)*chol(Pxx_p)(:,j) over j >= i is accumulated
+ * from the last point backwards, so every point costs O(L).
+ * Only the lower triangle of chol(Pxx_p) is read.
+ * With keep (UKF_MODE_STANDARD) Pxx_p is a covariance again after the draw: it is factorized
+ * without writing its strict upper triangle, the diagonal is kept in Y_m (free until the
+ * observation), and Pxx_p is mirrored back from both in O(L^2). A factor taken with UKF_SHARE_CHOL
+ * or from a repair is multiplied out instead.
+ * If Pxx_p fails to factorize and is not repaired, no sigma points are drawn and Pxx_p
+ * is restored from its backup in X_p (the restore of keep without tUKF.health.recover).
+ * 
+ * @param pUkf UKF - Working structure with reference to all in,out,states,par
+ * @param xLen Number of states
+ * @param sLen Number of sigma points
+ * @param keep Restore Pxx_p after the draw
+ * @return mtxResultInfo MTX_OPERATION_OK := sigma points drawn
+ */
+UKF_INLINE mtxResultInfo ukf_sigmapoint(tUKF *pUkf, const mtxDim xLen, const mtxDim sLen, const uint8_t keep) {
+    mtxScalar *const pPxx_p = pUkf->prev.Pxx_p.val;
+    mtxScalar *const pX_p = pUkf->prev.X_p.val;
+    mtxScalar *const px_p = pUkf->prev.x_p.val;
+    mtxScalar *const pDiag = pUkf->predict.Y_m.val;
+    const mtxScalar lambda = pUkf->par.lambda;
+    mtxDim xIdx, xTrIdx;
+    mtxDim sigmaIdx = 0;
+    mtxResultInfo mtxResult;
+    //Pxx_p holds the factor of a copy (UKF_SHARE_CHOL, repair) and is multiplied out by the restore
+    uint8_t product = 1;
+    //Pxx_p is copied to X_p for the repair and the restore without sigma points
+    const uint8_t backup = (0 != pUkf->health.recover || 0 == keep);
+
+    const mtxScalar gamma = (UKF_SIGMA_SIMPLEX == pUkf->par.scheme) ? (pUkf->par.alpha * MTX_SQRT(xLen + 1)) : MTX_SQRT(xLen + lambda);
+
+    //#1.1(begin/end) Calculate error covariance matrix square root
+    if (UKF_MODE_SQRT == pUkf->par.mode || UKF_SHARE_GET(pUkf, UKF_SHARE_CHOL)) {
+        //Pxx_p already holds lower Cholesky factor (square-root filter or UKF_SHARE_CHOL, e.g. the IMM mixing)
+        mtxResult = MTX_OPERATION_OK;
+    } else {
+        if (0 != backup) {
+            //X_p is free until the sigma points are drawn and holds the backup
+            mtx_kernel_cpy(pX_p, pPxx_p, (mtxIdx)xLen * xLen);
+        }
+
+        if (0 != keep) {
+            for (xIdx = 0; xIdx < xLen; xIdx++) {
+                pDiag[xIdx] = pPxx_p[xLen * xIdx + xIdx];
+            }
+            mtxResult = mtx_kernel_chol_lower_keep(pPxx_p, xLen);
+            product = 0;
+        } else {
+            mtxResult = mtx_kernel_chol_lower(pPxx_p, xLen);
+        }
+
+        if (MTX_OPERATION_OK != mtxResult) {
+            if (0 != pUkf->health.recover) {
+                product = 1;
+                mtx_kernel_cpy(pPxx_p, pX_p, (mtxIdx)xLen * xLen);
+                mtxResult = ukf_repair_chol(pUkf, pPxx_p, pX_p, xLen);
+            }
+            ukf_fault(pUkf, UKF_FAULT_SIGMAPOINT, mtxResult);
+        }
+    }
+
+    if (MTX_OPERATION_OK == mtxResult) {
+        //#1.2(begin) Calculate the sigma-points
+        for (xIdx = 0; xIdx < xLen; xIdx++) {
+            mtxScalar xMin = 0;
+            mtxScalar xMax = 0;
+            uint8_t xLimEnbl = 0;
+
+            if (NULL != pUkf->par.xLimEnbl.val && NULL != pUkf->par.xLim.val) {
+                xMin = pUkf->par.xLim.val[pUkf->par.xLim.ncol * xIdx + xMinIdx];
+                xMax = pUkf->par.xLim.val[pUkf->par.xLim.ncol * xIdx + xMaxIdx];
+                xLimEnbl = pUkf->par.xLimEnbl.val[xIdx];
+            }
+
+            //first column of sigma point matrix is equal of previous state value
+            pX_p[UKF_SIGMA_IDX(xLen, sLen, xIdx, sigmaIdx)] = ukf_state_limiter(px_p[xIdx], xMin, xMax, xLimEnbl);
+        }
+
+        for (xIdx = 0; xIdx < xLen && UKF_SIGMA_SIMPLEX == pUkf->par.scheme; xIdx++) {
+            mtxScalar xMin = 0;
+            mtxScalar xMax = 0;
+            uint8_t xLimEnbl = 0;
+            //sum(c(j)*L(xIdx,j)) for j >= sigmaIdx
+            mtxScalar tail = 0;
+
+            if (NULL != pUkf->par.xLimEnbl.val && NULL != pUkf->par.xLim.val) {
+                xMin = pUkf->par.xLim.val[pUkf->par.xLim.ncol * xIdx + xMinIdx];
+                xMax = pUkf->par.xLim.val[pUkf->par.xLim.ncol * xIdx + xMaxIdx];
+                xLimEnbl = pUkf->par.xLimEnbl.val[xIdx];
+            }
+
+            for (sigmaIdx = sLen - 1; sigmaIdx > 0; sigmaIdx--) {
+                mtxScalar dev = -tail;
+
+                if (sigmaIdx > 1) {
+                    //component j = sigmaIdx-1 is the last non zero one of Z(sigmaIdx)
+                    const mtxDim j = sigmaIdx - 1;
+                    const mtxScalar l = (j - 1 <= xIdx) ? pPxx_p[xLen * xIdx + (j - 1)] : 0;
+                    const mtxScalar term = gamma / MTX_SQRT((mtxScalar)j * (j + 1)) * l;
+
+                    dev += j * term;
+                    tail += term;
+                }
+                pX_p[UKF_SIGMA_IDX(xLen, sLen, xIdx, sigmaIdx)] = ukf_state_limiter(px_p[xIdx] + dev, xMin, xMax, xLimEnbl);
+            }
+        }
+
+        for (sigmaIdx = 1; sigmaIdx < sLen && UKF_SIGMA_SYMMETRIC == pUkf->par.scheme; sigmaIdx++) {
+            for (xIdx = 0; xIdx < xLen; xIdx++) {
+                mtxScalar xMin = 0;
+                mtxScalar xMax = 0;
+                uint8_t xLimEnbl = 0;
+
+                if (NULL != pUkf->par.xLimEnbl.val && NULL != pUkf->par.xLim.val) {
+                    xMin = pUkf->par.xLim.val[pUkf->par.xLim.ncol * xIdx + xMinIdx];
+                    xMax = pUkf->par.xLim.val[pUkf->par.xLim.ncol * xIdx + xMaxIdx];
+                    xLimEnbl = pUkf->par.xLimEnbl.val[xIdx];
+                }
+
+                if (sigmaIdx <= xLen) {
+                    const mtxScalar l = (sigmaIdx - 1 <= xIdx) ? pPxx_p[xLen * xIdx + (sigmaIdx - 1)] : 0;
+
+                    pX_p[UKF_SIGMA_IDX(xLen, sLen, xIdx, sigmaIdx)] = ukf_state_limiter(px_p[xIdx] + gamma * l, xMin, xMax, xLimEnbl);
+                } else {
+                    const mtxScalar l = (sigmaIdx - xLen - 1 <= xIdx) ? pPxx_p[xLen * xIdx + (sigmaIdx - xLen - 1)] : 0;
+
+                    pX_p[UKF_SIGMA_IDX(xLen, sLen, xIdx, sigmaIdx)] = ukf_state_limiter(px_p[xIdx] - gamma * l, xMin, xMax, xLimEnbl);
+                }
+            }
+        }
+        //#1.2(end) Calculate the sigma-points
+    }
+
+    if (MTX_OPERATION_OK != mtxResult && 0 != backup) {
+        //no sigma points, the (symmetrized) backup is Pxx_p again
+        mtx_kernel_cpy(pPxx_p, pX_p, (mtxIdx)xLen * xLen);
+    } else if (0 != keep && 0 != product) {
+        mtx_kernel_chol_product(pPxx_p, xLen);
+    } else if (0 != keep) {
+        //lower triangle from the untouched upper one, diagonal from its copy
+        for (xIdx = 0; xIdx < xLen; xIdx++) {
+            for (xTrIdx = 0; xTrIdx < xIdx; xTrIdx++) {
+                pPxx_p[xLen * xIdx + xTrIdx] = pPxx_p[xLen * xTrIdx + xIdx];
+            }
+            pPxx_p[xLen * xIdx + xIdx] = pDiag[xIdx];
+        }
+    }
+
+    return mtxResult;
+}
+
+/**
+ * @brief #2.1 Propagate sigma points [sigmaIdx, sigmaIdx + sigmaCnt) through prediction : X_m = f(X_p, u_p)
+ * Columns are independent, so disjoint ranges may run concurrently (tUKF.pExec).
+ * 
+ * @param pArg UKF - Working structure
+ * @param sigmaIdx First sigma point
+ * @param sigmaCnt Number of sigma points
+ */
+static void ukf_prop_state_range(void *pArg, mtxDim sigmaIdx, mtxDim sigmaCnt) {
+    tUKF *const pUkf = (tUKF *)pArg;
+    tUKFpar const *const pPar = (tUKFpar *)&pUkf->par;
+    const mtxDim sigmaEnd = sigmaIdx + sigmaCnt;
+    mtxDim sIdx, xIdx;
+
+    if (NULL != pUkf->predict.pFcnPredictVec) {
+        mtxScalar const *const pu_p = pUkf->prev.u_p.val;
+
+        for (sIdx = sigmaIdx; sIdx < sigmaEnd; sIdx++) {
+            //#2.1 Propagate each dense sigma-point in place
+            pUkf->predict.pFcnPredictVec(pu_p, &pUkf->predict.X_m.val[UKF_SIGMA_IDX(pPar->xLen, pPar->sLen, 0, sIdx)], pPar->dT);
+        }
+    } else if (NULL != pUkf->predict.pFcnPredictBatch) {
+        //#2.1 Propagate all sigma-points of the range through prediction in one call
+        pUkf->predict.pFcnPredictBatch(&pUkf->prev.u_p, &pUkf->prev.X_p, &pUkf->predict.X_m, sigmaIdx, sigmaCnt, pPar->dT);
+    } else if (NULL != pUkf->predict.pFcnPredict) {
+        for (sIdx = sigmaIdx; sIdx < sigmaEnd; sIdx++) {
+            for (xIdx = 0; xIdx < pPar->xLen; xIdx++) {
+                if (NULL != pUkf->predict.pFcnPredict[xIdx]) {
+                    //#2.1 Propagate each sigma-point through prediction
+                    pUkf->predict.pFcnPredict[xIdx](&pUkf->prev.u_p, &pUkf->prev.X_p, &pUkf->predict.X_m, sIdx, pPar->dT);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Step 2: Prediction Transformation (APPENDIX A:IMPLEMENTATION OF THE ADDITIVE NOISE UKF)
+ * #2.1 Propagate each sigma-point through prediction  : X_m = f(X_p, u_p)
+ * #2.2 Calculate mean of predicted state              : x_m = sum(Wm(i)*X_m(i)) , i=0,..2L
+ * With an executor the sigma points are propagated concurrently, the mean is always
+ * accumulated in sigma point order, so the result does not depend on the executor.
+ * 
+ * @param pUkf UKF - Working structure with reference to all in,out,states,par
+ * @param xLen Number of states
+ * @param sigmaLen Number of sigma points
+ */
+UKF_INLINE void ukf_mean_pred_state(tUKF *pUkf, const mtxDim xLen, const mtxDim sigmaLen) {
+    if (NULL != pUkf->pExec) {
+        pUkf->pExec->fcnParallel(pUkf->pExec->pCtx, &ukf_prop_state_range, pUkf, sigmaLen);
+    } else {
+        ukf_prop_state_range(pUkf, 0, sigmaLen);
+    }
+
+    //#2.2 Calculate mean of predicted state
+    ukf_sigma_mean(pUkf->predict.X_m.val, pUkf->par.Wm.val, pUkf->predict.x_m.val, xLen, sigmaLen, NULL);
+}
+
+/**
+ * @brief #2.3 Calculate covariance of predicted state : P_m = Q + sum(Wc(i)*(X_m(i)-x_m)*(X_m(i)-x_m)') P(k|k-1)
+ * In UKF_MODE_SQRT the lower Cholesky factor of P_m is calculated instead.
+ * 
+ * @param pUkf UKF - Working structure with reference to all in,out,states,par
+ * @param xLen Number of states
+ * @param sigmaLen Number of sigma points
+ */
+UKF_INLINE void ukf_cov_pred_state(tUKF *pUkf, const mtxDim xLen, const mtxDim sigmaLen) {
+    tUKFpar const *const pPar = (tUKFpar *)&pUkf->par;
+    mtxScalar const *const pWc = pPar->Wc.val;
+    mtxScalar const *const pX_m = pUkf->predict.X_m.val;
+    mtxScalar *const pP_m = pUkf->predict.P_m.val;
+    mtxScalar *const px_m = pUkf->predict.x_m.val;
+    mtxDim sigmaIdx, xIdx, xTrIdx;
+
+    if (UKF_MODE_SQRT == pPar->mode) {
+        //#2.3 Calculate square root of predicted state covariance: S_m = qr([sqrt(Wc)*(X_m-x_m), sqrt(Q)])
+        mtxResultInfo mtxResult = ukf_sqrt_covariance(pUkf, &pUkf->predict.X_m, &pUkf->predict.x_m, &pPar->Sqxx, NULL, &pUkf->predict.P_m);
+
+        if (MTX_OPERATION_OK != mtxResult) {
+            if (0 != pUkf->health.recover) {
+                mtxResult = ukf_repair_factor(pUkf, pP_m, xLen);
+            }
+            ukf_fault(pUkf, UKF_FAULT_PRED_COV, mtxResult);
+        }
+    } else {
+        //P(k|k-1) = Q(k-1)
+        mtx_kernel_cpy(pP_m, pPar->Qxx.val, (mtxIdx)xLen * xLen);
+
+        for (sigmaIdx = 0; sigmaIdx < sigmaLen; sigmaIdx++) {
+            for (xIdx = 0; xIdx < xLen; xIdx++) {
+                for (xTrIdx = 0; xTrIdx <= xIdx; xTrIdx++) {
+                    mtxScalar term1 = (pX_m[UKF_SIGMA_IDX(xLen, sigmaLen, xIdx, sigmaIdx)] - px_m[xIdx]);
+                    mtxScalar term2 = (pX_m[UKF_SIGMA_IDX(xLen, sigmaLen, xTrIdx, sigmaIdx)] - px_m[xTrIdx]);
+
+                    //#2.3 Calculate covariance of predicted state
+                    //Perform multiplication with accumulation for each covariance matrix index
+                    pP_m[xLen * xIdx + xTrIdx] += pWc[sigmaIdx] * term1 * term2;
+                }
+            }
+        }
+
+        //only lower triangle of P_m was accumulated
+        ukf_sym_mirror(pP_m, xLen);
+    }
+}
+
+/**
+ * @brief Step 2': Linear prediction (tUkfMatrix.F_state_transition assigned)
+ * #2.1' x(k|k-1) = F*x(k-1) + B*u(k-1), clamped by the state limiters
+ * #2.2' P(k|k-1) = F*P(k-1)*F' + Q, in UKF_MODE_SQRT S(k|k-1) = qr([F*S(k-1), sqrt(Q)])
+ * The sigma point matrix is not used by the prediction and holds F*P and the new state
+ * as temporal results.
+ * 
+ * @param pUkf UKF - Working structure with reference to all in,out,states,par
+ * @param xLen Number of states
+ */
+UKF_INLINE void ukf_linear_pred_state(tUKF *pUkf, const mtxDim xLen) {
+    tUKFpar const *const pPar = (tUKFpar *)&pUkf->par;
+    mtxScalar const *const pF = pPar->Fxx.val;
+    mtxScalar *const pP_m = pUkf->predict.P_m.val;
+    mtxScalar *const px_m = pUkf->predict.x_m.val;
+    mtxScalar *const pFP = pUkf->predict.X_m.val;
+    mtxScalar *const px = &pFP[(mtxIdx)xLen * xLen];
+    mtxDim xIdx, xTrIdx, k;
+
+    //#2.1' x(k|k-1) = F*x(k-1) + B*u(k-1), x_m shares memory with x_p
+    mtx_kernel_mul(pF, px_m, px, xLen, xLen, 1);
+
+    if (NULL != pPar->Bxu.val) {
+        const mtxDim uLen = pPar->Bxu.ncol;
+
+        for (xIdx = 0; xIdx < xLen; xIdx++) {
+            for (k = 0; k < uLen; k++) {
+                px[xIdx] += pPar->Bxu.val[uLen * xIdx + k] * pUkf->prev.u_p.val[k];
+            }
+        }
+    }
+
+    for (xIdx = 0; xIdx < xLen; xIdx++) {
+        mtxScalar xMin = 0;
+        mtxScalar xMax = 0;
+        uint8_t xLimEnbl = 0;
+
+        if (NULL != pPar->xLimEnbl.val && NULL != pPar->xLim.val) {
+            xMin = pPar->xLim.val[pPar->xLim.ncol * xIdx + xMinIdx];
+            xMax = pPar->xLim.val[pPar->xLim.ncol * xIdx + xMaxIdx];
+            xLimEnbl = pPar->xLimEnbl.val[xIdx];
+        }
+
+        //state limiters apply to x(k|k-1) like to the sigma points of the unscented prediction
+        px_m[xIdx] = ukf_state_limiter(px[xIdx], xMin, xMax, xLimEnbl);
+    }
+
+    if (UKF_MODE_SQRT == pPar->mode) {
+        mtxScalar *const pA = pUkf->update.Acmp.val;
+        tMatrix Acmp = {xLen, 2 * xLen, pA};
+
+        for (xIdx = 0; xIdx < xLen; xIdx++) {
+            mtxScalar *const pArow = &pA[2 * xLen * xIdx];
+
+            for (xTrIdx = 0; xTrIdx < xLen; xTrIdx++) {
+                mtxScalar sum = 0;
+
+                //S(k-1) is lower triangular
+                for (k = xTrIdx; k < xLen; k++) {
+                    sum += pF[xLen * xIdx + k] * pP_m[xLen * k + xTrIdx];
+                }
+                pArow[xTrIdx] = sum;
+                pArow[xLen + xTrIdx] = pPar->Sqxx.val[xLen * xIdx + xTrIdx];
+            }
+        }
+
+        //#2.2' S(k|k-1) = qr([F*S(k-1), sqrt(Q)])
+        (void)mtx_qr_lower(&Acmp, &pUkf->predict.P_m);
+    } else {
+        mtx_kernel_mul(pF, pP_m, pFP, xLen, xLen, xLen);
+
+        //#2.2' P(k|k-1) = Q + (F*P)*F', lower triangle and mirror
+        for (xIdx = 0; xIdx < xLen; xIdx++) {
+            for (xTrIdx = 0; xTrIdx <= xIdx; xTrIdx++) {
+                mtxScalar sum = pPar->Qxx.val[xLen * xIdx + xTrIdx];
+
+                for (k = 0; k < xLen; k++) {
+                    sum += pFP[xLen * xIdx + k] * pF[xLen * xTrIdx + k];
+                }
+                pP_m[xLen * xIdx + xTrIdx] = sum;
+            }
+        }
+        ukf_sym_mirror(pP_m, xLen);
+    }
+}
+
+/**
+ * @brief #3.1 Propagate sigma points [sigmaIdx, sigmaIdx + sigmaCnt) through observation : Y_m = h(X_m, u)
+ * Only measurements marked in input.yValid are observed by the per-output callbacks.
+ * 
+ * @param pArg UKF - Working structure
+ * @param sigmaIdx First sigma point
+ * @param sigmaCnt Number of sigma points
+ */
+static void ukf_prop_output_range(void *pArg, mtxDim sigmaIdx, mtxDim sigmaCnt) {
+    tUKF *const pUkf = (tUKF *)pArg;
+    uint8_t const *const pValid = pUkf->input.yValid.val;
+    const mtxDim xLen = pUkf->par.xLen;
+    const mtxDim yLen = pUkf->par.yLen;
+    const mtxDim sigmaLen = pUkf->par.sLen;
+    const mtxDim sigmaEnd = sigmaIdx + sigmaCnt;
+    mtxDim sIdx, yIdx;
+
+    (void)xLen;
+    (void)sigmaLen;
+
+    if (NULL != pUkf->predict.pFcnObservVec) {
+        mtxScalar const *const pu = pUkf->input.u.val;
+
+        for (sIdx = sigmaIdx; sIdx < sigmaEnd; sIdx++) {
+            //#3.1 Propagate each dense sigma-point through observation
+            pUkf->predict.pFcnObservVec(pu, &pUkf->predict.X_m.val[UKF_SIGMA_IDX(xLen, sigmaLen, 0, sIdx)],
+                                        &pUkf->predict.Y_m.val[UKF_SIGMA_IDX(yLen, sigmaLen, 0, sIdx)]);
+        }
+    } else if (NULL != pUkf->predict.pFcnObservBatch) {
+        //#3.1 Propagate all sigma-points of the range through observation in one call
+        pUkf->predict.pFcnObservBatch(&pUkf->input.u, &pUkf->predict.X_m, &pUkf->predict.Y_m, sigmaIdx, sigmaCnt);
+    } else {
+        for (sIdx = sigmaIdx; sIdx < sigmaEnd; sIdx++) {
+            for (yIdx = 0; yIdx < yLen; yIdx++) {
+                if (!UKF_Y_VALID(pValid, yIdx)) {
+                    //measurement not present in this step
+                } else if (NULL != pUkf->predict.pFcnObserv && pUkf->predict.pFcnObserv[yIdx] != NULL) {
+                    //#3.1 Propagate each sigma-point through observation
+                    pUkf->predict.pFcnObserv[yIdx](&pUkf->input.u, &pUkf->predict.X_m, &pUkf->predict.Y_m, sIdx);
+                } else {
+                    //assign 0 if observation function is not specified
+                    pUkf->predict.Y_m.val[UKF_SIGMA_IDX(yLen, sigmaLen, yIdx, sIdx)] = 0;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Step 3: Observation Transformation (APPENDIX A:IMPLEMENTATION OF THE ADDITIVE NOISE UKF)
+ * #3.1 Propagate each sigma-point through observation : Y_m = h(X_m, u)
+ * #3.2 Calculate mean of predicted output             : y_m = sum(Wm(i)*Y_m(i))
+ * Only measurements marked in input.yValid are observed, y_m of missing ones is 0.
+ * Sigma points are propagated concurrently if an executor is assigned (see ukf_mean_pred_state).
+ * 
+ * @param pUkf UKF - Working structure with reference to all in,out,states,par
+ * @param yLen Number of measurements
+ * @param sigmaLen Number of sigma points
+ */
+UKF_INLINE void ukf_mean_pred_output(tUKF *pUkf, const mtxDim yLen, const mtxDim sigmaLen) {
+    if (NULL != pUkf->pExec) {
+        pUkf->pExec->fcnParallel(pUkf->pExec->pCtx, &ukf_prop_output_range, pUkf, sigmaLen);
+    } else {
+        ukf_prop_output_range(pUkf, 0, sigmaLen);
+    }
+
+    //#3.2 Calculate mean of predicted output
+    ukf_sigma_mean(pUkf->predict.Y_m.val, pUkf->par.Wm.val, pUkf->predict.y_m.val, yLen, sigmaLen, pUkf->input.yValid.val);
+}
+
+/**
+ * @brief # 3.3 Calculate covariance of predicted output       : Pyy = R + sum(Wc(i)*(Y_m(i)-y_m)*(Y_m(i)-y_m)')
+ *        # 3.4 Calculate cross-covariance of state and output : Pxy = sum(Wc(i)*(X_m(i)-x_m)*(Y_m(i)-y_m)')
+ * In UKF_MODE_STANDARD X_m and Y_m are centered in place once, then all statistics
+ * are the lower triangle of the weighted product D*diag(Wc)*D' of the stacked
+ * block D = [X_m; Y_m], with every entry a weighted dot product of two contiguous
+ * sigma rows (UKF_SIGMA_MAJOR: sum of weighted rank-1 updates of contiguous sigma points). If the predict stage deferred #2.3, the [X_m; X_m] block gives
+ * P_m = Q + sum(Wc(i)*(X_m(i)-x_m)*(X_m(i)-x_m)') in the same sweep.
+ * Rows and columns of missing measurements are replaced with the identity in Pyy
+ * (Sy in UKF_MODE_SQRT) and with zero in Pxy, so their gain is zero.
+ * 
+ * @param pUkf UKF - Working structure with reference to all in,out,states,par
+ * @param xLen Number of states
+ * @param yLen Number of measurements
+ * @param sigmaLen Number of sigma points
+ * @param withPxx Also calculate P_m (UKF_MODE_STANDARD only)
+ */
+UKF_INLINE void ukf_calc_covariances(tUKF *pUkf, const mtxDim xLen, const mtxDim yLen, const mtxDim sigmaLen, const uint8_t withPxx) {
+    tUKFpar const *const pPar = (tUKFpar *)&pUkf->par;
+    mtxScalar const *const pWc = pPar->Wc.val;
+    mtxScalar *const pX_m = pUkf->predict.X_m.val;
+    mtxScalar *const pY_m = pUkf->predict.Y_m.val;
+    mtxScalar *const pP_m = pUkf->predict.P_m.val;
+    mtxScalar *const pPyy = pUkf->update.Pyy.val;
+    mtxScalar *const pPxy = pUkf->update.Pxy.val;
+    mtxScalar *const px_m = pUkf->predict.x_m.val;
+    mtxScalar *py_m = pUkf->predict.y_m.val;
+    uint8_t const *const pValid = pUkf->input.yValid.val;
+    mtxDim sigmaIdx, xIdx, xTrIdx, yIdx, yTrIdx;
+
+    if (UKF_MODE_STANDARD == pPar->mode) {
+        //center sigma points: X_m = X_m - x_m, Y_m = Y_m - y_m (missing measurements are not observed)
+        ukf_sigma_center(pX_m, px_m, xLen, sigmaLen, NULL);
+        ukf_sigma_center(pY_m, py_m, yLen, sigmaLen, pValid);
+
+#if defined(UKF_SIGMA_MAJOR)
+        //D*diag(Wc)*D' as sum of weighted rank-1 updates of contiguous sigma points
+        for (xIdx = 0; xIdx < xLen; xIdx++) {
+            for (xTrIdx = 0; xTrIdx <= xIdx && 0 != withPxx; xTrIdx++) {
+                pP_m[xLen * xIdx + xTrIdx] = pPar->Qxx.val[xLen * xIdx + xTrIdx];
+            }
+            for (yIdx = 0; yIdx < yLen; yIdx++) {
+                pPxy[yLen * xIdx + yIdx] = 0;
+            }
+        }
+
+        for (yIdx = 0; yIdx < yLen; yIdx++) {
+            for (yTrIdx = 0; yTrIdx <= yIdx; yTrIdx++) {
+                if (UKF_Y_VALID(pValid, yIdx) && UKF_Y_VALID(pValid, yTrIdx)) {
+                    pPyy[yLen * yIdx + yTrIdx] = pPar->Ryy0.val[yLen * yIdx + yTrIdx];
+                } else {
+                    //decouple missing measurement: unit variance without correlation
+                    pPyy[yLen * yIdx + yTrIdx] = (yIdx == yTrIdx) ? MTX_C(1.0) : MTX_C(0.0);
+                }
+            }
+        }
+
+        //deviations of missing measurements are cleared, they add nothing to the decoupled rows
+        for (sigmaIdx = 0; sigmaIdx < sigmaLen; sigmaIdx++) {
+            mtxScalar const *const pDx = &pX_m[UKF_SIGMA_IDX(xLen, sigmaLen, 0, sigmaIdx)];
+            mtxScalar const *const pDy = &pY_m[UKF_SIGMA_IDX(yLen, sigmaLen, 0, sigmaIdx)];
+            const mtxScalar w = pWc[sigmaIdx];
+
+            for (xIdx = 0; xIdx < xLen; xIdx++) {
+                const mtxScalar wdx = w * pDx[xIdx];
+                mtxScalar *const pPxyRow = &pPxy[yLen * xIdx];
+
+                if (0 != withPxx) {
+                    mtxScalar *const pP_mRow = &pP_m[xLen * xIdx];
+
+                    for (xTrIdx = 0; xTrIdx <= xIdx; xTrIdx++) {
+                        //#2.3 P(k|k-1) = Q(k-1) + sum(Wc*dX*dX')
+                        pP_mRow[xTrIdx] += wdx * pDx[xTrIdx];
+                    }
+                }
+                for (yIdx = 0; yIdx < yLen; yIdx++) {
+                    //#3.4 Calculate cross-covariance of state and output
+                    pPxyRow[yIdx] += wdx * pDy[yIdx];
+                }
+            }
+
+            for (yIdx = 0; yIdx < yLen; yIdx++) {
+                const mtxScalar wdy = w * pDy[yIdx];
+                mtxScalar *const pPyyRow = &pPyy[yLen * yIdx];
+
+                for (yTrIdx = 0; yTrIdx <= yIdx; yTrIdx++) {
+                    //#3.3 Pyy(k|k-1) = R(k) + sum(Wc*dY*dY')
+                    pPyyRow[yTrIdx] += wdy * pDy[yTrIdx];
+                }
+            }
+        }
+#else
+        for (xIdx = 0; xIdx < xLen && 0 != withPxx; xIdx++) {
+            mtxScalar const *const pDx = &pX_m[sigmaLen * xIdx];
+
+            for (xTrIdx = 0; xTrIdx <= xIdx; xTrIdx++) {
+                //#2.3 P(k|k-1) = Q(k-1) + sum(Wc*dX*dX')
+                pP_m[xLen * xIdx + xTrIdx] = pPar->Qxx.val[xLen * xIdx + xTrIdx] + mtx_kernel_wdot(pDx, &pX_m[sigmaLen * xTrIdx], pWc, sigmaLen);
+            }
+        }
+
+        for (yIdx = 0; yIdx < yLen; yIdx++) {
+            mtxScalar const *const pDy = &pY_m[sigmaLen * yIdx];
+
+            for (xIdx = 0; xIdx < xLen; xIdx++) {
+                //#3.4 Calculate cross-covariance of state and output
+                pPxy[yLen * xIdx + yIdx] = UKF_Y_VALID(pValid, yIdx) ? mtx_kernel_wdot(&pX_m[sigmaLen * xIdx], pDy, pWc, sigmaLen) : 0;
+            }
+
+            for (yTrIdx = 0; yTrIdx <= yIdx; yTrIdx++) {
+                if (UKF_Y_VALID(pValid, yIdx) && UKF_Y_VALID(pValid, yTrIdx)) {
+                    //#3.3 Pyy(k|k-1) = R(k) + sum(Wc*dY*dY')
+                    pPyy[yLen * yIdx + yTrIdx] = pPar->Ryy0.val[yLen * yIdx + yTrIdx] + mtx_kernel_wdot(pDy, &pY_m[sigmaLen * yTrIdx], pWc, sigmaLen);
+                } else {
+                    //decouple missing measurement: unit variance without correlation
+                    pPyy[yLen * yIdx + yTrIdx] = (yIdx == yTrIdx) ? MTX_C(1.0) : MTX_C(0.0);
+                }
+            }
+        }
+#endif
+
+        //only lower triangles of P_m and Pyy were evaluated
+        if (0 != withPxx) {
+            ukf_sym_mirror(pP_m, xLen);
+        }
+        ukf_sym_mirror(pPyy, yLen);
+    } else {
+        //#3.3 Calculate square root of output covariance: Sy = qr([sqrt(Wc)*(Y_m-y_m), sqrt(R)])
+        mtxResultInfo mtxResult = ukf_sqrt_covariance(pUkf, &pUkf->predict.Y_m, &pUkf->predict.y_m, &pPar->Sryy, pValid, &pUkf->update.Pyy);
+
+        if (MTX_OPERATION_OK != mtxResult) {
+            if (0 != pUkf->health.recover) {
+                mtxResult = ukf_repair_factor(pUkf, pPyy, yLen);
+            }
+            ukf_fault(pUkf, UKF_FAULT_OUTPUT_COV, mtxResult);
+        }
+
+        for (xIdx = 0; xIdx < xLen; xIdx++) {
+            for (yIdx = 0; yIdx < yLen; yIdx++) {
+                pPxy[yLen * xIdx + yIdx] = 0;
+            }
+        }
+
+        for (sigmaIdx = 0; sigmaIdx < sigmaLen; sigmaIdx++) {
+            for (xIdx = 0; xIdx < xLen; xIdx++) {
+                for (yTrIdx = 0; yTrIdx < yLen; yTrIdx++) {
+                    if (UKF_Y_VALID(pValid, yTrIdx)) {
+                        mtxScalar term1 = (pX_m[UKF_SIGMA_IDX(xLen, sigmaLen, xIdx, sigmaIdx)] - px_m[xIdx]);
+                        mtxScalar term2 = (pY_m[UKF_SIGMA_IDX(yLen, sigmaLen, yTrIdx, sigmaIdx)] - py_m[yTrIdx]);
+
+                        //#3.4 Calculate cross-covariance of state and output
+                        pPxy[yLen * xIdx + yTrIdx] += pWc[sigmaIdx] * term1 * term2;
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Step 4: Measurement Update (APPENDIX A:IMPLEMENTATION OF THE ADDITIVE NOISE UKF)
+ *        #4.1 Calculate Kalman gain   : K = Pxy*inv(Pyy)
+ *        #4.2 Update state estimate   : x = x_m + K(y - y_m)
+ *        #4.3 Update error covariance : Pxx = Pxx_m - K*Pyy*K' = Pxx_m - K*Pxy'
+ * By default the gain is solved with the Cholesky factorization Pyy = L*L' (Pyy is
+ * overwritten by L). Define UKF_GAIN_GAUSS_JORDAN to solve it with Gauss-Jordan
+ * elimination of Pyy instead (Pyy is reduced to identity). Both keep Pxy, so the
+ * correction is the symmetric rank-yLen update K*Pxy', its lower triangle is
+ * subtracted from P_m and mirrored.
+ * In UKF_MODE_SQRT Pyy already holds Sy and the factor of P_m is downdated
+ * with every column of U = K*Sy.
+ * The measurement update is skipped (UKF_FAULT_GAIN) if Pyy is not positive definite
+ * (UKF_GAIN_GAUSS_JORDAN: singular or with a non positive variance), unless
+ * tUKF.health.recover repairs it (UKF_MODE_STANDARD only with the backup in Pyy_cpy).
+ * 
+ * @param pUkf UKF - Working structure with reference to all in,out,states,par
+ * @param xLen Number of states
+ * @param yLen Number of measurements
+ */
+UKF_INLINE void ukf_meas_update(tUKF *pUkf, const mtxDim xLen, const mtxDim yLen) {
+    tUKFupdate *const pUpdate = (tUKFupdate *)&pUkf->update;
+    //lower Cholesky factor of Pyy for the likelihood of tUKF.pShare
+    mtxScalar const *pLik = pUpdate->Pyy.val;
+    //Pyy is kept for its repair if a backup buffer is assigned
+    mtxScalar *const pBak = (0 != pUkf->health.recover) ? pUpdate->Pyy_cpy.val : NULL;
+    mtxResultInfo mtxResult;
+    //the first factorization (or elimination) of Pyy failed
+    uint8_t failed = 0;
+    mtxDim yIdx;
 
     //#4.1(begin) Calculate Kalman gain:
-    (void)mtx_identity(&pUpdate->Iyy);
+    mtx_kernel_cpy(pUpdate->K.val, pUpdate->Pxy.val, (mtxIdx)xLen * yLen);
+
+    if (UKF_MODE_SQRT == pUkf->par.mode) {
+        //Sy with a zero (or invalid) diagonal is singular
+        mtxResult = MTX_OPERATION_OK;
+        for (yIdx = 0; yIdx < yLen; yIdx++) {
+            if (!(pUpdate->Pyy.val[yLen * yIdx + yIdx] > 0)) {
+                mtxResult = MTX_SINGULAR;
+                failed = 1;
+            }
+        }
+
+        if (0 != failed && 0 != pUkf->health.recover) {
+            mtxResult = ukf_repair_factor(pUkf, pUpdate->Pyy.val, yLen);
+        }
+
+        if (MTX_OPERATION_OK == mtxResult) {
+            //Kgain = Pxy * inv(Sy*Sy'), Pyy = Sy
+            mtxResult = mtx_chol_subst(&pUpdate->Pyy, &pUpdate->K);
+        }
+    } else {
+        if (NULL != pBak) {
+            mtx_kernel_cpy(pBak, pUpdate->Pyy.val, (mtxIdx)yLen * yLen);
+        }
+#if defined(UKF_GAIN_GAUSS_JORDAN)
+        if (NULL != pUkf->pShare) {
+            //elimination reduces Pyy to identity, the likelihood factorizes a copy
+            mtx_kernel_cpy(pUkf->pShare->pW, pUpdate->Pyy.val, (mtxIdx)yLen * yLen);
+            pLik = (MTX_OPERATION_OK == mtx_kernel_chol_lower(pUkf->pShare->pW, yLen)) ? pUkf->pShare->pW : NULL;
+        }
+
+        //elimination detects only a singular Pyy, a non positive variance is the cheap test of definiteness
+        mtxResult = MTX_OPERATION_OK;
+        for (yIdx = 0; yIdx < yLen; yIdx++) {
+            if (!(pUpdate->Pyy.val[yLen * yIdx + yIdx] > 0)) {
+                mtxResult = MTX_NOT_POS_DEFINED;
+            }
+        }
+
+        if (MTX_OPERATION_OK == mtxResult) {
+            //Kgain = Pxy * inv(Pyy), Pyy = I
+            mtxResult = mtx_gj_subst(&pUpdate->Pyy, &pUpdate->K);
+        }
+        failed = (MTX_OPERATION_OK != mtxResult);
+
+        if (0 != failed && NULL != pBak) {
+            //the repaired Pyy is factorized, the gain is solved with its factor, Pyy = L
+            mtx_kernel_cpy(pUpdate->Pyy.val, pBak, (mtxIdx)yLen * yLen);
+            mtx_kernel_cpy(pUpdate->K.val, pUpdate->Pxy.val, (mtxIdx)xLen * yLen);
+            mtxResult = ukf_repair_chol(pUkf, pUpdate->Pyy.val, pBak, yLen);
+            pLik = pUpdate->Pyy.val;
 
-    (void)mtx_cpy(&pUpdate->Pyy_cpy, &pUpdate->Pyy);
+            if (MTX_OPERATION_OK == mtxResult) {
+                mtx_kernel_chol_subst(pUpdate->Pyy.val, pUpdate->K.val, xLen, yLen);
+            }
+        }
+#else
+        //Kgain = Pxy * inv(L*L'), Pyy = L
+        mtxResult = mtx_kernel_chol_lower(pUpdate->Pyy.val, yLen);
+        failed = (MTX_OPERATION_OK != mtxResult);
+
+        if (0 != failed && NULL != pBak) {
+            mtx_kernel_cpy(pUpdate->Pyy.val, pBak, (mtxIdx)yLen * yLen);
+            mtxResult = ukf_repair_chol(pUkf, pUpdate->Pyy.val, pBak, yLen);
+        }
 
-    //inv(Pyy_cpy)
-    (void)mtx_inv(&pUpdate->Pyy_cpy, &pUpdate->Iyy);
+        if (MTX_OPERATION_OK == mtxResult) {
+            mtx_kernel_chol_subst(pUpdate->Pyy.val, pUpdate->K.val, xLen, yLen);
+        }
+#endif
+    }
 
-    //Kgain = Pxy * inv(Pyy)
-    (void)mtx_mul(&pUpdate->Pxy, &pUpdate->Iyy, &pUpdate->K);
+    if (0 != failed || MTX_OPERATION_OK != mtxResult) {
+        ukf_fault(pUkf, UKF_FAULT_GAIN, mtxResult);
+    }
     //#4.1(end) Calculate Kalman gain:
 
-    //#4.2(begin) Update state estimate
-    // y = y - y_m
-    (void)mtx_sub(&pUkf->input.y, &pUkf->predict.y_m);
+    if (MTX_OPERATION_OK == mtxResult) {
+        if (NULL != pUkf->pShare && NULL != pLik) {
+            ukf_innov_lik(pUkf, pLik, yLen);
+        }
+
+        //#4.2(begin) Update state estimate
+        // y = y - y_m
+        UKF_SUB(&pUkf->input.y, &pUkf->predict.y_m, yLen);
+
+        if (NULL != pUkf->input.yValid.val) {
+            for (yIdx = 0; yIdx < yLen; yIdx++) {
+                if (0 == pUkf->input.yValid.val[yIdx]) {
+                    //missing measurement has zero gain, clear possibly invalid sample
+                    pUkf->input.y.val[yIdx] = 0;
+                }
+            }
+        }
+
+        // x = x_m + K*(y - y_m)
+        mtx_kernel_mul_vec(pUkf->predict.x_m.val, pUpdate->K.val, pUkf->input.y.val, MTX_C(1.0), MTX_C(1.0), xLen, yLen);
+        //#4.2(end) Update state estimate
+
+        //#4.3(begin).Update error covariance
+        if (UKF_MODE_SQRT == pUkf->par.mode) {
+            mtxScalar *const px_corr = pUpdate->x_corr.val;
+            mtxDim xIdx;
+
+            //use Pxy for temporal result from multiplication
+            //U = K*Sy
+            (void)mtx_mul(&pUpdate->K, &pUpdate->Pyy, &pUpdate->Pxy);
+
+            //S = cholupdate(S_m, U(:,yIdx), -1), use x_corr as column buffer
+            for (yIdx = 0; yIdx < yLen; yIdx++) {
+                for (xIdx = 0; xIdx < xLen; xIdx++) {
+                    px_corr[xIdx] = pUpdate->Pxy.val[yLen * xIdx + yIdx];
+                }
+                mtxResult = mtx_chol_update(&pUkf->predict.P_m, &pUpdate->x_corr, -MTX_C(1.0));
+
+                if (MTX_OPERATION_OK != mtxResult) {
+                    //the repair uses Acmp, the downdate of the column is retried on the repaired factor,
+                    //x_corr was overwritten by the failed downdate. A failed retry leaves the column out
+                    //(S stays the larger repaired factor) and the fault is reported as not repaired.
+                    if (0 != pUkf->health.recover) {
+                        mtxResult = ukf_repair_factor(pUkf, pUkf->predict.P_m.val, xLen);
+                    }
+                    if (MTX_OPERATION_OK == mtxResult) {
+                        for (xIdx = 0; xIdx < xLen; xIdx++) {
+                            px_corr[xIdx] = pUpdate->Pxy.val[yLen * xIdx + yIdx];
+                        }
+                        mtxResult = mtx_chol_update(&pUkf->predict.P_m, &pUpdate->x_corr, -MTX_C(1.0));
+                    }
+                    ukf_fault(pUkf, UKF_FAULT_COV_UPDATE, mtxResult);
+                }
+            }
+        } else {
+            //Pxx = P_m - K*Pxy', K*Pxy' = Pxy*inv(Pyy)*Pxy' is symmetric
+            mtx_kernel_sub_mul_src2tr_sym(pUkf->predict.P_m.val, pUpdate->K.val, pUpdate->Pxy.val, xLen, yLen);
+        }
+        //#4.3(end).Update error covariance
+    }
+}
+
+/**
+ * @brief Step 4: Sequential measurement update (UKF_UPDATE_SEQUENTIAL)
+ * Measurements are applied one at a time as scalar updates:
+ *        s = Pyy(j,j), k = Pxy(:,j)/s
+ *        x = x + k*e(j), Pxx = Pxx - k*s*k'
+ * and the statistics of the remaining measurements are conditioned on measurement j
+ *        e(i) -= Pyy(i,j)/s*e(j), Pxy(:,i) -= k*Pyy(j,i), Pyy(i,l) -= Pyy(i,j)*Pyy(j,l)/s
+ * so the result is equal to the batch update for any Pyy, without matrix inversion.
+ * Column j of K receives gain k of step j, the corrections are accumulated in x_m.
+ * Only lower triangle of Pyy is used, a missing measurement or one with s <= 0 is skipped,
+ * the latter is reported as UKF_FAULT_GAIN.
+ * 
+ * @param pUkf UKF - Working structure with reference to all in,out,states,par
+ * @param xLen Number of states
+ * @param yLen Number of measurements
+ */
+UKF_INLINE void ukf_meas_update_seq(tUKF *pUkf, const mtxDim xLen, const mtxDim yLen) {
+    tUKFupdate *const pUpdate = (tUKFupdate *)&pUkf->update;
+    mtxScalar *const pPyy = pUpdate->Pyy.val;
+    mtxScalar *const pPxy = pUpdate->Pxy.val;
+    mtxScalar *const pK = pUpdate->K.val;
+    mtxScalar *const pe = pUkf->input.y.val;
+    mtxScalar *const px_m = pUkf->predict.x_m.val;
+    mtxScalar *const pP_m = pUkf->predict.P_m.val;
+    mtxScalar const *const py_m = pUkf->predict.y_m.val;
+    uint8_t const *const pValid = pUkf->input.yValid.val;
+    mtxScalar logLik = 0;
+    uint8_t lik = 1;
+    mtxDim xIdx, xTrIdx, yIdx, yTrIdx, yRemIdx;
+
+    // e = y - y_m, missing measurements are not used
+    for (yIdx = 0; yIdx < yLen; yIdx++) {
+        pe[yIdx] = UKF_Y_VALID(pValid, yIdx) ? (pe[yIdx] - py_m[yIdx]) : 0;
+    }
+
+    for (yIdx = 0; yIdx < yLen; yIdx++) {
+        const mtxScalar s = pPyy[yLen * yIdx + yIdx];
+
+        if (UKF_Y_VALID(pValid, yIdx) && s > 0) {
+            const mtxScalar sInv = MTX_C(1.0) / s;
+            const mtxScalar e = pe[yIdx];
+
+            //conditional innovations are independent: log N(e; 0, Pyy) = sum(log N(e(j); 0, s(j)))
+            logLik -= MTX_C(0.5) * (e * e * sInv + MTX_LOG(s) + UKF_LOG_2PI);
+
+            for (xIdx = 0; xIdx < xLen; xIdx++) {
+                //#4.1 scalar gain k = Pxy(:,j)/s
+                pK[yLen * xIdx + yIdx] = pPxy[yLen * xIdx + yIdx] * sInv;
+
+                //#4.2 x = x + k*e(j)
+                px_m[xIdx] += pK[yLen * xIdx + yIdx] * e;
+            }
+
+            //#4.3 Pxx = Pxx - k*Pxy(:,j)', lower triangle and mirror
+            for (xIdx = 0; xIdx < xLen; xIdx++) {
+                for (xTrIdx = 0; xTrIdx <= xIdx; xTrIdx++) {
+                    pP_m[xLen * xIdx + xTrIdx] -= pK[yLen * xIdx + yIdx] * pPxy[yLen * xTrIdx + yIdx];
+                    pP_m[xLen * xTrIdx + xIdx] = pP_m[xLen * xIdx + xTrIdx];
+                }
+            }
 
-    // K*(y - y_m) states correction
-    (void)mtx_mul(&pUpdate->K, &pUkf->input.y, &pUkf->update.x_corr);
+            //condition remaining measurements on measurement j
+            for (yRemIdx = yIdx + 1; yRemIdx < yLen; yRemIdx++) {
+                //Pyy and Pxy of missing measurements are decoupled, updating them is harmless
+                const mtxScalar pyj = pPyy[yLen * yRemIdx + yIdx];
+                const mtxScalar f = pyj * sInv;
 
-    // x = x_m + K*(y - y_m)
-    (void)mtx_add(&pUkf->predict.x_m, &pUkf->update.x_corr);
-    //#4.2(end) Update state estimate
+                pe[yRemIdx] -= f * e;
 
-    //#4.3(begin).Update error covariance
-    //use Pxy for temporal result from multiplication
-    //Pxy = K*Pyy
-    (void)mtx_mul(&pUpdate->K, &pUpdate->Pyy, &pUpdate->Pxy);
+                for (xIdx = 0; xIdx < xLen; xIdx++) {
+                    pPxy[yLen * xIdx + yRemIdx] -= pK[yLen * xIdx + yIdx] * pyj;
+                }
 
-    //Pxx_corr = K*Pyy*K'
-    (void)mtx_mul_src2tr(&pUpdate->Pxy, &pUpdate->K, &pUpdate->Pxx_corr);
+                for (yTrIdx = yIdx + 1; yTrIdx <= yRemIdx; yTrIdx++) {
+                    pPyy[yLen * yRemIdx + yTrIdx] -= f * pPyy[yLen * yTrIdx + yIdx];
+                }
+            }
+        } else {
+            if (UKF_Y_VALID(pValid, yIdx)) {
+                //present measurement without positive variance, likelihood of the step is incomplete
+                ukf_fault(pUkf, UKF_FAULT_GAIN, MTX_NOT_POS_DEFINED);
+                lik = 0;
+            }
+
+            //measurement missing or without information, gain column is cleared
+            for (xIdx = 0; xIdx < xLen; xIdx++) {
+                pK[yLen * xIdx + yIdx] = 0;
+            }
+        }
+    }
+
+    if (NULL != pUkf->pShare) {
+        pUkf->pShare->logLik = logLik;
+        pUkf->pShare->lik = lik;
+    }
+}
+
+/**
+ * @brief Log-likelihood of the innovation for tUKF.pShare (e.g. an IMM bank) before y is replaced by it:
+ * log N(y - y_m; 0, L*L') = -0.5*(z'*z + m*log(2*pi)) - sum(log(L(j,j))) with L*z = y - y_m and m
+ * present measurements. Rows of missing measurements are decoupled identity rows and don't contribute.
+ * 
+ * @param pUkf UKF - Working structure with reference to all in,out,states,par
+ * @param pL Lower Cholesky factor of Pyy
+ * @param yLen Number of measurements
+ */
+UKF_INLINE void ukf_innov_lik(tUKF *pUkf, mtxScalar const *pL, const mtxDim yLen) {
+    mtxScalar const *const py = pUkf->input.y.val;
+    mtxScalar const *const py_m = pUkf->predict.y_m.val;
+    uint8_t const *const pValid = pUkf->input.yValid.val;
+    mtxScalar *const pz = pUkf->pShare->pZ;
+    mtxScalar logLik = 0;
+    mtxDim yIdx, k;
+
+    for (yIdx = 0; yIdx < yLen; yIdx++) {
+        pz[yIdx] = 0;
+
+        if (UKF_Y_VALID(pValid, yIdx)) {
+            mtxScalar sum = py[yIdx] - py_m[yIdx];
+
+            //forward substitution, z of missing measurements is 0
+            for (k = 0; k < yIdx; k++) {
+                sum -= pL[yLen * yIdx + k] * pz[k];
+            }
+            pz[yIdx] = sum / pL[yLen * yIdx + yIdx];
+            logLik -= MTX_C(0.5) * (pz[yIdx] * pz[yIdx] + UKF_LOG_2PI) + MTX_LOG(pL[yLen * yIdx + yIdx]);
+        }
+    }
+
+    pUkf->pShare->logLik = logLik;
+    pUkf->pShare->lik = 1;
+}
+
+/**
+ * @brief Square root of weighted sigma-point covariance (UKF_MODE_SQRT)
+ *        S*S' = sum(Wc(i)*(Z(i)-z)*(Z(i)-z)') + N*N'
+ * Columns with positive weight and the noise factor N are stacked in the compound
+ * workspace and triangularized with QR, columns with negative weight are removed
+ * afterwards with rank-1 Cholesky downdates.
+ * Only rows marked in pValid are factorized (rows of N for present measurements
+ * factorize their noise block), rows and columns of missing rows are set to identity.
+ * 
+ * @param pUkf UKF - Working structure with reference to all in,out,states,par
+ * @param pZ Sigma points (n x sLen)
+ * @param pz Weighted mean of sigma points (n x 1)
+ * @param pN Lower Cholesky factor of additive noise (n x n)
+ * @param pValid Row mask (n) or NULL if all rows are used
+ * @param pS Lower triangular result (n x n)
+ * @return mtxResultInfo 
+ */
+static mtxResultInfo ukf_sqrt_covariance(tUKF *pUkf, const tMatrix *pZ, const tMatrix *pz, const tMatrix *pN, uint8_t const *pValid, tMatrix *pS) {
+    mtxScalar const *const pWc = pUkf->par.Wc.val;
+    mtxScalar const *const pZL = pZ->val;
+    mtxScalar const *const pzL = pz->val;
+    mtxScalar *const pA = pUkf->update.Acmp.val;
+    mtxScalar *const pSL = pS->val;
+    const mtxDim sigmaLen = pUkf->par.sLen;
+    const mtxDim n = UKF_SIGMA_NELEM(pZ);
+    tMatrix Acmp = {0, pN->ncol, pA};
+    tMatrix Sv;
+    tMatrix vec = {0, 1, pA};
+    mtxResultInfo mtxResult;
+    mtxDim sigmaIdx, row, col, vRow;
+
+    for (row = 0; row < n; row++) {
+        if (UKF_Y_VALID(pValid, row)) {
+            Acmp.nrow++;
+        }
+    }
+    vec.nrow = Acmp.nrow;
+    Sv = (tMatrix){Acmp.nrow, Acmp.nrow, pSL};
+
+    for (sigmaIdx = 0; sigmaIdx < sigmaLen; sigmaIdx++) {
+        if (pWc[sigmaIdx] > 0) {
+            Acmp.ncol++;
+        }
+    }
+
+    for (row = 0, vRow = 0; row < n; row++) {
+        if (UKF_Y_VALID(pValid, row)) {
+            mtxScalar *const pArow = &pA[Acmp.ncol * vRow++];
+
+            col = 0;
+            for (sigmaIdx = 0; sigmaIdx < sigmaLen; sigmaIdx++) {
+                if (pWc[sigmaIdx] > 0) {
+                    pArow[col++] = MTX_SQRT(pWc[sigmaIdx]) * (pZL[UKF_SIGMA_IDX(n, sigmaLen, row, sigmaIdx)] - pzL[row]);
+                }
+            }
+
+            for (sigmaIdx = 0; sigmaIdx < pN->ncol; sigmaIdx++) {
+                pArow[col++] = pN->val[pN->ncol * row + sigmaIdx];
+            }
+        }
+    }
+
+    mtxResult = mtx_qr_lower(&Acmp, &Sv);
+
+    for (sigmaIdx = 0; sigmaIdx < sigmaLen && MTX_OPERATION_OK == mtxResult; sigmaIdx++) {
+        if (pWc[sigmaIdx] < 0) {
+            for (row = 0, vRow = 0; row < n; row++) {
+                if (UKF_Y_VALID(pValid, row)) {
+                    pA[vRow++] = pZL[UKF_SIGMA_IDX(n, sigmaLen, row, sigmaIdx)] - pzL[row];
+                }
+            }
+            mtxResult = mtx_chol_update(&Sv, &vec, pWc[sigmaIdx]);
+        }
+    }
+
+    if (Sv.nrow < n) {
+        //expand packed factor of present rows in place, backwards so no element is overwritten before it is read
+        mtxDim vCol;
+
+        vRow = Sv.nrow;
+        for (row = n; row-- > 0;) {
+            const uint8_t rowValid = UKF_Y_VALID(pValid, row);
+
+            vRow -= (0 != rowValid) ? 1 : 0;
+            vCol = Sv.nrow;
+            for (col = n; col-- > 0;) {
+                const uint8_t colValid = UKF_Y_VALID(pValid, col);
+
+                vCol -= (0 != colValid) ? 1 : 0;
+                if (0 != rowValid && 0 != colValid) {
+                    pSL[n * row + col] = pSL[Sv.nrow * vRow + vCol];
+                } else {
+                    pSL[n * row + col] = (row == col) ? MTX_C(1.0) : MTX_C(0.0);
+                }
+            }
+        }
+    }
+
+    return mtxResult;
+}
+
+/**
+ * @brief Count a fault of the current step, fault is left in tUKF.health.status unless it was repaired
+ * 
+ * @param pUkf UKF - Working structure with reference to all in,out,states,par
+ * @param fault UKF_FAULT_* bit
+ * @param mtxResult Result after the repair, MTX_OPERATION_OK := repaired
+ */
+static void ukf_fault(tUKF *pUkf, const uint8_t fault, const mtxResultInfo mtxResult) {
+    tUkfHealth *const pHealth = &pUkf->health;
+    uint8_t bitIdx;
+
+    for (bitIdx = 0; bitIdx < UKF_FAULT_NUM; bitIdx++) {
+        if (fault == (1u << bitIdx)) {
+            pHealth->fault[bitIdx]++;
+
+            if (MTX_OPERATION_OK == mtxResult) {
+                pHealth->repair[bitIdx]++;
+                pHealth->repaired |= fault;
+            } else {
+                pHealth->status |= fault;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Repair a covariance which failed to factorize and factorize it again:
+ *        P = (P + P')/2, P(j,j) = max(P(j,j), d(j)) + d(j), d(j) = jitter*|P(j,j)|
+ * so the correlations shrink independent of the units of the states, d(j) of a zero
+ * diagonal is taken from the mean diagonal. The jitter starts at tUKF.health.jitter
+ * and grows by UKF_RECOVER_GROWTH for each of the tUKF.health.retryMax retries, every
+ * retry starts from the symmetrized backup. Non finite covariance is not repaired.
+ * 
+ * @param pUkf UKF - Working structure with reference to all in,out,states,par
+ * @param pP (n x n) Covariance, lower Cholesky factor of the repaired covariance on success
+ * @param pBak (n x n) Workspace, holds the symmetrized covariance on return
+ * @param n Matrix dimension
+ * @return mtxResultInfo MTX_OPERATION_OK := repaired
+ */
+static mtxResultInfo ukf_repair_chol(tUKF *pUkf, mtxScalar *pP, mtxScalar *pBak, const mtxDim n) {
+    tUkfHealth *const pHealth = &pUkf->health;
+    mtxScalar jitter = pHealth->jitter;
+    mtxScalar scale = 0;
+    uint8_t finite = 1;
+    uint8_t retryIdx;
+    mtxResultInfo mtxResult = MTX_NOT_POS_DEFINED;
+    mtxDim row, col;
+
+    for (row = 0; row < n; row++) {
+        for (col = 0; col <= row; col++) {
+            const mtxScalar sym = MTX_C(0.5) * (pP[n * row + col] + pP[n * col + row]);
+
+            //NaN and infinity give NaN
+            finite &= (MTX_C(0.0) == (sym - sym));
+            pBak[n * row + col] = sym;
+            pBak[n * col + row] = sym;
+        }
+        scale += MTX_FABS(pBak[n * row + row]);
+    }
+    scale = (scale > 0) ? (scale / n) : MTX_C(1.0);
+
+    for (retryIdx = 0; retryIdx <= pHealth->retryMax && 0 != finite && MTX_OPERATION_OK != mtxResult; retryIdx++) {
+        mtx_kernel_cpy(pP, pBak, (mtxIdx)n * n);
+        for (row = 0; row < n; row++) {
+            const mtxScalar diag = MTX_FABS(pP[n * row + row]);
+            const mtxScalar d = jitter * ((diag > 0) ? diag : scale);
+
+            pP[n * row + row] = ((pP[n * row + row] > d) ? pP[n * row + row] : d) + d;
+        }
+        mtxResult = mtx_kernel_chol_lower(pP, n);
+
+        if (MTX_OPERATION_OK == mtxResult && jitter > pHealth->jitterMax) {
+            pHealth->jitterMax = jitter;
+        }
+        jitter *= UKF_RECOVER_GROWTH;
+    }
+
+    return mtxResult;
+}
+
+/**
+ * @brief Repair a lower Cholesky factor whose downdate failed (UKF_MODE_SQRT). A failed
+ * mtx_chol_update() leaves the factor S unchanged, S*S' is rebuilt in place and repaired
+ * with ukf_repair_chol(), Acmp is the workspace.
+ * 
+ * @param pUkf UKF - Working structure with reference to all in,out,states,par
+ * @param pS (n x n) Lower Cholesky factor, repaired factor on success
+ * @param n Matrix dimension
+ * @return mtxResultInfo MTX_OPERATION_OK := repaired
+ */
+static mtxResultInfo ukf_repair_factor(tUKF *pUkf, mtxScalar *pS, const mtxDim n) {
+    mtx_kernel_chol_product(pS, n);
+
+    return ukf_repair_chol(pUkf, pS, pUkf->update.Acmp.val, n);
+}
+
+/**
+ * @brief Lower Cholesky factor of a covariance computed outside of the step (e.g. the
+ * IMM mixing) with the fault handling of the filter: a failed factorization is counted
+ * as fault in tUKF.health and repaired with tUKF.health.recover like inside the step.
+ * tUKF.health.status is reset by the next step, the caller reports the result itself.
+ * 
+ * @param pUkf UKF - Working structure with reference to all in,out,states,par
+ * @param pP (n x n) Symmetric covariance, lower Cholesky factor on success, the
+ * (symmetrized) covariance again if the factorization failed and was not repaired
+ * @param pBak (n x n) Workspace
+ * @param n Matrix dimension
+ * @param fault UKF_FAULT_* bit the failure is counted as
+ * @return mtxResultInfo MTX_OPERATION_OK := factorized or repaired
+ */
+mtxResultInfo ukf_health_chol(tUKF *pUkf, mtxScalar *pP, mtxScalar *pBak, const mtxDim n, const uint8_t fault) {
+    mtxResultInfo mtxResult;
+
+    mtx_kernel_cpy(pBak, pP, (mtxIdx)n * n);
+    mtxResult = mtx_kernel_chol_lower(pP, n);
+
+    if (MTX_OPERATION_OK != mtxResult) {
+        mtx_kernel_cpy(pP, pBak, (mtxIdx)n * n);
+        if (0 != pUkf->health.recover) {
+            mtxResult = ukf_repair_chol(pUkf, pP, pBak, n);
+        }
+        ukf_fault(pUkf, fault, mtxResult);
+
+        if (MTX_OPERATION_OK != mtxResult) {
+            mtx_kernel_cpy(pP, pBak, (mtxIdx)n * n);
+        }
+    }
 
-    (void)mtx_sub(&pUkf->predict.P_m, &pUpdate->Pxx_corr);
-    //#4.3(end).Update error covariance
+    return mtxResult;
 }
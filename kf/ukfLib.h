@@ -5,6 +5,7 @@
 #include <stdio.h>
 #include "math.h"
 #include "mtxLib.h"
+#include "ukfProf.h"
 
 #define xMinIdx (0u)
 #define xMaxIdx (1u)
@@ -14,8 +15,138 @@
 #define bethaIdx (1u)
 #define kappaIdx (2u)
 
-typedef void (*tPredictFcn)(tMatrix* pu_p, tMatrix* px_p, tMatrix* pX_m, uint8_t sigmaIdx, float dT);
-typedef void (*tObservFcn)(tMatrix* pu, tMatrix* pX_m, tMatrix* pY_m, uint8_t sigmaIdx);
+//! Filter formulation selected by tUkfMatrix.filter_mode
+#define UKF_MODE_STANDARD (0u)  //Propagate full error covariance Pxx
+#define UKF_MODE_SQRT     (1u)  //Square-root UKF: propagate lower Cholesky factor of Pxx
+
+//! Measurement update selected by tUkfMatrix.update_mode (UKF_MODE_STANDARD only)
+#define UKF_UPDATE_AUTO       (0u)  //sequential if Ryy0 is diagonal, batch otherwise
+#define UKF_UPDATE_BATCH      (1u)  //gain K = Pxy*inv(Pyy) for all measurements at once
+#define UKF_UPDATE_SEQUENTIAL (2u)  //one scalar update per measurement, no matrix inversion
+
+//! Sigma point set selected by tUkfMatrix.sigma_scheme
+#define UKF_SIGMA_SYMMETRIC (0u)  //2*xLen+1 points x +/- sqrt(xLen+lambda)*columns of chol(Pxx)
+#define UKF_SIGMA_SIMPLEX   (1u)  //xLen+2 points of the scaled spherical simplex set (kappa is not used)
+
+//! Number of sigma points of a scheme, use it to size Wm, Wc, X_sigma_points and Y_sigma_points
+#define UKF_SIGMA_LEN(xLen, scheme) ((UKF_SIGMA_SIMPLEX == (scheme)) ? ((xLen) + 2) : (2 * (xLen) + 1))
+
+//! Largest state vector whose sigma matrices fit mtxDim: 127 by default, 32767 with MTX_WIDE_INDEX
+#define UKF_STATE_LEN_MAX ((MTX_DIM_MAX - 1u) / 2u)
+
+//! Storage of the sigma matrices X_sigma_points and Y_sigma_points. Default is state-major: row = state/output,
+//! column = sigma point, (n x sLen). With UKF_SIGMA_MAJOR every sigma point is one contiguous row, (sLen x n).
+#if defined(UKF_SIGMA_MAJOR)
+#define UKF_SIGMA_IDX(nElem, nSigma, elemIdx, sigmaIdx) ((nElem) * (sigmaIdx) + (elemIdx))
+#define UKF_SIGMA_AT(pMtx, elemIdx, sigmaIdx)          ((pMtx)->val[(pMtx)->ncol * (sigmaIdx) + (elemIdx)])
+#define UKF_SIGMA_NELEM(pMtx)                          ((pMtx)->ncol)
+#else
+#define UKF_SIGMA_IDX(nElem, nSigma, elemIdx, sigmaIdx) ((nSigma) * (elemIdx) + (sigmaIdx))
+#define UKF_SIGMA_AT(pMtx, elemIdx, sigmaIdx)          ((pMtx)->val[(pMtx)->ncol * (elemIdx) + (sigmaIdx)])
+#define UKF_SIGMA_NELEM(pMtx)                          ((pMtx)->nrow)
+#endif
+
+typedef void (*tPredictFcn)(tMatrix* pu_p, tMatrix* px_p, tMatrix* pX_m, mtxDim sigmaIdx, mtxScalar dT);
+typedef void (*tObservFcn)(tMatrix* pu, tMatrix* pX_m, tMatrix* pY_m, mtxDim sigmaIdx);
+
+//! Batched model callbacks: transform sigma columns [sigmaIdx, sigmaIdx + sigmaCnt) for all states/outputs in one call.
+//! pX_p and pX_m share the same memory, so every column must be read completely before it is written.
+typedef void (*tPredictBatchFcn)(tMatrix* pu_p, tMatrix* pX_p, tMatrix* pX_m, mtxDim sigmaIdx, mtxDim sigmaCnt, mtxScalar dT);
+typedef void (*tObservBatchFcn)(tMatrix* pu, tMatrix* pX_m, tMatrix* pY_m, mtxDim sigmaIdx, mtxDim sigmaCnt);
+
+//! Dense sigma point callbacks (UKF_SIGMA_MAJOR only): px/py point to one contiguous sigma point, pu is NULL
+//! if the system has no inputs. Prediction works in place, px holds X_p(i) on entry and X_m(i) on return.
+typedef void (*tPredictVecFcn)(mtxScalar const* pu_p, mtxScalar* px, mtxScalar dT);
+typedef void (*tObservVecFcn)(mtxScalar const* pu, mtxScalar const* px_m, mtxScalar* py_m);
+
+//! Range job of a parallel executor: process sigma points [sigmaIdx, sigmaIdx + sigmaCnt)
+typedef void (*tUkfRangeFcn)(void* pArg, mtxDim sigmaIdx, mtxDim sigmaCnt);
+//! Parallel executor: cover [0, count) with calls of fcnRange on disjoint ranges, return when all are done
+typedef void (*tUkfParallelFcn)(void* pCtx, tUkfRangeFcn fcnRange, void* pArg, mtxDim count);
+
+struct uKF;
+
+typedef struct ukfExec {
+    tUkfParallelFcn fcnParallel;
+    void* pCtx;
+} tUkfExec;
+
+//! Observer of the prediction, called with the context of its hook table
+typedef void (*tUkfHookFcn)(void* pCtx, const struct uKF *pUkf);
+
+//! Hooks of the prediction phases, NULL entries are skipped (e.g. ukf_smooth_attach())
+typedef struct ukfPredHook {
+    tUkfHookFcn fcnPrior;  //x(k|k), P(k|k) and the sigma points X_p are known, propagation not started
+    tUkfHookFcn fcnCross;  //X_m and x(k+1|k) are known
+    tUkfHookFcn fcnPred;   //P(k+1|k) is known, prediction complete
+    void* pCtx;
+} tUkfPredHook;
+
+//! Work of one step exchanged through tUkfShare.put/get
+#define UKF_SHARE_CHOL (1u)  //Pxx holds its lower Cholesky factor already (UKF_MODE_STANDARD)
+#define UKF_SHARE_PROP (2u)  //propagated sigma points X(k|k-1)
+#define UKF_SHARE_OBS  (4u)  //observed sigma points Y(k|k-1)
+
+//! Step work shared with other filters and likelihood of the innovation (e.g. the models of an IMM bank, ukfImm.h)
+typedef struct ukfShare {
+    uint8_t put;                //UKF_SHARE_PROP/OBS the step writes to pXput/pYput
+    uint8_t get;                //UKF_SHARE_CHOL/PROP/OBS the step takes instead of evaluating it
+    mtxScalar const *pXget;     //(xLen x sLen) X(k|k-1) taken with UKF_SHARE_PROP
+    mtxScalar const *pYget;     //(yLen x sLen) Y(k|k-1) taken with UKF_SHARE_OBS
+    mtxScalar *pXput;           //(xLen x sLen) X(k|k-1) written with UKF_SHARE_PROP
+    mtxScalar *pYput;           //(yLen x sLen) Y(k|k-1) written with UKF_SHARE_OBS
+    mtxScalar *pZ;              //(yLen) whitened innovation of the likelihood
+    mtxScalar *pW;              //(yLen x yLen) Cholesky factor of Pyy for the likelihood (UKF_GAIN_GAUSS_JORDAN)
+    mtxScalar logLik;           //log N(y; y(k|k-1), Pyy) of the present measurements, valid if lik is set
+    uint8_t lik;                //1 := logLik of the current step is valid, 0 := no likelihood (update skipped or failed)
+} tUkfShare;
+
+//! Numerical faults of one step, bits of the ukf_step()/ukf_predict()/ukf_update() result and of tUkfHealth.status
+#define UKF_FAULT_SIGMAPOINT (1u)   //Pxx(k-1) not positive definite, sigma points not drawn, step skipped
+#define UKF_FAULT_PRED_COV   (2u)   //downdate of the factor of P(k|k-1) failed (UKF_MODE_SQRT)
+#define UKF_FAULT_OUTPUT_COV (4u)   //downdate of the factor of Pyy failed (UKF_MODE_SQRT)
+#define UKF_FAULT_GAIN       (8u)   //Pyy not positive definite or singular, measurement update (or one measurement of it) skipped
+#define UKF_FAULT_COV_UPDATE (16u)  //downdate of the factor of P(k) failed (UKF_MODE_SQRT)
+#define UKF_FAULT_NUM        (5u)
+
+//! Defaults of the covariance repair, the jitter grows by UKF_RECOVER_GROWTH per retry of the factorization
+#define UKF_RECOVER_JITTER (MTX_C(1e-6))  //first diagonal jitter relative to the diagonal
+#define UKF_RECOVER_RETRY  (6u)
+#define UKF_RECOVER_GROWTH (MTX_C(10.0))
+
+//! Numerical health of the filter, reset by ukf_init() and ukf_restore()
+typedef struct ukfHealth {
+    uint8_t recover;     //1 := repair a covariance that failed to factorize in place and retry in the same step, 0 := off (default)
+    uint8_t retryMax;    //factorization retries of one repair, default UKF_RECOVER_RETRY
+    mtxScalar jitter;    //first relative jitter of a repair, default UKF_RECOVER_JITTER
+    uint8_t status;      //UKF_FAULT_* left after the last call, equal to its result
+    uint8_t repaired;    //UKF_FAULT_* repaired in the last call
+    mtxScalar jitterMax; //largest relative jitter a repair needed
+    uint32_t steps;      //ukf_step(), ukf_predict() and ukf_update() calls
+    uint32_t faultSteps; //calls with a fault left
+    uint32_t fault[UKF_FAULT_NUM];   //occurrences of every fault (bit i), repaired ones included
+    uint32_t repair[UKF_FAULT_NUM];  //faults repaired
+} tUkfHealth;
+
+//! Checkpoint of the filter state, see ukf_checkpoint_save()
+#define UKF_CKPT_MAGIC   (0x434B4655u)  //"UKFC" in little endian memory
+#define UKF_CKPT_VERSION (1u)
+
+typedef struct ukfCkptHeader {
+    uint32_t crc;         //CRC-32 of all following bytes of the checkpoint
+    uint32_t magic;       //UKF_CKPT_MAGIC
+    uint32_t size;        //bytes of header and payload
+    uint16_t version;     //UKF_CKPT_VERSION
+    uint16_t xLen;
+    uint16_t yLen;
+    uint16_t uLen;
+    uint16_t sLen;
+    uint8_t scalarSize;   //sizeof(mtxScalar)
+    uint8_t mode;
+    uint8_t scheme;
+    uint8_t updateMode;
+    uint8_t reserved[6];
+} tUkfCkptHeader;
 
 typedef struct ukfMatrix {
     tMatrix Sc_vector;          //! Holds alpha, beta and kappa parameters for 
@@ -25,37 +156,53 @@ typedef struct ukfMatrix {
     tMatrix x_system_states_ic;
     tMatrix x_system_states_limits;             //NOT MANDATORY assign NULL if not required
     tMatrixBool x_system_states_limits_enable;  //NOT MANDATORY assign NULL if not required
-    tMatrix x_system_states_correction;
+    tMatrix x_system_states_correction;         //NOT MANDATORY assign NULL if not required, used only with UKF_MODE_SQRT (xLen x 1)
     tMatrix u_system_input;       //NOT MANDATORY assign NULL if not required
     tMatrix u_prev_system_input;  //NOT MANDATORY assign NULL if not required
     tMatrix X_sigma_points;
     tMatrix Y_sigma_points;
     tMatrix y_predicted_mean;
     tMatrix y_meas;
+    tMatrixBool y_meas_valid;          //NOT MANDATORY assign NULL if not required, (yLen x 1) 0 := measurement missing in this step
     tMatrix Pyy_out_covariance;
-    tMatrix Pyy_out_covariance_copy;
+    tMatrix Pyy_out_covariance_copy;   //NOT MANDATORY assign NULL if not required, (yLen x yLen) backup of Pyy, read and written only by the repair of the gain with tUKF.health.recover (UKF_MODE_STANDARD)
     tMatrix Ryy0_init_out_covariance;
     tMatrix Pxy_cross_covariance;
     tMatrix Pxx_error_covariance;
     tMatrix Pxx0_init_error_covariance;
     tMatrix Qxx_process_noise_cov;
     tMatrix K_kalman_gain;
-    tMatrix I_identity_matrix;
-    tMatrix Pxx_covariance_correction;
+    tMatrix I_identity_matrix;         //NOT MANDATORY assign NULL if not required, never used (gain is solved in place), kept for existing configurations
+    tMatrix Pxx_covariance_correction; //NOT MANDATORY assign NULL if not required, not used (symmetric correction is subtracted in place)
+    tMatrix Sqxx_process_noise_sqrt;   //NOT MANDATORY assign NULL if not required, used only with UKF_MODE_SQRT (xLen x xLen)
+    tMatrix Sryy_out_noise_sqrt;       //NOT MANDATORY assign NULL if not required, used only with UKF_MODE_SQRT (yLen x yLen)
+    tMatrix Sr_compound_workspace;     //NOT MANDATORY assign NULL if not required, used only with UKF_MODE_SQRT (n x (sLen + n)) for n = max(xLen, yLen)
+    tMatrix F_state_transition;        //NOT MANDATORY assign NULL if not required, (xLen x xLen) linear prediction x = F*x + B*u over dT, replaces fcnPredict*
+    tMatrix B_input_matrix;            //NOT MANDATORY assign NULL if not required, (xLen x uLen) used only with F_state_transition
     tPredictFcn* fcnPredict;
     tObservFcn* fcnObserve;
-    float dT;
+    tPredictBatchFcn fcnPredictBatch;  //NOT MANDATORY assign NULL if not required, takes precedence over fcnPredict
+    tObservBatchFcn fcnObserveBatch;   //NOT MANDATORY assign NULL if not required, takes precedence over fcnObserve
+    tPredictVecFcn fcnPredictVec;      //NOT MANDATORY assign NULL if not required, used only with UKF_SIGMA_MAJOR, takes precedence over fcnPredictBatch
+    tObservVecFcn fcnObserveVec;       //NOT MANDATORY assign NULL if not required, used only with UKF_SIGMA_MAJOR, takes precedence over fcnObserveBatch
+    mtxScalar dT;
+    uint8_t filter_mode;               //UKF_MODE_STANDARD (default) or UKF_MODE_SQRT
+    uint8_t update_mode;               //UKF_UPDATE_AUTO (default), UKF_UPDATE_BATCH or UKF_UPDATE_SEQUENTIAL
+    uint8_t sigma_scheme;              //UKF_SIGMA_SYMMETRIC (default) or UKF_SIGMA_SIMPLEX
 } tUkfMatrix;
 
 typedef struct uKFpar {
-    uint8_t xLen;     //length of state vector
-    uint8_t yLen;     //length of measurement vector
-    uint8_t sLen;     //length of sigma point
-    float alpha;  //Range:[10e-4 : 1].Smaller alpha leads to a tighter (closer) selection of sigma-points,
-    float betha;  //Contain information about the prior distribution (for Gaussian, beta = 2 is optimal).
-    float kappa;  //tertiary scaling parameter, usual value 0.
-    float lambda;
-    float dT;
+    mtxDim xLen;     //length of state vector
+    mtxDim yLen;     //length of measurement vector
+    mtxDim sLen;     //length of sigma point
+    mtxScalar alpha;  //Range:[10e-4 : 1].Smaller alpha leads to a tighter (closer) selection of sigma-points,
+    mtxScalar betha;  //Contain information about the prior distribution (for Gaussian, beta = 2 is optimal).
+    mtxScalar kappa;  //tertiary scaling parameter, usual value 0.
+    mtxScalar lambda;
+    mtxScalar dT;
+    uint8_t mode;     //UKF_MODE_STANDARD or UKF_MODE_SQRT
+    uint8_t updateMode;   //UKF_UPDATE_BATCH or UKF_UPDATE_SEQUENTIAL (resolved from tUkfMatrix.update_mode)
+    uint8_t scheme;       //UKF_SIGMA_SYMMETRIC or UKF_SIGMA_SIMPLEX
     tMatrix Wm;
     tMatrix Wc;
     tMatrix Qxx;
@@ -64,41 +211,49 @@ typedef struct uKFpar {
     tMatrix x0;
     tMatrix xLim;
     tMatrixBool xLimEnbl;
+    tMatrix Sqxx;     //sqrt(Qxx) lower Cholesky factor (UKF_MODE_SQRT)
+    tMatrix Sryy;     //sqrt(Ryy0) lower Cholesky factor (UKF_MODE_SQRT)
+    tMatrix Fxx;      //state transition of linear prediction, NULL if prediction is unscented
+    tMatrix Bxu;      //input matrix of linear prediction, NULL if not used
 } tUKFpar;
 
 typedef struct uKFin {
     tMatrix u;  // u(k)   Current inputs
     tMatrix y;  // y(k)   Current measurement
+    tMatrixBool yValid;  // Current measurement present flags, NULL if all are present
 } tUKFin;
 
 typedef struct uKFprev {
     tMatrix u_p;    // u(k-1)   Previous inputs
     tMatrix x_p;    // x(k-1)   Previous states
     tMatrix X_p;    // X(k-1)   Calculate the sigma-points
-    tMatrix Pxx_p;  // P(k-1)    Previous error covariance
+    tMatrix Pxx_p;  // P(k-1)    Previous error covariance (UKF_MODE_SQRT: lower Cholesky factor)
 } tUKFprev;
 
 typedef struct uKFpredict  //p(previous)==k-1, m(minus)=(k|k-1)
 {
-    tMatrix X_m;  //X(k|k-1) Propagate each sigma-point through prediction f(Chi)
+    tMatrix X_m;  //X(k|k-1) Propagate each sigma-point through prediction f(Chi), centered by the measurement update (UKF_MODE_STANDARD)
     tMatrix x_m;  //x(k|k-1) Calculate mean of predicted state
-    tMatrix P_m;  //P(k|k-1) Calculate covariance of predicted state
-    tMatrix Y_m;  //Y(k|k-1) Propagate each sigma-point through observation
+    tMatrix P_m;  //P(k|k-1) Calculate covariance of predicted state (UKF_MODE_SQRT: lower Cholesky factor)
+    tMatrix Y_m;  //Y(k|k-1) Propagate each sigma-point through observation, centered by the measurement update (UKF_MODE_STANDARD)
     tMatrix y_m;  //y(k|k-1) Calculate mean of predicted output
     tPredictFcn* pFcnPredict;
     tObservFcn* pFcnObserv;
+    tPredictBatchFcn pFcnPredictBatch;
+    tObservBatchFcn pFcnObservBatch;
+    tPredictVecFcn pFcnPredictVec;
+    tObservVecFcn pFcnObservVec;
 } tUKFpredict;
 
 typedef struct uKFupdate {
-    tMatrix Pyy;  //Calculate covariance of predicted output
-    tMatrix Pyy_cpy;
+    tMatrix Pyy;  //Calculate covariance of predicted output, holds its Cholesky factor after the update (identity with UKF_GAIN_GAUSS_JORDAN)
+    tMatrix Pyy_cpy;  //tUkfMatrix.Pyy_out_covariance_copy
     tMatrix Pxy;  //Calculate cross-covariance of state and output
     tMatrix K;    //K(k) Calculate gain
     tMatrix x;    //x(k) Update state estimate
-    tMatrix x_corr;
+    tMatrix x_corr;  //column buffer of the covariance downdate (UKF_MODE_SQRT)
     tMatrix Pxx;  //P(k) Update error covariance
-    tMatrix Pxx_corr;
-    tMatrix Iyy;  //tmp buffer initialized as identity matrix stor result from inversion and other operation
+    tMatrix Acmp; //compound matrix workspace for QR triangularization (UKF_MODE_SQRT)
 } tUKFupdate;
 
 typedef struct uKF {
@@ -107,9 +262,22 @@ typedef struct uKF {
     tUKFin input;
     tUKFpredict predict;
     tUKFupdate update;
+    uint8_t predicted;   //X_m, x_m and P_m come from ukf_predict() since last measurement update
+    tUkfProfile *pProf;  //NOT MANDATORY assign NULL if not required, phase timing of ukf_step() (UKF_PROFILE)
+    const tUkfExec *pExec;  //NOT MANDATORY assign NULL if not required, propagates sigma points through the model callbacks concurrently (e.g. ukfPool.h)
+    const tUkfPredHook *pHook;  //NOT MANDATORY assign NULL if not required, observes every prediction, e.g. the RTS smoother (ukf_smooth_attach())
+    tUkfShare *pShare;          //NOT MANDATORY assign NULL if not required, likelihood and shared sigma point work (e.g. ukf_imm_init())
+    tUkfHealth health;   //step status, fault counters and covariance repair settings
 } tUKF;
 
 uint8_t ukf_init(tUKF *pUkf, tUkfMatrix *pUkfMatrix);
-void    ukf_step(tUKF *pUkf);
+uint8_t ukf_step(tUKF *pUkf);
+uint8_t ukf_predict(tUKF *pUkf, mtxScalar dT);
+uint8_t ukf_update(tUKF *pUkf);
+mtxResultInfo ukf_health_chol(tUKF *pUkf, mtxScalar *pP, mtxScalar *pBak, mtxDim n, uint8_t fault);
+
+uint32_t ukf_checkpoint_size (const tUKF *pUkf);
+uint8_t  ukf_checkpoint_save (const tUKF *pUkf, void *pMem, uint32_t memSize);
+uint8_t  ukf_restore         (tUKF *pUkf, tUkfMatrix *pUkfMatrix, const void *pMem, uint32_t memSize);
 
 #endif
\ No newline at end of file
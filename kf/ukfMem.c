@@ -0,0 +1,322 @@
+/**
+ * @file ukfMem.c
+ * @brief UKF working storage layout in caller supplied memory.
+ * Replaces the per-filter static arrays of a ukfCfg.c file: every matrix of
+ * tUkfMatrix is placed in one contiguous block, so many filters of arbitrary
+ * shape can live side by side in a single arena. Temporaries of one step
+ * are planned by their lifetime and share one scratch region.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ukfMem.h"
+
+#define UKF_MEM_ROUND(size) (((size) + (UKF_MEM_ALIGN - 1u)) & ~(uint32_t)(UKF_MEM_ALIGN - 1u))
+
+//! Phases of a step in which a scratch buffer holds data, buffers without common phase share memory
+#define UKF_MEM_LIVE_PREDICT (1u)  //sigma points and predicted state
+#define UKF_MEM_LIVE_OUTPUT  (2u)  //predicted output, Pyy and Pxy
+#define UKF_MEM_LIVE_UPDATE  (4u)  //measurement update
+
+#define UKF_MEM_SCRATCH_MAX (4u)
+
+typedef struct ukfMemScratch {
+    tMatrix *pMtx;
+    mtxDim nrow;
+    mtxDim ncol;
+    uint8_t live;     //UKF_MEM_LIVE_* mask
+    uint32_t size;    //aligned bytes
+    uint32_t offset;  //bytes from start of scratch region
+} tUkfMemScratch;
+
+static uint32_t ukf_mem_assign  (tUkfMatrix *pUkfMatrix, uint8_t *pBase, mtxDim xLen, mtxDim yLen, uint8_t filterMode, uint8_t sigmaScheme, tUkfMemPlan *pPlan);
+static void     ukf_mem_take    (tMatrix *pMtx, uint8_t **ppCur, uint32_t *pUsed, mtxDim nrow, mtxDim ncol);
+static uint32_t ukf_mem_scratch (tUkfMemScratch *pItem, uint8_t nItem);
+
+/**
+ * @brief Reserve one aligned matrix buffer
+ *
+ * @param pMtx Matrix descriptor to fill
+ * @param ppCur Current position in memory block, NULL content if only size is calculated
+ * @param pUsed Accumulated number of bytes
+ * @param nrow Number of rows
+ * @param ncol Number of columns
+ */
+static void ukf_mem_take(tMatrix *pMtx, uint8_t **ppCur, uint32_t *pUsed, mtxDim nrow, mtxDim ncol) {
+    const uint32_t size = UKF_MEM_ROUND((uint32_t)nrow * ncol * sizeof(mtxScalar));
+
+    pMtx->nrow = nrow;
+    pMtx->ncol = ncol;
+    pMtx->val = (mtxScalar *)*ppCur;
+
+    if (NULL != *ppCur) {
+        *ppCur += size;
+    }
+    *pUsed += size;
+}
+
+/**
+ * @brief Plan offsets of scratch buffers in one shared region. Buffers are placed from
+ * the largest down, each at the lowest offset not overlapping a placed buffer with a
+ * common live phase (first fit by decreasing size).
+ *
+ * @param pItem Scratch buffers with size and live mask, offsets are filled
+ * @param nItem Number of buffers
+ * @return uint32_t Size of the shared region in bytes
+ */
+static uint32_t ukf_mem_scratch(tUkfMemScratch *pItem, uint8_t nItem) {
+    uint8_t placed[UKF_MEM_SCRATCH_MAX] = {0};
+    uint32_t regionSize = 0;
+    uint8_t iter, iIdx, cIdx;
+
+    for (iter = 0; iter < nItem; iter++) {
+        uint8_t cur = nItem;
+        uint32_t offset = UINT32_MAX;
+
+        for (iIdx = 0; iIdx < nItem; iIdx++) {
+            if (0 == placed[iIdx] && (nItem == cur || pItem[iIdx].size > pItem[cur].size)) {
+                cur = iIdx;
+            }
+        }
+
+        //candidates are the region start and the end of every conflicting placed buffer
+        for (cIdx = 0; cIdx <= nItem; cIdx++) {
+            if (cIdx == nItem || (0 != placed[cIdx] && 0 != (pItem[cIdx].live & pItem[cur].live))) {
+                const uint32_t cand = (cIdx == nItem) ? 0 : (pItem[cIdx].offset + pItem[cIdx].size);
+                uint8_t fits = 1;
+
+                for (iIdx = 0; iIdx < nItem; iIdx++) {
+                    if (0 != placed[iIdx] && 0 != (pItem[iIdx].live & pItem[cur].live) &&
+                        cand < pItem[iIdx].offset + pItem[iIdx].size && pItem[iIdx].offset < cand + pItem[cur].size) {
+                        fits = 0;
+                    }
+                }
+                if (0 != fits && cand < offset) {
+                    offset = cand;
+                }
+            }
+        }
+
+        pItem[cur].offset = offset;
+        placed[cur] = 1;
+        if (offset + pItem[cur].size > regionSize) {
+            regionSize = offset + pItem[cur].size;
+        }
+    }
+
+    return regionSize;
+}
+
+/**
+ * @brief Assign all tUkfMatrix buffers from memory block (or only count bytes if pBase is NULL).
+ * Buffers holding filter state between steps are placed first, followed by the shared
+ * scratch region of the step temporaries:
+ * - Y_sigma_points      : predicted output and covariances
+ * - K_kalman_gain       : measurement update, kept valid until the output of the next update
+ * - Pyy_out_covariance_copy : gain of the measurement update, backup for tUKF.health.recover (UKF_MODE_STANDARD)
+ * - Sr_compound_workspace, x_system_states_correction : square-root factorizations and downdate
+ *
+ * @param pUkfMatrix UKF - Structure with all filter matrix
+ * @param pBase Aligned memory block or NULL
+ * @param xLen Number of states
+ * @param yLen Number of measurements
+ * @param filterMode UKF_MODE_STANDARD or UKF_MODE_SQRT
+ * @param sigmaScheme UKF_SIGMA_SYMMETRIC or UKF_SIGMA_SIMPLEX
+ * @param pPlan Byte count report, NOT MANDATORY assign NULL if not required
+ * @return uint32_t Number of bytes used
+ */
+static uint32_t ukf_mem_assign(tUkfMatrix *pUkfMatrix, uint8_t *pBase, mtxDim xLen, mtxDim yLen, uint8_t filterMode, uint8_t sigmaScheme, tUkfMemPlan *pPlan) {
+    const mtxDim sLen = UKF_SIGMA_LEN(xLen, sigmaScheme);
+    const mtxDim maxLen = (xLen > yLen) ? xLen : yLen;
+    tUkfMemScratch scratch[UKF_MEM_SCRATCH_MAX] = {
+#if defined(UKF_SIGMA_MAJOR)
+        {&pUkfMatrix->Y_sigma_points, sLen, yLen, UKF_MEM_LIVE_OUTPUT, 0, 0},
+#else
+        {&pUkfMatrix->Y_sigma_points, yLen, sLen, UKF_MEM_LIVE_OUTPUT, 0, 0},
+#endif
+        {&pUkfMatrix->K_kalman_gain, xLen, yLen, UKF_MEM_LIVE_UPDATE | UKF_MEM_LIVE_PREDICT, 0, 0},
+        {&pUkfMatrix->Sr_compound_workspace, maxLen, (mtxDim)(sLen + maxLen), UKF_MEM_LIVE_PREDICT | UKF_MEM_LIVE_OUTPUT, 0, 0},
+        {&pUkfMatrix->x_system_states_correction, xLen, 1, UKF_MEM_LIVE_UPDATE, 0, 0},
+    };
+    //square-root buffers are the last entries, the standard filter takes the Pyy backup instead
+    const uint8_t nScratch = (UKF_MODE_SQRT == filterMode) ? 4u : 3u;
+    uint8_t *pCur = pBase;
+    uint32_t used = 0;
+    uint32_t unshared = 0, regionSize;
+    uint32_t boolSize;
+    uint8_t sIdx;
+
+    ukf_mem_take(&pUkfMatrix->Sc_vector,                  &pCur, &used, 1, 3);
+    ukf_mem_take(&pUkfMatrix->Wm_weight_vector,           &pCur, &used, 1, sLen);
+    ukf_mem_take(&pUkfMatrix->Wc_weight_vector,           &pCur, &used, 1, sLen);
+    ukf_mem_take(&pUkfMatrix->x_system_states,            &pCur, &used, xLen, 1);
+    ukf_mem_take(&pUkfMatrix->x_system_states_ic,         &pCur, &used, xLen, 1);
+    ukf_mem_take(&pUkfMatrix->x_system_states_limits,     &pCur, &used, xLen, 3);
+#if defined(UKF_SIGMA_MAJOR)
+    ukf_mem_take(&pUkfMatrix->X_sigma_points,             &pCur, &used, sLen, xLen);
+#else
+    ukf_mem_take(&pUkfMatrix->X_sigma_points,             &pCur, &used, xLen, sLen);
+#endif
+    ukf_mem_take(&pUkfMatrix->y_predicted_mean,           &pCur, &used, yLen, 1);
+    ukf_mem_take(&pUkfMatrix->y_meas,                     &pCur, &used, yLen, 1);
+    ukf_mem_take(&pUkfMatrix->Pyy_out_covariance,         &pCur, &used, yLen, yLen);
+    ukf_mem_take(&pUkfMatrix->Ryy0_init_out_covariance,   &pCur, &used, yLen, yLen);
+    ukf_mem_take(&pUkfMatrix->Pxy_cross_covariance,       &pCur, &used, xLen, yLen);
+    ukf_mem_take(&pUkfMatrix->Pxx_error_covariance,       &pCur, &used, xLen, xLen);
+    ukf_mem_take(&pUkfMatrix->Pxx0_init_error_covariance, &pCur, &used, xLen, xLen);
+    ukf_mem_take(&pUkfMatrix->Qxx_process_noise_cov,      &pCur, &used, xLen, xLen);
+    pUkfMatrix->Pxx_covariance_correction = (tMatrix){0, 0, NULL};
+    pUkfMatrix->I_identity_matrix         = (tMatrix){0, 0, NULL};
+
+    if (UKF_MODE_SQRT == filterMode) {
+        ukf_mem_take(&pUkfMatrix->Sqxx_process_noise_sqrt, &pCur, &used, xLen, xLen);
+        ukf_mem_take(&pUkfMatrix->Sryy_out_noise_sqrt,     &pCur, &used, yLen, yLen);
+        pUkfMatrix->Pyy_out_covariance_copy    = (tMatrix){0, 0, NULL};
+    } else {
+        //Y sigma points are dead once Pyy and Pxy are known, the backup may take their place
+        scratch[2] = (tUkfMemScratch){&pUkfMatrix->Pyy_out_covariance_copy, yLen, yLen, UKF_MEM_LIVE_UPDATE, 0, 0};
+        pUkfMatrix->Sqxx_process_noise_sqrt    = (tMatrix){0, 0, NULL};
+        pUkfMatrix->Sryy_out_noise_sqrt        = (tMatrix){0, 0, NULL};
+        pUkfMatrix->Sr_compound_workspace      = (tMatrix){0, 0, NULL};
+        pUkfMatrix->x_system_states_correction = (tMatrix){0, 0, NULL};
+    }
+
+    //step temporaries share the scratch region, every buffer stays aligned
+    for (sIdx = 0; sIdx < nScratch; sIdx++) {
+        scratch[sIdx].size = UKF_MEM_ROUND((uint32_t)scratch[sIdx].nrow * scratch[sIdx].ncol * sizeof(mtxScalar));
+        unshared += scratch[sIdx].size;
+    }
+    regionSize = ukf_mem_scratch(scratch, nScratch);
+
+    for (sIdx = 0; sIdx < nScratch; sIdx++) {
+        scratch[sIdx].pMtx->nrow = scratch[sIdx].nrow;
+        scratch[sIdx].pMtx->ncol = scratch[sIdx].ncol;
+        scratch[sIdx].pMtx->val = (NULL != pCur) ? (mtxScalar *)(pCur + scratch[sIdx].offset) : NULL;
+    }
+    if (NULL != pCur) {
+        pCur += regionSize;
+    }
+    used += regionSize;
+
+    //limiter enable and measurement present flags are the only non-scalar buffers and placed last
+    boolSize = UKF_MEM_ROUND((uint32_t)xLen * sizeof(uint8_t));
+    pUkfMatrix->x_system_states_limits_enable.nrow = xLen;
+    pUkfMatrix->x_system_states_limits_enable.ncol = 1;
+    pUkfMatrix->x_system_states_limits_enable.val = pCur;
+    used += boolSize;
+
+    pUkfMatrix->y_meas_valid.nrow = yLen;
+    pUkfMatrix->y_meas_valid.ncol = 1;
+    pUkfMatrix->y_meas_valid.val = (NULL != pCur) ? (pCur + boolSize) : NULL;
+    used += UKF_MEM_ROUND((uint32_t)yLen * sizeof(uint8_t));
+
+    //system inputs and linear prediction are not part of the layout, attach them if the model requires it
+    pUkfMatrix->u_system_input = (tMatrix){0, 0, NULL};
+    pUkfMatrix->u_prev_system_input = (tMatrix){0, 0, NULL};
+    pUkfMatrix->F_state_transition = (tMatrix){0, 0, NULL};
+    pUkfMatrix->B_input_matrix = (tMatrix){0, 0, NULL};
+    pUkfMatrix->filter_mode = filterMode;
+    pUkfMatrix->update_mode = UKF_UPDATE_AUTO;
+    pUkfMatrix->sigma_scheme = sigmaScheme;
+
+    if (NULL != pPlan) {
+        pPlan->total = used;
+        pPlan->persist = used - regionSize;
+        pPlan->scratch = regionSize;
+        pPlan->scratchUnshared = unshared;
+    }
+
+    return used;
+}
+
+/**
+ * @brief Number of bytes required by ukf_mem_layout() for one filter.
+ * The result is a multiple of UKF_MEM_ALIGN, so N filters can be placed
+ * back to back in an arena of N * ukf_mem_size() bytes.
+ *
+ * @param xLen Number of states
+ * @param yLen Number of measurements
+ * @param filterMode UKF_MODE_STANDARD or UKF_MODE_SQRT
+ * @param sigmaScheme UKF_SIGMA_SYMMETRIC or UKF_SIGMA_SIMPLEX
+ * @return uint32_t Block size in bytes
+ */
+uint32_t ukf_mem_size(mtxDim xLen, mtxDim yLen, uint8_t filterMode, uint8_t sigmaScheme) {
+    tUkfMatrix dummy;
+
+    return ukf_mem_assign(&dummy, NULL, xLen, yLen, filterMode, sigmaScheme, NULL);
+}
+
+/**
+ * @brief Byte count of the layout of one filter, split into buffers holding filter
+ * state between steps and the shared scratch region of the step temporaries
+ *
+ * @param pPlan Byte count report to fill
+ * @param xLen Number of states
+ * @param yLen Number of measurements
+ * @param filterMode UKF_MODE_STANDARD or UKF_MODE_SQRT
+ * @param sigmaScheme UKF_SIGMA_SYMMETRIC or UKF_SIGMA_SIMPLEX
+ * @return uint32_t Block size in bytes, same as ukf_mem_size()
+ */
+uint32_t ukf_mem_plan(tUkfMemPlan *pPlan, mtxDim xLen, mtxDim yLen, uint8_t filterMode, uint8_t sigmaScheme) {
+    tUkfMatrix dummy;
+
+    return ukf_mem_assign(&dummy, NULL, xLen, yLen, filterMode, sigmaScheme, pPlan);
+}
+
+/**
+ * @brief Lay out every tUkfMatrix buffer for xLen/yLen inside one memory block.
+ * The used part of the block is cleared. Defaults: Sc = {alpha = 1, beta = 2, kappa = 0},
+ * Pxx0 and Ryy0 are identity matrices, state limiters are disabled, all measurements
+ * are marked present and system inputs are not assigned. Model callbacks, dT, initial states and noise
+ * covariances should be filled by caller before ukf_init().
+ *
+ * @param pUkfMatrix UKF - Structure with all filter matrix to fill
+ * @param pMem Memory block aligned to UKF_MEM_ALIGN
+ * @param memSize Size of memory block, at least ukf_mem_size()
+ * @param xLen Number of states
+ * @param yLen Number of measurements
+ * @param filterMode UKF_MODE_STANDARD or UKF_MODE_SQRT
+ * @param sigmaScheme UKF_SIGMA_SYMMETRIC or UKF_SIGMA_SIMPLEX
+ * @return uint8_t
+ * 0 := OK
+ * 1 := NOK (memory block too small or misaligned)
+ */
+uint8_t ukf_mem_layout(tUkfMatrix *pUkfMatrix, void *pMem, uint32_t memSize, mtxDim xLen, mtxDim yLen, uint8_t filterMode, uint8_t sigmaScheme) {
+    uint8_t *const pBase = (uint8_t *)pMem;
+    const mtxIdx maxLen = (xLen > yLen) ? xLen : yLen;
+    const uint32_t size = ukf_mem_size(xLen, yLen, filterMode, sigmaScheme);
+    uint8_t Result = 0;
+    uint32_t eIdx;
+
+    if (NULL == pBase || 0 != ((uintptr_t)pBase & (UKF_MEM_ALIGN - 1u)) || memSize < size ||
+        0 == xLen || 0 == yLen || xLen > UKF_STATE_LEN_MAX || (UKF_MODE_SQRT == filterMode && (UKF_SIGMA_LEN(xLen, sigmaScheme) + maxLen) > MTX_DIM_MAX)) {
+        Result = 1;
+    } else {
+        for (eIdx = 0; eIdx < size; eIdx++) {
+            pBase[eIdx] = 0;
+        }
+
+        (void)ukf_mem_assign(pUkfMatrix, pBase, xLen, yLen, filterMode, sigmaScheme, NULL);
+
+        pUkfMatrix->Sc_vector.val[alphaIdx] = 1;
+        pUkfMatrix->Sc_vector.val[bethaIdx] = 2;
+        pUkfMatrix->Sc_vector.val[kappaIdx] = 0;
+        (void)mtx_identity(&pUkfMatrix->Pxx0_init_error_covariance);
+        (void)mtx_identity(&pUkfMatrix->Ryy0_init_out_covariance);
+
+        for (eIdx = 0; eIdx < yLen; eIdx++) {
+            //all measurements present
+            pUkfMatrix->y_meas_valid.val[eIdx] = 1;
+        }
+
+        pUkfMatrix->fcnPredict = NULL;
+        pUkfMatrix->fcnObserve = NULL;
+        pUkfMatrix->fcnPredictBatch = NULL;
+        pUkfMatrix->fcnObserveBatch = NULL;
+        pUkfMatrix->fcnPredictVec = NULL;
+        pUkfMatrix->fcnObserveVec = NULL;
+        pUkfMatrix->dT = 0;
+    }
+
+    return Result;
+}
@@ -0,0 +1,31 @@
+/**
+ * @file ukfMem.h
+ * @brief UKF working storage layout in caller supplied memory.
+ * Step temporaries (Y sigma points, Kalman gain, backup of Pyy, square-root workspace)
+ * share one scratch region, Y_sigma_points may alias K_kalman_gain and Pyy_out_covariance_copy.
+ */
+
+#ifndef UKFMEM_H
+#define UKFMEM_H
+
+#include <stdint.h>
+#include "ukfLib.h"
+
+//! Alignment in bytes of every buffer laid out by ukf_mem_layout(), power of 2
+#ifndef UKF_MEM_ALIGN
+#define UKF_MEM_ALIGN (16u)
+#endif
+
+//! Byte count of one layout
+typedef struct ukfMemPlan {
+    uint32_t total;            //ukf_mem_size()
+    uint32_t persist;          //buffers holding filter state between steps
+    uint32_t scratch;          //shared region of the step temporaries
+    uint32_t scratchUnshared;  //temporaries without sharing, scratchUnshared - scratch is saved
+} tUkfMemPlan;
+
+uint32_t ukf_mem_size   (mtxDim xLen, mtxDim yLen, uint8_t filterMode, uint8_t sigmaScheme);
+uint32_t ukf_mem_plan   (tUkfMemPlan *pPlan, mtxDim xLen, mtxDim yLen, uint8_t filterMode, uint8_t sigmaScheme);
+uint8_t  ukf_mem_layout (tUkfMatrix *pUkfMatrix, void *pMem, uint32_t memSize, mtxDim xLen, mtxDim yLen, uint8_t filterMode, uint8_t sigmaScheme);
+
+#endif /* UKFMEM_H */
@@ -0,0 +1,168 @@
+/**
+ * @file ukfPool.c
+ * @brief Persistent POSIX thread pool executing the sigma point propagation of ukf_step()
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ukfPool.h"
+
+static void *ukf_pool_worker (void *pArg);
+static void  ukf_pool_drain  (tUkfPool *pPool);
+
+/**
+ * @brief Take chunks of the current job until all are taken, pool lock must be held
+ * and is held again on return
+ *
+ * @param pPool Thread pool
+ */
+static void ukf_pool_drain(tUkfPool *pPool) {
+    while (pPool->next < pPool->count) {
+        const mtxDim sigmaIdx = pPool->next;
+        const mtxDim sigmaCnt = (pPool->count - sigmaIdx < pPool->chunk) ? (mtxDim)(pPool->count - sigmaIdx) : pPool->chunk;
+        const tUkfRangeFcn fcnRange = pPool->fcnRange;
+        void *const pArg = pPool->pArg;
+
+        pPool->next = sigmaIdx + sigmaCnt;
+        (void)pthread_mutex_unlock(&pPool->lock);
+
+        fcnRange(pArg, sigmaIdx, sigmaCnt);
+
+        (void)pthread_mutex_lock(&pPool->lock);
+        pPool->pending -= sigmaCnt;
+        if (0 == pPool->pending) {
+            (void)pthread_cond_signal(&pPool->done);
+        }
+    }
+}
+
+/**
+ * @brief Worker thread: wait for a job, help draining it, repeat until the pool stops
+ *
+ * @param pArg Thread pool
+ * @return void* NULL
+ */
+static void *ukf_pool_worker(void *pArg) {
+    tUkfPool *const pPool = (tUkfPool *)pArg;
+    uint32_t job;
+
+    (void)pthread_mutex_lock(&pPool->lock);
+    job = pPool->job;
+
+    while (0 == pPool->stop) {
+        if (job == pPool->job) {
+            (void)pthread_cond_wait(&pPool->start, &pPool->lock);
+        } else {
+            job = pPool->job;
+            ukf_pool_drain(pPool);
+        }
+    }
+    (void)pthread_mutex_unlock(&pPool->lock);
+
+    return NULL;
+}
+
+/**
+ * @brief Start nThread persistent worker threads
+ *
+ * @param pPool Thread pool
+ * @param nThread Number of worker threads (1 .. UKF_POOL_THREADS_MAX), the calling thread works as one more
+ * @return uint8_t
+ * 0 := OK
+ * 1 := NOK (invalid thread count or thread creation failed, pool is not usable)
+ */
+uint8_t ukf_pool_init(tUkfPool *pPool, uint8_t nThread) {
+    uint8_t Result = 0;
+    uint8_t tIdx;
+
+    pPool->exec.fcnParallel = &ukf_pool_parallel;
+    pPool->exec.pCtx = pPool;
+    pPool->nThread = 0;
+    pPool->job = 0;
+    pPool->fcnRange = NULL;
+    pPool->pArg = NULL;
+    pPool->count = 0;
+    pPool->next = 0;
+    pPool->chunk = 1;
+    pPool->pending = 0;
+    pPool->stop = 0;
+
+    if (0 == nThread || nThread > UKF_POOL_THREADS_MAX) {
+        Result = 1;
+    } else if (0 != pthread_mutex_init(&pPool->lock, NULL)) {
+        Result = 1;
+    } else if (0 != pthread_cond_init(&pPool->start, NULL) || 0 != pthread_cond_init(&pPool->done, NULL)) {
+        (void)pthread_mutex_destroy(&pPool->lock);
+        Result = 1;
+    } else {
+        for (tIdx = 0; tIdx < nThread && 0 == Result; tIdx++) {
+            if (0 != pthread_create(&pPool->thread[tIdx], NULL, &ukf_pool_worker, pPool)) {
+                Result = 1;
+            } else {
+                pPool->nThread++;
+            }
+        }
+
+        if (0 != Result) {
+            //stop the threads already running
+            ukf_pool_destroy(pPool);
+        }
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Stop and join all worker threads
+ *
+ * @param pPool Thread pool started with ukf_pool_init()
+ */
+void ukf_pool_destroy(tUkfPool *pPool) {
+    uint8_t tIdx;
+
+    (void)pthread_mutex_lock(&pPool->lock);
+    pPool->stop = 1;
+    (void)pthread_cond_broadcast(&pPool->start);
+    (void)pthread_mutex_unlock(&pPool->lock);
+
+    for (tIdx = 0; tIdx < pPool->nThread; tIdx++) {
+        (void)pthread_join(pPool->thread[tIdx], NULL);
+    }
+    pPool->nThread = 0;
+
+    (void)pthread_cond_destroy(&pPool->done);
+    (void)pthread_cond_destroy(&pPool->start);
+    (void)pthread_mutex_destroy(&pPool->lock);
+}
+
+/**
+ * @brief tUkfParallelFcn of the pool: run fcnRange over [0, count) in chunks of about
+ * count / (UKF_POOL_CHUNKS * threads) sigma points, the caller takes chunks as well
+ * and returns when the last chunk is finished. Jobs of one pool must not be nested.
+ *
+ * @param pCtx Thread pool
+ * @param fcnRange Range job
+ * @param pArg Argument of the range job
+ * @param count Number of sigma points
+ */
+void ukf_pool_parallel(void *pCtx, tUkfRangeFcn fcnRange, void *pArg, mtxDim count) {
+    tUkfPool *const pPool = (tUkfPool *)pCtx;
+    const uint32_t nChunk = UKF_POOL_CHUNKS * ((uint32_t)pPool->nThread + 1u);
+
+    (void)pthread_mutex_lock(&pPool->lock);
+    pPool->fcnRange = fcnRange;
+    pPool->pArg = pArg;
+    pPool->count = count;
+    pPool->next = 0;
+    pPool->chunk = (count > nChunk) ? (mtxDim)((count + nChunk - 1u) / nChunk) : 1;
+    pPool->pending = count;
+    pPool->job++;
+    (void)pthread_cond_broadcast(&pPool->start);
+
+    ukf_pool_drain(pPool);
+
+    while (0 != pPool->pending) {
+        (void)pthread_cond_wait(&pPool->done, &pPool->lock);
+    }
+    (void)pthread_mutex_unlock(&pPool->lock);
+}
@@ -0,0 +1,49 @@
+/**
+ * @file ukfPool.h
+ * @brief Persistent POSIX thread pool executing the sigma point propagation of ukf_step()
+ * (host builds). Assign &pool.exec to tUKF.pExec: every job is split into chunks of
+ * sigma points, the workers and the calling thread take chunks until the job is done.
+ * Model callbacks must be reentrant for disjoint sigma ranges. Weighted means are still
+ * reduced by the filter in sigma point order, so results are bit-for-bit equal
+ * to the sequential path.
+ */
+
+#ifndef UKFPOOL_H
+#define UKFPOOL_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include "ukfLib.h"
+
+//! Maximum number of worker threads of one pool
+#ifndef UKF_POOL_THREADS_MAX
+#define UKF_POOL_THREADS_MAX (16u)
+#endif
+
+//! Chunks per thread and job, more chunks balance uneven callback cost
+#ifndef UKF_POOL_CHUNKS
+#define UKF_POOL_CHUNKS (4u)
+#endif
+
+typedef struct ukfPool {
+    tUkfExec exec;              //executor to assign to tUKF.pExec
+    pthread_t thread[UKF_POOL_THREADS_MAX];
+    uint8_t nThread;            //number of worker threads, the caller of a job works as one more
+    pthread_mutex_t lock;
+    pthread_cond_t start;       //new job or shutdown
+    pthread_cond_t done;        //all sigma points of the job finished
+    uint32_t job;               //incremented for every job
+    tUkfRangeFcn fcnRange;      //range job and it's argument
+    void *pArg;
+    mtxDim count;               //number of sigma points of the job
+    mtxDim next;                //first sigma point not yet taken
+    mtxDim chunk;               //sigma points per chunk
+    mtxDim pending;             //sigma points not yet finished
+    uint8_t stop;               //workers terminate
+} tUkfPool;
+
+uint8_t ukf_pool_init     (tUkfPool *pPool, uint8_t nThread);
+void    ukf_pool_destroy  (tUkfPool *pPool);
+void    ukf_pool_parallel (void *pCtx, tUkfRangeFcn fcnRange, void *pArg, mtxDim count);
+
+#endif /* UKFPOOL_H */
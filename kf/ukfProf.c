@@ -0,0 +1,151 @@
+/**
+ * @file ukfProf.c
+ * @brief Optional per-phase execution time profiling of ukf_step().
+ * Default clock is the DWT cycle counter on Cortex-M3/M4/M7 and CLOCK_MONOTONIC
+ * in nanoseconds on hosted builds.
+ */
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ukfProf.h"
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+#define UKF_PROF_DWT
+#define UKF_PROF_DEMCR      (*(volatile uint32_t *)0xE000EDFCu)
+#define UKF_PROF_DWT_CTRL   (*(volatile uint32_t *)0xE0001000u)
+#define UKF_PROF_DWT_CYCCNT (*(volatile uint32_t *)0xE0001004u)
+#define UKF_PROF_TRCENA     (1u << 24)
+#define UKF_PROF_CYCCNTENA  (1u << 0)
+#elif defined(__unix__) || defined(__APPLE__)
+#define UKF_PROF_POSIX
+#include <time.h>
+#endif
+
+/**
+ * @brief Default profiling clock
+ * 
+ * @return uint32_t DWT CYCCNT cycles on Cortex-M, nanoseconds on host, 0 if not available
+ */
+uint32_t ukf_prof_clock(void) {
+#if defined(UKF_PROF_DWT)
+    return UKF_PROF_DWT_CYCCNT;
+#elif defined(UKF_PROF_POSIX)
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Clear all phase statistics, budgets are kept
+ * 
+ * @param pProf Profile structure
+ */
+void ukf_prof_reset(tUkfProfile *pProf) {
+    uint8_t phaseIdx;
+
+    for (phaseIdx = 0; phaseIdx < UKF_PHASE_NUM; phaseIdx++) {
+        tUkfPhaseStat *const pStat = &pProf->phase[phaseIdx];
+
+        pStat->last = 0;
+        pStat->min = UINT32_MAX;
+        pStat->max = 0;
+        pStat->count = 0;
+        pStat->sum = 0;
+        pStat->overrun = 0;
+    }
+}
+
+/**
+ * @brief Initialize profile structure. Assign it to tUKF.pProf after ukf_init()
+ * to start profiling of ukf_step() (requires build with UKF_PROFILE).
+ * 
+ * @param pProf Profile structure
+ * @param fcnClock Timestamp source or NULL for ukf_prof_clock()
+ */
+void ukf_prof_init(tUkfProfile *pProf, tUkfProfClockFcn fcnClock) {
+    uint8_t phaseIdx;
+
+    pProf->fcnClock = (NULL != fcnClock) ? fcnClock : &ukf_prof_clock;
+
+    for (phaseIdx = 0; phaseIdx < UKF_PHASE_NUM; phaseIdx++) {
+        pProf->phase[phaseIdx].budget = 0;
+    }
+    ukf_prof_reset(pProf);
+
+#if defined(UKF_PROF_DWT)
+    if (&ukf_prof_clock == pProf->fcnClock) {
+        //enable trace unit and start cycle counter
+        UKF_PROF_DEMCR |= UKF_PROF_TRCENA;
+        UKF_PROF_DWT_CYCCNT = 0;
+        UKF_PROF_DWT_CTRL |= UKF_PROF_CYCCNTENA;
+    }
+#endif
+}
+
+/**
+ * @brief Current timestamp of profile clock
+ * 
+ * @param pProf Profile structure or NULL
+ * @return uint32_t Timestamp, 0 if profiling is not active
+ */
+uint32_t ukf_prof_now(const tUkfProfile *pProf) {
+    uint32_t Result = 0;
+
+    if (NULL != pProf) {
+        Result = pProf->fcnClock();
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Account one execution of phase
+ * 
+ * @param pProf Profile structure or NULL
+ * @param phase Profiled phase
+ * @param ticks Execution time in clock ticks
+ */
+void ukf_prof_record(tUkfProfile *pProf, tUkfPhase phase, uint32_t ticks) {
+    if (NULL != pProf && phase < UKF_PHASE_NUM) {
+        tUkfPhaseStat *const pStat = &pProf->phase[phase];
+
+        pStat->last = ticks;
+        pStat->sum += ticks;
+        pStat->count++;
+
+        if (ticks < pStat->min) {
+            pStat->min = ticks;
+        }
+        if (ticks > pStat->max) {
+            pStat->max = ticks;
+        }
+        if (0 != pStat->budget && ticks > pStat->budget) {
+            pStat->overrun++;
+        }
+    }
+}
+
+/**
+ * @brief Mean execution time of phase
+ * 
+ * @param pStat Phase statistic
+ * @return uint32_t Mean ticks, 0 if phase was not executed
+ */
+uint32_t ukf_prof_mean(const tUkfPhaseStat *pStat) {
+    uint32_t Result = 0;
+
+    if (0 != pStat->count) {
+        Result = (uint32_t)(pStat->sum / pStat->count);
+    }
+
+    return Result;
+}
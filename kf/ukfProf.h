@@ -0,0 +1,63 @@
+/**
+ * @file ukfProf.h
+ * @brief Optional per-phase execution time profiling of ukf_step().
+ * Hooks in ukfLib.c are compiled only with UKF_PROFILE defined, otherwise
+ * ukf_step() has no instrumentation overhead.
+ */
+
+#ifndef UKFPROF_H
+#define UKFPROF_H
+
+#include <stdint.h>
+
+//! Profiled phases of ukf_step(), UKF_PHASE_STEP covers the whole step
+typedef enum ukfPhase {
+    UKF_PHASE_SIGMAPOINT = 0,
+    UKF_PHASE_PRED_STATE,
+    UKF_PHASE_PRED_OUTPUT,
+    UKF_PHASE_COVARIANCES,
+    UKF_PHASE_MEAS_UPDATE,
+    UKF_PHASE_STEP,
+    UKF_PHASE_NUM
+} tUkfPhase;
+
+//! Free running timestamp in clock ticks, wrap around is allowed
+typedef uint32_t (*tUkfProfClockFcn)(void);
+
+typedef struct ukfPhaseStat {
+    uint32_t last;     //ticks of last execution
+    uint32_t min;      //best case ticks
+    uint32_t max;      //worst case ticks
+    uint32_t count;    //number of executions
+    uint64_t sum;      //accumulated ticks, mean = sum / count
+    uint32_t budget;   //NOT MANDATORY set 0 if not required, allowed ticks per execution
+    uint32_t overrun;  //number of executions longer than budget
+} tUkfPhaseStat;
+
+typedef struct ukfProfile {
+    tUkfProfClockFcn fcnClock;
+    tUkfPhaseStat phase[UKF_PHASE_NUM];
+} tUkfProfile;
+
+void     ukf_prof_init      (tUkfProfile *pProf, tUkfProfClockFcn fcnClock);
+void     ukf_prof_reset     (tUkfProfile *pProf);
+uint32_t ukf_prof_mean      (const tUkfPhaseStat *pStat);
+uint32_t ukf_prof_clock     (void);
+uint32_t ukf_prof_now       (const tUkfProfile *pProf);
+void     ukf_prof_record    (tUkfProfile *pProf, tUkfPhase phase, uint32_t ticks);
+
+#if defined(UKF_PROFILE)
+#define UKF_PROF_START(pProf, t)        uint32_t t = ukf_prof_now(pProf)
+#define UKF_PROF_MARK(pProf, t, phase)  do {                                        \
+        const uint32_t ukfProfNow = ukf_prof_now(pProf);                            \
+        ukf_prof_record((pProf), (phase), ukfProfNow - (t));                        \
+        (t) = ukfProfNow;                                                           \
+    } while (0)
+#define UKF_PROF_STOP(pProf, t, phase)  ukf_prof_record((pProf), (phase), ukf_prof_now(pProf) - (t))
+#else
+#define UKF_PROF_START(pProf, t)
+#define UKF_PROF_MARK(pProf, t, phase)
+#define UKF_PROF_STOP(pProf, t, phase)
+#endif
+
+#endif /* UKFPROF_H */
@@ -0,0 +1,193 @@
+/**
+ * @file ukfQueue.c
+ * @brief Single-producer/single-consumer measurement queue between an ISR and the filter task.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ukfQueue.h"
+
+/**
+ * @brief Number of bytes required by ukf_queue_init(): samples, timestamps and
+ * measurement present flags of every slot
+ *
+ * @param yLen Number of measurements
+ * @param depth Number of slots
+ * @return uint32_t Block size in bytes
+ */
+uint32_t ukf_queue_mem_size(mtxDim yLen, uint8_t depth) {
+    return (uint32_t)depth * (yLen * (uint32_t)sizeof(mtxScalar) + (uint32_t)sizeof(uint32_t) + yLen);
+}
+
+/**
+ * @brief Lay out an empty queue in caller supplied memory
+ *
+ * @param pQueue Queue to initialize
+ * @param pMem Memory block aligned for mtxScalar
+ * @param memSize Size of memory block, at least ukf_queue_mem_size()
+ * @param yLen Number of measurements, must match the filter
+ * @param depth Number of slots, power of 2 and at least 2
+ * @return uint8_t
+ * 0 := OK
+ * 1 := NOK (invalid depth, memory block too small or misaligned)
+ */
+uint8_t ukf_queue_init(tUkfQueue *pQueue, void *pMem, uint32_t memSize, mtxDim yLen, uint8_t depth) {
+    uint8_t *const pBase = (uint8_t *)pMem;
+    uint8_t Result = 0;
+
+    if (NULL == pBase || 0 != ((uintptr_t)pBase & (sizeof(mtxScalar) - 1u)) || depth < 2 || 0 != (depth & (depth - 1u)) ||
+        0 == yLen || memSize < ukf_queue_mem_size(yLen, depth)) {
+        Result = 1;
+    } else {
+        pQueue->yLen = yLen;
+        pQueue->depth = depth;
+        pQueue->pY = (mtxScalar *)pBase;
+        pQueue->pStamp = (uint32_t *)(pBase + (uint32_t)depth * yLen * sizeof(mtxScalar));
+        pQueue->pValid = (uint8_t *)&pQueue->pStamp[depth];
+        pQueue->head = 0;
+        pQueue->tail = 0;
+        pQueue->dropped = 0;
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Number of samples waiting for the consumer, including a sample held by it
+ *
+ * @param pQueue Queue
+ * @return uint32_t Number of samples
+ */
+uint32_t ukf_queue_count(const tUkfQueue *pQueue) {
+    return pQueue->tail - pQueue->head;
+}
+
+/**
+ * @brief Producer: free slot for the next sample, e.g. as DMA destination. The slot is
+ * published by ukf_queue_commit(), reserving again before commit returns the same slot.
+ *
+ * @param pQueue Queue
+ * @param ppValid Measurement present flags of the slot (yLen), all set to present
+ * @return mtxScalar* Measurement vector of the slot (yLen), NULL if the queue is full
+ */
+mtxScalar *ukf_queue_reserve(tUkfQueue *pQueue, uint8_t **ppValid) {
+    const uint32_t tail = pQueue->tail;
+    mtxScalar *pSlot = NULL;
+
+    if (tail - pQueue->head < pQueue->depth) {
+        const uint32_t slot = tail & (pQueue->depth - 1u);
+        uint8_t *const pValid = &pQueue->pValid[(uint32_t)pQueue->yLen * slot];
+        mtxDim yIdx;
+
+        for (yIdx = 0; yIdx < pQueue->yLen; yIdx++) {
+            pValid[yIdx] = 1;
+        }
+        pSlot = &pQueue->pY[(uint32_t)pQueue->yLen * slot];
+        *ppValid = pValid;
+    } else {
+        //queue full: newest sample is lost, the slot of the consumer is never overwritten
+        pQueue->dropped++;
+    }
+
+    return pSlot;
+}
+
+/**
+ * @brief Producer: publish the sample written into the reserved slot
+ *
+ * @param pQueue Queue
+ * @param stamp Timestamp of the sample
+ */
+void ukf_queue_commit(tUkfQueue *pQueue, uint32_t stamp) {
+    const uint32_t tail = pQueue->tail;
+
+    pQueue->pStamp[tail & (pQueue->depth - 1u)] = stamp;
+
+    //sample must be complete before the consumer can see it
+    UKF_QUEUE_BARRIER();
+    pQueue->tail = tail + 1u;
+}
+
+/**
+ * @brief Producer: copy and publish one sample
+ *
+ * @param pQueue Queue
+ * @param stamp Timestamp of the sample
+ * @param pY Measurement vector (yLen)
+ * @param pValid Measurement present flags (yLen), NOT MANDATORY assign NULL if all are present
+ * @return uint8_t
+ * 0 := OK
+ * 1 := NOK (queue full, sample dropped)
+ */
+uint8_t ukf_queue_push(tUkfQueue *pQueue, uint32_t stamp, mtxScalar const *pY, uint8_t const *pValid) {
+    uint8_t *pSlotValid = NULL;
+    mtxScalar *const pSlot = ukf_queue_reserve(pQueue, &pSlotValid);
+    uint8_t Result = 0;
+    mtxDim yIdx;
+
+    if (NULL != pSlot) {
+        for (yIdx = 0; yIdx < pQueue->yLen; yIdx++) {
+            pSlot[yIdx] = pY[yIdx];
+            pSlotValid[yIdx] = (NULL == pValid) ? 1 : pValid[yIdx];
+        }
+        ukf_queue_commit(pQueue, stamp);
+    } else {
+        Result = 1;
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Consumer: attach the oldest sample as input.y and input.yValid of the filter.
+ * The filter works directly in the slot (the update leaves the innovation there), the
+ * slot stays owned by the consumer until ukf_queue_release(). input.y keeps pointing
+ * into the queue afterwards, so measurements must not be written to it directly.
+ *
+ * @param pQueue Queue
+ * @param pUkf UKF - Working structure, par.yLen must match the queue
+ * @param pStamp Timestamp of the sample, NOT MANDATORY assign NULL if not required
+ * @return uint8_t
+ * 0 := OK
+ * 1 := NOK (queue empty or dimension mismatch, input is unchanged)
+ */
+uint8_t ukf_queue_acquire(tUkfQueue *pQueue, tUKF *pUkf, uint32_t *pStamp) {
+    const uint32_t head = pQueue->head;
+    uint8_t Result = 0;
+
+    if (head == pQueue->tail || pUkf->par.yLen != pQueue->yLen) {
+        Result = 1;
+    } else {
+        const uint32_t slot = head & (pQueue->depth - 1u);
+
+        //tail is read before the slot content
+        UKF_QUEUE_BARRIER();
+        pUkf->input.y.nrow = pQueue->yLen;
+        pUkf->input.y.ncol = 1;
+        pUkf->input.y.val = &pQueue->pY[(uint32_t)pQueue->yLen * slot];
+        pUkf->input.yValid.nrow = pQueue->yLen;
+        pUkf->input.yValid.ncol = 1;
+        pUkf->input.yValid.val = &pQueue->pValid[(uint32_t)pQueue->yLen * slot];
+
+        if (NULL != pStamp) {
+            *pStamp = pQueue->pStamp[slot];
+        }
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Consumer: return the slot of the acquired sample to the producer
+ *
+ * @param pQueue Queue
+ */
+void ukf_queue_release(tUkfQueue *pQueue) {
+    const uint32_t head = pQueue->head;
+
+    if (head != pQueue->tail) {
+        //filter must be done with the slot before the producer can reuse it
+        UKF_QUEUE_BARRIER();
+        pQueue->head = head + 1u;
+    }
+}
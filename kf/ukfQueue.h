@@ -0,0 +1,51 @@
+/**
+ * @file ukfQueue.h
+ * @brief Single-producer/single-consumer measurement queue between an ISR and the filter task.
+ * The producer (ISR, DMA complete callback) publishes timestamped samples wait-free,
+ * the consumer attaches the oldest sample as input.y/input.yValid of the filter without
+ * copying and releases the slot after the step. The producer never touches the slot
+ * held by the consumer, with depth 2 the queue is a double-buffered input slot.
+ * Only the producer writes tail and dropped, only the consumer writes head, so no
+ * critical section is required on cores with atomic aligned 32-bit stores.
+ */
+
+#ifndef UKFQUEUE_H
+#define UKFQUEUE_H
+
+#include <stdint.h>
+#include "ukfLib.h"
+
+//! Memory barrier between slot data and index publication, e.g. DMB on Cortex-M
+#ifndef UKF_QUEUE_BARRIER
+#if defined(__GNUC__)
+#define UKF_QUEUE_BARRIER() __sync_synchronize()
+#else
+#define UKF_QUEUE_BARRIER()
+#endif
+#endif
+
+typedef struct ukfQueue {
+    mtxDim yLen;                //length of measurement vector
+    uint8_t depth;              //number of slots, power of 2
+    mtxScalar *pY;              //(depth x yLen) measurement samples
+    uint8_t *pValid;            //(depth x yLen) 0 := measurement missing in the sample
+    uint32_t *pStamp;           //(depth) timestamp of each sample
+    volatile uint32_t head;     //free running index of the oldest sample, written by consumer only
+    volatile uint32_t tail;     //free running index of the next free slot, written by producer only
+    volatile uint32_t dropped;  //samples rejected because the queue was full, written by producer only
+} tUkfQueue;
+
+uint32_t   ukf_queue_mem_size (mtxDim yLen, uint8_t depth);
+uint8_t    ukf_queue_init     (tUkfQueue *pQueue, void *pMem, uint32_t memSize, mtxDim yLen, uint8_t depth);
+uint32_t   ukf_queue_count    (const tUkfQueue *pQueue);
+
+//producer side (ISR)
+mtxScalar *ukf_queue_reserve  (tUkfQueue *pQueue, uint8_t **ppValid);
+void       ukf_queue_commit   (tUkfQueue *pQueue, uint32_t stamp);
+uint8_t    ukf_queue_push     (tUkfQueue *pQueue, uint32_t stamp, mtxScalar const *pY, uint8_t const *pValid);
+
+//consumer side (filter task)
+uint8_t    ukf_queue_acquire  (tUkfQueue *pQueue, tUKF *pUkf, uint32_t *pStamp);
+void       ukf_queue_release  (tUkfQueue *pQueue);
+
+#endif /* UKFQUEUE_H */
@@ -0,0 +1,206 @@
+/**
+ * @file ukfReplay.c
+ * @brief Offline replay of recorded measurement logs through one or many filters (host builds).
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "ukfReplay.h"
+
+static void ukf_replay_range  (void *pArg, mtxDim jobIdx, mtxDim jobCnt);
+static void ukf_replay_record (tUKF *pUkf, tUkfLogRecord const *pRec, const mtxDim uLen, const mtxDim yLen);
+
+/**
+ * @brief Feed one log record to a filter and run the step: measurements missing in the record
+ * are masked through input.yValid, a filter without input.yValid and records without any
+ * measurement only predict
+ *
+ * @param pUkf UKF - Working structure
+ * @param pRec Log record followed by u[uLen], y[yLen]
+ * @param uLen Number of inputs
+ * @param yLen Number of measurements
+ */
+static void ukf_replay_record(tUKF *pUkf, tUkfLogRecord const *pRec, const mtxDim uLen, const mtxDim yLen) {
+    mtxScalar const *const pu = (mtxScalar const *)(pRec + 1);
+    mtxScalar const *const py = pu + uLen;
+    const uint32_t full = (yLen >= 32u) ? 0xFFFFFFFFu : ((1u << yLen) - 1u);
+    const uint32_t valid = pRec->valid & full;
+    uint8_t *const pValid = pUkf->input.yValid.val;
+    mtxDim idx;
+
+    for (idx = 0; idx < uLen; idx++) {
+        pUkf->input.u.val[idx] = pu[idx];
+    }
+
+    if (0 == valid || (full != valid && NULL == pValid)) {
+        //nothing to update with or missing measurements can't be masked
+        ukf_predict(pUkf, pUkf->par.dT);
+    } else {
+        for (idx = 0; idx < yLen; idx++) {
+            pUkf->input.y.val[idx] = py[idx];
+            if (NULL != pValid) {
+                pValid[idx] = (uint8_t)((valid >> idx) & 1u);
+            }
+        }
+        ukf_step(pUkf);
+    }
+}
+
+/**
+ * @brief Replay a measurement log through nFilt filters in lockstep and write their states
+ * after every record. The filters are used as initialized (e.g. ukf_init() or ukf_restore()),
+ * predict only records use their par.dT. Files must be opened in binary mode.
+ *
+ * @param pReplay Work buffers
+ * @param pLog Measurement log, read from the current position
+ * @param pEst Estimates, NOT MANDATORY assign NULL if not required
+ * @param pUkf nFilt filters with equal xLen, yLen and inputs matching the log
+ * @param nFilt Number of filters (at least 1)
+ * @param pSamples Number of replayed records, NOT MANDATORY assign NULL if not required
+ * @return uint8_t
+ * 0 := OK
+ * 1 := NOK (invalid header, dimensions not matching the filters, truncated record or write error)
+ */
+uint8_t ukf_replay_stream(tUkfReplay *pReplay, FILE *pLog, FILE *pEst, tUKF *pUkf, uint8_t nFilt, uint32_t *pSamples) {
+    uint8_t *const pIn = (uint8_t *)pReplay->in;
+    uint8_t *const pOut = (uint8_t *)pReplay->out;
+    uint32_t samples = 0;
+    uint8_t Result = 0;
+    tUkfLogHeader hdr;
+    uint8_t fIdx;
+
+    if (0 == nFilt || 1 != fread(&hdr, sizeof(hdr), 1, pLog) || UKF_LOG_MAGIC != hdr.magic || UKF_LOG_VERSION != hdr.version ||
+        sizeof(mtxScalar) != hdr.scalarSize || hdr.yLen > 32u) {
+        Result = 1;
+    }
+
+    for (fIdx = 0; fIdx < nFilt && 0 == Result; fIdx++) {
+        const uint32_t uLen = (NULL != pUkf[fIdx].input.u.val) ? pUkf[fIdx].input.u.nrow : 0;
+
+        if (hdr.yLen != pUkf[fIdx].par.yLen || hdr.uLen != uLen || pUkf[0].par.xLen != pUkf[fIdx].par.xLen) {
+            Result = 1;
+        }
+    }
+
+    if (0 == Result) {
+        const uint32_t inSize = (uint32_t)sizeof(tUkfLogRecord) + ((uint32_t)hdr.uLen + hdr.yLen) * (uint32_t)sizeof(mtxScalar);
+        const uint32_t outSize = (uint32_t)sizeof(tUkfLogRecord) + (uint32_t)nFilt * pUkf[0].par.xLen * (uint32_t)sizeof(mtxScalar);
+        uint32_t inLen = 0;
+        uint32_t inPos = 0;
+        uint32_t outLen = 0;
+        uint8_t eof = 0;
+
+        if (NULL != pEst) {
+            tUkfEstHeader est;
+
+            (void)memset(&est, 0, sizeof(est));
+            est.magic = UKF_EST_MAGIC;
+            est.version = UKF_LOG_VERSION;
+            est.scalarSize = (uint8_t)sizeof(mtxScalar);
+            est.nFilt = nFilt;
+            est.xLen = pUkf[0].par.xLen;
+            if (1 != fwrite(&est, sizeof(est), 1, pEst)) {
+                Result = 1;
+            }
+        }
+
+        if (inSize > UKF_REPLAY_BUF_SIZE || outSize > UKF_REPLAY_BUF_SIZE) {
+            Result = 1;
+        }
+
+        while (0 == Result && 0 == eof) {
+            if (inLen - inPos < inSize) {
+                //refill: partial record moves to the start, record sizes keep the following ones aligned
+                const uint32_t rest = inLen - inPos;
+                uint32_t nRead;
+
+                (void)memmove(pIn, &pIn[inPos], rest);
+                nRead = (uint32_t)fread(&pIn[rest], 1, UKF_REPLAY_BUF_SIZE - rest, pLog);
+                inLen = rest + nRead;
+                inPos = 0;
+
+                if (inLen < inSize) {
+                    eof = 1;
+                    if (0 != inLen || 0 != ferror(pLog)) {
+                        Result = 1;
+                    }
+                }
+            } else {
+                tUkfLogRecord const *const pRec = (tUkfLogRecord const *)&pIn[inPos];
+
+                for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                    ukf_replay_record(&pUkf[fIdx], pRec, hdr.uLen, hdr.yLen);
+                }
+                inPos += inSize;
+                samples++;
+
+                if (NULL != pEst) {
+                    tUkfLogRecord *const pEstRec = (tUkfLogRecord *)&pOut[outLen];
+                    mtxScalar *px = (mtxScalar *)(pEstRec + 1);
+
+                    pEstRec->stamp = pRec->stamp;
+                    pEstRec->valid = pRec->valid;
+                    for (fIdx = 0; fIdx < nFilt; fIdx++) {
+                        (void)memcpy(px, pUkf[fIdx].update.x.val, pUkf[0].par.xLen * sizeof(mtxScalar));
+                        px += pUkf[0].par.xLen;
+                    }
+                    outLen += outSize;
+
+                    if (outLen + outSize > UKF_REPLAY_BUF_SIZE) {
+                        if (outLen != fwrite(pOut, 1, outLen, pEst)) {
+                            Result = 1;
+                        }
+                        outLen = 0;
+                    }
+                }
+            }
+        }
+
+        if (0 != outLen && outLen != fwrite(pOut, 1, outLen, pEst)) {
+            Result = 1;
+        }
+        if (NULL != pEst && 0 != fflush(pEst)) {
+            Result = 1;
+        }
+    }
+
+    if (NULL != pSamples) {
+        *pSamples = samples;
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Range job of ukf_replay_jobs()
+ *
+ * @param pArg Job array
+ * @param jobIdx First job
+ * @param jobCnt Number of jobs
+ */
+static void ukf_replay_range(void *pArg, mtxDim jobIdx, mtxDim jobCnt) {
+    tUkfReplayJob *const pJob = (tUkfReplayJob *)pArg;
+    mtxDim idx;
+
+    for (idx = jobIdx; idx < jobIdx + jobCnt; idx++) {
+        pJob[idx].result = ukf_replay_stream(pJob[idx].pReplay, pJob[idx].pLog, pJob[idx].pEst, pJob[idx].pUkf, pJob[idx].nFilt,
+                                             &pJob[idx].samples);
+    }
+}
+
+/**
+ * @brief Replay independent logs, concurrently if an executor is assigned. Jobs must not
+ * share filters or work buffers, and filters of the jobs must not use the same executor.
+ *
+ * @param pJob Jobs, result and samples are written back
+ * @param count Number of jobs
+ * @param pExec Parallel executor (e.g. &pool.exec of ukfPool.h), NOT MANDATORY assign NULL if not required
+ */
+void ukf_replay_jobs(tUkfReplayJob *pJob, mtxDim count, const tUkfExec *pExec) {
+    if (NULL != pExec) {
+        pExec->fcnParallel(pExec->pCtx, &ukf_replay_range, pJob, count);
+    } else {
+        ukf_replay_range(pJob, 0, count);
+    }
+}
@@ -0,0 +1,75 @@
+/**
+ * @file ukfReplay.h
+ * @brief Offline replay of recorded measurement logs through one or many filters (host builds).
+ * Logs and estimates are packed binary files in native byte order: a header followed by
+ * fixed size records. Records are read in chunks of UKF_REPLAY_BUF_SIZE bytes and
+ * estimates are collected in an output buffer of the same size, there is no formatted
+ * I/O per sample. Independent logs run as jobs on a parallel executor (e.g. ukfPool.h).
+ *
+ * log:       tUkfLogHeader, records {tUkfLogRecord, u[uLen], y[yLen]}
+ * estimates: tUkfEstHeader, records {tUkfLogRecord, x[xLen] of filter 0 .. nFilt-1}
+ */
+
+#ifndef UKFREPLAY_H
+#define UKFREPLAY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "ukfLib.h"
+
+#define UKF_LOG_MAGIC   (0x4C464B55u)  //"UKFL" in little endian files
+#define UKF_EST_MAGIC   (0x45464B55u)  //"UKFE" in little endian files
+#define UKF_LOG_VERSION (1u)
+
+//! Size of the input and of the output buffer of one replay stream in bytes
+#ifndef UKF_REPLAY_BUF_SIZE
+#define UKF_REPLAY_BUF_SIZE (256u * 1024u)
+#endif
+
+typedef struct ukfLogHeader {
+    uint32_t magic;       //UKF_LOG_MAGIC
+    uint16_t version;     //UKF_LOG_VERSION
+    uint8_t scalarSize;   //sizeof(mtxScalar) of the records
+    uint8_t reserved;
+    uint16_t yLen;        //measurements per record, at most 32
+    uint16_t uLen;        //inputs per record
+    uint32_t reserved2;
+} tUkfLogHeader;
+
+typedef struct ukfEstHeader {
+    uint32_t magic;       //UKF_EST_MAGIC
+    uint16_t version;     //UKF_LOG_VERSION
+    uint8_t scalarSize;   //sizeof(mtxScalar) of the records
+    uint8_t nFilt;        //filters per record
+    uint16_t xLen;        //states per filter
+    uint16_t reserved;
+    uint32_t reserved2;
+} tUkfEstHeader;
+
+//! Head of every log and estimate record, followed by the scalars of the record
+typedef struct ukfLogRecord {
+    uint32_t stamp;       //timestamp, copied from the log into the estimates
+    uint32_t valid;       //bit yIdx set := measurement yIdx present, 0 := predict only
+} tUkfLogRecord;
+
+//! Work buffers of one replay stream, mtxScalar storage keeps the records aligned
+typedef struct ukfReplay {
+    mtxScalar in[UKF_REPLAY_BUF_SIZE / sizeof(mtxScalar)];
+    mtxScalar out[UKF_REPLAY_BUF_SIZE / sizeof(mtxScalar)];
+} tUkfReplay;
+
+//! One log replayed by ukf_replay_jobs()
+typedef struct ukfReplayJob {
+    FILE *pLog;             //measurement log opened for binary reading
+    FILE *pEst;             //NOT MANDATORY assign NULL if not required, estimates opened for binary writing
+    tUKF *pUkf;             //nFilt initialized filters, all see the same log
+    uint8_t nFilt;
+    tUkfReplay *pReplay;    //work buffers, one per job
+    uint32_t samples;       //records replayed
+    uint8_t result;         //0 := OK, 1 := NOK (see ukf_replay_stream())
+} tUkfReplayJob;
+
+uint8_t ukf_replay_stream (tUkfReplay *pReplay, FILE *pLog, FILE *pEst, tUKF *pUkf, uint8_t nFilt, uint32_t *pSamples);
+void    ukf_replay_jobs   (tUkfReplayJob *pJob, mtxDim count, const tUkfExec *pExec);
+
+#endif /* UKFREPLAY_H */
@@ -0,0 +1,395 @@
+/**
+ * @file ukfSmooth.c
+ * @brief Unscented Rauch-Tung-Striebel smoother with bounded memory.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ukfSmooth.h"
+
+static uint8_t ukf_smooth_back   (tUkfSmooth *pSmooth, uint16_t entry);
+static void    ukf_smooth_start  (tUkfSmooth *pSmooth, const tUKF *pUkf);
+static void    ukf_smooth_full   (mtxScalar *pDst, mtxScalar const *pSrc, const tUKF *pUkf, uint8_t isFactor);
+static void    ukf_smooth_capture_prior (void *pCtx, const tUKF *pUkf);
+static void    ukf_smooth_capture_cross (void *pCtx, const tUKF *pUkf);
+static void    ukf_smooth_capture_pred  (void *pCtx, const tUKF *pUkf);
+
+/**
+ * @brief Number of bytes required by ukf_smooth_init()
+ *
+ * @param xLen Number of states
+ * @param sLen Number of sigma points of the filter
+ * @param depth Number of ring entries (lag of the fixed-lag mode, interval length of the fixed-interval mode)
+ * @return uint32_t Block size in bytes
+ */
+uint32_t ukf_smooth_mem_size(mtxDim xLen, mtxDim sLen, uint16_t depth) {
+    const uint32_t nn = (uint32_t)xLen * xLen;
+
+    return ((uint32_t)depth * (2u * xLen + 3u * nn) + (uint32_t)xLen * sLen + 4u * nn + 2u * xLen) * (uint32_t)sizeof(mtxScalar);
+}
+
+/**
+ * @brief Lay out an empty smoother in caller supplied memory
+ *
+ * @param pSmooth Smoother to initialize
+ * @param pMem Memory block aligned for mtxScalar
+ * @param memSize Size of memory block, at least ukf_smooth_mem_size()
+ * @param xLen Number of states, must match the filter
+ * @param sLen Number of sigma points, must match the filter
+ * @param depth Number of ring entries, at least 1
+ * @return uint8_t
+ * 0 := OK
+ * 1 := NOK (invalid dimensions, memory block too small or misaligned)
+ */
+uint8_t ukf_smooth_init(tUkfSmooth *pSmooth, void *pMem, uint32_t memSize, mtxDim xLen, mtxDim sLen, uint16_t depth) {
+    mtxScalar *pBase = (mtxScalar *)pMem;
+    uint8_t Result = 0;
+
+    if (NULL == pBase || 0 != ((uintptr_t)pBase & (sizeof(mtxScalar) - 1u)) || 0 == depth || 0 == xLen || 0 == sLen ||
+        memSize < ukf_smooth_mem_size(xLen, sLen, depth)) {
+        Result = 1;
+    } else {
+        const uint32_t nn = (uint32_t)xLen * xLen;
+
+        pSmooth->xLen = xLen;
+        pSmooth->sLen = sLen;
+        pSmooth->depth = depth;
+        pSmooth->pX = pBase;
+        pBase += (uint32_t)depth * xLen;
+        pSmooth->pP = pBase;
+        pBase += (uint32_t)depth * nn;
+        pSmooth->pXm = pBase;
+        pBase += (uint32_t)depth * xLen;
+        pSmooth->pPm = pBase;
+        pBase += (uint32_t)depth * nn;
+        pSmooth->pC = pBase;
+        pBase += (uint32_t)depth * nn;
+        pSmooth->pDev = pBase;
+        pBase += (uint32_t)xLen * sLen;
+        pSmooth->pL = pBase;
+        pBase += nn;
+        pSmooth->pG = pBase;
+        pBase += nn;
+        pSmooth->pT = pBase;
+        pBase += nn;
+        pSmooth->pPs = pBase;
+        pBase += nn;
+        pSmooth->pXs = pBase;
+        pBase += xLen;
+        pSmooth->pD = pBase;
+        ukf_smooth_reset(pSmooth);
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Drop all entries, e.g. to start a new fixed interval
+ *
+ * @param pSmooth Smoother
+ */
+void ukf_smooth_reset(tUkfSmooth *pSmooth) {
+    pSmooth->head = 0;
+    pSmooth->count = 0;
+    pSmooth->pending = 0;
+}
+
+/**
+ * @brief Record every prediction of the filter: the capture functions become the
+ * prediction hooks of pUkf (tUKF.pHook), assign NULL to tUKF.pHook to detach
+ *
+ * @param pSmooth Smoother initialized by ukf_smooth_init()
+ * @param pUkf UKF - Working structure, after ukf_init()
+ */
+void ukf_smooth_attach(tUkfSmooth *pSmooth, tUKF *pUkf) {
+    pSmooth->hook.fcnPrior = ukf_smooth_capture_prior;
+    pSmooth->hook.fcnCross = ukf_smooth_capture_cross;
+    pSmooth->hook.fcnPred = ukf_smooth_capture_pred;
+    pSmooth->hook.pCtx = pSmooth;
+    pUkf->pHook = &pSmooth->hook;
+}
+
+/**
+ * @brief Full covariance Dst(xLen x xLen) of Src, which is the matrix itself or its lower Cholesky factor
+ *
+ * @param pDst Full covariance
+ * @param pSrc Covariance or lower Cholesky factor
+ * @param pUkf UKF - Working structure
+ * @param isFactor Src is a lower Cholesky factor
+ */
+static void ukf_smooth_full(mtxScalar *pDst, mtxScalar const *pSrc, const tUKF *pUkf, uint8_t isFactor) {
+    const mtxDim xLen = pUkf->par.xLen;
+
+    mtx_kernel_cpy(pDst, pSrc, (mtxIdx)xLen * xLen);
+    if (0 != isFactor) {
+        //P = L*L'
+        mtx_kernel_chol_product(pDst, xLen);
+    }
+}
+
+/**
+ * @brief Store x(k|k), P(k|k) of the prediction in progress: after ukf_sigmapoint() (Pxx_p
+ * holds its lower Cholesky factor, X_p the sigma points) or before the linear prediction
+ *
+ * @param pCtx Smoother, entries are not captured if its dimensions don't match the filter
+ * @param pUkf UKF - Working structure
+ */
+static void ukf_smooth_capture_prior(void *pCtx, const tUKF *pUkf) {
+    tUkfSmooth *const pSmooth = (tUkfSmooth *)pCtx;
+    const mtxDim xLen = pUkf->par.xLen;
+    const mtxDim sLen = pUkf->par.sLen;
+    const uint8_t linear = (NULL != pUkf->par.Fxx.val);
+
+    pSmooth->pending = (xLen == pSmooth->xLen && sLen == pSmooth->sLen);
+
+    if (0 != pSmooth->pending) {
+        const uint32_t entry = pSmooth->head;
+        mtxScalar const *const px_p = pUkf->prev.x_p.val;
+        mtxDim xIdx, sIdx;
+
+        mtx_kernel_cpy(&pSmooth->pX[(uint32_t)xLen * entry], px_p, xLen);
+        ukf_smooth_full(&pSmooth->pP[(uint32_t)xLen * xLen * entry], pUkf->prev.Pxx_p.val, pUkf,
+                        (0 == linear || UKF_MODE_SQRT == pUkf->par.mode));
+
+        for (xIdx = 0; xIdx < xLen && 0 == linear; xIdx++) {
+            for (sIdx = 0; sIdx < sLen; sIdx++) {
+                const mtxIdx idx = UKF_SIGMA_IDX(xLen, sLen, xIdx, sIdx);
+
+                //sigma points are propagated in place, keep their deviations
+                pSmooth->pDev[idx] = pUkf->prev.X_p.val[idx] - px_p[xIdx];
+            }
+        }
+    }
+}
+
+/**
+ * @brief Cross-covariance of the prediction in progress: after the predicted mean of the
+ * unscented prediction (X_m not yet centered) or after the linear prediction
+ *
+ * @param pCtx Smoother
+ * @param pUkf UKF - Working structure
+ */
+static void ukf_smooth_capture_cross(void *pCtx, const tUKF *pUkf) {
+    tUkfSmooth *const pSmooth = (tUkfSmooth *)pCtx;
+
+    if (0 != pSmooth->pending) {
+        const mtxDim xLen = pSmooth->xLen;
+        const mtxDim sLen = pSmooth->sLen;
+        const uint32_t nn = (uint32_t)xLen * xLen;
+        mtxScalar *const pC = &pSmooth->pC[nn * pSmooth->head];
+
+        if (NULL != pUkf->par.Fxx.val) {
+            //C = P(k|k)*F'
+            mtx_kernel_mul_src2tr(&pSmooth->pP[nn * pSmooth->head], pUkf->par.Fxx.val, pC, xLen, xLen, xLen);
+        } else {
+            mtxScalar const *const pWc = pUkf->par.Wc.val;
+            mtxScalar const *const pX_m = pUkf->predict.X_m.val;
+            mtxScalar const *const px_m = pUkf->predict.x_m.val;
+            mtxDim row, col, sIdx;
+
+            for (row = 0; row < xLen; row++) {
+                for (col = 0; col < xLen; col++) {
+                    mtxScalar sum = 0;
+
+                    for (sIdx = 0; sIdx < sLen; sIdx++) {
+                        sum += pWc[sIdx] * pSmooth->pDev[UKF_SIGMA_IDX(xLen, sLen, row, sIdx)] *
+                               (pX_m[UKF_SIGMA_IDX(xLen, sLen, col, sIdx)] - px_m[col]);
+                    }
+                    pC[xLen * row + col] = sum;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Store x(k+1|k), P(k+1|k) and complete the entry of the prediction in progress
+ *
+ * @param pCtx Smoother
+ * @param pUkf UKF - Working structure
+ */
+static void ukf_smooth_capture_pred(void *pCtx, const tUKF *pUkf) {
+    tUkfSmooth *const pSmooth = (tUkfSmooth *)pCtx;
+
+    if (0 != pSmooth->pending) {
+        const mtxDim xLen = pSmooth->xLen;
+
+        mtx_kernel_cpy(&pSmooth->pXm[(uint32_t)xLen * pSmooth->head], pUkf->predict.x_m.val, xLen);
+        ukf_smooth_full(&pSmooth->pPm[(uint32_t)xLen * xLen * pSmooth->head], pUkf->predict.P_m.val, pUkf,
+                        (UKF_MODE_SQRT == pUkf->par.mode));
+
+        pSmooth->head = (uint16_t)((pSmooth->head + 1u) % pSmooth->depth);
+        if (pSmooth->count < pSmooth->depth) {
+            pSmooth->count++;
+        }
+        pSmooth->pending = 0;
+    }
+}
+
+/**
+ * @brief Recursion start x(N|N), P(N|N): current state of the filter
+ *
+ * @param pSmooth Smoother
+ * @param pUkf UKF - Working structure
+ */
+static void ukf_smooth_start(tUkfSmooth *pSmooth, const tUKF *pUkf) {
+    mtx_kernel_cpy(pSmooth->pXs, pUkf->update.x.val, pSmooth->xLen);
+    ukf_smooth_full(pSmooth->pPs, pUkf->update.Pxx.val, pUkf, (UKF_MODE_SQRT == pUkf->par.mode));
+}
+
+/**
+ * @brief One step of the backward recursion: x(k+1|N), P(k+1|N) in pXs, pPs become x(k|N), P(k|N)
+ *
+ * @param pSmooth Smoother
+ * @param entry Ring entry of step k
+ * @return uint8_t
+ * 0 := OK
+ * 1 := NOK (P(k+1|k) is not positive definite)
+ */
+static uint8_t ukf_smooth_back(tUkfSmooth *pSmooth, uint16_t entry) {
+    const mtxDim xLen = pSmooth->xLen;
+    const uint32_t nn = (uint32_t)xLen * xLen;
+    mtxScalar const *const px = &pSmooth->pX[(uint32_t)xLen * entry];
+    mtxScalar const *const pP = &pSmooth->pP[nn * entry];
+    mtxScalar const *const pxm = &pSmooth->pXm[(uint32_t)xLen * entry];
+    mtxScalar const *const pPm = &pSmooth->pPm[nn * entry];
+    mtxScalar *const pPs = pSmooth->pPs;
+    uint8_t Result = 0;
+
+    //G = C*inv(P(k+1|k))
+    mtx_kernel_cpy(pSmooth->pL, pPm, (mtxIdx)nn);
+    if (MTX_OPERATION_OK != mtx_kernel_chol_lower(pSmooth->pL, xLen)) {
+        Result = 1;
+    } else {
+        mtxDim row, col, k;
+
+        mtx_kernel_cpy(pSmooth->pG, &pSmooth->pC[nn * entry], (mtxIdx)nn);
+        mtx_kernel_chol_subst(pSmooth->pL, pSmooth->pG, xLen, xLen);
+
+        //x(k|N) = x(k|k) + G*(x(k+1|N) - x(k+1|k))
+        for (row = 0; row < xLen; row++) {
+            pSmooth->pD[row] = pSmooth->pXs[row] - pxm[row];
+        }
+        mtx_kernel_cpy(pSmooth->pXs, px, xLen);
+        mtx_kernel_mul_vec(pSmooth->pXs, pSmooth->pG, pSmooth->pD, MTX_C(1.0), MTX_C(1.0), xLen, xLen);
+
+        //P(k|N) = P(k|k) + G*(P(k+1|N) - P(k+1|k))*G', lower triangle is mirrored
+        mtx_kernel_sub(pPs, pPm, (mtxIdx)nn);
+        mtx_kernel_mul(pSmooth->pG, pPs, pSmooth->pT, xLen, xLen, xLen);
+        for (row = 0; row < xLen; row++) {
+            for (col = 0; col <= row; col++) {
+                mtxScalar sum = pP[xLen * row + col];
+
+                for (k = 0; k < xLen; k++) {
+                    sum += pSmooth->pT[xLen * row + k] * pSmooth->pG[xLen * col + k];
+                }
+                pPs[xLen * row + col] = sum;
+                pPs[xLen * col + row] = sum;
+            }
+        }
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Fixed-lag smoothing: x(N-lag|N), P(N-lag|N) from the filter state x(N|N), P(N|N)
+ * and the last lag entries; cost is lag backward steps, entries are not modified
+ *
+ * @param pSmooth Smoother attached to the filter
+ * @param pUkf UKF - Working structure
+ * @param lag Number of predictions back, at most the number of stored entries (0 := filter state)
+ * @param px Smoothed state (xLen x 1)
+ * @param pP Smoothed covariance (xLen x xLen), NOT MANDATORY assign NULL if not required
+ * @return uint8_t
+ * 0 := OK
+ * 1 := NOK (not enough entries, dimension mismatch or P(k+1|k) not positive definite)
+ */
+uint8_t ukf_smooth_lag(tUkfSmooth *pSmooth, const tUKF *pUkf, uint16_t lag, tMatrix *px, tMatrix *pP) {
+    const mtxDim xLen = pSmooth->xLen;
+    uint8_t Result = 0;
+    uint16_t bIdx;
+
+    if (lag > pSmooth->count || xLen != pUkf->par.xLen || px->nrow != xLen || (NULL != pP && (pP->nrow != xLen || pP->ncol != xLen))) {
+        Result = 1;
+    } else {
+        ukf_smooth_start(pSmooth, pUkf);
+
+        for (bIdx = 0; bIdx < lag && 0 == Result; bIdx++) {
+            //newest entry first
+            Result = ukf_smooth_back(pSmooth, (uint16_t)((pSmooth->head + 2u * pSmooth->depth - 1u - bIdx) % pSmooth->depth));
+        }
+
+        mtx_kernel_cpy(px->val, pSmooth->pXs, xLen);
+        if (NULL != pP) {
+            mtx_kernel_cpy(pP->val, pSmooth->pPs, (mtxIdx)xLen * xLen);
+        }
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Fixed-interval smoothing of all stored entries from the filter state x(N|N), P(N|N):
+ * every entry is replaced by x(k|N), P(k|N) (read with ukf_smooth_get()). Call
+ * ukf_smooth_reset() before the filter records the next interval.
+ *
+ * @param pSmooth Smoother attached to the filter
+ * @param pUkf UKF - Working structure
+ * @return uint8_t
+ * 0 := OK
+ * 1 := NOK (dimension mismatch or P(k+1|k) not positive definite, older entries are not smoothed)
+ */
+uint8_t ukf_smooth_interval(tUkfSmooth *pSmooth, const tUKF *pUkf) {
+    const mtxDim xLen = pSmooth->xLen;
+    const uint32_t nn = (uint32_t)xLen * xLen;
+    uint8_t Result = 0;
+    uint16_t bIdx;
+
+    if (xLen != pUkf->par.xLen) {
+        Result = 1;
+    } else {
+        ukf_smooth_start(pSmooth, pUkf);
+
+        for (bIdx = 0; bIdx < pSmooth->count && 0 == Result; bIdx++) {
+            const uint16_t entry = (uint16_t)((pSmooth->head + 2u * pSmooth->depth - 1u - bIdx) % pSmooth->depth);
+
+            Result = ukf_smooth_back(pSmooth, entry);
+            if (0 == Result) {
+                mtx_kernel_cpy(&pSmooth->pX[(uint32_t)xLen * entry], pSmooth->pXs, xLen);
+                mtx_kernel_cpy(&pSmooth->pP[nn * entry], pSmooth->pPs, (mtxIdx)nn);
+            }
+        }
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Read a stored entry: x(k|k), P(k|k), or x(k|N), P(k|N) after ukf_smooth_interval()
+ *
+ * @param pSmooth Smoother
+ * @param idx Entry, 0 is the oldest one
+ * @param px State (xLen x 1)
+ * @param pP Covariance (xLen x xLen), NOT MANDATORY assign NULL if not required
+ * @return uint8_t
+ * 0 := OK
+ * 1 := NOK (no such entry or dimension mismatch)
+ */
+uint8_t ukf_smooth_get(const tUkfSmooth *pSmooth, uint16_t idx, tMatrix *px, tMatrix *pP) {
+    const mtxDim xLen = pSmooth->xLen;
+    uint8_t Result = 0;
+
+    if (idx >= pSmooth->count || px->nrow != xLen || (NULL != pP && (pP->nrow != xLen || pP->ncol != xLen))) {
+        Result = 1;
+    } else {
+        const uint32_t entry = ((uint32_t)pSmooth->head + pSmooth->depth - pSmooth->count + idx) % pSmooth->depth;
+
+        mtx_kernel_cpy(px->val, &pSmooth->pX[(uint32_t)xLen * entry], xLen);
+        if (NULL != pP) {
+            mtx_kernel_cpy(pP->val, &pSmooth->pP[(uint32_t)xLen * xLen * entry], (mtxIdx)xLen * xLen);
+        }
+    }
+
+    return Result;
+}
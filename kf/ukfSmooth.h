@@ -0,0 +1,51 @@
+/**
+ * @file ukfSmooth.h
+ * @brief Unscented Rauch-Tung-Striebel smoother with bounded memory.
+ * Attach a smoother with ukf_smooth_attach(): every prediction of the filter stores the tuple
+ * x(k|k), P(k|k), x(k+1|k), P(k+1|k) and the cross-covariance
+ * C(k) = sum(Wc(i)*(X_p(i)-x(k|k))*(X_m(i)-x(k+1|k))') (P(k|k)*F' with linear prediction)
+ * into a preallocated ring of depth entries, the oldest entry is overwritten.
+ * Backward recursion with G(k) = C(k)*inv(P(k+1|k)):
+ * x(k|N) = x(k|k) + G(k)*(x(k+1|N) - x(k+1|k))
+ * P(k|N) = P(k|k) + G(k)*(P(k+1|N) - P(k+1|k))*G(k)'
+ * starting from the current filter state x(N|N), P(N|N). Covariances are stored and
+ * returned as full matrices in both filter modes.
+ */
+
+#ifndef UKFSMOOTH_H
+#define UKFSMOOTH_H
+
+#include <stdint.h>
+#include "ukfLib.h"
+
+typedef struct ukfSmooth {
+    mtxDim xLen;          //length of state vector
+    mtxDim sLen;          //number of sigma points of the filter
+    uint16_t depth;       //number of ring entries
+    uint16_t head;        //next entry written by the filter
+    uint16_t count;       //valid entries (at most depth)
+    uint8_t pending;      //entry at head is being captured
+    mtxScalar *pX;        //(depth x xLen) x(k|k), x(k|N) after ukf_smooth_interval()
+    mtxScalar *pP;        //(depth x xLen x xLen) P(k|k), P(k|N) after ukf_smooth_interval()
+    mtxScalar *pXm;       //(depth x xLen) x(k+1|k)
+    mtxScalar *pPm;       //(depth x xLen x xLen) P(k+1|k)
+    mtxScalar *pC;        //(depth x xLen x xLen) cross-covariance C(k)
+    mtxScalar *pDev;      //(xLen x sLen) sigma point deviations X_p - x(k|k) of the prediction in progress
+    mtxScalar *pL;        //(xLen x xLen) Cholesky factor of P(k+1|k)
+    mtxScalar *pG;        //(xLen x xLen) smoother gain
+    mtxScalar *pT;        //(xLen x xLen) G*(P(k+1|N) - P(k+1|k))
+    mtxScalar *pPs;       //(xLen x xLen) smoothed covariance of the recursion
+    mtxScalar *pXs;       //(xLen) smoothed state of the recursion
+    mtxScalar *pD;        //(xLen) x(k+1|N) - x(k+1|k)
+    tUkfPredHook hook;    //prediction hooks of the filter, tUKF.pHook after ukf_smooth_attach()
+} tUkfSmooth;
+
+uint32_t ukf_smooth_mem_size (mtxDim xLen, mtxDim sLen, uint16_t depth);
+uint8_t  ukf_smooth_init     (tUkfSmooth *pSmooth, void *pMem, uint32_t memSize, mtxDim xLen, mtxDim sLen, uint16_t depth);
+void     ukf_smooth_attach   (tUkfSmooth *pSmooth, tUKF *pUkf);
+void     ukf_smooth_reset    (tUkfSmooth *pSmooth);
+uint8_t  ukf_smooth_lag      (tUkfSmooth *pSmooth, const tUKF *pUkf, uint16_t lag, tMatrix *px, tMatrix *pP);
+uint8_t  ukf_smooth_interval (tUkfSmooth *pSmooth, const tUKF *pUkf);
+uint8_t  ukf_smooth_get      (const tUkfSmooth *pSmooth, uint16_t idx, tMatrix *px, tMatrix *pP);
+
+#endif /* UKFSMOOTH_H */